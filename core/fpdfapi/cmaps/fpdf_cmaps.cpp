@@ -7,8 +7,11 @@
 #include "core/fpdfapi/cmaps/fpdf_cmaps.h"
 
 #include <algorithm>
+#include <ranges>
+#include <vector>
 
 #include "core/fxcrt/check.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/span.h"
 
 namespace fxcmap {
@@ -78,6 +81,50 @@ uint16_t CIDFromCharCodeForDword(const CMap* cmap, uint32_t charcode) {
 
 }  // namespace
 
+CIDTable::CIDTable(const CMap* cmap) : pages_(256) {
+  CHECK(cmap);
+  std::vector<const CMap*> chain;
+  for (; cmap; cmap = FindNextCMap(cmap)) {
+    CHECK(cmap->word_map_);
+    chain.push_back(cmap);
+  }
+
+  // CIDFromCharCode() takes the first match along the chain, and the first
+  // match within each CMap. Fill in reverse, so those overwrite the others.
+  for (const CMap* map : std::ranges::reverse_view(chain)) {
+    switch (map->word_map_type_) {
+      case CMap::Type::kSingle: {
+        for (const auto& single : std::ranges::reverse_view(
+                 GetSingleCmapSpan(map))) {
+          SetCID(single.code, single.cid);
+        }
+        break;
+      }
+      case CMap::Type::kRange: {
+        for (const auto& range :
+             std::ranges::reverse_view(GetRangeCmapSpan(map))) {
+          for (uint32_t code = range.low; code <= range.high; ++code) {
+            SetCID(static_cast<uint16_t>(code),
+                   static_cast<uint16_t>(range.cid + code - range.low));
+          }
+        }
+        break;
+      }
+    }
+  }
+}
+
+CIDTable::~CIDTable() = default;
+
+void CIDTable::SetCID(uint16_t charcode, uint16_t cid) {
+  uint16_t& page = page_index_[charcode >> 8];
+  if (!page) {
+    page = pdfium::checked_cast<uint16_t>(pages_.size() / 256);
+    pages_.resize(pages_.size() + 256);
+  }
+  pages_[page * 256 + (charcode & 0xff)] = cid;
+}
+
 uint16_t CIDFromCharCode(const CMap* cmap, uint32_t charcode) {
   CHECK(cmap);
   if (charcode >> 16) {
@@ -9,6 +9,9 @@
 
 #include <stdint.h>
 
+#include <array>
+
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/unowned_ptr_exclusion.h"
 
 namespace fxcmap {
@@ -32,6 +35,29 @@ struct CMap {
   int8_t use_offset_;
 };
 
+// Direct-indexed table of the 2-byte character code mappings in a CMap and
+// the CMaps it uses, for lookups without searching. Codes are split into a
+// page index for the high byte and 256-entry pages for the low byte. Pages
+// only get allocated for high bytes with mappings.
+class CIDTable {
+ public:
+  explicit CIDTable(const CMap* cmap);
+  ~CIDTable();
+
+  // Same as CIDFromCharCode() below, for `charcode` up to 0xffff.
+  uint16_t CIDFromCharCode(uint16_t charcode) const {
+    const size_t page = page_index_[charcode >> 8];
+    return pages_[page * 256 + (charcode & 0xff)];
+  }
+
+ private:
+  void SetCID(uint16_t charcode, uint16_t cid);
+
+  // Page 0 is all zeros, and used for all high bytes without mappings.
+  std::array<uint16_t, 256> page_index_ = {};
+  DataVector<uint16_t> pages_;
+};
+
 uint16_t CIDFromCharCode(const CMap* cmap, uint32_t charcode);
 uint32_t CharCodeFromCID(const CMap* cmap, uint16_t cid);
 
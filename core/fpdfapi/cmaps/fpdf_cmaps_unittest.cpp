@@ -0,0 +1,54 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/cmaps/fpdf_cmaps.h"
+
+#include <stdint.h>
+
+#include "core/fpdfapi/cmaps/CNS1/cmaps_cns1.h"
+#include "core/fpdfapi/cmaps/GB1/cmaps_gb1.h"
+#include "core/fpdfapi/cmaps/Japan1/cmaps_japan1.h"
+#include "core/fpdfapi/cmaps/Korea1/cmaps_korea1.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace fxcmap {
+
+namespace {
+
+void CheckCIDTables(pdfium::span<const CMap> cmaps) {
+  for (const CMap& cmap : cmaps) {
+    SCOPED_TRACE(cmap.name_);
+    const CIDTable table(&cmap);
+    for (uint32_t code = 0; code <= 0xffff; ++code) {
+      ASSERT_EQ(CIDFromCharCode(&cmap, code),
+                table.CIDFromCharCode(static_cast<uint16_t>(code)))
+          << "code " << code;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FPDFCMapsTest, CIDTableMatchesCIDFromCharCode) {
+  CheckCIDTables(kCNS1_cmaps);
+  CheckCIDTables(kGB1_cmaps);
+  CheckCIDTables(kJapan1_cmaps);
+  CheckCIDTables(kKorea1_cmaps);
+}
+
+TEST(FPDFCMapsTest, CIDFromCharCode) {
+  // GB-EUC-V uses GB-EUC-H for most codes.
+  const CMap* gb_euc_v = &kGB1_cmaps[1];
+  ASSERT_STREQ("GB-EUC-V", gb_euc_v->name_);
+  const CIDTable table(gb_euc_v);
+  EXPECT_EQ(0u, table.CIDFromCharCode(0x0000));
+  EXPECT_EQ(CIDFromCharCode(&kGB1_cmaps[0], 0xb0a1),
+            table.CIDFromCharCode(0xb0a1));
+  EXPECT_NE(0u, table.CIDFromCharCode(0xb0a1));
+  EXPECT_NE(CIDFromCharCode(&kGB1_cmaps[0], 0xa1a2),
+            table.CIDFromCharCode(0xa1a2));
+}
+
+}  // namespace fxcmap
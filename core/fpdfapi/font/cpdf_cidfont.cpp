@@ -158,14 +158,14 @@ bool IsValidEmbeddedCharcodeFromUnicodeCharset(CIDSet charset) {
   }
 }
 
-wchar_t EmbeddedUnicodeFromCharcode(const fxcmap::CMap* pEmbedMap,
+wchar_t EmbeddedUnicodeFromCharcode(const CPDF_CMap* cmap,
                                     CIDSet charset,
                                     uint32_t charcode) {
   if (!IsValidEmbeddedCharcodeFromUnicodeCharset(charset)) {
     return 0;
   }
 
-  uint16_t cid = fxcmap::CIDFromCharCode(pEmbedMap, charcode);
+  uint16_t cid = cmap->CIDFromCharCode(charcode);
   if (!cid) {
     return 0;
   }
@@ -313,13 +313,17 @@ bool CPDF_CIDFont::IsVertWriting() const {
   return cmap_ && cmap_->IsVertWriting();
 }
 
-WideString CPDF_CIDFont::UnicodeFromCharCode(uint32_t charcode) const {
-  WideString str = CPDF_Font::UnicodeFromCharCode(charcode);
-  if (!str.IsEmpty()) {
-    return str;
+void CPDF_CIDFont::AppendUnicodeFromCharCode(uint32_t charcode,
+                                             WideString* str) const {
+  const size_t old_length = str->GetLength();
+  CPDF_Font::AppendUnicodeFromCharCode(charcode, str);
+  if (str->GetLength() != old_length) {
+    return;
   }
   wchar_t ret = GetUnicodeFromCharCode(charcode);
-  return ret ? WideString(ret) : WideString();
+  if (ret) {
+    *str += ret;
+  }
 }
 
 wchar_t CPDF_CIDFont::GetUnicodeFromCharCode(uint32_t charcode) const {
@@ -359,7 +363,7 @@ wchar_t CPDF_CIDFont::GetUnicodeFromCharCode(uint32_t charcode) const {
   if (!cmap_->GetEmbedMap()) {
     return 0;
   }
-  return EmbeddedUnicodeFromCharcode(cmap_->GetEmbedMap(), cmap_->GetCharset(),
+  return EmbeddedUnicodeFromCharcode(cmap_.Get(), cmap_->GetCharset(),
                                      charcode);
 #endif
 }
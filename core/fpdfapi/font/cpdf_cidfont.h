@@ -64,7 +64,8 @@ class CPDF_CIDFont final : public CPDF_Font {
   bool IsVertWriting() const override;
   bool IsUnicodeCompatible() const override;
   bool Load() override;
-  WideString UnicodeFromCharCode(uint32_t charcode) const override;
+  void AppendUnicodeFromCharCode(uint32_t charcode,
+                                 WideString* str) const override;
   uint32_t CharCodeFromUnicode(wchar_t Unicode) const override;
 
   uint16_t CIDFromCharCode(uint32_t charcode) const;
@@ -8,6 +8,7 @@
 
 #include <array>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -282,6 +283,7 @@ CPDF_CMap::CPDF_CMap(ByteStringView bsPredefinedName)
     return;
   }
 
+  embed_cid_table_ = std::make_unique<fxcmap::CIDTable>(embed_map_);
   loaded_ = true;
 }
 
@@ -306,6 +308,10 @@ uint16_t CPDF_CMap::CIDFromCharCode(uint32_t charcode) const {
     return static_cast<uint16_t>(charcode);
   }
   if (embed_map_) {
+    if (charcode <= 0xffff) {
+      return embed_cid_table_->CIDFromCharCode(
+          static_cast<uint16_t>(charcode));
+    }
     return fxcmap::CIDFromCharCode(embed_map_, charcode);
   }
   if (direct_charcode_to_cidtable_.empty()) {
@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <array>
+#include <memory>
 #include <vector>
 
 #include "core/fpdfapi/font/cpdf_cidfont.h"
@@ -19,6 +20,7 @@
 #include "core/fxcrt/unowned_ptr.h"
 
 namespace fxcmap {
+class CIDTable;
 struct CMap;
 }
 
@@ -100,6 +102,8 @@ class CPDF_CMap final : public Retainable {
   FixedSizeDataVector<uint16_t> direct_charcode_to_cidtable_;
   std::vector<CIDRange> additional_charcode_to_cidmappings_;
   UnownedPtr<const fxcmap::CMap> embed_map_;
+  // Lookup table for the 2-byte codes in `embed_map_`.
+  std::unique_ptr<const fxcmap::CIDTable> embed_cid_table_;
 };
 
 #endif  // CORE_FPDFAPI_FONT_CPDF_CMAP_H_
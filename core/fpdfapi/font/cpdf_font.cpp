@@ -131,12 +131,21 @@ void CPDF_Font::AppendChar(ByteString* str, uint32_t charcode) const {
   *str += static_cast<char>(charcode);
 }
 
-WideString CPDF_Font::UnicodeFromCharCode(uint32_t charcode) const {
+void CPDF_Font::AppendUnicodeFromCharCode(uint32_t charcode,
+                                          WideString* str) const {
   if (!to_unicode_loaded_) {
     LoadUnicodeMap();
   }
 
-  return to_unicode_map_ ? to_unicode_map_->Lookup(charcode) : WideString();
+  if (to_unicode_map_) {
+    to_unicode_map_->AppendLookup(charcode, str);
+  }
+}
+
+WideString CPDF_Font::UnicodeFromCharCode(uint32_t charcode) const {
+  WideString result;
+  AppendUnicodeFromCharCode(charcode, &result);
+  return result;
 }
 
 uint32_t CPDF_Font::CharCodeFromUnicode(wchar_t unicode) const {
@@ -91,10 +91,16 @@ class CPDF_Font : public Retainable, public Observable {
 #if BUILDFLAG(IS_APPLE)
   virtual int GlyphFromCharCodeExt(uint32_t charcode);
 #endif
-  virtual WideString UnicodeFromCharCode(uint32_t charcode) const;
+  // Appends the Unicode string for `charcode` to `str`, if there is one.
+  // Text extraction calls this for every character, so implementations
+  // must not allocate, unless `str` needs to grow.
+  virtual void AppendUnicodeFromCharCode(uint32_t charcode,
+                                         WideString* str) const;
   virtual uint32_t CharCodeFromUnicode(wchar_t Unicode) const;
   virtual bool HasFontWidths() const;
 
+  WideString UnicodeFromCharCode(uint32_t charcode) const;
+
   ByteString GetBaseFontName() const { return base_font_name_; }
   std::optional<FX_Charset> GetSubstFontCharset() const;
   bool IsEmbedded() const { return IsType3Font() || font_file_ != nullptr; }
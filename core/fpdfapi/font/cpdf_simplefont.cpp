@@ -320,16 +320,17 @@ bool CPDF_SimpleFont::IsUnicodeCompatible() const {
          base_encoding_ != FontEncoding::kZapfDingbats;
 }
 
-WideString CPDF_SimpleFont::UnicodeFromCharCode(uint32_t charcode) const {
-  WideString unicode = CPDF_Font::UnicodeFromCharCode(charcode);
-  if (!unicode.IsEmpty()) {
-    return unicode;
+void CPDF_SimpleFont::AppendUnicodeFromCharCode(uint32_t charcode,
+                                                WideString* str) const {
+  const size_t old_length = str->GetLength();
+  CPDF_Font::AppendUnicodeFromCharCode(charcode, str);
+  if (str->GetLength() != old_length) {
+    return;
   }
   wchar_t ret = encoding_.UnicodeFromCharCode((uint8_t)charcode);
-  if (ret == 0) {
-    return WideString();
+  if (ret) {
+    *str += ret;
   }
-  return WideString(ret);
 }
 
 uint32_t CPDF_SimpleFont::CharCodeFromUnicode(wchar_t unicode) const {
@@ -25,7 +25,8 @@ class CPDF_SimpleFont : public CPDF_Font {
   FX_RECT GetCharBBox(uint32_t charcode) override;
   int GlyphFromCharCode(uint32_t charcode, bool* pVertGlyph) override;
   bool IsUnicodeCompatible() const override;
-  WideString UnicodeFromCharCode(uint32_t charcode) const override;
+  void AppendUnicodeFromCharCode(uint32_t charcode,
+                                 WideString* str) const override;
   uint32_t CharCodeFromUnicode(wchar_t Unicode) const override;
 
   const CPDF_FontEncoding* GetEncoding() const { return &encoding_; }
@@ -6,7 +6,9 @@
 
 #include "core/fpdfapi/font/cpdf_tounicodemap.h"
 
-#include <set>
+#include <algorithm>
+#include <functional>
+#include <optional>
 #include <utility>
 #include <variant>
 
@@ -15,9 +17,10 @@
 #include "core/fpdfapi/parser/cpdf_simple_parser.h"
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
-#include "core/fxcrt/containers/contains.h"
+#include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
 
 namespace {
 
@@ -56,38 +59,57 @@ CPDF_ToUnicodeMap::CPDF_ToUnicodeMap(RetainPtr<const CPDF_Stream> pStream) {
 CPDF_ToUnicodeMap::~CPDF_ToUnicodeMap() = default;
 
 WideString CPDF_ToUnicodeMap::Lookup(uint32_t charcode) const {
-  auto it = multimap_.find(charcode);
-  if (it == multimap_.end()) {
-    if (!base_map_) {
-      return WideString();
+  WideString result;
+  AppendLookup(charcode, &result);
+  return result;
+}
+
+void CPDF_ToUnicodeMap::AppendLookup(uint32_t charcode,
+                                     WideString* str) const {
+  pdfium::span<const uint32_t> values = GetValues(charcode);
+  if (values.empty()) {
+    if (base_map_) {
+      *str += base_map_->UnicodeFromCID(static_cast<uint16_t>(charcode));
     }
-    return WideString(
-        base_map_->UnicodeFromCID(static_cast<uint16_t>(charcode)));
+    return;
   }
 
-  uint32_t value = *it->second.begin();
-  wchar_t unicode = static_cast<wchar_t>(value & 0xffff);
-  if (unicode != 0xffff) {
-    return WideString(unicode);
+  const uint32_t value = values.front();
+  std::optional<WideStringView> multi_char = GetMultiCharString(value);
+  if (!multi_char.has_value()) {
+    *str += static_cast<wchar_t>(value & 0xffff);
+    return;
   }
-
-  size_t index = value >> 16;
-  return index < multi_char_vec_.size() ? multi_char_vec_[index] : WideString();
+  *str += multi_char.value();
 }
 
 uint32_t CPDF_ToUnicodeMap::ReverseLookup(wchar_t unicode) const {
-  for (const auto& pair : multimap_) {
-    if (pdfium::Contains(pair.second, static_cast<uint32_t>(unicode))) {
-      return pair.first;
+  if (!reverse_index_built_) {
+    reverse_index_built_ = true;
+    for (uint32_t code = 0; code + 1 < offsets_.size(); ++code) {
+      for (uint32_t value : GetValues(code)) {
+        reverse_index_.emplace_back(value, code);
+      }
     }
+    // Codes are visited in ascending order, so a stable sort keeps the
+    // smallest code first for each value.
+    std::ranges::stable_sort(reverse_index_, std::less<>{},
+                             &std::pair<uint32_t, uint32_t>::first);
+    auto duplicates =
+        std::ranges::unique(reverse_index_, std::equal_to<>{},
+                            &std::pair<uint32_t, uint32_t>::first);
+    reverse_index_.erase(duplicates.begin(), duplicates.end());
   }
-  return 0;
+
+  const uint32_t value = static_cast<uint32_t>(unicode);
+  auto it = std::ranges::lower_bound(reverse_index_, value, std::less<>{},
+                                     &std::pair<uint32_t, uint32_t>::first);
+  return it != reverse_index_.end() && it->first == value ? it->second : 0;
 }
 
 size_t CPDF_ToUnicodeMap::GetUnicodeCountByCharcodeForTesting(
     uint32_t charcode) const {
-  auto it = multimap_.find(charcode);
-  return it != multimap_.end() ? it->second.size() : 0u;
+  return GetValues(charcode).size();
 }
 
 // static
@@ -176,6 +198,7 @@ void CPDF_ToUnicodeMap::Load(RetainPtr<const CPDF_Stream> pStream) {
   if (cid_set != CIDSET_UNKNOWN) {
     base_map_ = CPDF_FontGlobals::GetInstance()->GetCID2UnicodeMap(cid_set);
   }
+  BuildMultimap();
 }
 
 ByteStringView CPDF_ToUnicodeMap::HandleBeginBFChar(
@@ -353,7 +376,7 @@ ByteStringView CPDF_ToUnicodeMap::HandleBeginBFRange(
         uint32_t code = range.low_code;
         for (const auto& retcode : range.retcodes) {
           InsertIntoMultimap(code, GetMultiCharIndexIndicator());
-          multi_char_vec_.push_back(retcode);
+          AddMultiCharString(retcode);
           ++code;
         }
       }
@@ -363,7 +386,7 @@ ByteStringView CPDF_ToUnicodeMap::HandleBeginBFRange(
 }
 
 uint32_t CPDF_ToUnicodeMap::GetMultiCharIndexIndicator() const {
-  FX_SAFE_UINT32 uni = multi_char_vec_.size();
+  FX_SAFE_UINT32 uni = multi_char_ranges_.size();
   uni = uni * 0x10000 + 0xffff;
   return uni.ValueOrDefault(0);
 }
@@ -378,16 +401,66 @@ void CPDF_ToUnicodeMap::SetCode(uint32_t srccode, WideString destcode) {
     InsertIntoMultimap(srccode, destcode[0]);
   } else {
     InsertIntoMultimap(srccode, GetMultiCharIndexIndicator());
-    multi_char_vec_.push_back(destcode);
+    AddMultiCharString(destcode);
   }
 }
 
+void CPDF_ToUnicodeMap::AddMultiCharString(const WideString& str) {
+  multi_char_ranges_.emplace_back(
+      pdfium::checked_cast<uint32_t>(multi_char_pool_.size()),
+      pdfium::checked_cast<uint32_t>(str.GetLength()));
+  multi_char_pool_.insert(multi_char_pool_.end(), str.begin(), str.end());
+}
+
 void CPDF_ToUnicodeMap::InsertIntoMultimap(uint32_t code, uint32_t destcode) {
-  auto it = multimap_.find(code);
-  if (it == multimap_.end()) {
-    multimap_.emplace(code, std::set<uint32_t>{destcode});
+  pending_entries_.emplace_back(code, destcode);
+}
+
+void CPDF_ToUnicodeMap::BuildMultimap() {
+  if (pending_entries_.empty()) {
     return;
   }
 
-  it->second.emplace(destcode);
+  std::ranges::sort(pending_entries_);
+  auto duplicates = std::ranges::unique(pending_entries_);
+  pending_entries_.erase(duplicates.begin(), duplicates.end());
+
+  // Codes are at most `kCidLimit`, see HandleBeginBFChar() and
+  // HandleBeginBFRange().
+  const uint32_t max_code = pending_entries_.back().first;
+  CHECK_LE(max_code, kCidLimit);
+  offsets_ = DataVector<uint32_t>(max_code + 2);
+  values_.reserve(pending_entries_.size());
+  for (const auto& [code, value] : pending_entries_) {
+    ++offsets_[code + 1];
+    values_.push_back(value);
+  }
+  for (size_t i = 1; i < offsets_.size(); ++i) {
+    offsets_[i] += offsets_[i - 1];
+  }
+  pending_entries_.clear();
+  pending_entries_.shrink_to_fit();
+}
+
+pdfium::span<const uint32_t> CPDF_ToUnicodeMap::GetValues(
+    uint32_t code) const {
+  if (offsets_.empty() || code >= offsets_.size() - 1) {
+    return {};
+  }
+  return pdfium::span(values_).subspan(offsets_[code],
+                                       offsets_[code + 1] - offsets_[code]);
+}
+
+std::optional<WideStringView> CPDF_ToUnicodeMap::GetMultiCharString(
+    uint32_t value) const {
+  if ((value & 0xffff) != 0xffff) {
+    return std::nullopt;
+  }
+
+  const size_t index = value >> 16;
+  if (index >= multi_char_ranges_.size()) {
+    return WideStringView();
+  }
+  const auto& [offset, length] = multi_char_ranges_[index];
+  return WideStringView(pdfium::span(multi_char_pool_).subspan(offset, length));
 }
@@ -7,13 +7,17 @@
 #ifndef CORE_FPDFAPI_FONT_CPDF_TOUNICODEMAP_H_
 #define CORE_FPDFAPI_FONT_CPDF_TOUNICODEMAP_H_
 
-#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
 #include <optional>
-#include <set>
+#include <utility>
 #include <vector>
 
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_string.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 
 class CPDF_CID2UnicodeMap;
@@ -26,6 +30,11 @@ class CPDF_ToUnicodeMap {
   ~CPDF_ToUnicodeMap();
 
   WideString Lookup(uint32_t charcode) const;
+
+  // Same as Lookup(), but appends the result to `str` instead. Does not
+  // allocate, unless `str` needs to grow.
+  void AppendLookup(uint32_t charcode, WideString* str) const;
+
   uint32_t ReverseLookup(wchar_t unicode) const;
 
   size_t GetUnicodeCountByCharcodeForTesting(uint32_t charcode) const;
@@ -48,14 +57,42 @@ class CPDF_ToUnicodeMap {
 
   uint32_t GetMultiCharIndexIndicator() const;
   void SetCode(uint32_t srccode, WideString destcode);
+  void AddMultiCharString(const WideString& str);
 
-  // Inserts a new entry which hasn't not been inserted into `multimap_`
-  // before.
+  // Adds `destcode` to the values for `code`. BuildMultimap() drops
+  // duplicates.
   void InsertIntoMultimap(uint32_t code, uint32_t destcode);
 
-  std::map<uint32_t, std::set<uint32_t>> multimap_;
+  // Moves the entries collected while loading into `offsets_` and `values_`.
+  void BuildMultimap();
+
+  // Returns the values for `code` in ascending order.
+  pdfium::span<const uint32_t> GetValues(uint32_t code) const;
+
+  // Returns the string for `value` from GetValues(), if it maps to multiple
+  // characters. Otherwise, the value itself is the character.
+  std::optional<WideStringView> GetMultiCharString(uint32_t value) const;
+
+  // Entries collected while loading. Empty afterwards.
+  std::vector<std::pair<uint32_t, uint32_t>> pending_entries_;
+
+  // The values for `code` are at [offsets_[code], offsets_[code + 1]) in
+  // `values_`. Codes are at most 0xffff, so this stays reasonably small.
+  DataVector<uint32_t> offsets_;
+  DataVector<uint32_t> values_;
+
+  // (value, code) pairs sorted by value, with only the smallest code for each
+  // value. Built on the first ReverseLookup().
+  mutable std::vector<std::pair<uint32_t, uint32_t>> reverse_index_;
+  mutable bool reverse_index_built_ = false;
+
   UnownedPtr<const CPDF_CID2UnicodeMap> base_map_;
-  std::vector<WideString> multi_char_vec_;
+
+  // Pool of the strings for values that map to multiple characters. Entry
+  // `i` of `multi_char_ranges_` is the (offset, length) in `multi_char_pool_`
+  // of the string with index `i`.
+  std::vector<std::pair<uint32_t, uint32_t>> multi_char_ranges_;
+  DataVector<wchar_t> multi_char_pool_;
 };
 
 #endif  // CORE_FPDFAPI_FONT_CPDF_TOUNICODEMAP_H_
@@ -341,8 +341,8 @@ TEST(CPDFToUnicodeMapTest, InsertIntoMultimap) {
     EXPECT_EQ(2u, map.GetUnicodeCountByCharcodeForTesting(0u));
   }
   {
-    // Duplicate mappings of CID 0 to unicode "A". There should be only 1 entry
-    // in `multimap_`.
+    // Duplicate mappings of CID 0 to unicode "A". There should be only 1 value
+    // for CID 0.
     static constexpr uint8_t kInput3[] =
         "1 beginbfrange<0><0>[<0041>]endbfrange\n"
         "1 beginbfchar<0><0041>endbfchar";
@@ -363,3 +363,47 @@ TEST(CPDFToUnicodeMapTest, NonBmpUnicodeLookup) {
   EXPECT_EQ(0u, map.ReverseLookup(0x20676));
 #endif
 }
+
+TEST(CPDFToUnicodeMapTest, LookupMixedEntries) {
+  static constexpr uint8_t kInput[] =
+      "3 beginbfchar<01><0041><02><00660069><03><0042>endbfchar\n"
+      "1 beginbfrange<10><12><0061>endbfrange\n"
+      "1 beginbfchar<20><0041>endbfchar";
+  CPDF_ToUnicodeMap map(pdfium::MakeRetain<CPDF_Stream>(kInput));
+  EXPECT_EQ(L"A", map.Lookup(0x01));
+  EXPECT_EQ(L"fi", map.Lookup(0x02));
+  EXPECT_EQ(L"B", map.Lookup(0x03));
+  EXPECT_EQ(L"a", map.Lookup(0x10));
+  EXPECT_EQ(L"c", map.Lookup(0x12));
+  EXPECT_EQ(L"", map.Lookup(0x13));
+  EXPECT_EQ(L"", map.Lookup(0x10000000));
+
+  // The smallest code wins.
+  EXPECT_EQ(1u, map.ReverseLookup(L'A'));
+  EXPECT_EQ(0x11u, map.ReverseLookup(L'b'));
+  EXPECT_EQ(0u, map.ReverseLookup(L'Z'));
+}
+
+TEST(CPDFToUnicodeMapTest, AppendLookup) {
+  static constexpr uint8_t kInput[] =
+      "2 beginbfchar<01><0041><02><00660069>endbfchar\n"
+      "1 beginbfrange<10><12><0061>endbfrange";
+  CPDF_ToUnicodeMap map(pdfium::MakeRetain<CPDF_Stream>(kInput));
+
+  WideString str(L"x");
+  map.AppendLookup(0x01, &str);
+  map.AppendLookup(0x02, &str);
+  map.AppendLookup(0x13, &str);
+  map.AppendLookup(0x11, &str);
+  EXPECT_EQ(L"xAfib", str);
+
+  // A cleared buffer gets reused.
+  str.clear();
+  const wchar_t* const buffer = str.c_str();
+  for (uint32_t code : {0x01u, 0x02u, 0x10u, 0x13u}) {
+    str.clear();
+    map.AppendLookup(code, &str);
+    EXPECT_EQ(map.Lookup(code), str);
+    EXPECT_EQ(buffer, str.c_str());
+  }
+}
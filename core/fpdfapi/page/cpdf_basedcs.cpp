@@ -6,13 +6,119 @@
 
 #include "core/fpdfapi/page/cpdf_basedcs.h"
 
+#include <array>
+
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/stl_util.h"
+
+namespace {
+
+// Bounds the memory used by TranslateImageLineMemoized(). Colors beyond this
+// are still converted correctly, just not remembered.
+constexpr size_t kMaxMemoizedColors = 64 * 1024;
+
+constexpr size_t kMaxMemoizedComponents = 4;
+
+uint32_t ToBGRByte(float value) {
+  // Matches the truncation done by CPDF_ColorSpace::TranslateImageLine().
+  return static_cast<uint8_t>(static_cast<int32_t>(value * 255));
+}
+
+}  // namespace
+
 CPDF_BasedCS::CPDF_BasedCS(Family family) : CPDF_ColorSpace(family) {}
 
 CPDF_BasedCS::~CPDF_BasedCS() = default;
 
 void CPDF_BasedCS::EnableStdConversion(bool bEnabled) {
+  const bool was_enabled = IsStdConversionEnabled();
   CPDF_ColorSpace::EnableStdConversion(bEnabled);
   if (base_cs_) {
     base_cs_->EnableStdConversion(bEnabled);
   }
+  if (IsStdConversionEnabled() != was_enabled) {
+    sample_table_.clear();
+    memoized_colors_.clear();
+  }
+}
+
+void CPDF_BasedCS::TranslateImageLineWithTable(
+    pdfium::span<uint8_t> dest_span,
+    pdfium::span<const uint8_t> src_span,
+    int pixels,
+    int divisor) const {
+  CHECK_EQ(ComponentCount(), 1u);
+  if (sample_table_.empty()) {
+    sample_table_.resize(256 * 3);
+    for (int i = 0; i < 256; ++i) {
+      const float comp = static_cast<float>(i) / divisor;
+      const uint32_t bgr = ConvertToPackedBGR(pdfium::span_from_ref(comp));
+      sample_table_[i * 3] = bgr & 0xff;
+      sample_table_[i * 3 + 1] = (bgr >> 8) & 0xff;
+      sample_table_[i * 3 + 2] = (bgr >> 16) & 0xff;
+    }
+  }
+
+  const size_t count = static_cast<size_t>(pixels);
+  pdfium::span<const uint8_t> src = src_span.first(count);
+  pdfium::span<uint8_t> dest = dest_span.first(count * 3);
+  for (size_t i = 0; i < count; ++i) {
+    fxcrt::Copy(pdfium::span(sample_table_).subspan(src[i] * 3u, 3u),
+                dest.subspan(i * 3, 3u));
+  }
+}
+
+void CPDF_BasedCS::TranslateImageLineMemoized(
+    pdfium::span<uint8_t> dest_span,
+    pdfium::span<const uint8_t> src_span,
+    int pixels) const {
+  const uint32_t components = ComponentCount();
+  CHECK_LE(components, kMaxMemoizedComponents);
+
+  const size_t count = static_cast<size_t>(pixels);
+  pdfium::span<const uint8_t> src = src_span.first(count * components);
+  pdfium::span<uint8_t> dest = dest_span.first(count * 3);
+  std::array<float, kMaxMemoizedComponents> comps = {};
+  // Scanned images tend to repeat the previous color, so check that first.
+  bool has_last = false;
+  uint32_t last_key = 0;
+  uint32_t last_bgr = 0;
+  for (size_t i = 0; i < count; ++i) {
+    pdfium::span<const uint8_t> pixel = src.subspan(i * components, components);
+    uint32_t key = 0;
+    for (uint8_t sample : pixel) {
+      key = (key << 8) | sample;
+    }
+
+    uint32_t bgr;
+    if (has_last && key == last_key) {
+      bgr = last_bgr;
+    } else {
+      auto it = memoized_colors_.find(key);
+      if (it != memoized_colors_.end()) {
+        bgr = it->second;
+      } else {
+        for (uint32_t j = 0; j < components; ++j) {
+          comps[j] = static_cast<float>(pixel[j]) / 255;
+        }
+        bgr = ConvertToPackedBGR(pdfium::span(comps).first(components));
+        if (memoized_colors_.size() < kMaxMemoizedColors) {
+          memoized_colors_[key] = bgr;
+        }
+      }
+      has_last = true;
+      last_key = key;
+      last_bgr = bgr;
+    }
+    dest[i * 3] = bgr & 0xff;
+    dest[i * 3 + 1] = (bgr >> 8) & 0xff;
+    dest[i * 3 + 2] = (bgr >> 16) & 0xff;
+  }
+}
+
+uint32_t CPDF_BasedCS::ConvertToPackedBGR(
+    pdfium::span<const float> comps) const {
+  auto rgb = GetRGBOrZerosOnError(comps);
+  return ToBGRByte(rgb.blue) | (ToBGRByte(rgb.green) << 8) |
+         (ToBGRByte(rgb.red) << 16);
 }
@@ -7,8 +7,14 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_BASEDCS_H_
 #define CORE_FPDFAPI_PAGE_CPDF_BASEDCS_H_
 
+#include <stdint.h>
+
+#include <map>
+
 #include "core/fpdfapi/page/cpdf_colorspace.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 
 // Represents a color space that is based on another color space. This includes
 // all the special color spaces in ISO 32000-1:2008, table 62, as well as the
@@ -23,7 +29,33 @@ class CPDF_BasedCS : public CPDF_ColorSpace {
  protected:
   explicit CPDF_BasedCS(Family family);
 
+  // Same result as CPDF_ColorSpace::TranslateImageLine() for a single
+  // component colorspace, but converts each of the 256 possible samples only
+  // once and then looks them up. Samples are divided by `divisor` to get the
+  // component value.
+  void TranslateImageLineWithTable(pdfium::span<uint8_t> dest_span,
+                                   pdfium::span<const uint8_t> src_span,
+                                   int pixels,
+                                   int divisor) const;
+
+  // Same result as CPDF_ColorSpace::TranslateImageLine(), but remembers the
+  // conversion of each distinct color, so it is only computed once. Only
+  // useful for colorspaces with expensive conversions and at most 4
+  // components.
+  void TranslateImageLineMemoized(pdfium::span<uint8_t> dest_span,
+                                  pdfium::span<const uint8_t> src_span,
+                                  int pixels) const;
+
   RetainPtr<CPDF_ColorSpace> base_cs_;  // May be fallback CS in some cases.
+
+ private:
+  // Computes the BGR bytes TranslateImageLine() writes for `comps`.
+  uint32_t ConvertToPackedBGR(pdfium::span<const float> comps) const;
+
+  // Both caches depend on the standard conversion setting, so they are
+  // cleared whenever it changes.
+  mutable DataVector<uint8_t> sample_table_;
+  mutable std::map<uint32_t, uint32_t> memoized_colors_;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_BASEDCS_H_
@@ -262,6 +262,12 @@ class CPDF_SeparationCS final : public CPDF_BasedCS {
                        float* value,
                        float* min,
                        float* max) const override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
   uint32_t v_Load(CPDF_Document* doc,
                   const CPDF_Array* pArray,
                   std::set<const CPDF_Object*>* pVisited) override;
@@ -285,6 +291,12 @@ class CPDF_DeviceNCS final : public CPDF_BasedCS {
                        float* value,
                        float* min,
                        float* max) const override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
   uint32_t v_Load(CPDF_Document* doc,
                   const CPDF_Array* pArray,
                   std::set<const CPDF_Object*>* pVisited) override;
@@ -1210,6 +1222,21 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_SeparationCS::GetRGB(
   return std::nullopt;
 }
 
+void CPDF_SeparationCS::TranslateImageLine(
+    pdfium::span<uint8_t> dest_span,
+    pdfium::span<const uint8_t> src_span,
+    int pixels,
+    int image_width,
+    int image_height,
+    bool bTransMask) const {
+  // Only applies to CMYK colorspaces.
+  CHECK(!bTransMask);
+
+  // The tint transform can be arbitrarily expensive, so evaluate it once per
+  // possible sample value instead of once per pixel.
+  TranslateImageLineWithTable(dest_span, src_span, pixels, /*divisor=*/255);
+}
+
 CPDF_DeviceNCS::CPDF_DeviceNCS() : CPDF_BasedCS(Family::kDeviceN) {}
 
 CPDF_DeviceNCS::~CPDF_DeviceNCS() = default;
@@ -1268,3 +1295,22 @@ std::optional<FX_RGB_STRUCT<float>> CPDF_DeviceNCS::GetRGB(
   }
   return base_cs_->GetRGB(results);
 }
+
+void CPDF_DeviceNCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                                        pdfium::span<const uint8_t> src_span,
+                                        int pixels,
+                                        int image_width,
+                                        int image_height,
+                                        bool bTransMask) const {
+  // Only applies to CMYK colorspaces.
+  CHECK(!bTransMask);
+
+  // Images typically use far fewer colors than pixels, so only evaluate the
+  // tint transform once per distinct color.
+  if (ComponentCount() <= 4) {
+    TranslateImageLineMemoized(dest_span, src_span, pixels);
+    return;
+  }
+  CPDF_ColorSpace::TranslateImageLine(dest_span, src_span, pixels,
+                                      image_width, image_height, bTransMask);
+}
@@ -8,12 +8,57 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <set>
+#include <vector>
 
+#include "core/fpdfapi/page/cpdf_pagemodule.h"
+#include "core/fpdfapi/parser/cpdf_array.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_indirect_object_holder.h"
+#include "core/fpdfapi/parser/cpdf_name.h"
+#include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_reference.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+namespace {
+
+// Converts `src` one pixel at a time, the way the generic
+// CPDF_ColorSpace::TranslateImageLine() does.
+std::vector<uint8_t> TranslatePerPixel(const CPDF_ColorSpace* cs,
+                                       pdfium::span<const uint8_t> src) {
+  const size_t components = cs->ComponentCount();
+  std::vector<uint8_t> result;
+  std::vector<float> comps(components);
+  for (size_t i = 0; i < src.size(); i += components) {
+    for (size_t j = 0; j < components; ++j) {
+      comps[j] = static_cast<float>(src[i + j]) / 255;
+    }
+    auto rgb = cs->GetRGBOrZerosOnError(comps);
+    result.push_back(static_cast<int32_t>(rgb.blue * 255));
+    result.push_back(static_cast<int32_t>(rgb.green * 255));
+    result.push_back(static_cast<int32_t>(rgb.red * 255));
+  }
+  return result;
+}
+
+RetainPtr<CPDF_Array> CreateNumberArray(std::initializer_list<float> values) {
+  auto array = pdfium::MakeRetain<CPDF_Array>();
+  for (float value : values) {
+    array->AppendNew<CPDF_Number>(value);
+  }
+  return array;
+}
+
+}  // namespace
 
 TEST(CPDFCalGrayTest, TranslateImageLine) {
   RetainPtr<CPDF_ColorSpace> pCal = CPDF_ColorSpace::AllocateColorSpace("CalG");
@@ -38,3 +83,80 @@ TEST(CPDFCalRGBTest, TranslateImageLine) {
   pCal->TranslateImageLine(dst, kSrc, 4, 4, 1, /*bTransMask=*/false);
   EXPECT_THAT(dst, ElementsAre(0, 0, 255, 0, 255, 0, 255, 0, 0, 128, 128, 128));
 }
+
+TEST(CPDFSeparationCSTest, TranslateImageLine) {
+  pdfium::InitializePageModule();
+  {
+    // Tints from white to (0, 0.5, 1).
+    auto func = pdfium::MakeRetain<CPDF_Dictionary>();
+    func->SetNewFor<CPDF_Number>("FunctionType", 2);
+    func->SetFor("Domain", CreateNumberArray({0, 1}));
+    func->SetFor("C0", CreateNumberArray({1, 1, 1}));
+    func->SetFor("C1", CreateNumberArray({0, 0.5f, 1}));
+    func->SetNewFor<CPDF_Number>("N", 1);
+
+    auto array = pdfium::MakeRetain<CPDF_Array>();
+    array->AppendNew<CPDF_Name>("Separation");
+    array->AppendNew<CPDF_Name>("Spot");
+    array->AppendNew<CPDF_Name>("DeviceRGB");
+    array->Append(func);
+    std::set<const CPDF_Object*> visited;
+    RetainPtr<CPDF_ColorSpace> cs =
+        CPDF_ColorSpace::Load(nullptr, array.Get(), &visited);
+    ASSERT_TRUE(cs);
+    ASSERT_EQ(1u, cs->ComponentCount());
+
+    const uint8_t kSrc[] = {0, 255, 128, 128, 64, 0, 1};
+    uint8_t dst[std::size(kSrc) * 3];
+    std::ranges::fill(dst, 0xbd);
+    cs->TranslateImageLine(dst, kSrc, std::size(kSrc), std::size(kSrc), 1,
+                           /*bTransMask=*/false);
+    EXPECT_THAT(dst, ElementsAreArray(TranslatePerPixel(cs.Get(), kSrc)));
+    EXPECT_THAT(pdfium::span(dst).first(6u),
+                ElementsAre(255, 255, 255, 255, 127, 0));
+  }
+  pdfium::DestroyPageModule();
+}
+
+TEST(CPDFDeviceNCSTest, TranslateImageLine) {
+  pdfium::InitializePageModule();
+  {
+    // Maps (a, b) to RGB (a, b, 0).
+    static constexpr char kProgram[] = "{ 0 }";
+    auto func_dict = pdfium::MakeRetain<CPDF_Dictionary>();
+    func_dict->SetNewFor<CPDF_Number>("FunctionType", 4);
+    func_dict->SetFor("Domain", CreateNumberArray({0, 1, 0, 1}));
+    func_dict->SetFor("Range", CreateNumberArray({0, 1, 0, 1, 0, 1}));
+    CPDF_IndirectObjectHolder holder;
+    auto func = holder.NewIndirect<CPDF_Stream>(
+        DataVector<uint8_t>(std::begin(kProgram), std::end(kProgram) - 1),
+        func_dict);
+
+    auto array = pdfium::MakeRetain<CPDF_Array>();
+    array->AppendNew<CPDF_Name>("DeviceN");
+    auto names = array->AppendNew<CPDF_Array>();
+    names->AppendNew<CPDF_Name>("A");
+    names->AppendNew<CPDF_Name>("B");
+    array->AppendNew<CPDF_Name>("DeviceRGB");
+    array->AppendNew<CPDF_Reference>(&holder, func->GetObjNum());
+    std::set<const CPDF_Object*> visited;
+    RetainPtr<CPDF_ColorSpace> cs =
+        CPDF_ColorSpace::Load(nullptr, array.Get(), &visited);
+    ASSERT_TRUE(cs);
+    ASSERT_EQ(2u, cs->ComponentCount());
+
+    // Includes repeated colors, both adjacent and not.
+    const uint8_t kSrc[] = {0,   0,   255, 0,  255, 0,  255, 0,
+                            128, 255, 0,   0,  128, 255, 10, 20};
+    constexpr int kPixels = std::size(kSrc) / 2;
+    uint8_t dst[kPixels * 3];
+    for (int pass = 0; pass < 2; ++pass) {
+      std::ranges::fill(dst, 0xbd);
+      cs->TranslateImageLine(dst, kSrc, kPixels, kPixels, 1,
+                             /*bTransMask=*/false);
+      EXPECT_THAT(dst, ElementsAreArray(TranslatePerPixel(cs.Get(), kSrc)));
+    }
+    EXPECT_THAT(pdfium::span(dst).first(6u), ElementsAre(0, 0, 0, 0, 0, 255));
+  }
+  pdfium::DestroyPageModule();
+}
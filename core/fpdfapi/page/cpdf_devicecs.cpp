@@ -128,15 +128,9 @@ void CPDF_DeviceCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
         }
         break;
       }
-      for (const auto& cmyk : cmyk_in.first(static_cast<size_t>(pixels))) {
-        // TODO(tsepez): maybe this is a FX_BGR_STRUCT in reality?
-        FX_RGB_STRUCT<uint8_t> rgb =
-            AdobeCMYK_to_sRGB1(cmyk.cyan, cmyk.magenta, cmyk.yellow, cmyk.key);
-        rgb_out.front().red = rgb.blue;
-        rgb_out.front().green = rgb.green;
-        rgb_out.front().blue = rgb.red;
-        rgb_out = rgb_out.subspan<1u>();
-      }
+      AdobeCMYK_to_sRGB_Line(
+          cmyk_in.first(static_cast<size_t>(pixels)),
+          fxcrt::reinterpret_span<FX_BGR_STRUCT<uint8_t>>(dest_span));
       break;
     }
     default:
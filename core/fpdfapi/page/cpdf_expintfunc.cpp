@@ -47,6 +47,11 @@ bool CPDF_ExpIntFunc::v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) {
     end_values_[i] = pArray1 ? pArray1->GetFloatAt(i) : 1.0f;
   }
 
+  deltas_ = DataVector<float>(outputs_);
+  for (uint32_t i = 0; i < outputs_; i++) {
+    deltas_[i] = end_values_[i] - begin_values_[i];
+  }
+
   FX_SAFE_UINT32 nOutputs = outputs_;
   nOutputs *= inputs_;
   if (!nOutputs.IsValid()) {
@@ -69,3 +74,26 @@ bool CPDF_ExpIntFunc::v_Call(pdfium::span<const float> inputs,
   }
   return true;
 }
+
+bool CPDF_ExpIntFunc::v_CallBatch(size_t count,
+                                  pdfium::span<const float> inputs,
+                                  pdfium::span<float> results) const {
+  // Linear interpolation is by far the most common case, and powf() with an
+  // exponent of 1 returns its input unchanged.
+  const bool is_linear = exponent_ == 1.0f;
+  pdfium::span<const float> begin_values =
+      pdfium::span(begin_values_).first(orig_outputs_);
+  pdfium::span<const float> deltas = pdfium::span(deltas_);
+  for (size_t n = 0; n < count; ++n) {
+    for (uint32_t i = 0; i < inputs_; i++) {
+      const float input = inputs[n * inputs_ + i];
+      const float t = is_linear ? input : powf(input, exponent_);
+      pdfium::span<float> dest =
+          results.subspan((n * inputs_ + i) * orig_outputs_, orig_outputs_);
+      for (uint32_t j = 0; j < orig_outputs_; j++) {
+        dest[j] = begin_values[j] + t * deltas[j];
+      }
+    }
+  }
+  return true;
+}
@@ -7,12 +7,11 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_EXPINTFUNC_H_
 #define CORE_FPDFAPI_PAGE_CPDF_EXPINTFUNC_H_
 
+#include <stddef.h>
+
 #include "core/fpdfapi/page/cpdf_function.h"
 #include "core/fxcrt/data_vector.h"
-
-#if defined(PDF_USE_SKIA)
 #include "core/fxcrt/span.h"
-#endif
 
 class CPDF_ExpIntFunc final : public CPDF_Function {
  public:
@@ -23,6 +22,9 @@ class CPDF_ExpIntFunc final : public CPDF_Function {
   bool v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) override;
   bool v_Call(pdfium::span<const float> inputs,
               pdfium::span<float> results) const override;
+  bool v_CallBatch(size_t count,
+                   pdfium::span<const float> inputs,
+                   pdfium::span<float> results) const override;
 
   uint32_t GetOrigOutputs() const { return orig_outputs_; }
   float GetExponent() const { return exponent_; }
@@ -37,6 +39,8 @@ class CPDF_ExpIntFunc final : public CPDF_Function {
   float exponent_ = 0.0f;
   DataVector<float> begin_values_;
   DataVector<float> end_values_;
+  // `end_values_` minus `begin_values_`, for the first `orig_outputs_` values.
+  DataVector<float> deltas_;
 };
 
 #endif  // CORE_FPDFAPI_PAGE_CPDF_EXPINTFUNC_H_
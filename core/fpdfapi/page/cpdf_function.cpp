@@ -173,6 +173,67 @@ std::optional<uint32_t> CPDF_Function::Call(pdfium::span<const float> inputs,
   return outputs_;
 }
 
+bool CPDF_Function::CallBatch(size_t count,
+                              pdfium::span<const float> inputs,
+                              pdfium::span<float> results) const {
+  FX_SAFE_SIZE_T input_size = count;
+  input_size *= inputs_;
+  FX_SAFE_SIZE_T result_size = count;
+  result_size *= outputs_;
+  if (!input_size.IsValid() || !result_size.IsValid() ||
+      inputs.size() < input_size.ValueOrDie() ||
+      results.size() < result_size.ValueOrDie()) {
+    return false;
+  }
+
+  std::vector<float> clamped_inputs(input_size.ValueOrDie());
+  for (uint32_t i = 0; i < inputs_; i++) {
+    float domain1 = domains_[i * 2];
+    float domain2 = domains_[i * 2 + 1];
+    if (domain1 > domain2) {
+      return false;
+    }
+
+    for (size_t j = 0; j < count; ++j) {
+      const size_t index = j * inputs_ + i;
+      clamped_inputs[index] = std::clamp(inputs[index], domain1, domain2);
+    }
+  }
+  if (!v_CallBatch(count, clamped_inputs, results)) {
+    return false;
+  }
+
+  if (ranges_.empty()) {
+    return true;
+  }
+
+  for (uint32_t i = 0; i < outputs_; i++) {
+    float range1 = ranges_[i * 2];
+    float range2 = ranges_[i * 2 + 1];
+    if (range1 > range2) {
+      return false;
+    }
+
+    for (size_t j = 0; j < count; ++j) {
+      const size_t index = j * outputs_ + i;
+      results[index] = std::clamp(results[index], range1, range2);
+    }
+  }
+  return true;
+}
+
+bool CPDF_Function::v_CallBatch(size_t count,
+                                pdfium::span<const float> inputs,
+                                pdfium::span<float> results) const {
+  for (size_t i = 0; i < count; ++i) {
+    if (!v_Call(inputs.subspan(i * inputs_, inputs_),
+                results.subspan(i * outputs_, outputs_))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // See PDF Reference 1.7, page 170.
 float CPDF_Function::Interpolate(float x,
                                  float xmin,
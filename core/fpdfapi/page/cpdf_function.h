@@ -7,6 +7,9 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_FUNCTION_H_
 #define CORE_FPDFAPI_PAGE_CPDF_FUNCTION_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <optional>
 #include <set>
@@ -38,6 +41,14 @@ class CPDF_Function {
 
   std::optional<uint32_t> Call(pdfium::span<const float> inputs,
                                pdfium::span<float> results) const;
+
+  // Same as calling Call() `count` times. `inputs` holds `count` sets of
+  // InputCount() values back to back, and `results` receives `count` sets of
+  // OutputCount() values. Returns false if any evaluation fails, in which case
+  // the contents of `results` are unspecified.
+  bool CallBatch(size_t count,
+                 pdfium::span<const float> inputs,
+                 pdfium::span<float> results) const;
   uint32_t InputCount() const { return inputs_; }
   uint32_t OutputCount() const { return outputs_; }
   float GetDomain(int i) const { return domains_[i]; }
@@ -66,6 +77,12 @@ class CPDF_Function {
   virtual bool v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) = 0;
   virtual bool v_Call(pdfium::span<const float> inputs,
                       pdfium::span<float> results) const = 0;
+  // Like v_Call(), for `count` sets of inputs that are already clamped to the
+  // domain. Subclasses override this when they have a faster way to evaluate
+  // many points. The default implementation calls v_Call() for each one.
+  virtual bool v_CallBatch(size_t count,
+                           pdfium::span<const float> inputs,
+                           pdfium::span<float> results) const;
 
   const Type type_;
   uint32_t inputs_ = 0;
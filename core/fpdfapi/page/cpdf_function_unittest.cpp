@@ -4,9 +4,14 @@
 
 #include "core/fpdfapi/page/cpdf_function.h"
 
+#include <iterator>
+#include <memory>
+
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_number.h"
+#include "core/fpdfapi/parser/cpdf_stream.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/retain_ptr.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -41,3 +46,146 @@ TEST(CPDFFunction, NoRange) {
   pArray->AppendNew<CPDF_Number>(10);
   EXPECT_FALSE(CPDF_Function::Load(dict));
 }
+
+TEST(CPDFFunction, PostScriptCallBatch) {
+  // The first output is affine, the second one needs a branch.
+  static constexpr char kProgram[] =
+      "{ dup 2 mul 0.5 sub exch dup 0.5 gt { 1 exch sub } if }";
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("FunctionType", 4);
+  auto domain = dict->SetNewFor<CPDF_Array>("Domain");
+  domain->AppendNew<CPDF_Number>(0);
+  domain->AppendNew<CPDF_Number>(1);
+  auto range = dict->SetNewFor<CPDF_Array>("Range");
+  for (int i = 0; i < 2; ++i) {
+    range->AppendNew<CPDF_Number>(0);
+    range->AppendNew<CPDF_Number>(1);
+  }
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>(std::begin(kProgram), std::end(kProgram) - 1),
+      dict);
+  std::unique_ptr<CPDF_Function> func = CPDF_Function::Load(stream);
+  ASSERT_TRUE(func);
+  ASSERT_EQ(2u, func->OutputCount());
+
+  // Includes values outside the domain.
+  static constexpr float kInputs[] = {-1, 0, 0.2f, 0.5f, 0.6f, 0.9f, 1, 2};
+  float batch_results[std::size(kInputs) * 2];
+  ASSERT_TRUE(func->CallBatch(std::size(kInputs), kInputs, batch_results));
+  for (size_t i = 0; i < std::size(kInputs); ++i) {
+    float results[2];
+    ASSERT_EQ(2u, func->Call(pdfium::span_from_ref(kInputs[i]), results));
+    EXPECT_EQ(results[0], batch_results[i * 2]);
+    EXPECT_EQ(results[1], batch_results[i * 2 + 1]);
+  }
+  EXPECT_FLOAT_EQ(0.0f, batch_results[0]);
+  EXPECT_FLOAT_EQ(0.0f, batch_results[1]);
+  EXPECT_FLOAT_EQ(0.7f, batch_results[8]);
+  EXPECT_FLOAT_EQ(0.4f, batch_results[9]);
+
+  // Too few inputs or results.
+  EXPECT_FALSE(func->CallBatch(3, pdfium::span(kInputs).first(2u),
+                               batch_results));
+  EXPECT_FALSE(func->CallBatch(3, kInputs,
+                               pdfium::span(batch_results).first(5u)));
+}
+
+TEST(CPDFFunction, SampledCallBatch) {
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("FunctionType", 0);
+  dict->SetNewFor<CPDF_Number>("BitsPerSample", 8);
+  auto domain = dict->SetNewFor<CPDF_Array>("Domain");
+  domain->AppendNew<CPDF_Number>(0);
+  domain->AppendNew<CPDF_Number>(1);
+  auto range = dict->SetNewFor<CPDF_Array>("Range");
+  range->AppendNew<CPDF_Number>(0);
+  range->AppendNew<CPDF_Number>(1);
+  dict->SetNewFor<CPDF_Array>("Size")->AppendNew<CPDF_Number>(3);
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>({0, 255, 51}), dict);
+  std::unique_ptr<CPDF_Function> func = CPDF_Function::Load(stream);
+  ASSERT_TRUE(func);
+
+  static constexpr float kInputs[] = {-1, 0, 0.25f, 0.5f, 0.75f, 1, 2};
+  static constexpr float kExpected[] = {0, 0, 0.5f, 1, 0.6f, 0.2f, 0.2f};
+  float batch_results[std::size(kInputs)];
+  ASSERT_TRUE(func->CallBatch(std::size(kInputs), kInputs, batch_results));
+  for (size_t i = 0; i < std::size(kInputs); ++i) {
+    float result;
+    ASSERT_EQ(1u, func->Call(pdfium::span_from_ref(kInputs[i]),
+                             pdfium::span_from_ref(result)));
+    EXPECT_EQ(result, batch_results[i]);
+    EXPECT_FLOAT_EQ(kExpected[i], batch_results[i]);
+  }
+}
+
+TEST(CPDFFunction, SampledCallBatch16Bit) {
+  // 2 inputs and 2 outputs, so every sample read is byte-aligned but not the
+  // first in the stream.
+  auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+  dict->SetNewFor<CPDF_Number>("FunctionType", 0);
+  dict->SetNewFor<CPDF_Number>("BitsPerSample", 16);
+  auto domain = dict->SetNewFor<CPDF_Array>("Domain");
+  auto range = dict->SetNewFor<CPDF_Array>("Range");
+  auto size = dict->SetNewFor<CPDF_Array>("Size");
+  for (int i = 0; i < 2; ++i) {
+    domain->AppendNew<CPDF_Number>(0);
+    domain->AppendNew<CPDF_Number>(1);
+    range->AppendNew<CPDF_Number>(0);
+    range->AppendNew<CPDF_Number>(1);
+    size->AppendNew<CPDF_Number>(2);
+  }
+  // The first output is x, the second one is y.
+  auto stream = pdfium::MakeRetain<CPDF_Stream>(
+      DataVector<uint8_t>({0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00,
+                           0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}),
+      dict);
+  std::unique_ptr<CPDF_Function> func = CPDF_Function::Load(stream);
+  ASSERT_TRUE(func);
+
+  static constexpr float kInputs[] = {0, 0, 0.25f, 0.5f, 1, 0.75f, 1, 1};
+  float batch_results[std::size(kInputs)];
+  ASSERT_TRUE(
+      func->CallBatch(std::size(kInputs) / 2, kInputs, batch_results));
+  for (size_t i = 0; i < std::size(kInputs); i += 2) {
+    float results[2];
+    ASSERT_EQ(2u, func->Call(pdfium::span(kInputs).subspan(i, 2u), results));
+    EXPECT_EQ(results[0], batch_results[i]);
+    EXPECT_EQ(results[1], batch_results[i + 1]);
+    EXPECT_FLOAT_EQ(kInputs[i], batch_results[i]);
+    EXPECT_FLOAT_EQ(kInputs[i + 1], batch_results[i + 1]);
+  }
+}
+
+TEST(CPDFFunction, ExponentialCallBatch) {
+  for (float exponent : {1.0f, 2.0f}) {
+    auto dict = pdfium::MakeRetain<CPDF_Dictionary>();
+    dict->SetNewFor<CPDF_Number>("FunctionType", 2);
+    dict->SetNewFor<CPDF_Number>("N", exponent);
+    auto domain = dict->SetNewFor<CPDF_Array>("Domain");
+    domain->AppendNew<CPDF_Number>(0);
+    domain->AppendNew<CPDF_Number>(1);
+    auto c0 = dict->SetNewFor<CPDF_Array>("C0");
+    c0->AppendNew<CPDF_Number>(0);
+    c0->AppendNew<CPDF_Number>(1);
+    auto c1 = dict->SetNewFor<CPDF_Array>("C1");
+    c1->AppendNew<CPDF_Number>(1);
+    c1->AppendNew<CPDF_Number>(0.5f);
+    std::unique_ptr<CPDF_Function> func = CPDF_Function::Load(dict);
+    ASSERT_TRUE(func);
+    ASSERT_EQ(2u, func->OutputCount());
+
+    static constexpr float kInputs[] = {-1, 0, 0.1f, 0.5f, 0.7f, 1};
+    float batch_results[std::size(kInputs) * 2];
+    ASSERT_TRUE(func->CallBatch(std::size(kInputs), kInputs, batch_results));
+    for (size_t i = 0; i < std::size(kInputs); ++i) {
+      float results[2];
+      ASSERT_EQ(2u, func->Call(pdfium::span_from_ref(kInputs[i]), results));
+      EXPECT_EQ(results[0], batch_results[i * 2]);
+      EXPECT_EQ(results[1], batch_results[i * 2 + 1]);
+    }
+    const float t = exponent == 1.0f ? 0.5f : 0.25f;
+    EXPECT_FLOAT_EQ(t, batch_results[6]);
+    EXPECT_FLOAT_EQ(1.0f - 0.5f * t, batch_results[7]);
+  }
+}
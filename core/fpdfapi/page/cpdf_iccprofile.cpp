@@ -8,6 +8,7 @@
 
 #include <utility>
 
+#include "core/fpdfapi/page/cpdf_icctransformcache.h"
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fxcodec/icc/icc_transform.h"
 #include "core/fxcrt/span.h"
@@ -30,19 +31,11 @@ CPDF_IccProfile::CPDF_IccProfile(RetainPtr<const CPDF_StreamAcc> stream_acc,
     return;
   }
 
-  auto transform =
-      fxcodec::IccTransform::CreateTransformSRGB(stream_acc_->GetSpan());
-  if (!transform) {
-    return;
+  transform_ = CPDF_IccTransformCache::GetInstance()->GetTransformSRGB(
+      stream_acc_->GetSpan(), expected_components, INTENT_PERCEPTUAL);
+  if (transform_) {
+    src_components_ = expected_components;
   }
-
-  uint32_t components = transform->components();
-  if (components != expected_components) {
-    return;
-  }
-
-  src_components_ = components;
-  transform_ = std::move(transform);
 }
 
 CPDF_IccProfile::~CPDF_IccProfile() = default;
@@ -9,8 +9,6 @@
 
 #include <stdint.h>
 
-#include <memory>
-
 #include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 
@@ -43,11 +41,9 @@ class CPDF_IccProfile final : public Retainable {
                   uint32_t expected_components);
   ~CPDF_IccProfile() override;
 
-  // Keeps stream alive for the lifetime of this object, so `transform_` can
-  // safely access the stream data.
   RetainPtr<const CPDF_StreamAcc> const stream_acc_;
-  // Uses data from `stream_acc_`.
-  std::unique_ptr<fxcodec::IccTransform> transform_;
+  // May be shared with profiles from other documents.
+  RetainPtr<fxcodec::IccTransform> transform_;
   const bool is_srgb_;
   uint32_t src_components_ = 0;
 };
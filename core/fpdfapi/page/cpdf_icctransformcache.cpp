@@ -0,0 +1,90 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_icctransformcache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "core/fdrm/fx_crypt_sha.h"
+#include "core/fxcodec/icc/icc_transform.h"
+#include "core/fxcrt/check.h"
+
+namespace {
+
+CPDF_IccTransformCache* g_IccTransformCache = nullptr;
+
+}  // namespace
+
+// static
+void CPDF_IccTransformCache::Create() {
+  DCHECK(!g_IccTransformCache);
+  g_IccTransformCache = new CPDF_IccTransformCache();
+}
+
+// static
+void CPDF_IccTransformCache::Destroy() {
+  DCHECK(g_IccTransformCache);
+  delete g_IccTransformCache;
+  g_IccTransformCache = nullptr;
+}
+
+// static
+CPDF_IccTransformCache* CPDF_IccTransformCache::GetInstance() {
+  DCHECK(g_IccTransformCache);
+  return g_IccTransformCache;
+}
+
+CPDF_IccTransformCache::CPDF_IccTransformCache() = default;
+
+CPDF_IccTransformCache::~CPDF_IccTransformCache() = default;
+
+RetainPtr<fxcodec::IccTransform> CPDF_IccTransformCache::GetTransformSRGB(
+    pdfium::span<const uint8_t> profile,
+    uint32_t expected_components,
+    uint32_t intent) {
+  DataVector<uint8_t> digest = CRYPT_SHA256Generate(profile);
+  auto it = std::ranges::find_if(entries_, [&](const Entry& entry) {
+    return entry.components == expected_components &&
+           entry.intent == intent && std::ranges::equal(entry.digest, digest);
+  });
+  if (it != entries_.end()) {
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it);
+    return entries_.front().transform;
+  }
+
+  ++stats_.misses;
+  RetainPtr<fxcodec::IccTransform> transform =
+      fxcodec::IccTransform::CreateTransformSRGB(profile, intent);
+  if (transform &&
+      static_cast<uint32_t>(transform->components()) != expected_components) {
+    transform.Reset();
+  }
+  if (entries_.size() >= kMaxEntries) {
+    ++stats_.evictions;
+    entries_.pop_back();
+  }
+  entries_.emplace_front(std::move(digest), expected_components, intent,
+                         transform);
+  return transform;
+}
+
+void CPDF_IccTransformCache::Clear() {
+  entries_.clear();
+}
+
+CPDF_IccTransformCache::Entry::Entry(
+    DataVector<uint8_t> digest,
+    uint32_t components,
+    uint32_t intent,
+    RetainPtr<fxcodec::IccTransform> transform)
+    : digest(std::move(digest)),
+      components(components),
+      intent(intent),
+      transform(std::move(transform)) {}
+
+CPDF_IccTransformCache::Entry::Entry(Entry&& that) noexcept = default;
+
+CPDF_IccTransformCache::Entry::~Entry() = default;
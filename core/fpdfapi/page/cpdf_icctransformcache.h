@@ -0,0 +1,84 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_ICCTRANSFORMCACHE_H_
+#define CORE_FPDFAPI_PAGE_CPDF_ICCTRANSFORMCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+
+namespace fxcodec {
+class IccTransform;
+}  // namespace fxcodec
+
+// Process-wide cache of ICC to sRGB transforms. Creating an lcms transform is
+// expensive, and documents commonly embed the same handful of profiles.
+// Per-document de-duplication happens in CPDF_DocPageData; this cache lets
+// the resulting transforms be shared across documents as well.
+//
+// Entries are keyed by the SHA-256 digest of the profile, the number of
+// components the caller expects, and the rendering intent. The digest has to
+// be collision resistant, since entries created for one document get used by
+// others. Profiles that fail to produce a
+// usable transform are cached as well, so they are not parsed repeatedly.
+// Once the cache is full, the least recently used entry gets evicted.
+class CPDF_IccTransformCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  static constexpr size_t kMaxEntries = 64;
+
+  // Per-process singleton which must be managed by callers.
+  static void Create();
+  static void Destroy();
+  static CPDF_IccTransformCache* GetInstance();
+
+  CPDF_IccTransformCache();
+  ~CPDF_IccTransformCache();
+
+  // Returns the transform for `profile`, creating it on a cache miss.
+  // Returns nullptr if lcms cannot create a transform for `profile`, or if the
+  // transform does not take `expected_components` components.
+  RetainPtr<fxcodec::IccTransform> GetTransformSRGB(
+      pdfium::span<const uint8_t> profile,
+      uint32_t expected_components,
+      uint32_t intent);
+
+  void Clear();
+
+  size_t size() const { return entries_.size(); }
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct Entry {
+    Entry(DataVector<uint8_t> digest,
+          uint32_t components,
+          uint32_t intent,
+          RetainPtr<fxcodec::IccTransform> transform);
+    Entry(Entry&& that) noexcept;
+    ~Entry();
+
+    DataVector<uint8_t> digest;
+    uint32_t components;
+    uint32_t intent;
+    // Null if creating the transform failed.
+    RetainPtr<fxcodec::IccTransform> transform;
+  };
+
+  // Most recently used first.
+  std::list<Entry> entries_;
+  Stats stats_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_ICCTRANSFORMCACHE_H_
@@ -0,0 +1,128 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_icctransformcache.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcodec/icc/icc_transform.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Returns an sRGB profile with `model` as its device model. Profiles with
+// different models have different bytes, but behave the same.
+DataVector<uint8_t> CreateSRGBProfile(uint32_t model = 0) {
+  cmsHPROFILE profile = cmsCreate_sRGBProfile();
+  cmsSetHeaderModel(profile, model);
+  cmsUInt32Number size = 0;
+  cmsSaveProfileToMem(profile, nullptr, &size);
+  DataVector<uint8_t> data(size);
+  cmsSaveProfileToMem(profile, data.data(), &size);
+  cmsCloseProfile(profile);
+  return data;
+}
+
+}  // namespace
+
+TEST(CPDFIccTransformCache, HitsAndMisses) {
+  const DataVector<uint8_t> profile = CreateSRGBProfile();
+  CPDF_IccTransformCache cache;
+
+  RetainPtr<fxcodec::IccTransform> transform =
+      cache.GetTransformSRGB(profile, 3, INTENT_PERCEPTUAL);
+  ASSERT_TRUE(transform);
+  EXPECT_EQ(3, transform->components());
+  EXPECT_EQ(0u, cache.stats().hits);
+  EXPECT_EQ(1u, cache.stats().misses);
+
+  EXPECT_EQ(transform,
+            cache.GetTransformSRGB(profile, 3, INTENT_PERCEPTUAL));
+  EXPECT_EQ(1u, cache.stats().hits);
+  EXPECT_EQ(1u, cache.stats().misses);
+  EXPECT_EQ(1u, cache.size());
+
+  // The intent is part of the key.
+  RetainPtr<fxcodec::IccTransform> colorimetric = cache.GetTransformSRGB(
+      profile, 3, INTENT_RELATIVE_COLORIMETRIC);
+  ASSERT_TRUE(colorimetric);
+  EXPECT_NE(transform, colorimetric);
+  EXPECT_EQ(2u, cache.stats().misses);
+  EXPECT_EQ(2u, cache.size());
+
+  // Transforms outlive the cache entries.
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(3, transform->components());
+}
+
+TEST(CPDFIccTransformCache, Failures) {
+  const DataVector<uint8_t> profile = CreateSRGBProfile();
+  CPDF_IccTransformCache cache;
+
+  // Mismatched component counts fail, and are cached.
+  EXPECT_FALSE(cache.GetTransformSRGB(profile, 4, INTENT_PERCEPTUAL));
+  EXPECT_FALSE(cache.GetTransformSRGB(profile, 4, INTENT_PERCEPTUAL));
+  EXPECT_EQ(1u, cache.stats().hits);
+  EXPECT_EQ(1u, cache.stats().misses);
+  EXPECT_TRUE(cache.GetTransformSRGB(profile, 3, INTENT_PERCEPTUAL));
+  EXPECT_EQ(2u, cache.stats().misses);
+
+  // So are invalid profiles.
+  static constexpr uint8_t kGarbage[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_FALSE(cache.GetTransformSRGB(kGarbage, 3, INTENT_PERCEPTUAL));
+  EXPECT_FALSE(cache.GetTransformSRGB(kGarbage, 3, INTENT_PERCEPTUAL));
+  EXPECT_EQ(2u, cache.stats().hits);
+  EXPECT_EQ(3u, cache.stats().misses);
+  EXPECT_EQ(3u, cache.size());
+}
+
+TEST(CPDFIccTransformCache, KeyedOnProfileContents) {
+  const DataVector<uint8_t> profile = CreateSRGBProfile(1);
+  const DataVector<uint8_t> same_profile = CreateSRGBProfile(1);
+  const DataVector<uint8_t> other_profile = CreateSRGBProfile(2);
+  CPDF_IccTransformCache cache;
+
+  RetainPtr<fxcodec::IccTransform> transform =
+      cache.GetTransformSRGB(profile, 3, INTENT_PERCEPTUAL);
+  ASSERT_TRUE(transform);
+  EXPECT_EQ(transform,
+            cache.GetTransformSRGB(same_profile, 3, INTENT_PERCEPTUAL));
+  EXPECT_EQ(1u, cache.stats().hits);
+
+  RetainPtr<fxcodec::IccTransform> other_transform =
+      cache.GetTransformSRGB(other_profile, 3, INTENT_PERCEPTUAL);
+  ASSERT_TRUE(other_transform);
+  EXPECT_NE(transform, other_transform);
+  EXPECT_EQ(2u, cache.stats().misses);
+}
+
+TEST(CPDFIccTransformCache, EvictsLeastRecentlyUsed) {
+  std::vector<DataVector<uint8_t>> profiles;
+  for (uint32_t i = 0; i <= CPDF_IccTransformCache::kMaxEntries; ++i) {
+    profiles.push_back(CreateSRGBProfile(i));
+  }
+  CPDF_IccTransformCache cache;
+  for (uint32_t i = 0; i < CPDF_IccTransformCache::kMaxEntries; ++i) {
+    ASSERT_TRUE(cache.GetTransformSRGB(profiles[i], 3, INTENT_PERCEPTUAL));
+  }
+  EXPECT_EQ(CPDF_IccTransformCache::kMaxEntries, cache.size());
+
+  // Touch the oldest entry, so the second oldest one gets evicted instead.
+  cache.GetTransformSRGB(profiles[0], 3, INTENT_PERCEPTUAL);
+  cache.GetTransformSRGB(profiles.back(), 3, INTENT_PERCEPTUAL);
+  EXPECT_EQ(CPDF_IccTransformCache::kMaxEntries, cache.size());
+  EXPECT_EQ(1u, cache.stats().evictions);
+
+  const size_t misses = cache.stats().misses;
+  cache.GetTransformSRGB(profiles[0], 3, INTENT_PERCEPTUAL);
+  EXPECT_EQ(misses, cache.stats().misses);
+  cache.GetTransformSRGB(profiles[1], 3, INTENT_PERCEPTUAL);
+  EXPECT_EQ(misses + 1, cache.stats().misses);
+}
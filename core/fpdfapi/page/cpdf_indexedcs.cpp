@@ -14,6 +14,7 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fpdfapi/parser/cpdf_string.h"
+#include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_safe_types.h"
@@ -24,6 +25,19 @@ CPDF_IndexedCS::CPDF_IndexedCS() : CPDF_BasedCS(Family::kIndexed) {}
 
 CPDF_IndexedCS::~CPDF_IndexedCS() = default;
 
+void CPDF_IndexedCS::TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                                        pdfium::span<const uint8_t> src_span,
+                                        int pixels,
+                                        int image_width,
+                                        int image_height,
+                                        bool bTransMask) const {
+  // Only applies to CMYK colorspaces.
+  CHECK(!bTransMask);
+
+  // Samples are palette indices, so convert the whole palette once.
+  TranslateImageLineWithTable(dest_span, src_span, pixels, /*divisor=*/1);
+}
+
 const CPDF_IndexedCS* CPDF_IndexedCS::AsIndexedCS() const {
   return this;
 }
@@ -30,6 +30,12 @@ class CPDF_IndexedCS final : public CPDF_BasedCS {
   // CPDF_ColorSpace:
   std::optional<FX_RGB_STRUCT<float>> GetRGB(
       pdfium::span<const float> pBuf) const override;
+  void TranslateImageLine(pdfium::span<uint8_t> dest_span,
+                          pdfium::span<const uint8_t> src_span,
+                          int pixels,
+                          int image_width,
+                          int image_height,
+                          bool bTransMask) const override;
   const CPDF_IndexedCS* AsIndexedCS() const override;
   uint32_t v_Load(CPDF_Document* doc,
                   const CPDF_Array* pArray,
@@ -233,6 +233,12 @@ void CPDF_Page::ClearView() {
   }
 }
 
+void CPDF_Page::NotifyAnnotRectsChanged() {
+  if (view_) {
+    view_->OnAnnotRectsChanged();
+  }
+}
+
 void CPDF_Page::UpdateDimensions() {
   CFX_FloatRect mediabox = GetBox(pdfium::page_object::kMediaBox);
   if (mediabox.IsEmpty()) {
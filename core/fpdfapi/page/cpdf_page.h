@@ -31,6 +31,8 @@ class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
   class View : public Observable {
    public:
     virtual void ClearPage(CPDF_Page* pPage) = 0;
+    // Called when annotations on the page may have moved or been resized.
+    virtual void OnAnnotRectsChanged() = 0;
   };
 
   // Data for the render layer to attach to this page.
@@ -93,6 +95,7 @@ class CPDF_Page final : public IPDF_Page, public CPDF_PageObjectHolder {
 
   void SetView(View* pView) { view_.Reset(pView); }
   void ClearView();
+  void NotifyAnnotRectsChanged();
   void UpdateDimensions();
 
  private:
@@ -8,12 +8,14 @@
 
 #include "core/fpdfapi/font/cpdf_fontglobals.h"
 #include "core/fpdfapi/page/cpdf_colorspace.h"
+#include "core/fpdfapi/page/cpdf_icctransformcache.h"
 #include "core/fpdfapi/page/cpdf_streamcontentparser.h"
 
 namespace pdfium {
 
 void InitializePageModule() {
   CPDF_ColorSpace::InitializeGlobals();
+  CPDF_IccTransformCache::Create();
   CPDF_FontGlobals::Create();
   CPDF_FontGlobals::GetInstance()->LoadEmbeddedMaps();
   CPDF_StreamContentParser::InitializeGlobals();
@@ -22,6 +24,7 @@ void InitializePageModule() {
 void DestroyPageModule() {
   CPDF_StreamContentParser::DestroyGlobals();
   CPDF_FontGlobals::Destroy();
+  CPDF_IccTransformCache::Destroy();
   CPDF_ColorSpace::DestroyGlobals();
 }
 
@@ -63,6 +63,11 @@ void CPDF_PageObjectHolder::StartParse(
   parse_state_ = ParseState::kParsing;
 }
 
+void CPDF_PageObjectHolder::SetParseMode(ParseMode mode) {
+  DCHECK_EQ(parse_state_, ParseState::kNotParsed);
+  parse_mode_ = mode;
+}
+
 void CPDF_PageObjectHolder::ContinueParse(PauseIndicatorIface* pPause) {
   if (parse_state_ == ParseState::kParsed) {
     return;
@@ -53,6 +53,11 @@ class CPDF_PageObjectHolder {
  public:
   enum class ParseState : uint8_t { kNotParsed, kParsing, kParsed };
 
+  // Selects which page objects content parsing creates. With kTextOnly, only
+  // text and form objects are created, along with the graphics state needed to
+  // place glyphs. Paths, clips, images and shadings are skipped.
+  enum class ParseMode : bool { kFull, kTextOnly };
+
   // Key: The stream index.
   // Value: The current transformation matrix at the end of the stream.
   using CTMMap = std::map<int32_t, CFX_Matrix>;
@@ -82,6 +87,10 @@ class CPDF_PageObjectHolder {
   void ContinueParse(PauseIndicatorIface* pPause);
   ParseState GetParseState() const { return parse_state_; }
 
+  // Must be called before StartParse().
+  void SetParseMode(ParseMode mode);
+  ParseMode GetParseMode() const { return parse_mode_; }
+
   CPDF_Document* GetDocument() const { return document_; }
   RetainPtr<const CPDF_Dictionary> GetDict() const { return dict_; }
   RetainPtr<CPDF_Dictionary> GetMutableDict() { return dict_; }
@@ -159,6 +168,7 @@ class CPDF_PageObjectHolder {
  private:
   bool background_alpha_needed_ = false;
   ParseState parse_state_ = ParseState::kNotParsed;
+  ParseMode parse_mode_ = ParseMode::kFull;
   RetainPtr<CPDF_Dictionary> const dict_;
   UnownedPtr<CPDF_Document> document_;
   std::vector<CFX_FloatRect> mask_bounding_boxes_;
@@ -18,6 +18,7 @@
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_string.h"
+#include "core/fxcrt/notreached.h"
 
 namespace {
 
@@ -108,6 +109,11 @@ void CPDF_PSOP::Execute(CPDF_PSEngine* pEngine) {
   proc_->Execute(pEngine);
 }
 
+const CPDF_PSProc& CPDF_PSOP::GetProc() const {
+  CHECK_EQ(op_, PSOP_PROC);
+  return *proc_;
+}
+
 float CPDF_PSOP::GetFloatValue() const {
   CHECK_EQ(op_, PSOP_CONST);
   return value_;
@@ -219,171 +225,150 @@ bool CPDF_PSEngine::Parse(pdfium::span<const uint8_t> input) {
   return parser.GetWord() == "{" && main_proc_.Parse(&parser, 0);
 }
 
-bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
-  int i1;
-  int i2;
-  float d1;
-  float d2;
-  FX_SAFE_INT32 result;
+// static
+bool CPDF_PSEngine::IsUnaryOperator(PDF_PSOP op) {
   switch (op) {
-    case PSOP_ADD:
-      d1 = Pop();
-      d2 = Pop();
-      Push(d1 + d2);
-      break;
-    case PSOP_SUB:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 - d2);
-      break;
-    case PSOP_MUL:
-      d1 = Pop();
-      d2 = Pop();
-      Push(d1 * d2);
-      break;
-    case PSOP_DIV:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d2 ? d1 / d2 : 0);
-      break;
-    case PSOP_IDIV:
-      i2 = PopInt();
-      i1 = PopInt();
-      if (i2) {
-        result = i1;
-        result /= i2;
-        Push(result.ValueOrDefault(0));
-      } else {
-        Push(0);
-      }
-      break;
-    case PSOP_MOD:
-      i2 = PopInt();
-      i1 = PopInt();
-      if (i2) {
-        result = i1;
-        result %= i2;
-        Push(result.ValueOrDefault(0));
-      } else {
-        Push(0);
-      }
-      break;
     case PSOP_NEG:
-      d1 = Pop();
-      Push(-d1);
-      break;
     case PSOP_ABS:
-      d1 = Pop();
-      Push(fabs(d1));
-      break;
     case PSOP_CEILING:
-      d1 = Pop();
-      Push(ceil(d1));
-      break;
     case PSOP_FLOOR:
-      d1 = Pop();
-      Push(floor(d1));
-      break;
     case PSOP_ROUND:
-      d1 = Pop();
-      Push(RoundHalfUp(d1));
-      break;
     case PSOP_TRUNCATE:
-      i1 = PopInt();
-      Push(i1);
-      break;
     case PSOP_SQRT:
-      d1 = Pop();
-      Push(sqrt(d1));
-      break;
     case PSOP_SIN:
-      d1 = Pop();
-      Push(sin(d1 * FXSYS_PI / 180.0f));
-      break;
     case PSOP_COS:
-      d1 = Pop();
-      Push(cos(d1 * FXSYS_PI / 180.0f));
-      break;
-    case PSOP_ATAN:
-      d2 = Pop();
-      d1 = Pop();
-      d1 = atan2(d1, d2) * 180.0 / FXSYS_PI;
-      if (d1 < 0) {
-        d1 += 360;
-      }
-      Push(d1);
-      break;
-    case PSOP_EXP:
-      d2 = Pop();
-      d1 = Pop();
-      Push(powf(d1, d2));
-      break;
     case PSOP_LN:
-      d1 = Pop();
-      Push(log(d1));
-      break;
     case PSOP_LOG:
-      d1 = Pop();
-      Push(log10(d1));
-      break;
     case PSOP_CVI:
-      i1 = PopInt();
-      Push(i1);
-      break;
-    case PSOP_CVR:
-      break;
+    case PSOP_NOT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+float CPDF_PSEngine::DoUnaryOperator(PDF_PSOP op, float value) {
+  switch (op) {
+    case PSOP_NEG:
+      return -value;
+    case PSOP_ABS:
+      return fabs(value);
+    case PSOP_CEILING:
+      return ceil(value);
+    case PSOP_FLOOR:
+      return floor(value);
+    case PSOP_ROUND:
+      return RoundHalfUp(value);
+    case PSOP_TRUNCATE:
+    case PSOP_CVI:
+      return static_cast<int>(value);
+    case PSOP_SQRT:
+      return sqrt(value);
+    case PSOP_SIN:
+      return sin(value * FXSYS_PI / 180.0f);
+    case PSOP_COS:
+      return cos(value * FXSYS_PI / 180.0f);
+    case PSOP_LN:
+      return log(value);
+    case PSOP_LOG:
+      return log10(value);
+    case PSOP_NOT:
+      return !static_cast<int>(value);
+    default:
+      NOTREACHED();
+  }
+}
+
+// static
+bool CPDF_PSEngine::IsBinaryOperator(PDF_PSOP op) {
+  switch (op) {
+    case PSOP_ADD:
+    case PSOP_SUB:
+    case PSOP_MUL:
+    case PSOP_DIV:
+    case PSOP_IDIV:
+    case PSOP_MOD:
+    case PSOP_ATAN:
+    case PSOP_EXP:
     case PSOP_EQ:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 == d2);
-      break;
     case PSOP_NE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 != d2);
-      break;
     case PSOP_GT:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 > d2);
-      break;
     case PSOP_GE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 >= d2);
-      break;
     case PSOP_LT:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 < d2);
-      break;
     case PSOP_LE:
-      d2 = Pop();
-      d1 = Pop();
-      Push(d1 <= d2);
-      break;
     case PSOP_AND:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 & i2);
-      break;
     case PSOP_OR:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 | i2);
-      break;
     case PSOP_XOR:
-      i1 = PopInt();
-      i2 = PopInt();
-      Push(i1 ^ i2);
-      break;
-    case PSOP_NOT:
-      i1 = PopInt();
-      Push(!i1);
-      break;
+    case PSOP_BITSHIFT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// static
+float CPDF_PSEngine::DoBinaryOperator(PDF_PSOP op, float below, float top) {
+  FX_SAFE_INT32 result;
+  switch (op) {
+    case PSOP_ADD:
+      return top + below;
+    case PSOP_SUB:
+      return below - top;
+    case PSOP_MUL:
+      return top * below;
+    case PSOP_DIV:
+      return top ? below / top : 0;
+    case PSOP_IDIV: {
+      const int divisor = static_cast<int>(top);
+      const int dividend = static_cast<int>(below);
+      if (!divisor) {
+        return 0;
+      }
+      result = dividend;
+      result /= divisor;
+      return result.ValueOrDefault(0);
+    }
+    case PSOP_MOD: {
+      const int divisor = static_cast<int>(top);
+      const int dividend = static_cast<int>(below);
+      if (!divisor) {
+        return 0;
+      }
+      result = dividend;
+      result %= divisor;
+      return result.ValueOrDefault(0);
+    }
+    case PSOP_ATAN: {
+      float angle = atan2(below, top) * 180.0 / FXSYS_PI;
+      if (angle < 0) {
+        angle += 360;
+      }
+      return angle;
+    }
+    case PSOP_EXP:
+      return powf(below, top);
+    case PSOP_EQ:
+      return below == top;
+    case PSOP_NE:
+      return below != top;
+    case PSOP_GT:
+      return below > top;
+    case PSOP_GE:
+      return below >= top;
+    case PSOP_LT:
+      return below < top;
+    case PSOP_LE:
+      return below <= top;
+    case PSOP_AND:
+      return static_cast<int>(top) & static_cast<int>(below);
+    case PSOP_OR:
+      return static_cast<int>(top) | static_cast<int>(below);
+    case PSOP_XOR:
+      return static_cast<int>(top) ^ static_cast<int>(below);
     case PSOP_BITSHIFT: {
-      int shift = PopInt();
-      result = PopInt();
+      const int shift = static_cast<int>(top);
+      result = static_cast<int>(below);
       if (shift > 0) {
         result <<= shift;
       } else {
@@ -391,9 +376,28 @@ bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
         FX_SAFE_INT32 safe_shift = shift;
         result >>= (-safe_shift).ValueOrDefault(0);
       }
-      Push(result.ValueOrDefault(0));
-      break;
+      return result.ValueOrDefault(0);
     }
+    default:
+      NOTREACHED();
+  }
+}
+
+bool CPDF_PSEngine::DoOperator(PDF_PSOP op) {
+  if (IsUnaryOperator(op)) {
+    Push(DoUnaryOperator(op, Pop()));
+    return true;
+  }
+  if (IsBinaryOperator(op)) {
+    const float top = Pop();
+    const float below = Pop();
+    Push(DoBinaryOperator(op, below, top));
+    return true;
+  }
+
+  float d1;
+  float d2;
+  switch (op) {
     case PSOP_TRUE:
       Push(1);
       break;
@@ -79,6 +79,9 @@ class CPDF_PSOP {
   float GetFloatValue() const;
   PDF_PSOP GetOp() const { return op_; }
 
+  // Only valid for PSOP_PROC.
+  const CPDF_PSProc& GetProc() const;
+
  private:
   const PDF_PSOP op_;
   const float value_;
@@ -93,6 +96,10 @@ class CPDF_PSProc {
   bool Parse(CPDF_SimpleParser* parser, int depth);
   bool Execute(CPDF_PSEngine* pEngine);
 
+  pdfium::span<const std::unique_ptr<CPDF_PSOP>> operators() const {
+    return operators_;
+  }
+
   // These methods are exposed for testing.
   void AddOperatorForTesting(ByteStringView word);
   const std::unique_ptr<CPDF_PSOP>& last_operator() {
@@ -109,6 +116,17 @@ class CPDF_PSProc {
 
 class CPDF_PSEngine {
  public:
+  static constexpr uint32_t kPSEngineStackSize = 100;
+
+  // Operators that pop one value and push one result.
+  static bool IsUnaryOperator(PDF_PSOP op);
+  static float DoUnaryOperator(PDF_PSOP op, float value);
+
+  // Operators that pop two values and push one result. `top` is the value
+  // that was on the top of the stack.
+  static bool IsBinaryOperator(PDF_PSOP op);
+  static float DoBinaryOperator(PDF_PSOP op, float below, float top);
+
   CPDF_PSEngine();
   ~CPDF_PSEngine();
 
@@ -120,10 +138,9 @@ class CPDF_PSEngine {
   float Pop();
   int PopInt();
   uint32_t GetStackSize() const { return stack_count_; }
+  const CPDF_PSProc& main_proc() const { return main_proc_; }
 
  private:
-  static constexpr uint32_t kPSEngineStackSize = 100;
-
   uint32_t stack_count_ = 0;
   CPDF_PSProc main_proc_;
   std::array<float, kPSEngineStackSize> stack_ = {};
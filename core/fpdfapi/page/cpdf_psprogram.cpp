@@ -0,0 +1,516 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+// Compiles by executing the procedure symbolically: the stack holds register
+// numbers instead of values, and each operator either folds into a new
+// constant or emits an instruction. Only the stack depth has to be known
+// ahead of time, which is true of most real world functions.
+class CPDF_PSProgram::Compiler {
+ public:
+  explicit Compiler(uint32_t input_count) {
+    for (uint32_t i = 0; i < input_count; ++i) {
+      Push(NewRegister(std::nullopt));
+    }
+  }
+
+  // Returns false if `proc` cannot be compiled.
+  bool CompileProc(const CPDF_PSProc& proc) {
+    pdfium::span<const std::unique_ptr<CPDF_PSOP>> ops = proc.operators();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      const PDF_PSOP op = ops[i]->GetOp();
+      if (op == PSOP_PROC) {
+        continue;
+      }
+      if (op == PSOP_CONST) {
+        Push(NewConstant(ops[i]->GetFloatValue()));
+        continue;
+      }
+      if (op == PSOP_IF) {
+        if (i == 0 || ops[i - 1]->GetOp() != PSOP_PROC) {
+          // CPDF_PSProc::Execute() stops here.
+          return true;
+        }
+        if (!CompileIf(Pop(), ops[i - 1]->GetProc(), nullptr)) {
+          return false;
+        }
+        continue;
+      }
+      if (op == PSOP_IFELSE) {
+        if (i < 2 || ops[i - 1]->GetOp() != PSOP_PROC ||
+            ops[i - 2]->GetOp() != PSOP_PROC) {
+          return true;
+        }
+        if (!CompileIf(Pop(), ops[i - 2]->GetProc(), &ops[i - 1]->GetProc())) {
+          return false;
+        }
+        continue;
+      }
+      if (!CompileOperator(op)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool Finish(uint32_t output_count, CPDF_PSProgram* program) {
+    if (stack_.size() < output_count) {
+      return false;
+    }
+
+    program->output_registers_.assign(stack_.end() - output_count,
+                                      stack_.end());
+    const bool has_jumps = std::ranges::any_of(code_, [](const auto& inst) {
+      return inst.opcode == Opcode::kJumpIfZero || inst.opcode == Opcode::kJump;
+    });
+    if (!has_jumps) {
+      RemoveDeadCode(program->output_registers_);
+      program->affine_outputs_ = GetAffineOutputs(program->output_registers_);
+      if (!program->affine_outputs_.empty()) {
+        code_.clear();
+      }
+    }
+    program->code_ = std::move(code_);
+    program->registers_.resize(constants_.size());
+    for (size_t i = 0; i < constants_.size(); ++i) {
+      program->registers_[i] = constants_[i].value_or(0);
+    }
+    return true;
+  }
+
+ private:
+  // Mirrors CPDF_PSEngine::Push().
+  void Push(uint32_t reg) {
+    if (stack_.size() < CPDF_PSEngine::kPSEngineStackSize) {
+      stack_.push_back(reg);
+    }
+  }
+
+  // Mirrors CPDF_PSEngine::Pop().
+  uint32_t Pop() {
+    if (stack_.empty()) {
+      return NewConstant(0);
+    }
+    const uint32_t reg = stack_.back();
+    stack_.pop_back();
+    return reg;
+  }
+
+  uint32_t NewRegister(std::optional<float> constant) {
+    constants_.push_back(constant);
+    return static_cast<uint32_t>(constants_.size() - 1);
+  }
+
+  uint32_t NewConstant(float value) { return NewRegister(value); }
+
+  uint32_t EmitUnary(PDF_PSOP op, uint32_t src) {
+    if (constants_[src].has_value()) {
+      return NewConstant(
+          CPDF_PSEngine::DoUnaryOperator(op, constants_[src].value()));
+    }
+    const uint32_t dest = NewRegister(std::nullopt);
+    code_.push_back({Opcode::kUnary, op, dest, src, 0});
+    return dest;
+  }
+
+  uint32_t EmitBinary(PDF_PSOP op, uint32_t below, uint32_t top) {
+    if (constants_[below].has_value() && constants_[top].has_value()) {
+      return NewConstant(CPDF_PSEngine::DoBinaryOperator(
+          op, constants_[below].value(), constants_[top].value()));
+    }
+    const uint32_t dest = NewRegister(std::nullopt);
+    code_.push_back({Opcode::kBinary, op, dest, below, top});
+    return dest;
+  }
+
+  // Returns the integer operand of `copy`, `index` or `roll`, which must be
+  // known at compile time.
+  std::optional<int> PopConstantInt() {
+    const uint32_t reg = Pop();
+    if (!constants_[reg].has_value()) {
+      return std::nullopt;
+    }
+    return static_cast<int>(constants_[reg].value());
+  }
+
+  // Mirrors CPDF_PSEngine::DoOperator().
+  bool CompileOperator(PDF_PSOP op) {
+    if (CPDF_PSEngine::IsUnaryOperator(op)) {
+      Push(EmitUnary(op, Pop()));
+      return true;
+    }
+    if (CPDF_PSEngine::IsBinaryOperator(op)) {
+      const uint32_t top = Pop();
+      const uint32_t below = Pop();
+      Push(EmitBinary(op, below, top));
+      return true;
+    }
+
+    switch (op) {
+      case PSOP_TRUE:
+        Push(NewConstant(1));
+        return true;
+      case PSOP_FALSE:
+        Push(NewConstant(0));
+        return true;
+      case PSOP_POP:
+        Pop();
+        return true;
+      case PSOP_EXCH: {
+        const uint32_t top = Pop();
+        const uint32_t below = Pop();
+        Push(top);
+        Push(below);
+        return true;
+      }
+      case PSOP_DUP: {
+        const uint32_t top = Pop();
+        Push(top);
+        Push(top);
+        return true;
+      }
+      case PSOP_COPY: {
+        std::optional<int> n = PopConstantInt();
+        if (!n.has_value()) {
+          return false;
+        }
+        const int size = static_cast<int>(stack_.size());
+        if (n.value() < 0 ||
+            size + n.value() >
+                static_cast<int>(CPDF_PSEngine::kPSEngineStackSize) ||
+            n.value() > size) {
+          return true;
+        }
+        for (int i = 0; i < n.value(); ++i) {
+          const uint32_t reg = stack_[size - n.value() + i];
+          stack_.push_back(reg);
+        }
+        return true;
+      }
+      case PSOP_INDEX: {
+        std::optional<int> n = PopConstantInt();
+        if (!n.has_value()) {
+          return false;
+        }
+        const int size = static_cast<int>(stack_.size());
+        if (n.value() < 0 || n.value() >= size) {
+          return true;
+        }
+        Push(stack_[size - n.value() - 1]);
+        return true;
+      }
+      case PSOP_ROLL: {
+        std::optional<int> j = PopConstantInt();
+        std::optional<int> n = PopConstantInt();
+        if (!j.has_value() || !n.has_value()) {
+          return false;
+        }
+        const int size = static_cast<int>(stack_.size());
+        if (j.value() == 0 || n.value() == 0 || size == 0) {
+          return true;
+        }
+        if (n.value() < 0 || n.value() > size) {
+          return true;
+        }
+        int shift = j.value() % n.value();
+        if (shift > 0) {
+          shift -= n.value();
+        }
+        auto begin_it = stack_.end() - n.value();
+        std::rotate(begin_it, begin_it - shift, stack_.end());
+        return true;
+      }
+      default:
+        // Includes PSOP_CVR, which is a no-op.
+        return true;
+    }
+  }
+
+  // Compiles `if` when `false_proc` is null, and `ifelse` otherwise.
+  bool CompileIf(uint32_t condition,
+                 const CPDF_PSProc& true_proc,
+                 const CPDF_PSProc* false_proc) {
+    if (constants_[condition].has_value()) {
+      if (static_cast<int>(constants_[condition].value())) {
+        return CompileProc(true_proc);
+      }
+      return !false_proc || CompileProc(*false_proc);
+    }
+
+    std::vector<Instruction> outer_code = std::move(code_);
+    const std::vector<uint32_t> initial_stack = stack_;
+
+    code_.clear();
+    if (!CompileProc(true_proc)) {
+      return false;
+    }
+    std::vector<Instruction> true_code = std::move(code_);
+    std::vector<uint32_t> true_stack = std::move(stack_);
+
+    code_.clear();
+    stack_ = initial_stack;
+    if (false_proc && !CompileProc(*false_proc)) {
+      return false;
+    }
+    std::vector<Instruction> false_code = std::move(code_);
+
+    // Both branches must leave the same number of values, so that the stack
+    // depth stays known. Values that differ get merged into a new register.
+    if (true_stack.size() != stack_.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < stack_.size(); ++i) {
+      if (true_stack[i] == stack_[i]) {
+        continue;
+      }
+      const uint32_t merged = NewRegister(std::nullopt);
+      true_code.push_back({Opcode::kMove, PSOP_PROC, merged, true_stack[i], 0});
+      false_code.push_back({Opcode::kMove, PSOP_PROC, merged, stack_[i], 0});
+      stack_[i] = merged;
+    }
+
+    code_ = std::move(outer_code);
+    const bool need_jump = !false_code.empty();
+    const uint32_t true_size =
+        static_cast<uint32_t>(true_code.size()) + (need_jump ? 1 : 0);
+    code_.push_back({Opcode::kJumpIfZero, PSOP_PROC, true_size, condition, 0});
+    code_.insert(code_.end(), true_code.begin(), true_code.end());
+    if (need_jump) {
+      code_.push_back({Opcode::kJump, PSOP_PROC,
+                       static_cast<uint32_t>(false_code.size()), 0, 0});
+      code_.insert(code_.end(), false_code.begin(), false_code.end());
+    }
+    return true;
+  }
+
+  // Only valid for code without jumps.
+  void RemoveDeadCode(pdfium::span<const uint32_t> outputs) {
+    std::vector<bool> live(constants_.size());
+    for (uint32_t reg : outputs) {
+      live[reg] = true;
+    }
+    std::vector<Instruction> kept;
+    for (auto it = code_.rbegin(); it != code_.rend(); ++it) {
+      if (!live[it->dest]) {
+        continue;
+      }
+      live[it->src1] = true;
+      if (it->opcode == Opcode::kBinary) {
+        live[it->src2] = true;
+      }
+      kept.push_back(*it);
+    }
+    std::ranges::reverse(kept);
+    code_ = std::move(kept);
+  }
+
+  // Only valid for code without jumps. Returns an empty vector if any output
+  // is not affine.
+  std::vector<AffineOutput> GetAffineOutputs(
+      pdfium::span<const uint32_t> outputs) const {
+    std::vector<std::optional<size_t>> definitions(constants_.size());
+    for (size_t i = 0; i < code_.size(); ++i) {
+      definitions[code_[i].dest] = i;
+    }
+
+    std::vector<AffineOutput> result;
+    for (uint32_t reg : outputs) {
+      std::optional<AffineOutput> affine = GetAffineOutput(reg, definitions);
+      if (!affine.has_value()) {
+        return {};
+      }
+      result.push_back(affine.value());
+    }
+    return result;
+  }
+
+  // Every transformation here must produce exactly the same float as the
+  // instructions it replaces. E.g. `c - (x * s)` equals `(x * -s) + c`.
+  std::optional<AffineOutput> GetAffineOutput(
+      uint32_t reg,
+      pdfium::span<const std::optional<size_t>> definitions) const {
+    if (constants_[reg].has_value()) {
+      return AffineOutput{.constant = constants_[reg].value()};
+    }
+    if (!definitions[reg].has_value()) {
+      // An input.
+      return AffineOutput{.has_input = true, .input = reg};
+    }
+
+    const Instruction& inst = code_[definitions[reg].value()];
+    if (inst.opcode == Opcode::kUnary) {
+      if (inst.op != PSOP_NEG) {
+        return std::nullopt;
+      }
+      std::optional<AffineOutput> inner =
+          GetScaledInput(inst.src1, definitions);
+      if (!inner.has_value()) {
+        return std::nullopt;
+      }
+      return Negate(inner.value());
+    }
+
+    const std::optional<float> below = constants_[inst.src1];
+    const std::optional<float> top = constants_[inst.src2];
+    if (below.has_value() == top.has_value()) {
+      return std::nullopt;
+    }
+    const float constant = below.has_value() ? below.value() : top.value();
+    const uint32_t other = below.has_value() ? inst.src2 : inst.src1;
+    switch (inst.op) {
+      case PSOP_MUL: {
+        // Scales only combine exactly if the first one just flips the sign.
+        std::optional<AffineOutput> inner = GetScaledInput(other, definitions);
+        if (!inner.has_value() ||
+            (inner.value().has_scale && inner.value().scale != -1.0f)) {
+          return std::nullopt;
+        }
+        AffineOutput result = inner.value();
+        result.scale = result.has_scale ? -constant : constant;
+        result.has_scale = true;
+        return result;
+      }
+      case PSOP_ADD:
+      case PSOP_SUB: {
+        std::optional<AffineOutput> inner = GetScaledInput(other, definitions);
+        if (!inner.has_value()) {
+          return std::nullopt;
+        }
+        AffineOutput result = inner.value();
+        if (inst.op == PSOP_SUB && below.has_value()) {
+          result = Negate(result);
+        }
+        result.has_offset = true;
+        result.offset =
+            inst.op == PSOP_SUB && top.has_value() ? -constant : constant;
+        return result;
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+
+  // Returns `reg` as an input, optionally scaled, but without an offset.
+  std::optional<AffineOutput> GetScaledInput(
+      uint32_t reg,
+      pdfium::span<const std::optional<size_t>> definitions) const {
+    std::optional<AffineOutput> result = GetAffineOutput(reg, definitions);
+    if (!result.has_value() || !result.value().has_input ||
+        result.value().has_offset) {
+      return std::nullopt;
+    }
+    return result;
+  }
+
+  static AffineOutput Negate(AffineOutput value) {
+    value.scale = value.has_scale ? -value.scale : -1.0f;
+    value.has_scale = true;
+    return value;
+  }
+
+  std::vector<Instruction> code_;
+  std::vector<uint32_t> stack_;
+  // Indexed by register. Holds values for registers that are constants.
+  std::vector<std::optional<float>> constants_;
+};
+
+// static
+std::unique_ptr<CPDF_PSProgram> CPDF_PSProgram::Compile(
+    const CPDF_PSProc& proc,
+    uint32_t input_count,
+    uint32_t output_count) {
+  Compiler compiler(input_count);
+  if (!compiler.CompileProc(proc)) {
+    return nullptr;
+  }
+
+  auto program = std::unique_ptr<CPDF_PSProgram>(
+      new CPDF_PSProgram(input_count, output_count));
+  if (!compiler.Finish(output_count, program.get())) {
+    return nullptr;
+  }
+  return program;
+}
+
+CPDF_PSProgram::CPDF_PSProgram(uint32_t input_count, uint32_t output_count)
+    : input_count_(input_count), output_count_(output_count) {}
+
+CPDF_PSProgram::~CPDF_PSProgram() = default;
+
+void CPDF_PSProgram::Run(size_t count,
+                         pdfium::span<const float> inputs,
+                         pdfium::span<float> results) const {
+  for (size_t i = 0; i < count; ++i) {
+    pdfium::span<const float> point_inputs =
+        inputs.subspan(i * input_count_, input_count_);
+    pdfium::span<float> point_results =
+        results.subspan(i * output_count_, output_count_);
+    if (!affine_outputs_.empty()) {
+      RunAffine(point_inputs, point_results);
+    } else {
+      RunCode(point_inputs, point_results);
+    }
+  }
+}
+
+void CPDF_PSProgram::RunAffine(pdfium::span<const float> inputs,
+                               pdfium::span<float> results) const {
+  for (size_t i = 0; i < affine_outputs_.size(); ++i) {
+    const AffineOutput& output = affine_outputs_[i];
+    float value = output.has_input ? inputs[output.input] : output.constant;
+    // Separate statements, so the compiler does not fuse them into a
+    // multiply-add, which would round differently than CPDF_PSEngine.
+    if (output.has_scale) {
+      value = value * output.scale;
+    }
+    if (output.has_offset) {
+      value = value + output.offset;
+    }
+    results[i] = value;
+  }
+}
+
+void CPDF_PSProgram::RunCode(pdfium::span<const float> inputs,
+                             pdfium::span<float> results) const {
+  // Inputs beyond the stack size never get used.
+  const size_t used_inputs =
+      std::min<size_t>(inputs.size(), CPDF_PSEngine::kPSEngineStackSize);
+  for (size_t i = 0; i < used_inputs; ++i) {
+    registers_[i] = inputs[i];
+  }
+
+  for (size_t pc = 0; pc < code_.size(); ++pc) {
+    const Instruction& inst = code_[pc];
+    switch (inst.opcode) {
+      case Opcode::kUnary:
+        registers_[inst.dest] =
+            CPDF_PSEngine::DoUnaryOperator(inst.op, registers_[inst.src1]);
+        break;
+      case Opcode::kBinary:
+        registers_[inst.dest] = CPDF_PSEngine::DoBinaryOperator(
+            inst.op, registers_[inst.src1], registers_[inst.src2]);
+        break;
+      case Opcode::kMove:
+        registers_[inst.dest] = registers_[inst.src1];
+        break;
+      case Opcode::kJumpIfZero:
+        if (!static_cast<int>(registers_[inst.src1])) {
+          pc += inst.dest;
+        }
+        break;
+      case Opcode::kJump:
+        pc += inst.dest;
+        break;
+    }
+  }
+
+  for (size_t i = 0; i < output_registers_.size(); ++i) {
+    results[i] = registers_[output_registers_[i]];
+  }
+}
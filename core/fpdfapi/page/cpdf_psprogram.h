@@ -0,0 +1,94 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
+#define CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fxcrt/span.h"
+
+// A PostScript calculator function compiled from a CPDF_PSProc tree into flat
+// register code. All stack manipulation is resolved at compile time and
+// constant subexpressions are folded, so running the program gives the same
+// results as CPDF_PSEngine, bit for bit, without maintaining a stack.
+//
+// Programs whose outputs are each a constant, or an input optionally scaled
+// and offset by constants, do not run any code at all. This covers channel
+// permutations and linear tint ramps.
+class CPDF_PSProgram {
+ public:
+  // Returns nullptr if `proc` cannot be compiled, in which case the caller
+  // should keep interpreting it. That happens when the stack depth depends on
+  // the inputs, when `copy`, `index` or `roll` get computed operands, or when
+  // executing `proc` leaves fewer than `output_count` values on the stack.
+  static std::unique_ptr<CPDF_PSProgram> Compile(const CPDF_PSProc& proc,
+                                                 uint32_t input_count,
+                                                 uint32_t output_count);
+
+  ~CPDF_PSProgram();
+
+  // Runs the program for `count` sets of inputs stored back to back in
+  // `inputs`, and writes `count` sets of outputs back to back to `results`.
+  void Run(size_t count,
+           pdfium::span<const float> inputs,
+           pdfium::span<float> results) const;
+
+  bool IsAffineForTesting() const { return !affine_outputs_.empty(); }
+  size_t InstructionCountForTesting() const { return code_.size(); }
+
+ private:
+  class Compiler;
+
+  enum class Opcode : uint8_t {
+    kUnary,
+    kBinary,
+    kMove,
+    // Jumps skip the next `dest` instructions.
+    kJumpIfZero,
+    kJump,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    PDF_PSOP op;
+    uint32_t dest;
+    uint32_t src1;
+    uint32_t src2;
+  };
+
+  // output = ((input * scale) + offset), with each step being optional, or
+  // `constant` if there is no input.
+  struct AffineOutput {
+    bool has_input;
+    bool has_scale;
+    bool has_offset;
+    uint32_t input;
+    float constant;
+    float scale;
+    float offset;
+  };
+
+  CPDF_PSProgram(uint32_t input_count, uint32_t output_count);
+
+  void RunAffine(pdfium::span<const float> inputs,
+                 pdfium::span<float> results) const;
+  void RunCode(pdfium::span<const float> inputs,
+               pdfium::span<float> results) const;
+
+  const uint32_t input_count_;
+  const uint32_t output_count_;
+  std::vector<Instruction> code_;
+  std::vector<uint32_t> output_registers_;
+  std::vector<AffineOutput> affine_outputs_;
+  // Holds the constants. Scratch space for everything else.
+  mutable std::vector<float> registers_;
+};
+
+#endif  // CORE_FPDFAPI_PAGE_CPDF_PSPROGRAM_H_
@@ -0,0 +1,261 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fxcrt/bytestring.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr uint32_t kMaxInputs = 4;
+
+std::vector<float> Interpret(CPDF_PSEngine* engine,
+                             pdfium::span<const float> inputs,
+                             uint32_t output_count) {
+  engine->Reset();
+  for (float input : inputs) {
+    engine->Push(input);
+  }
+  engine->Execute();
+  if (engine->GetStackSize() < output_count) {
+    return {};
+  }
+  std::vector<float> results(output_count);
+  for (uint32_t i = 0; i < output_count; ++i) {
+    results[output_count - i - 1] = engine->Pop();
+  }
+  return results;
+}
+
+bool SameFloat(float a, float b) {
+  return (isnan(a) && isnan(b)) || memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Checks that the compiled program for `source` matches the interpreter.
+// Returns the program, or nullptr if it did not compile.
+std::unique_ptr<CPDF_PSProgram> CheckProgram(const ByteString& source,
+                                             uint32_t input_count,
+                                             uint32_t output_count) {
+  static constexpr float kInputs[][kMaxInputs] = {
+      {0, 0, 0, 0},        {1, 1, 1, 1},       {0.5f, 0.25f, 0.75f, 1},
+      {0.1f, 0.9f, 0, 1},  {-3, 7.5f, 2, -1},  {100, -100, 0.001f, 42},
+      {1, 0, 1, 0},        {0, 1, 0, 1},
+  };
+
+  CPDF_PSEngine engine;
+  if (!engine.Parse(source.unsigned_span())) {
+    return nullptr;
+  }
+  std::unique_ptr<CPDF_PSProgram> program =
+      CPDF_PSProgram::Compile(engine.main_proc(), input_count, output_count);
+
+  std::vector<float> batch_inputs;
+  std::vector<std::vector<float>> expected_results;
+  for (const auto& input_set : kInputs) {
+    auto inputs = pdfium::span(input_set).first(input_count);
+    std::vector<float> expected = Interpret(&engine, inputs, output_count);
+    if (!program) {
+      continue;
+    }
+    EXPECT_EQ(output_count, expected.size()) << source;
+    if (expected.size() != output_count) {
+      return program;
+    }
+
+    std::vector<float> results(output_count);
+    program->Run(1, inputs, results);
+    for (uint32_t i = 0; i < output_count; ++i) {
+      EXPECT_TRUE(SameFloat(expected[i], results[i]))
+          << source << ": output " << i << " is " << results[i]
+          << ", expected " << expected[i];
+    }
+    batch_inputs.insert(batch_inputs.end(), inputs.begin(), inputs.end());
+    expected_results.push_back(std::move(expected));
+  }
+
+  if (program) {
+    std::vector<float> batch_results(expected_results.size() * output_count);
+    program->Run(expected_results.size(), batch_inputs, batch_results);
+    for (size_t i = 0; i < expected_results.size(); ++i) {
+      for (uint32_t j = 0; j < output_count; ++j) {
+        EXPECT_TRUE(SameFloat(expected_results[i][j],
+                              batch_results[i * output_count + j]))
+            << source;
+      }
+    }
+  }
+  return program;
+}
+
+// Deterministic pseudo-random generator, so failures are reproducible.
+class Lcg {
+ public:
+  explicit Lcg(uint32_t seed) : state_(seed) {}
+
+  uint32_t Next(uint32_t bound) {
+    state_ = state_ * 1664525u + 1013904223u;
+    return (state_ >> 8) % bound;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+void AppendRandomProc(Lcg* rng, int depth, std::string* source) {
+  static constexpr const char* kWords[] = {
+      "add",  "sub",      "mul",   "div",   "idiv",  "mod",  "neg",
+      "abs",  "ceiling",  "floor", "round", "sqrt",  "sin",  "cos",
+      "atan", "exp",      "ln",    "log",   "cvi",   "cvr",  "eq",
+      "ne",   "gt",       "ge",    "lt",    "le",    "and",  "or",
+      "xor",  "not",      "true",  "false", "pop",   "exch", "dup",
+      "1",    "0",        "0.5",   "2",     "-1",    "3",    "255",
+      "bitshift", "truncate",
+  };
+  source->append("{");
+  const uint32_t length = 1 + rng->Next(12);
+  for (uint32_t i = 0; i < length; ++i) {
+    const uint32_t choice = rng->Next(20);
+    if (choice == 0 && depth < 3) {
+      AppendRandomProc(rng, depth + 1, source);
+      source->append(" if ");
+    } else if (choice == 1 && depth < 3) {
+      AppendRandomProc(rng, depth + 1, source);
+      AppendRandomProc(rng, depth + 1, source);
+      source->append(" ifelse ");
+    } else if (choice == 2) {
+      // Stack operators with constant operands.
+      static constexpr const char* kStackOps[] = {
+          "2 copy", "1 index", "3 2 roll", "3 -1 roll", "0 index", "4 copy",
+      };
+      source->append(kStackOps[rng->Next(std::size(kStackOps))]);
+      source->append(" ");
+    } else {
+      source->append(kWords[rng->Next(std::size(kWords))]);
+      source->append(" ");
+    }
+  }
+  source->append("}");
+}
+
+}  // namespace
+
+TEST(CPDFPSProgramTest, Arithmetic) {
+  EXPECT_TRUE(CheckProgram("{ 2 mul 1 add }", 1, 1));
+  EXPECT_TRUE(CheckProgram("{ add 2 div sqrt }", 2, 1));
+  EXPECT_TRUE(CheckProgram("{ atan exch 3 exp exch }", 3, 2));
+  EXPECT_TRUE(CheckProgram("{ 7 idiv exch 3 mod }", 2, 2));
+  EXPECT_TRUE(CheckProgram("{ 0 div 5 bitshift -2 bitshift }", 2, 1));
+}
+
+TEST(CPDFPSProgramTest, ConstantFolding) {
+  auto program = CheckProgram("{ 2 3 add mul 90 sin 0.5 mul sub }", 1, 1);
+  ASSERT_TRUE(program);
+  // Folds into `x * 5 - 0.5`, which needs no code.
+  EXPECT_EQ(0u, program->InstructionCountForTesting());
+  EXPECT_TRUE(program->IsAffineForTesting());
+
+  program = CheckProgram("{ 1 2 3 pop pop pop 4 5 mul }", 1, 2);
+  ASSERT_TRUE(program);
+  EXPECT_EQ(0u, program->InstructionCountForTesting());
+}
+
+TEST(CPDFPSProgramTest, AffinePrograms) {
+  // Linear tint ramps.
+  static constexpr struct {
+    const char* source;
+    uint32_t output_count;
+  } kRamps[] = {
+      {"{ dup 0.5 mul exch 1 exch sub 0 }", 3},
+      {"{ dup neg 1 add exch 0.25 mul 0.1 sub 1 index }", 3},
+      {"{ 0.3 mul 0.2 exch sub }", 1},
+      {"{ neg 0.7 mul }", 1},
+  };
+  for (const auto& ramp : kRamps) {
+    auto program = CheckProgram(ramp.source, 1, ramp.output_count);
+    ASSERT_TRUE(program) << ramp.source;
+    EXPECT_TRUE(program->IsAffineForTesting()) << ramp.source;
+  }
+
+  // Channel permutations.
+  auto program = CheckProgram("{ 3 1 roll exch }", 3, 3);
+  ASSERT_TRUE(program);
+  EXPECT_TRUE(program->IsAffineForTesting());
+  program = CheckProgram("{ pop 2 copy 1 }", 4, 5);
+  ASSERT_TRUE(program);
+  EXPECT_TRUE(program->IsAffineForTesting());
+
+  program = CheckProgram("{ dup mul }", 1, 1);
+  ASSERT_TRUE(program);
+  EXPECT_FALSE(program->IsAffineForTesting());
+}
+
+TEST(CPDFPSProgramTest, Conditionals) {
+  EXPECT_TRUE(CheckProgram("{ dup 0.5 gt { 1 sub } if }", 1, 1));
+  EXPECT_TRUE(
+      CheckProgram("{ dup 0.5 lt { 2 mul 0 } { 1 exch sub 1 } ifelse }", 1, 2));
+  EXPECT_TRUE(CheckProgram(
+      "{ 2 copy gt { exch } if dup 0 eq { pop 1 } { 0.5 add } ifelse }", 2,
+      2));
+  EXPECT_TRUE(CheckProgram(
+      "{ dup 0.25 ge { dup 0.75 le { 0.5 } { 1 } ifelse } { 0 } ifelse }", 1,
+      2));
+  // Constant conditions are resolved at compile time.
+  auto program = CheckProgram("{ true { 2 mul } { 3 mul } ifelse }", 1, 1);
+  ASSERT_TRUE(program);
+  EXPECT_TRUE(program->IsAffineForTesting());
+}
+
+TEST(CPDFPSProgramTest, MalformedPrograms) {
+  // Stack underflow produces zeros.
+  EXPECT_TRUE(CheckProgram("{ pop pop add 1 }", 1, 2));
+  EXPECT_TRUE(CheckProgram("{ exch dup }", 0, 2));
+  // Too many values for the stack.
+  std::string source = "{";
+  for (int i = 0; i < 120; ++i) {
+    source += " 1 add dup";
+  }
+  source += " }";
+  EXPECT_TRUE(CheckProgram(ByteString(source.c_str()), 1, 3));
+  // `if` without a procedure stops the procedure.
+  EXPECT_TRUE(CheckProgram("{ 1 if 2 }", 1, 1));
+  EXPECT_TRUE(CheckProgram("{ dup { 1 if 5 } { 1 } ifelse 2 }", 1, 3));
+  // Invalid stack operator operands are ignored.
+  EXPECT_TRUE(CheckProgram("{ -1 copy 10 index 5 0 roll 9 2 roll }", 2, 2));
+}
+
+TEST(CPDFPSProgramTest, Uncompilable) {
+  // Computed operands for stack operators.
+  EXPECT_FALSE(CheckProgram("{ dup cvi copy }", 1, 1));
+  EXPECT_FALSE(CheckProgram("{ 1 index 2 exch roll }", 2, 1));
+  // Stack depth depends on the input.
+  EXPECT_FALSE(CheckProgram("{ dup 0.5 gt { 1 } if }", 1, 1));
+  // Not enough outputs.
+  EXPECT_FALSE(CheckProgram("{ pop }", 1, 1));
+}
+
+TEST(CPDFPSProgramTest, MatchesInterpreter) {
+  Lcg rng(0x50534650);
+  int compiled_count = 0;
+  for (int i = 0; i < 2000; ++i) {
+    std::string source;
+    AppendRandomProc(&rng, 0, &source);
+    const uint32_t input_count = 1 + rng.Next(kMaxInputs);
+    const uint32_t output_count = 1 + rng.Next(4);
+    if (CheckProgram(ByteString(source.c_str()), input_count, output_count)) {
+      ++compiled_count;
+    }
+  }
+  // Many random programs should compile, or this test is not testing much.
+  EXPECT_GT(compiled_count, 500);
+}
@@ -7,10 +7,14 @@
 #ifndef CORE_FPDFAPI_PAGE_CPDF_SAMPLEDFUNC_H_
 #define CORE_FPDFAPI_PAGE_CPDF_SAMPLEDFUNC_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <vector>
 
 #include "core/fpdfapi/page/cpdf_function.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 
 class CPDF_StreamAcc;
 
@@ -34,6 +38,9 @@ class CPDF_SampledFunc final : public CPDF_Function {
   bool v_Init(const CPDF_Object* pObj, VisitedSet* pVisited) override;
   bool v_Call(pdfium::span<const float> inputs,
               pdfium::span<float> results) const override;
+  bool v_CallBatch(size_t count,
+                   pdfium::span<const float> inputs,
+                   pdfium::span<float> results) const override;
 
   const std::vector<SampleEncodeInfo>& GetEncodeInfo() const {
     return encode_info_;
@@ -45,6 +52,9 @@ class CPDF_SampledFunc final : public CPDF_Function {
 #endif
 
  private:
+  uint32_t ReadSample(pdfium::span<const uint8_t> sample_data,
+                      uint32_t bit_offset) const;
+
   std::vector<SampleEncodeInfo> encode_info_;
   std::vector<SampleDecodeInfo> decode_info_;
   uint32_t bits_per_sample_ = 0;
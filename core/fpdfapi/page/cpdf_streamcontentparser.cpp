@@ -403,6 +403,8 @@ CPDF_StreamContentParser::CPDF_StreamContentParser(
                                                 pParentResources.Get(),
                                                 pPageResources.Get())),
       object_holder_(pObjHolder),
+      text_only_(pObjHolder->GetParseMode() ==
+                 CPDF_PageObjectHolder::ParseMode::kTextOnly),
       recursion_state_(recursion_state),
       bbox_(rcBBox),
       cur_states_(std::make_unique<CPDF_AllStates>()) {
@@ -691,6 +693,10 @@ void CPDF_StreamContentParser::Handle_BeginImage() {
       break;
     }
   }
+  if (text_only_) {
+    return;
+  }
+
   CPDF_ImageObject* pObj = AddImageFromStream(std::move(pStream), /*name=*/"");
   // Record the bounding box of this image, so rendering code can draw it
   // properly.
@@ -791,7 +797,7 @@ void CPDF_StreamContentParser::Handle_ExecuteXObject() {
     return;
   }
 
-  if (type == "Image") {
+  if (type == "Image" && !text_only_) {
     CPDF_ImageObject* pObj =
         pXObject->IsInline()
             ? AddImageFromStream(ToStream(pXObject->Clone()), name)
@@ -816,6 +822,7 @@ void CPDF_StreamContentParser::AddForm(RetainPtr<CPDF_Stream> pStream,
   status.mutable_text_state() = cur_states_->text_state();
   auto form = std::make_unique<CPDF_Form>(document_, page_resources_,
                                           std::move(pStream), resources_.Get());
+  form->SetParseMode(object_holder_->GetParseMode());
   form->ParseContent(&status, nullptr, recursion_state_);
 
   CFX_Matrix matrix =
@@ -1153,6 +1160,10 @@ void CPDF_StreamContentParser::Handle_SetColorPS_Stroke() {
 }
 
 void CPDF_StreamContentParser::Handle_ShadeFill() {
+  if (text_only_) {
+    return;
+  }
+
   RetainPtr<CPDF_ShadingPattern> pShading = FindShading(GetString(0));
   if (!pShading) {
     return;
@@ -1347,7 +1358,7 @@ void CPDF_StreamContentParser::AddTextObject(
         pText->CalcPositionData(cur_states_->text_horz_scale());
     cur_states_->IncrementTextPositionX(position.x);
     cur_states_->IncrementTextPositionY(position.y);
-    if (TextRenderingModeIsClipMode(text_mode)) {
+    if (TextRenderingModeIsClipMode(text_mode) && !text_only_) {
       clip_text_list_.push_back(pText->Clone());
     }
     object_holder_->AppendPageObject(std::move(pText));
@@ -1526,6 +1537,12 @@ void CPDF_StreamContentParser::Handle_Invalid() {}
 
 void CPDF_StreamContentParser::AddPathPoint(const CFX_PointF& point,
                                             CFX_Path::Point::Type type) {
+  // Without any points, painting and clipping operators become no-ops, so this
+  // is all it takes to skip paths and clips.
+  if (text_only_) {
+    return;
+  }
+
   // If the path point is the same move as the previous one and neither of them
   // closes the path, then just skip it.
   if (type == CFX_Path::Point::Type::kMove && !path_points_.empty() &&
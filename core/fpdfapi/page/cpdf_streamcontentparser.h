@@ -214,6 +214,7 @@ class CPDF_StreamContentParser {
   RetainPtr<CPDF_Dictionary> const parent_resources_;
   RetainPtr<CPDF_Dictionary> const resources_;
   UnownedPtr<CPDF_PageObjectHolder> const object_holder_;
+  const bool text_only_;
   UnownedPtr<CPDF_Form::RecursionState> const recursion_state_;
   CFX_Matrix mt_content_to_user_;
   const CFX_FloatRect bbox_;
@@ -110,10 +110,12 @@ int CPDF_TextObject::CountWords() const {
   RetainPtr<CPDF_Font> font = GetFont();
   bool bInLatinWord = false;
   int nWords = 0;
+  WideString swUnicode;
   for (size_t i = 0, sz = CountChars(); i < sz; ++i) {
     uint32_t charcode = GetCharCode(i);
 
-    WideString swUnicode = font->UnicodeFromCharCode(charcode);
+    swUnicode.clear();
+    font->AppendUnicodeFromCharCode(charcode, &swUnicode);
     uint16_t unicode = 0;
     if (swUnicode.GetLength() > 0) {
       unicode = swUnicode[0];
@@ -138,10 +140,12 @@ WideString CPDF_TextObject::GetWordString(int nWordIndex) const {
   WideString swRet;
   int nWords = 0;
   bool bInLatinWord = false;
+  WideString swUnicode;
   for (size_t i = 0, sz = CountChars(); i < sz; ++i) {
     uint32_t charcode = GetCharCode(i);
 
-    WideString swUnicode = font->UnicodeFromCharCode(charcode);
+    swUnicode.clear();
+    font->AppendUnicodeFromCharCode(charcode, &swUnicode);
     uint16_t unicode = 0;
     if (swUnicode.GetLength() > 0) {
       unicode = swUnicode[0];
@@ -0,0 +1,176 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/parser/cpdf_async_file_reader.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/containers/contains.h"
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/span_util.h"
+
+CPDF_AsyncFileReader::CPDF_AsyncFileReader(Delegate* delegate,
+                                           FX_FILESIZE file_size)
+    : delegate_(delegate), file_size_(std::max<FX_FILESIZE>(file_size, 0)) {
+  DCHECK(delegate_);
+}
+
+CPDF_AsyncFileReader::~CPDF_AsyncFileReader() = default;
+
+bool CPDF_AsyncFileReader::CompleteRead(uint32_t request_id,
+                                        pdfium::span<const uint8_t> data) {
+  auto it = pending_reads_.find(request_id);
+  if (it == pending_reads_.end()) {
+    return false;
+  }
+
+  const PendingRead read = it->second;
+  pending_reads_.erase(it);
+  for (uint32_t i = 0; i < read.block_count; ++i) {
+    requested_blocks_.erase(read.first_block + i);
+  }
+
+  size_t expected_size = 0;
+  for (uint32_t i = 0; i < read.block_count; ++i) {
+    expected_size += GetBlockLength(read.first_block + i);
+  }
+  if (data.size() != expected_size) {
+    MarkFailed(read);
+    return data.empty();
+  }
+
+  for (uint32_t i = 0; i < read.block_count; ++i) {
+    const uint32_t block = read.first_block + i;
+    const size_t length = GetBlockLength(block);
+    blocks_[block] = DataVector<uint8_t>(data.begin(), data.begin() + length);
+    data = data.subspan(length);
+  }
+  return true;
+}
+
+FX_FILESIZE CPDF_AsyncFileReader::GetSize() {
+  return file_size_;
+}
+
+bool CPDF_AsyncFileReader::ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                                             FX_FILESIZE offset) {
+  uint32_t first_block;
+  uint32_t end_block;
+  if (buffer.empty() ||
+      !GetBlockRange(offset, buffer.size(), &first_block, &end_block)) {
+    return false;
+  }
+
+  for (uint32_t block = first_block; block < end_block; ++block) {
+    auto it = blocks_.find(block);
+    if (it == blocks_.end()) {
+      return false;
+    }
+    const FX_FILESIZE block_start =
+        static_cast<FX_FILESIZE>(block) * kBlockSize;
+    pdfium::span<const uint8_t> src = it->second;
+    if (offset > block_start) {
+      src = src.subspan(static_cast<size_t>(offset - block_start));
+    }
+    const size_t copy_size = std::min(src.size(), buffer.size());
+    buffer = fxcrt::spancpy(buffer, src.first(copy_size));
+    offset += copy_size;
+  }
+  return true;
+}
+
+bool CPDF_AsyncFileReader::IsDataAvail(FX_FILESIZE offset, size_t size) {
+  uint32_t first_block;
+  uint32_t end_block;
+  if (!GetBlockRange(offset, size, &first_block, &end_block)) {
+    return false;
+  }
+
+  for (uint32_t block = first_block; block < end_block; ++block) {
+    if (!pdfium::Contains(blocks_, block) &&
+        !pdfium::Contains(failed_blocks_, block)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void CPDF_AsyncFileReader::AddSegment(FX_FILESIZE offset, size_t size) {
+  uint32_t first_block;
+  uint32_t end_block;
+  if (!GetBlockRange(offset, size, &first_block, &end_block)) {
+    return;
+  }
+
+  // Issue one read per run of blocks that are neither present nor in flight.
+  // Collect them first, since the delegate may complete reads synchronously.
+  std::vector<PendingRead> reads;
+  for (uint32_t block = first_block; block < end_block; ++block) {
+    if (pdfium::Contains(blocks_, block) ||
+        pdfium::Contains(failed_blocks_, block) ||
+        pdfium::Contains(requested_blocks_, block)) {
+      continue;
+    }
+    if (!reads.empty() &&
+        reads.back().first_block + reads.back().block_count == block) {
+      ++reads.back().block_count;
+    } else {
+      reads.push_back({block, 1});
+    }
+    requested_blocks_.insert(block);
+  }
+
+  for (const PendingRead& read : reads) {
+    const uint32_t request_id = next_request_id_++;
+    pending_reads_[request_id] = read;
+
+    size_t read_size = 0;
+    for (uint32_t i = 0; i < read.block_count; ++i) {
+      read_size += GetBlockLength(read.first_block + i);
+    }
+    delegate_->ReadAsync(
+        static_cast<FX_FILESIZE>(read.first_block) * kBlockSize, read_size,
+        request_id);
+  }
+}
+
+bool CPDF_AsyncFileReader::GetBlockRange(FX_FILESIZE offset,
+                                         size_t size,
+                                         uint32_t* first_block,
+                                         uint32_t* end_block) const {
+  FX_SAFE_FILESIZE safe_end = offset;
+  safe_end += size;
+  if (offset < 0 || !safe_end.IsValid()) {
+    return false;
+  }
+  const FX_FILESIZE end = safe_end.ValueOrDie();
+  if (end > file_size_) {
+    return false;
+  }
+
+  const FX_FILESIZE last = std::max<FX_FILESIZE>(end - 1, offset);
+  *first_block = pdfium::checked_cast<uint32_t>(offset / kBlockSize);
+  *end_block = pdfium::checked_cast<uint32_t>(last / kBlockSize) + 1;
+  if (size == 0) {
+    *end_block = *first_block;
+  }
+  return true;
+}
+
+size_t CPDF_AsyncFileReader::GetBlockLength(uint32_t block) const {
+  const FX_FILESIZE block_start = static_cast<FX_FILESIZE>(block) * kBlockSize;
+  DCHECK_LT(block_start, file_size_);
+  return static_cast<size_t>(
+      std::min<FX_FILESIZE>(kBlockSize, file_size_ - block_start));
+}
+
+void CPDF_AsyncFileReader::MarkFailed(const PendingRead& read) {
+  for (uint32_t i = 0; i < read.block_count; ++i) {
+    failed_blocks_.insert(read.first_block + i);
+  }
+}
@@ -0,0 +1,95 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_PARSER_CPDF_ASYNC_FILE_READER_H_
+#define CORE_FPDFAPI_PARSER_CPDF_ASYNC_FILE_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <set>
+
+#include "core/fpdfapi/parser/cpdf_data_avail.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_stream.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/unowned_ptr.h"
+
+// Adapts a file that can only be read asynchronously to the polling model of
+// CPDF_DataAvail. Data that CPDF_DataAvail asks for through DownloadHints is
+// fetched with Delegate::ReadAsync(), and kept in fixed-size blocks once the
+// read is completed with CompleteRead(). Until then, the data is reported as
+// unavailable, so callers keep polling CPDF_DataAvail instead of blocking.
+//
+// Not thread-safe. CompleteRead() must be called on the thread that uses the
+// reader, e.g. by posting the completion of the underlying I/O to it.
+class CPDF_AsyncFileReader final : public IFX_SeekableReadStream,
+                                   public CPDF_DataAvail::FileAvail,
+                                   public CPDF_DataAvail::DownloadHints {
+ public:
+  class Delegate {
+   public:
+    virtual ~Delegate() = default;
+
+    // Starts reading `size` bytes at `offset`. Must not block. The result is
+    // passed to CompleteRead() with the same `request_id`. May complete
+    // synchronously.
+    virtual void ReadAsync(FX_FILESIZE offset,
+                           size_t size,
+                           uint32_t request_id) = 0;
+  };
+
+  static constexpr size_t kBlockSize = 16 * 1024;
+
+  CONSTRUCT_VIA_MAKE_RETAIN;
+
+  // Stores the result of the read with `request_id`. An empty `data` marks the
+  // range as failed: it then counts as available, but reading from it fails,
+  // so CPDF_DataAvail reports an error instead of waiting forever. Returns
+  // false if `request_id` is unknown, or if `data` is non-empty but has the
+  // wrong size, which is treated as a failure as well.
+  bool CompleteRead(uint32_t request_id, pdfium::span<const uint8_t> data);
+
+  size_t pending_read_count() const { return pending_reads_.size(); }
+
+  // IFX_SeekableReadStream:
+  FX_FILESIZE GetSize() override;
+  bool ReadBlockAtOffset(pdfium::span<uint8_t> buffer,
+                         FX_FILESIZE offset) override;
+
+  // CPDF_DataAvail::FileAvail:
+  bool IsDataAvail(FX_FILESIZE offset, size_t size) override;
+
+  // CPDF_DataAvail::DownloadHints:
+  void AddSegment(FX_FILESIZE offset, size_t size) override;
+
+ private:
+  struct PendingRead {
+    uint32_t first_block;
+    uint32_t block_count;
+  };
+
+  CPDF_AsyncFileReader(Delegate* delegate, FX_FILESIZE file_size);
+  ~CPDF_AsyncFileReader() override;
+
+  // Returns false if the range is outside the file.
+  bool GetBlockRange(FX_FILESIZE offset,
+                     size_t size,
+                     uint32_t* first_block,
+                     uint32_t* end_block) const;
+  size_t GetBlockLength(uint32_t block) const;
+  void MarkFailed(const PendingRead& read);
+
+  UnownedPtr<Delegate> const delegate_;
+  const FX_FILESIZE file_size_;
+  uint32_t next_request_id_ = 1;
+  std::map<uint32_t, DataVector<uint8_t>> blocks_;
+  std::set<uint32_t> failed_blocks_;
+  std::set<uint32_t> requested_blocks_;
+  std::map<uint32_t, PendingRead> pending_reads_;
+};
+
+#endif  // CORE_FPDFAPI_PARSER_CPDF_ASYNC_FILE_READER_H_
@@ -0,0 +1,183 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/parser/cpdf_async_file_reader.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/span.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr size_t kBlockSize = CPDF_AsyncFileReader::kBlockSize;
+constexpr size_t kFileSize = 3 * kBlockSize + 100;
+
+// In-memory file whose reads only complete when the test says so, like a
+// network file with arbitrary latency.
+class FakeDelegate final : public CPDF_AsyncFileReader::Delegate {
+ public:
+  struct Read {
+    FX_FILESIZE offset;
+    size_t size;
+    uint32_t request_id;
+  };
+
+  FakeDelegate() : contents_(kFileSize) {
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<uint8_t>(i * 7);
+    }
+  }
+  ~FakeDelegate() override = default;
+
+  // CPDF_AsyncFileReader::Delegate:
+  void ReadAsync(FX_FILESIZE offset,
+                 size_t size,
+                 uint32_t request_id) override {
+    reads_.push_back({offset, size, request_id});
+  }
+
+  void set_reader(CPDF_AsyncFileReader* reader) { reader_ = reader; }
+  const std::deque<Read>& reads() const { return reads_; }
+  pdfium::span<const uint8_t> contents() const { return contents_; }
+
+  // Completes the oldest outstanding read.
+  bool CompleteOldest() {
+    const Read read = reads_.front();
+    reads_.pop_front();
+    return reader_->CompleteRead(
+        read.request_id,
+        pdfium::span(contents_).subspan(static_cast<size_t>(read.offset),
+                                        read.size));
+  }
+
+  bool FailOldest() {
+    const Read read = reads_.front();
+    reads_.pop_front();
+    return reader_->CompleteRead(read.request_id, {});
+  }
+
+ private:
+  CPDF_AsyncFileReader* reader_ = nullptr;
+  DataVector<uint8_t> contents_;
+  std::deque<Read> reads_;
+};
+
+}  // namespace
+
+TEST(CPDFAsyncFileReaderTest, ReadAfterCompletion) {
+  FakeDelegate delegate;
+  auto reader = pdfium::MakeRetain<CPDF_AsyncFileReader>(&delegate, kFileSize);
+  delegate.set_reader(reader.Get());
+  EXPECT_EQ(static_cast<FX_FILESIZE>(kFileSize), reader->GetSize());
+
+  DataVector<uint8_t> buffer(200);
+  const FX_FILESIZE offset = kBlockSize - 100;
+  EXPECT_FALSE(reader->IsDataAvail(offset, buffer.size()));
+  EXPECT_FALSE(reader->ReadBlockAtOffset(buffer, offset));
+
+  // Straddles two blocks, which are fetched with one read.
+  reader->AddSegment(offset, buffer.size());
+  ASSERT_EQ(1u, delegate.reads().size());
+  EXPECT_EQ(0, delegate.reads()[0].offset);
+  EXPECT_EQ(2 * kBlockSize, delegate.reads()[0].size);
+  EXPECT_EQ(1u, reader->pending_read_count());
+
+  // Asking again while the read is in flight does not issue another one.
+  reader->AddSegment(offset, buffer.size());
+  EXPECT_EQ(1u, delegate.reads().size());
+  EXPECT_FALSE(reader->IsDataAvail(offset, buffer.size()));
+
+  EXPECT_TRUE(delegate.CompleteOldest());
+  EXPECT_EQ(0u, reader->pending_read_count());
+  EXPECT_TRUE(reader->IsDataAvail(offset, buffer.size()));
+  ASSERT_TRUE(reader->ReadBlockAtOffset(buffer, offset));
+  EXPECT_TRUE(std::ranges::equal(
+      buffer, delegate.contents().subspan(static_cast<size_t>(offset),
+                                          buffer.size())));
+
+  // Available data is not requested again.
+  reader->AddSegment(offset, buffer.size());
+  EXPECT_TRUE(delegate.reads().empty());
+}
+
+TEST(CPDFAsyncFileReaderTest, PartialLastBlock) {
+  FakeDelegate delegate;
+  auto reader = pdfium::MakeRetain<CPDF_AsyncFileReader>(&delegate, kFileSize);
+  delegate.set_reader(reader.Get());
+
+  reader->AddSegment(kFileSize - 10, 10);
+  ASSERT_EQ(1u, delegate.reads().size());
+  EXPECT_EQ(static_cast<FX_FILESIZE>(3 * kBlockSize),
+            delegate.reads()[0].offset);
+  EXPECT_EQ(100u, delegate.reads()[0].size);
+  EXPECT_TRUE(delegate.CompleteOldest());
+
+  DataVector<uint8_t> buffer(10);
+  ASSERT_TRUE(reader->ReadBlockAtOffset(buffer, kFileSize - 10));
+  EXPECT_EQ(delegate.contents()[kFileSize - 1], buffer.back());
+
+  // Out of range.
+  EXPECT_FALSE(reader->IsDataAvail(kFileSize - 10, 11));
+  EXPECT_FALSE(reader->ReadBlockAtOffset(buffer, kFileSize - 9));
+  reader->AddSegment(kFileSize, 1);
+  EXPECT_TRUE(delegate.reads().empty());
+}
+
+TEST(CPDFAsyncFileReaderTest, OnlyMissingBlocksRequested) {
+  FakeDelegate delegate;
+  auto reader = pdfium::MakeRetain<CPDF_AsyncFileReader>(&delegate, kFileSize);
+  delegate.set_reader(reader.Get());
+
+  reader->AddSegment(kBlockSize + 1, 1);
+  EXPECT_TRUE(delegate.CompleteOldest());
+
+  // Blocks 0 and 2-3 are missing, block 1 is present.
+  reader->AddSegment(0, kFileSize);
+  ASSERT_EQ(2u, delegate.reads().size());
+  EXPECT_EQ(0, delegate.reads()[0].offset);
+  EXPECT_EQ(kBlockSize, delegate.reads()[0].size);
+  EXPECT_EQ(static_cast<FX_FILESIZE>(2 * kBlockSize),
+            delegate.reads()[1].offset);
+  EXPECT_EQ(kBlockSize + 100, delegate.reads()[1].size);
+
+  EXPECT_TRUE(delegate.CompleteOldest());
+  EXPECT_FALSE(reader->IsDataAvail(0, kFileSize));
+  EXPECT_TRUE(delegate.CompleteOldest());
+  EXPECT_TRUE(reader->IsDataAvail(0, kFileSize));
+
+  // Unknown and already completed requests are rejected.
+  DataVector<uint8_t> buffer(10);
+  EXPECT_FALSE(reader->CompleteRead(12345, buffer));
+  EXPECT_FALSE(reader->CompleteRead(1, buffer));
+}
+
+TEST(CPDFAsyncFileReaderTest, FailedRead) {
+  FakeDelegate delegate;
+  auto reader = pdfium::MakeRetain<CPDF_AsyncFileReader>(&delegate, kFileSize);
+  delegate.set_reader(reader.Get());
+
+  reader->AddSegment(0, 10);
+  EXPECT_TRUE(delegate.FailOldest());
+
+  // Reported as available so that callers stop waiting, but reads fail.
+  EXPECT_TRUE(reader->IsDataAvail(0, 10));
+  DataVector<uint8_t> buffer(10);
+  EXPECT_FALSE(reader->ReadBlockAtOffset(buffer, 0));
+
+  // Not retried.
+  reader->AddSegment(0, 10);
+  EXPECT_TRUE(delegate.reads().empty());
+
+  // A read of the wrong size counts as a failure too.
+  reader->AddSegment(kBlockSize, 10);
+  ASSERT_EQ(1u, delegate.reads().size());
+  EXPECT_FALSE(reader->CompleteRead(delegate.reads()[0].request_id, buffer));
+  EXPECT_TRUE(reader->IsDataAvail(kBlockSize, 10));
+  EXPECT_FALSE(reader->ReadBlockAtOffset(buffer, kBlockSize));
+}
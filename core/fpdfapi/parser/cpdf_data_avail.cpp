@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_cross_ref_avail.h"
@@ -54,6 +55,24 @@ RetainPtr<CPDF_Object> GetResourceObject(RetainPtr<CPDF_Dictionary> dict) {
   return nullptr;
 }
 
+// Pages and shared object groups are each stored contiguously in linearized
+// files, so read-ahead should not run past them.
+std::vector<CPDF_ReadValidator::Range> GetHintTableRanges(
+    const CPDF_HintTables& hint_tables) {
+  std::vector<CPDF_ReadValidator::Range> ranges;
+  for (const CPDF_HintTables::PageInfo& page : hint_tables.PageInfos()) {
+    ranges.push_back({page.page_offset(),
+                      page.page_offset() +
+                          static_cast<FX_FILESIZE>(page.page_length())});
+  }
+  for (const CPDF_HintTables::SharedObjGroupInfo& group :
+       hint_tables.SharedGroupInfos()) {
+    ranges.push_back({group.offset_,
+                      group.offset_ + static_cast<FX_FILESIZE>(group.length_)});
+  }
+  return ranges;
+}
+
 class HintsScope {
  public:
   HintsScope(RetainPtr<CPDF_ReadValidator> validator,
@@ -477,6 +496,9 @@ bool CPDF_DataAvail::CheckHintTables() {
     return false;
   }
 
+  if (hint_tables_) {
+    GetValidator()->SetReadAheadRanges(GetHintTableRanges(*hint_tables_));
+  }
   internal_status_ = InternalStatus::kDone;
   return true;
 }
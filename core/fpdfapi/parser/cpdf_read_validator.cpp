@@ -10,6 +10,7 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/notreached.h"
+#include "core/fxcrt/span.h"
 
 namespace {
 
@@ -49,6 +50,22 @@ CPDF_ReadValidator::CPDF_ReadValidator(
 
 CPDF_ReadValidator::~CPDF_ReadValidator() = default;
 
+void CPDF_ReadValidator::SetDownloadHints(
+    CPDF_DataAvail::DownloadHints* hints) {
+  if (hints_ != hints) {
+    FlushPendingRequests();
+  }
+  hints_ = hints;
+}
+
+void CPDF_ReadValidator::SetReadAheadRanges(std::vector<Range> ranges) {
+  std::erase_if(ranges, [](const Range& range) {
+    return range.start < 0 || range.end <= range.start;
+  });
+  std::ranges::sort(ranges, {}, &Range::start);
+  read_ahead_ranges_ = std::move(ranges);
+}
+
 void CPDF_ReadValidator::ResetErrors() {
   read_error_ = false;
   has_unavailable_data_ = false;
@@ -102,8 +119,8 @@ void CPDF_ReadValidator::ScheduleDownload(FX_FILESIZE offset, size_t size) {
     DCHECK(false);
     return;
   }
-  end_segment_offset =
-      std::min(file_size_, AlignUp(end_segment_offset.ValueOrDie()));
+  end_segment_offset = std::min(
+      file_size_, AlignUp(ApplyReadAhead(end_segment_offset.ValueOrDie())));
 
   FX_SAFE_SIZE_T segment_size = end_segment_offset;
   segment_size -= start_segment_offset;
@@ -113,7 +130,69 @@ void CPDF_ReadValidator::ScheduleDownload(FX_FILESIZE offset, size_t size) {
     DCHECK(false);
     return;
   }
-  hints_->AddSegment(start_segment_offset, segment_size.ValueOrDie());
+
+  const Range range = {start_segment_offset, end_segment_offset.ValueOrDie()};
+  if (policy_.coalesce) {
+    pending_requests_.push_back(range);
+    return;
+  }
+  SendRequest(range);
+}
+
+FX_FILESIZE CPDF_ReadValidator::ApplyReadAhead(FX_FILESIZE end) const {
+  if (policy_.read_ahead == 0) {
+    return end;
+  }
+
+  FX_SAFE_FILESIZE safe_end = end;
+  safe_end += policy_.read_ahead;
+  FX_FILESIZE result = safe_end.ValueOrDefault(file_size_);
+
+  // Find the last range starting before `end`, and stop at its end if `end`
+  // is inside it.
+  auto it = std::ranges::upper_bound(read_ahead_ranges_, end - 1, {},
+                                     &Range::start);
+  if (it != read_ahead_ranges_.begin()) {
+    --it;
+    if (end <= it->end) {
+      result = std::min(result, it->end);
+    }
+  }
+  return std::max(end, result);
+}
+
+void CPDF_ReadValidator::SendRequest(const Range& range) {
+  DCHECK(hints_);
+  const size_t size = static_cast<size_t>(range.end - range.start);
+  ++request_stats_.request_count;
+  request_stats_.requested_bytes += size;
+  hints_->AddSegment(range.start, size);
+}
+
+void CPDF_ReadValidator::FlushPendingRequests() {
+  if (pending_requests_.empty()) {
+    return;
+  }
+
+  std::vector<Range> requests = std::move(pending_requests_);
+  pending_requests_.clear();
+  if (!hints_) {
+    return;
+  }
+
+  std::ranges::sort(requests, {}, &Range::start);
+  Range merged = requests.front();
+  for (const Range& range : pdfium::span(requests).subspan<1u>()) {
+    FX_SAFE_FILESIZE merge_limit = merged.end;
+    merge_limit += policy_.merge_gap;
+    if (range.start <= merge_limit.ValueOrDefault(file_size_)) {
+      merged.end = std::max(merged.end, range.end);
+      continue;
+    }
+    SendRequest(merged);
+    merged = range;
+  }
+  SendRequest(merged);
 }
 
 bool CPDF_ReadValidator::IsDataRangeAvailable(FX_FILESIZE offset,
@@ -5,6 +5,10 @@
 #ifndef CORE_FPDFAPI_PARSER_CPDF_READ_VALIDATOR_H_
 #define CORE_FPDFAPI_PARSER_CPDF_READ_VALIDATOR_H_
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "core/fpdfapi/parser/cpdf_data_avail.h"
 #include "core/fxcrt/fx_memory.h"
 #include "core/fxcrt/fx_stream.h"
@@ -28,11 +32,41 @@ class CPDF_ReadValidator : public IFX_SeekableReadStream {
     const bool saved_has_unavailable_data_;
   };
 
+  // Controls how missing ranges turn into DownloadHints::AddSegment() calls.
+  // The default sends every range as soon as it is found to be missing.
+  struct RequestPolicy {
+    // Queue missing ranges while download hints are set, and send them merged
+    // when the hints are detached.
+    bool coalesce = false;
+    // When coalescing, also merge queued ranges separated by at most this
+    // many bytes.
+    uint32_t merge_gap = 0;
+    // Extra bytes to request past the end of each missing range. If the end
+    // falls inside a range passed to SetReadAheadRanges(), read-ahead stops
+    // at the end of that range.
+    uint32_t read_ahead = 0;
+  };
+
+  struct RequestStats {
+    uint64_t request_count = 0;
+    uint64_t requested_bytes = 0;
+  };
+
+  // A half-open byte range [start, end).
+  struct Range {
+    FX_FILESIZE start;
+    FX_FILESIZE end;
+  };
+
   CONSTRUCT_VIA_MAKE_RETAIN;
 
-  void SetDownloadHints(CPDF_DataAvail::DownloadHints* hints) {
-    hints_ = hints;
-  }
+  // Sends queued requests to the previous hints, if any, before switching.
+  void SetDownloadHints(CPDF_DataAvail::DownloadHints* hints);
+  void SetRequestPolicy(const RequestPolicy& policy) { policy_ = policy; }
+  // `ranges` are units of data that are usually read together, e.g. pages
+  // from the linearization hint tables. They need not be sorted.
+  void SetReadAheadRanges(std::vector<Range> ranges);
+  const RequestStats& request_stats() const { return request_stats_; }
   bool read_error() const { return read_error_; }
   bool has_unavailable_data() const { return has_unavailable_data_; }
   bool has_read_problems() const {
@@ -56,6 +90,9 @@ class CPDF_ReadValidator : public IFX_SeekableReadStream {
 
  private:
   void ScheduleDownload(FX_FILESIZE offset, size_t size);
+  FX_FILESIZE ApplyReadAhead(FX_FILESIZE end) const;
+  void SendRequest(const Range& range);
+  void FlushPendingRequests();
   bool IsDataRangeAvailable(FX_FILESIZE offset, size_t size) const;
 
   RetainPtr<IFX_SeekableReadStream> const file_read_;
@@ -65,6 +102,11 @@ class CPDF_ReadValidator : public IFX_SeekableReadStream {
   bool has_unavailable_data_ = false;
   bool whole_file_already_available_ = false;
   const FX_FILESIZE file_size_;
+  RequestPolicy policy_;
+  RequestStats request_stats_;
+  // Sorted by `start`.
+  std::vector<Range> read_ahead_ranges_;
+  std::vector<Range> pending_requests_;
 };
 
 #endif  // CORE_FPDFAPI_PARSER_CPDF_READ_VALIDATOR_H_
@@ -8,6 +8,7 @@
 
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "core/fxcrt/cfx_read_only_span_stream.h"
 #include "core/fxcrt/cfx_read_only_vector_stream.h"
@@ -65,6 +66,33 @@ class MockDownloadHints final : public CPDF_DataAvail::DownloadHints {
   std::pair<FX_FILESIZE, FX_FILESIZE> last_requested_range_;
 };
 
+// Records every requested range, like an embedder issuing one network request
+// per AddSegment() call.
+class CountingDownloadHints final : public CPDF_DataAvail::DownloadHints {
+ public:
+  CountingDownloadHints() = default;
+  ~CountingDownloadHints() override = default;
+
+  void AddSegment(FX_FILESIZE offset, size_t size) override {
+    requests_.push_back(MakeRange(offset, offset + size));
+  }
+
+  const std::vector<std::pair<FX_FILESIZE, FX_FILESIZE>>& requests() const {
+    return requests_;
+  }
+
+ private:
+  std::vector<std::pair<FX_FILESIZE, FX_FILESIZE>> requests_;
+};
+
+RetainPtr<CPDF_ReadValidator> MakeValidatorWithoutData(
+    MockFileAvail* file_avail) {
+  DataVector<uint8_t> test_data(kTestDataSize);
+  auto file =
+      pdfium::MakeRetain<CFX_ReadOnlyVectorStream>(std::move(test_data));
+  return pdfium::MakeRetain<CPDF_ReadValidator>(std::move(file), file_avail);
+}
+
 }  // namespace
 
 TEST(ReadValidatorTest, UnavailableData) {
@@ -300,3 +328,106 @@ TEST(ReadValidatorTest, CheckDataRangeAndRequestIfUnavailable) {
 
   validator->SetDownloadHints(nullptr);
 }
+
+TEST(ReadValidatorTest, DefaultPolicyRequestsEachRange) {
+  MockFileAvail file_avail;
+  auto validator = MakeValidatorWithoutData(&file_avail);
+  CountingDownloadHints hints;
+  validator->SetDownloadHints(&hints);
+
+  DataVector<uint8_t> read_buffer(100);
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 5000));
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 5200));
+  ASSERT_EQ(2u, hints.requests().size());
+  EXPECT_EQ(MakeRange(4608, 5120), hints.requests()[0]);
+  EXPECT_EQ(MakeRange(5120, 5632), hints.requests()[1]);
+
+  validator->SetDownloadHints(nullptr);
+  EXPECT_EQ(2u, hints.requests().size());
+  EXPECT_EQ(2u, validator->request_stats().request_count);
+  EXPECT_EQ(1024u, validator->request_stats().requested_bytes);
+}
+
+TEST(ReadValidatorTest, CoalescedRequests) {
+  MockFileAvail file_avail;
+  auto validator = MakeValidatorWithoutData(&file_avail);
+  CPDF_ReadValidator::RequestPolicy policy;
+  policy.coalesce = true;
+  policy.merge_gap = 1024;
+  validator->SetRequestPolicy(policy);
+  CountingDownloadHints hints;
+  validator->SetDownloadHints(&hints);
+
+  DataVector<uint8_t> read_buffer(100);
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 5000));
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 20000));
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 6200));
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 5000));
+  EXPECT_TRUE(validator->has_unavailable_data());
+
+  // Nothing is requested until the hints are detached.
+  EXPECT_TRUE(hints.requests().empty());
+  validator->SetDownloadHints(nullptr);
+
+  // [4608, 5120) and [6144, 6656) are within `merge_gap`; the duplicate
+  // request is dropped.
+  ASSERT_EQ(2u, hints.requests().size());
+  EXPECT_EQ(MakeRange(4608, 6656), hints.requests()[0]);
+  EXPECT_EQ(MakeRange(19968, 20480), hints.requests()[1]);
+  EXPECT_EQ(2u, validator->request_stats().request_count);
+  EXPECT_EQ(2560u, validator->request_stats().requested_bytes);
+
+  // Queued requests are per hints session.
+  CountingDownloadHints hints2;
+  validator->SetDownloadHints(&hints2);
+  validator->SetDownloadHints(nullptr);
+  EXPECT_TRUE(hints2.requests().empty());
+}
+
+TEST(ReadValidatorTest, ReadAhead) {
+  MockFileAvail file_avail;
+  auto validator = MakeValidatorWithoutData(&file_avail);
+  CPDF_ReadValidator::RequestPolicy policy;
+  policy.read_ahead = 4096;
+  validator->SetRequestPolicy(policy);
+  CountingDownloadHints hints;
+  validator->SetDownloadHints(&hints);
+
+  DataVector<uint8_t> read_buffer(100);
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 5000));
+  ASSERT_EQ(1u, hints.requests().size());
+  EXPECT_EQ(MakeRange(4608, 9216), hints.requests()[0]);
+
+  // Read-ahead does not go past the end of the file.
+  EXPECT_FALSE(validator->ReadBlockAtOffset(
+      read_buffer, validator->GetSize() - read_buffer.size()));
+  ASSERT_EQ(2u, hints.requests().size());
+  EXPECT_EQ(validator->GetSize(), hints.requests()[1].second);
+
+  validator->SetDownloadHints(nullptr);
+}
+
+TEST(ReadValidatorTest, ReadAheadStopsAtRangeEnd) {
+  MockFileAvail file_avail;
+  auto validator = MakeValidatorWithoutData(&file_avail);
+  CPDF_ReadValidator::RequestPolicy policy;
+  policy.read_ahead = 4096;
+  validator->SetRequestPolicy(policy);
+  validator->SetReadAheadRanges({{30000, 40000}, {4000, 6000}});
+  CountingDownloadHints hints;
+  validator->SetDownloadHints(&hints);
+
+  DataVector<uint8_t> read_buffer(100);
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 5000));
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 10000));
+  EXPECT_FALSE(validator->ReadBlockAtOffset(read_buffer, 30000));
+  ASSERT_EQ(3u, hints.requests().size());
+  // Ends inside [4000, 6000), so read-ahead stops at 6000 before alignment.
+  EXPECT_EQ(MakeRange(4608, 6144), hints.requests()[0]);
+  // Outside every range, so the full read-ahead applies.
+  EXPECT_EQ(MakeRange(9728, 14336), hints.requests()[1]);
+  // Inside [30000, 40000), which is longer than the read-ahead.
+  EXPECT_EQ(MakeRange(29696, 34304), hints.requests()[2]);
+
+  validator->SetDownloadHints(nullptr);
+}
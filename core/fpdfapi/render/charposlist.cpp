@@ -104,6 +104,7 @@ std::vector<TextCharPos> GetCharPosList(pdfium::span<const uint32_t> char_codes,
   CPDF_CIDFont* cid_font = font->AsCIDFont();
   bool is_vertical_writing = cid_font && cid_font->IsVertWriting();
   bool has_to_unicode = !!font->GetFontDict()->GetStreamFor("ToUnicode");
+  WideString unicode;
   for (size_t i = 0; i < char_codes.size(); ++i) {
     uint32_t char_code = char_codes[i];
     if (char_code == static_cast<uint32_t>(-1)) {
@@ -116,7 +117,8 @@ std::vector<TextCharPos> GetCharPosList(pdfium::span<const uint32_t> char_codes,
     if (cid_font) {
       text_char_pos.font_style_ = true;
     }
-    WideString unicode = font->UnicodeFromCharCode(char_code);
+    unicode.clear();
+    font->AppendUnicodeFromCharCode(char_code, &unicode);
     text_char_pos.unicode_ = !unicode.IsEmpty() ? unicode[0] : char_code;
     text_char_pos.glyph_index_ =
         font->GlyphFromCharCode(char_code, &is_vertical_glyph);
@@ -0,0 +1,252 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_meshrasterizer.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/numerics/clamped_math.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace {
+
+// Colors are stepped across a span in 16.16 fixed point. Span endpoints are
+// clamped to +/- `kMaxSpanValue`, so neither the values nor the per-pixel
+// steps between them can overflow.
+constexpr int kFixedShift = 16;
+constexpr float kFixedOne = 1 << kFixedShift;
+constexpr float kMaxSpanValue = 8192.0f;
+
+float ClampSpanValue(float value) {
+  return isnan(value) ? 0.0f : std::clamp(value, -kMaxSpanValue, kMaxSpanValue);
+}
+
+int32_t ToFixed(float value) {
+  return static_cast<int32_t>(value * kFixedOne);
+}
+
+// Returns `value` rounded down and clamped to [`min`, `max`].
+int FloatToClampedInt(float value, int min, int max) {
+  if (!(value > min)) {
+    return min;
+  }
+  if (!(value < max)) {
+    return max;
+  }
+  return static_cast<int>(value);
+}
+
+// Interpolates between `v1` and `v2` at row `y`, which is between their rows.
+CPDF_MeshVertex InterpolateEdge(const CPDF_MeshVertex& v1,
+                                const CPDF_MeshVertex& v2,
+                                int y) {
+  const float y_dist = (y - v1.position.y) / (v2.position.y - v1.position.y);
+  CPDF_MeshVertex result;
+  result.position.x =
+      v1.position.x + ((v2.position.x - v1.position.x) * y_dist);
+  result.position.y = y;
+  result.rgb.red = v1.rgb.red + ((v2.rgb.red - v1.rgb.red) * y_dist);
+  result.rgb.green = v1.rgb.green + ((v2.rgb.green - v1.rgb.green) * y_dist);
+  result.rgb.blue = v1.rgb.blue + ((v2.rgb.blue - v1.rgb.blue) * y_dist);
+  return result;
+}
+
+}  // namespace
+
+CPDF_MeshRasterizer::CPDF_MeshRasterizer(
+    int width,
+    int height,
+    int alpha,
+    pdfium::span<const FX_ARGB> shading_steps)
+    : width_(width),
+      height_(height),
+      alpha_(alpha),
+      shading_steps_(shading_steps),
+      triangles_by_first_row_(std::max(height, 0)) {}
+
+CPDF_MeshRasterizer::~CPDF_MeshRasterizer() = default;
+
+void CPDF_MeshRasterizer::AddTriangle(
+    pdfium::span<const CPDF_MeshVertex, 3> triangle) {
+  Triangle sorted;
+  std::ranges::copy(triangle, sorted.vertices.begin());
+  std::ranges::stable_sort(sorted.vertices, std::ranges::less(),
+                           [](const CPDF_MeshVertex& vertex) {
+                             return vertex.position.y;
+                           });
+  const float min_y = sorted.vertices[0].position.y;
+  const float max_y = sorted.vertices[2].position.y;
+  if (!(min_y < max_y)) {
+    return;
+  }
+  const auto [min_x, max_x] = std::ranges::minmax(
+      {sorted.vertices[0].position.x, sorted.vertices[1].position.x,
+       sorted.vertices[2].position.x});
+  if (!(max_x > 0) || !(min_x < width_)) {
+    return;
+  }
+
+  const int first_row = FloatToClampedInt(floorf(min_y), 0, height_);
+  sorted.last_row = FloatToClampedInt(ceilf(max_y), -1, height_ - 1);
+  if (first_row > sorted.last_row) {
+    return;
+  }
+
+  triangles_by_first_row_[first_row].push_back(
+      pdfium::checked_cast<uint32_t>(triangles_.size()));
+  triangles_.push_back(std::move(sorted));
+}
+
+void CPDF_MeshRasterizer::Flush(const RetainPtr<CFX_DIBitmap>& bitmap) {
+  Rasterize(bitmap);
+  triangles_.clear();
+  // Replace the bins rather than clearing them, so that rows that got many
+  // triangles in this batch do not keep their capacity.
+  triangles_by_first_row_.assign(triangles_by_first_row_.size(), {});
+}
+
+void CPDF_MeshRasterizer::Rasterize(
+    const RetainPtr<CFX_DIBitmap>& bitmap) const {
+  Rasterize(bitmap, 0, height_);
+}
+
+void CPDF_MeshRasterizer::Rasterize(const RetainPtr<CFX_DIBitmap>& bitmap,
+                                    int top,
+                                    int bottom) const {
+  CHECK_EQ(bitmap->GetFormat(), FXDIB_Format::kBgra);
+  CHECK_EQ(bitmap->GetWidth(), width_);
+  CHECK_EQ(bitmap->GetHeight(), height_);
+  top = std::max(top, 0);
+  bottom = std::min(bottom, height_);
+  if (top >= bottom) {
+    return;
+  }
+
+  // Triangles covering the current row, in the order they were added.
+  std::vector<uint32_t> active;
+  for (int row = 0; row < top; ++row) {
+    for (uint32_t index : triangles_by_first_row_[row]) {
+      if (triangles_[index].last_row >= top) {
+        active.push_back(index);
+      }
+    }
+  }
+  std::ranges::sort(active);
+
+  std::vector<uint32_t> merged;
+  for (int row = top; row < bottom; ++row) {
+    const std::vector<uint32_t>& starting = triangles_by_first_row_[row];
+    if (!starting.empty()) {
+      merged.clear();
+      std::ranges::merge(active, starting, std::back_inserter(merged));
+      std::swap(active, merged);
+    }
+    if (active.empty()) {
+      continue;
+    }
+
+    pdfium::span<FX_ARGB> dest = bitmap->GetWritableScanlineAs<FX_ARGB>(row);
+    for (uint32_t index : active) {
+      DrawTriangleRow(triangles_[index], row, dest);
+    }
+    std::erase_if(active, [this, row](uint32_t index) {
+      return triangles_[index].last_row == row;
+    });
+  }
+}
+
+void CPDF_MeshRasterizer::DrawTriangleRow(const Triangle& triangle,
+                                          int row,
+                                          pdfium::span<FX_ARGB> dest) const {
+  const CPDF_MeshVertex& top = triangle.vertices[0];
+  const CPDF_MeshVertex& middle = triangle.vertices[1];
+  const CPDF_MeshVertex& bottom = triangle.vertices[2];
+  const float y = static_cast<float>(row);
+  if (y < top.position.y || y > bottom.position.y) {
+    return;
+  }
+
+  // The row crosses the long edge from top to bottom, and one of the two
+  // short edges. A row through the middle vertex, strictly between the other
+  // two, intersects all three edges and is not drawn.
+  CPDF_MeshVertex short_edge_point;
+  if (y < middle.position.y) {
+    short_edge_point = InterpolateEdge(top, middle, row);
+  } else if (y > middle.position.y) {
+    short_edge_point = InterpolateEdge(middle, bottom, row);
+  } else if (top.position.y == middle.position.y) {
+    short_edge_point = InterpolateEdge(middle, bottom, row);
+  } else if (middle.position.y == bottom.position.y) {
+    short_edge_point = InterpolateEdge(top, middle, row);
+  } else {
+    return;
+  }
+  CPDF_MeshVertex long_edge_point = InterpolateEdge(top, bottom, row);
+
+  const CPDF_MeshVertex* start = &short_edge_point;
+  const CPDF_MeshVertex* end = &long_edge_point;
+  if (!(start->position.x < end->position.x)) {
+    std::swap(start, end);
+  }
+  const int min_x = FloatToClampedInt(
+      floorf(start->position.x), std::numeric_limits<int>::min(),
+      std::numeric_limits<int>::max());
+  const int max_x =
+      FloatToClampedInt(ceilf(end->position.x),
+                        std::numeric_limits<int>::min(),
+                        std::numeric_limits<int>::max());
+  const int start_x = std::clamp(min_x, 0, width_);
+  const int end_x = std::clamp(max_x, 0, width_);
+  if (start_x >= end_x) {
+    return;
+  }
+
+  // The first pixel gets the color one step past `start_x`.
+  const float range_x = static_cast<float>(pdfium::ClampSub(max_x, min_x));
+  const float first_step =
+      static_cast<float>(pdfium::ClampSub(start_x, min_x)) + 1;
+  pdfium::span<FX_ARGB> span =
+      dest.subspan(static_cast<size_t>(start_x),
+                   static_cast<size_t>(end_x - start_x));
+  if (!shading_steps_.empty()) {
+    const float start_value = ClampSpanValue(start->rgb.red);
+    const float unit = (ClampSpanValue(end->rgb.red) - start_value) / range_x;
+    int32_t value = ToFixed(start_value + first_step * unit);
+    const int32_t step = ToFixed(unit);
+    const int32_t max_index = static_cast<int32_t>(shading_steps_.size() - 1);
+    for (FX_ARGB& pixel : span) {
+      pixel = shading_steps_[std::clamp(value >> kFixedShift, 0, max_index)];
+      value += step;
+    }
+    return;
+  }
+
+  std::array<int32_t, 3> values;
+  std::array<int32_t, 3> steps;
+  const std::array<float, 3> start_color = {
+      start->rgb.red, start->rgb.green, start->rgb.blue};
+  const std::array<float, 3> end_color = {end->rgb.red, end->rgb.green,
+                                          end->rgb.blue};
+  for (size_t i = 0; i < 3; ++i) {
+    const float start_value = ClampSpanValue(start_color[i] * 255);
+    const float unit =
+        (ClampSpanValue(end_color[i] * 255) - start_value) / range_x;
+    values[i] = ToFixed(start_value + first_step * unit);
+    steps[i] = ToFixed(unit);
+  }
+  for (FX_ARGB& pixel : span) {
+    pixel = ArgbEncode(alpha_, values[0] >> kFixedShift,
+                       values[1] >> kFixedShift, values[2] >> kFixedShift);
+    values[0] += steps[0];
+    values[1] += steps[1];
+    values[2] += steps[2];
+  }
+}
@@ -0,0 +1,87 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_MESHRASTERIZER_H_
+#define CORE_FPDFAPI_RENDER_CPDF_MESHRASTERIZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "core/fpdfapi/page/cpdf_meshstream.h"
+#include "core/fxcrt/raw_span.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/fx_dib.h"
+
+class CFX_DIBitmap;
+
+// Draws Gouraud-shaded triangles, such as the ones in free-form and
+// lattice-form triangle mesh shadings, into a BGRA bitmap.
+//
+// Triangles are binned by the first row they cover. Rasterize() then makes a
+// single pass over the bitmap's rows, and fills each row's spans from all the
+// triangles that cover it, in the order the triangles were added. Colors are
+// stepped across each span in fixed point.
+//
+// Callers streaming a mesh of unbounded size should Flush() whenever IsFull()
+// returns true, so that at most `kMaxPendingTriangles` are held at a time.
+class CPDF_MeshRasterizer {
+ public:
+  static constexpr size_t kMaxPendingTriangles = 65536;
+
+  // If `shading_steps` is not empty, then the red component of each vertex
+  // color is an index into it, and the other components are ignored.
+  // Otherwise, vertex colors are RGB values from 0 to 1, and get `alpha`.
+  CPDF_MeshRasterizer(int width,
+                      int height,
+                      int alpha,
+                      pdfium::span<const FX_ARGB> shading_steps);
+  ~CPDF_MeshRasterizer();
+
+  // Vertex positions are in device space. Triangles that do not overlap the
+  // bitmap are dropped.
+  void AddTriangle(pdfium::span<const CPDF_MeshVertex, 3> triangle);
+
+  bool IsFull() const { return triangles_.size() >= kMaxPendingTriangles; }
+
+  // Draws all rows, then discards the triangles added so far. Triangles added
+  // afterwards draw on top of them.
+  void Flush(const RetainPtr<CFX_DIBitmap>& bitmap);
+
+  // Draws all rows.
+  void Rasterize(const RetainPtr<CFX_DIBitmap>& bitmap) const;
+
+  // Draws the rows from `top` up to, but not including, `bottom`. Calls for
+  // non-overlapping row ranges write to disjoint parts of `bitmap`, so they
+  // may run concurrently once all triangles have been added.
+  void Rasterize(const RetainPtr<CFX_DIBitmap>& bitmap,
+                 int top,
+                 int bottom) const;
+
+  size_t triangle_count() const { return triangles_.size(); }
+
+ private:
+  struct Triangle {
+    // Sorted from top to bottom.
+    std::array<CPDF_MeshVertex, 3> vertices;
+    int last_row;
+  };
+
+  void DrawTriangleRow(const Triangle& triangle,
+                       int row,
+                       pdfium::span<FX_ARGB> dest) const;
+
+  const int width_;
+  const int height_;
+  const int alpha_;
+  const pdfium::raw_span<const FX_ARGB> shading_steps_;
+  std::vector<Triangle> triangles_;
+  // Indices into `triangles_`, by the first row each triangle covers.
+  std::vector<std::vector<uint32_t>> triangles_by_first_row_;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_MESHRASTERIZER_H_
@@ -0,0 +1,217 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_meshrasterizer.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <array>
+
+#include "core/fpdfapi/page/cpdf_meshstream.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr FX_ARGB kBackground = 0x12345678;
+
+CPDF_MeshVertex MakeVertex(float x, float y, float r, float g, float b) {
+  CPDF_MeshVertex vertex;
+  vertex.position = CFX_PointF(x, y);
+  vertex.rgb = {r, g, b};
+  return vertex;
+}
+
+RetainPtr<CFX_DIBitmap> CreateBitmap(int width, int height) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, FXDIB_Format::kBgra));
+  for (int row = 0; row < height; ++row) {
+    for (FX_ARGB& pixel : bitmap->GetWritableScanlineAs<FX_ARGB>(row)) {
+      pixel = kBackground;
+    }
+  }
+  return bitmap;
+}
+
+FX_ARGB GetPixel(const RetainPtr<CFX_DIBitmap>& bitmap, int x, int y) {
+  return bitmap->GetScanlineAs<FX_ARGB>(y)[x];
+}
+
+}  // namespace
+
+TEST(CPDFMeshRasterizer, SolidTriangle) {
+  const std::array<CPDF_MeshVertex, 3> triangle = {
+      MakeVertex(2.5f, 2.5f, 1, 0, 0), MakeVertex(17.5f, 2.5f, 1, 0, 0),
+      MakeVertex(2.5f, 17.5f, 1, 0, 0)};
+  CPDF_MeshRasterizer rasterizer(20, 20, 0xff, {});
+  rasterizer.AddTriangle(triangle);
+  auto bitmap = CreateBitmap(20, 20);
+  rasterizer.Rasterize(bitmap);
+
+  EXPECT_EQ(0xffff0000, GetPixel(bitmap, 3, 3));
+  EXPECT_EQ(0xffff0000, GetPixel(bitmap, 10, 5));
+  EXPECT_EQ(0xffff0000, GetPixel(bitmap, 3, 15));
+  EXPECT_EQ(kBackground, GetPixel(bitmap, 1, 1));
+  EXPECT_EQ(kBackground, GetPixel(bitmap, 15, 15));
+  EXPECT_EQ(kBackground, GetPixel(bitmap, 19, 19));
+}
+
+TEST(CPDFMeshRasterizer, Gradient) {
+  // Red goes from 0 at x = 0 to 1 at x = 255, on every row.
+  const std::array<CPDF_MeshVertex, 3> upper = {
+      MakeVertex(0, 0, 0, 0, 1), MakeVertex(255, 0, 1, 0, 1),
+      MakeVertex(0, 8, 0, 0, 1)};
+  const std::array<CPDF_MeshVertex, 3> lower = {
+      MakeVertex(255, 0, 1, 0, 1), MakeVertex(255, 8, 1, 0, 1),
+      MakeVertex(0, 8, 0, 0, 1)};
+  CPDF_MeshRasterizer rasterizer(256, 8, 0x80, {});
+  rasterizer.AddTriangle(upper);
+  rasterizer.AddTriangle(lower);
+  auto bitmap = CreateBitmap(256, 8);
+  rasterizer.Rasterize(bitmap);
+
+  for (int x = 0; x < 255; ++x) {
+    const FX_ARGB pixel = GetPixel(bitmap, x, 5);
+    EXPECT_EQ(0x80u, FXARGB_A(pixel));
+    EXPECT_LE(abs(FXARGB_R(pixel) - (x + 1)), 1) << x;
+    EXPECT_EQ(0u, FXARGB_G(pixel));
+    EXPECT_EQ(0xffu, FXARGB_B(pixel));
+  }
+}
+
+TEST(CPDFMeshRasterizer, LaterTrianglesDrawOnTop) {
+  const std::array<CPDF_MeshVertex, 3> red = {
+      MakeVertex(0, 0, 1, 0, 0), MakeVertex(20, 0, 1, 0, 0),
+      MakeVertex(0, 20, 1, 0, 0)};
+  const std::array<CPDF_MeshVertex, 3> green = {
+      MakeVertex(0, 5, 0, 1, 0), MakeVertex(20, 5, 0, 1, 0),
+      MakeVertex(0, 25, 0, 1, 0)};
+  const std::array<CPDF_MeshVertex, 3> blue = {
+      MakeVertex(0, 0, 0, 0, 1), MakeVertex(8, 0, 0, 0, 1),
+      MakeVertex(0, 8, 0, 0, 1)};
+  CPDF_MeshRasterizer rasterizer(30, 30, 0xff, {});
+  rasterizer.AddTriangle(red);
+  rasterizer.AddTriangle(green);
+  rasterizer.AddTriangle(blue);
+  EXPECT_EQ(3u, rasterizer.triangle_count());
+  auto bitmap = CreateBitmap(30, 30);
+  rasterizer.Rasterize(bitmap);
+
+  EXPECT_EQ(0xff0000ff, GetPixel(bitmap, 2, 2));
+  EXPECT_EQ(0xff00ff00, GetPixel(bitmap, 2, 7));
+  EXPECT_EQ(0xff00ff00, GetPixel(bitmap, 10, 6));
+  EXPECT_EQ(0xffff0000, GetPixel(bitmap, 12, 2));
+}
+
+TEST(CPDFMeshRasterizer, ShadingSteps) {
+  static constexpr FX_ARGB kSteps[] = {0xff000000, 0xff111111, 0xff222222,
+                                       0xff333333};
+  // The index goes from 0 to 4 across the bitmap, and gets clamped.
+  const std::array<CPDF_MeshVertex, 3> triangle = {
+      MakeVertex(0, 0, 0, 0, 0), MakeVertex(16, 0, 4, 0, 0),
+      MakeVertex(0, 16, 0, 0, 0)};
+  CPDF_MeshRasterizer rasterizer(16, 16, 0xff, kSteps);
+  rasterizer.AddTriangle(triangle);
+  auto bitmap = CreateBitmap(16, 16);
+  rasterizer.Rasterize(bitmap);
+
+  // Row 2 spans x from 0 to 14, with the index going from 0 to 3.5.
+  EXPECT_EQ(0xff000000, GetPixel(bitmap, 0, 2));
+  EXPECT_EQ(0xff111111, GetPixel(bitmap, 4, 2));
+  EXPECT_EQ(0xff222222, GetPixel(bitmap, 8, 2));
+  EXPECT_EQ(0xff333333, GetPixel(bitmap, 13, 2));
+  EXPECT_EQ(kBackground, GetPixel(bitmap, 15, 2));
+}
+
+TEST(CPDFMeshRasterizer, OutOfBounds) {
+  // Partially and entirely outside the bitmap, degenerate, and NaN.
+  const std::array<CPDF_MeshVertex, 3> partial = {
+      MakeVertex(-100, -100, 1, 1, 1), MakeVertex(200, -100, 1, 1, 1),
+      MakeVertex(-100, 200, 1, 1, 1)};
+  const std::array<CPDF_MeshVertex, 3> outside = {
+      MakeVertex(0, 50, 0, 0, 0), MakeVertex(10, 50, 0, 0, 0),
+      MakeVertex(0, 60, 0, 0, 0)};
+  const std::array<CPDF_MeshVertex, 3> left = {
+      MakeVertex(-20, 0, 0, 0, 0), MakeVertex(-1, 5, 0, 0, 0),
+      MakeVertex(-10, 9, 0, 0, 0)};
+  const std::array<CPDF_MeshVertex, 3> right = {
+      MakeVertex(10, 0, 0, 0, 0), MakeVertex(30, 5, 0, 0, 0),
+      MakeVertex(15, 9, 0, 0, 0)};
+  const std::array<CPDF_MeshVertex, 3> flat = {
+      MakeVertex(0, 3, 0, 0, 0), MakeVertex(10, 3, 0, 0, 0),
+      MakeVertex(5, 3, 0, 0, 0)};
+  const std::array<CPDF_MeshVertex, 3> nan = {
+      MakeVertex(0, NAN, 0, 0, 0), MakeVertex(10, 3, 0, 0, 0),
+      MakeVertex(5, 8, 0, 0, 0)};
+  CPDF_MeshRasterizer rasterizer(10, 10, 0xff, {});
+  rasterizer.AddTriangle(partial);
+  rasterizer.AddTriangle(outside);
+  rasterizer.AddTriangle(left);
+  rasterizer.AddTriangle(right);
+  rasterizer.AddTriangle(flat);
+  rasterizer.AddTriangle(nan);
+  EXPECT_EQ(1u, rasterizer.triangle_count());
+  auto bitmap = CreateBitmap(10, 10);
+  rasterizer.Rasterize(bitmap);
+
+  EXPECT_EQ(0xffffffff, GetPixel(bitmap, 0, 0));
+  EXPECT_EQ(0xffffffff, GetPixel(bitmap, 9, 9));
+}
+
+TEST(CPDFMeshRasterizer, Flush) {
+  const std::array<CPDF_MeshVertex, 3> red = {MakeVertex(0, 0, 1, 0, 0),
+                                              MakeVertex(20, 0, 1, 0, 0),
+                                              MakeVertex(0, 20, 1, 0, 0)};
+  const std::array<CPDF_MeshVertex, 3> blue = {MakeVertex(0, 0, 0, 0, 1),
+                                               MakeVertex(20, 0, 0, 0, 1),
+                                               MakeVertex(0, 20, 0, 0, 1)};
+  CPDF_MeshRasterizer rasterizer(10, 10, 0xff, {});
+  for (size_t i = 1; i < CPDF_MeshRasterizer::kMaxPendingTriangles; ++i) {
+    rasterizer.AddTriangle(red);
+  }
+  EXPECT_FALSE(rasterizer.IsFull());
+  rasterizer.AddTriangle(blue);
+  EXPECT_TRUE(rasterizer.IsFull());
+
+  auto bitmap = CreateBitmap(10, 10);
+  rasterizer.Flush(bitmap);
+  EXPECT_EQ(0u, rasterizer.triangle_count());
+  EXPECT_EQ(0xff0000ff, GetPixel(bitmap, 2, 2));
+
+  // Triangles from a later batch draw on top of earlier ones.
+  rasterizer.AddTriangle(red);
+  rasterizer.Flush(bitmap);
+  EXPECT_EQ(0xffff0000, GetPixel(bitmap, 2, 2));
+}
+
+TEST(CPDFMeshRasterizer, RowRanges) {
+  CPDF_MeshRasterizer rasterizer(64, 64, 0xff, {});
+  for (int i = 0; i < 50; ++i) {
+    const float x = (i * 37) % 60;
+    const float y = (i * 23) % 60;
+    const float c = i / 50.0f;
+    const std::array<CPDF_MeshVertex, 3> triangle = {
+        MakeVertex(x, y, c, 0, 1 - c), MakeVertex(x + 20, y + 3, 1 - c, c, 0),
+        MakeVertex(x - 5, y + 25, 0, 1, c)};
+    rasterizer.AddTriangle(triangle);
+  }
+  auto whole = CreateBitmap(64, 64);
+  rasterizer.Rasterize(whole);
+
+  // Drawing in bands, in any order, gives the same result.
+  auto banded = CreateBitmap(64, 64);
+  rasterizer.Rasterize(banded, 40, 100);
+  rasterizer.Rasterize(banded, 0, 17);
+  rasterizer.Rasterize(banded, 17, 40);
+  for (int y = 0; y < 64; ++y) {
+    for (int x = 0; x < 64; ++x) {
+      ASSERT_EQ(GetPixel(whole, x, y), GetPixel(banded, x, y))
+          << x << ", " << y;
+    }
+  }
+}
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -23,13 +24,14 @@
 #include "core/fpdfapi/parser/cpdf_stream.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fpdfapi/render/cpdf_devicebuffer.h"
+#include "core/fpdfapi/render/cpdf_meshrasterizer.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/fx_2d_size.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_system.h"
-#include "core/fxcrt/numerics/clamped_math.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/span_util.h"
 #include "core/fxcrt/stl_util.h"
@@ -42,7 +44,11 @@
 
 namespace {
 
+// Number of colors precomputed for mesh shadings, and the minimum for axial
+// and radial shadings.
 constexpr int kShadingSteps = 256;
+constexpr size_t kMaxShadingSteps = 4096;
+constexpr float kMaxPixelsPerShadingStep = 4.0f;
 
 uint32_t CountOutputsFromFunctions(
     const std::vector<std::unique_ptr<CPDF_Function>>& funcs) {
@@ -62,12 +68,58 @@ uint32_t GetValidatedOutputsCount(
   return funcs_outputs ? std::max(funcs_outputs, pCS->ComponentCount()) : 0;
 }
 
+// Evaluates `funcs` at each of the points in `inputs`, which holds
+// `input_count` values per point. Each point gets `results_count` values in
+// `results`, filled the same way as calling each function on that point in
+// turn would. Functions are evaluated for all points at once where possible.
+void CallFunctions(const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
+                   uint32_t input_count,
+                   pdfium::span<const float> inputs,
+                   uint32_t results_count,
+                   pdfium::span<float> results) {
+  const size_t point_count = inputs.size() / input_count;
+  CHECK_EQ(results.size(), Fx2DSizeOrDie(point_count, results_count));
+  // Where the next function's results go for each point. These only differ
+  // between points when a function fails for some points but not others.
+  std::vector<uint32_t> offsets(point_count);
+  std::vector<float> func_results;
+  for (const auto& func : funcs) {
+    if (!func || func->InputCount() != input_count) {
+      continue;
+    }
+
+    const uint32_t output_count = func->OutputCount();
+    func_results.resize(Fx2DSizeOrDie(point_count, output_count));
+    if (func->CallBatch(point_count, inputs, func_results)) {
+      for (size_t i = 0; i < point_count; ++i) {
+        fxcrt::Copy(pdfium::span(func_results)
+                        .subspan(i * output_count, output_count),
+                    results.subspan(i * results_count + offsets[i]));
+        offsets[i] += output_count;
+      }
+      continue;
+    }
+
+    for (size_t i = 0; i < point_count; ++i) {
+      std::optional<uint32_t> nresults = func->Call(
+          inputs.subspan(i * input_count, input_count),
+          results.subspan(i * results_count + offsets[i],
+                          results_count - offsets[i]));
+      if (nresults.has_value()) {
+        offsets[i] += nresults.value();
+      }
+    }
+  }
+}
+
+// Fills `output` with the colors of `funcs` at evenly spaced points from
+// `t_min` to `t_max`.
 bool GetShadingSteps(float t_min,
                      float t_max,
                      const std::vector<std::unique_ptr<CPDF_Function>>& funcs,
                      const RetainPtr<CPDF_ColorSpace>& pCS,
                      int alpha,
-                     std::array<FX_ARGB, kShadingSteps>* output) {
+                     pdfium::span<FX_ARGB> output) {
   const uint32_t results_count = GetValidatedOutputsCount(funcs, pCS);
   if (results_count == 0) {
     return false;
@@ -75,28 +127,69 @@ bool GetShadingSteps(float t_min,
 
   CHECK_GE(results_count, CountOutputsFromFunctions(funcs));
   CHECK_GE(results_count, pCS->ComponentCount());
-  std::array<FX_ARGB, kShadingSteps>& shading_steps = *output;
-  std::vector<float> result_array(results_count);
+  const size_t steps = output.size();
+  std::vector<float> inputs(steps);
   float diff = t_max - t_min;
-  for (int i = 0; i < kShadingSteps; ++i) {
-    float input = diff * i / kShadingSteps + t_min;
-    pdfium::span<float> result_span = pdfium::span(result_array);
-    for (const auto& func : funcs) {
-      if (!func) {
+  for (size_t i = 0; i < steps; ++i) {
+    inputs[i] = diff * i / steps + t_min;
+  }
+  std::vector<float> result_array(Fx2DSizeOrDie(steps, results_count));
+  CallFunctions(funcs, /*input_count=*/1, inputs, results_count,
+                result_array);
+  for (size_t i = 0; i < steps; ++i) {
+    auto rgb = pCS->GetRGBOrZerosOnError(
+        pdfium::span(result_array).subspan(i * results_count, results_count));
+    output[i] =
+        ArgbEncode(alpha, FXSYS_roundf(rgb.red * 255),
+                   FXSYS_roundf(rgb.green * 255), FXSYS_roundf(rgb.blue * 255));
+  }
+  return true;
+}
+
+// Returns how many colors to precompute for an axial or radial shading whose
+// parameter varies over `device_extent` pixels. Long gradients get more
+// colors, so that each one covers at most a few pixels and does not show up
+// as a band.
+size_t GetShadingStepCount(float device_extent) {
+  size_t steps = kShadingSteps;
+  while (steps < kMaxShadingSteps &&
+         steps * kMaxPixelsPerShadingStep < device_extent) {
+    steps *= 2;
+  }
+  return steps;
+}
+
+// Sets each pixel in `dest` to the entry in `shading_steps` that the
+// corresponding entry in `positions` selects. Positions are indices into
+// `shading_steps`, before truncation. Positions outside of the table select
+// its first or last entry if the shading extends in that direction, and
+// leave the pixel alone otherwise. So do NaN positions.
+void FillRowFromShadingSteps(pdfium::span<const float> positions,
+                             pdfium::span<const FX_ARGB> shading_steps,
+                             bool extend_start,
+                             bool extend_end,
+                             pdfium::span<uint32_t> dest) {
+  const float step_count = static_cast<float>(shading_steps.size());
+  for (size_t i = 0; i < dest.size(); ++i) {
+    const float position = positions[i];
+    size_t index;
+    if (position > -1.0f && position < step_count) {
+      index = static_cast<size_t>(std::max(position, 0.0f));
+    } else if (position <= -1.0f) {
+      if (!extend_start) {
         continue;
       }
-      std::optional<uint32_t> nresults =
-          func->Call(pdfium::span_from_ref(input), result_span);
-      if (nresults.has_value()) {
-        result_span = result_span.subspan(nresults.value());
+      index = 0;
+    } else if (position >= step_count) {
+      if (!extend_end) {
+        continue;
       }
+      index = shading_steps.size() - 1;
+    } else {
+      continue;
     }
-    auto rgb = pCS->GetRGBOrZerosOnError(result_array);
-    shading_steps[i] =
-        ArgbEncode(alpha, FXSYS_roundf(rgb.red * 255),
-                   FXSYS_roundf(rgb.green * 255), FXSYS_roundf(rgb.blue * 255));
+    dest[i] = shading_steps[index];
   }
-  return true;
 }
 
 float ComponentToShadingIndex(float c, float c_min, float c_max) {
@@ -140,37 +233,37 @@ void DrawAxialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
   float y_span = end_y - start_y;
   float axis_len_square = (x_span * x_span) + (y_span * y_span);
 
-  std::array<FX_ARGB, kShadingSteps> shading_steps;
-  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, &shading_steps)) {
+  const CFX_PointF device_start =
+      mtObject2Bitmap.Transform(CFX_PointF(start_x, start_y));
+  const CFX_PointF device_end =
+      mtObject2Bitmap.Transform(CFX_PointF(end_x, end_y));
+  std::vector<FX_ARGB> shading_steps(GetShadingStepCount(
+      hypotf(device_end.x - device_start.x, device_end.y - device_start.y)));
+  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, shading_steps)) {
     return;
   }
 
-  CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  // The position along the axis is affine in the column, so each row only
+  // needs its value at the first column and how much it changes per column.
+  const float max_index = static_cast<float>(shading_steps.size() - 1);
+  const CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  const float position_per_column =
+      ((matrix.a * x_span) + (matrix.b * y_span)) / axis_len_square *
+      max_index;
+  std::vector<float> positions(width);
   for (int row = 0; row < height; row++) {
-    auto dest_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
-        static_cast<size_t>(width));
-    size_t column_counter = 0;
-    for (auto& pix : dest_buf) {
-      const float column = static_cast<float>(column_counter++);
-      const CFX_PointF pos =
-          matrix.Transform(CFX_PointF(column, static_cast<float>(row)));
-      float scale =
-          (((pos.x - start_x) * x_span) + ((pos.y - start_y) * y_span)) /
-          axis_len_square;
-      int index = static_cast<int32_t>(scale * (kShadingSteps - 1));
-      if (index < 0) {
-        if (!bStartExtend) {
-          continue;
-        }
-        index = 0;
-      } else if (index >= kShadingSteps) {
-        if (!bEndExtend) {
-          continue;
-        }
-        index = kShadingSteps - 1;
-      }
-      pix = shading_steps[index];
+    const CFX_PointF pos =
+        matrix.Transform(CFX_PointF(0.0f, static_cast<float>(row)));
+    const float row_start =
+        (((pos.x - start_x) * x_span) + ((pos.y - start_y) * y_span)) /
+        axis_len_square * max_index;
+    for (int column = 0; column < width; column++) {
+      positions[column] = row_start + column * position_per_column;
     }
+    FillRowFromShadingSteps(
+        positions, shading_steps, bStartExtend, bEndExtend,
+        pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
+            static_cast<size_t>(width)));
   }
 }
 
@@ -204,34 +297,43 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
   const bool bStartExtend = pArray && pArray->GetBooleanAt(0, false);
   const bool bEndExtend = pArray && pArray->GetBooleanAt(1, false);
 
-  std::array<FX_ARGB, kShadingSteps> shading_steps;
-  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, &shading_steps)) {
-    return;
-  }
-
   const float dx = end_x - start_x;
   const float dy = end_y - start_y;
   const float dr = end_r - start_r;
   const float a = dx * dx + dy * dy - dr * dr;
   const bool a_is_float_zero = FXSYS_IsFloatZero(a);
 
+  std::vector<FX_ARGB> shading_steps(GetShadingStepCount(
+      mtObject2Bitmap.TransformDistance(hypotf(dx, dy) + fabsf(dr))));
+  if (!GetShadingSteps(t_min, t_max, funcs, pCS, alpha, shading_steps)) {
+    return;
+  }
+
   int width = pBitmap->GetWidth();
   int height = pBitmap->GetHeight();
   bool bDecreasing = dr < 0 && static_cast<int>(hypotf(dx, dy)) < -dr;
 
-  CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  // Along a row, the offset from the start circle's center is affine in the
+  // column, which makes `b` affine and `c` quadratic in the column. Each row
+  // computes them from their values at the first column.
+  const float max_index = static_cast<float>(shading_steps.size() - 1);
+  const CFX_Matrix matrix = mtObject2Bitmap.GetInverse();
+  const float b_per_column = -2 * (matrix.a * dx + matrix.b * dy);
+  const float c_per_column_squared = matrix.a * matrix.a + matrix.b * matrix.b;
+  std::vector<float> positions(width);
   for (int row = 0; row < height; row++) {
-    auto dest_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
-        static_cast<size_t>(width));
-    size_t column_counter = 0;
-    for (auto& pix : dest_buf) {
-      const float column = static_cast<float>(column_counter++);
-      const CFX_PointF pos =
-          matrix.Transform(CFX_PointF(column, static_cast<float>(row)));
-      float pos_dx = pos.x - start_x;
-      float pos_dy = pos.y - start_y;
-      float b = -2 * (pos_dx * dx + pos_dy * dy + start_r * dr);
-      float c = pos_dx * pos_dx + pos_dy * pos_dy - start_r * start_r;
+    const CFX_PointF pos =
+        matrix.Transform(CFX_PointF(0.0f, static_cast<float>(row)));
+    const float pos_dx = pos.x - start_x;
+    const float pos_dy = pos.y - start_y;
+    const float b_start = -2 * (pos_dx * dx + pos_dy * dy + start_r * dr);
+    const float c_start =
+        pos_dx * pos_dx + pos_dy * pos_dy - start_r * start_r;
+    const float c_per_column = 2 * (pos_dx * matrix.a + pos_dy * matrix.b);
+    for (int column = 0; column < width; column++) {
+      const float b = b_start + column * b_per_column;
+      const float c =
+          c_start + column * (c_per_column + column * c_per_column_squared);
       float s;
       if (FXSYS_IsFloatZero(b)) {
         s = sqrt(-c / a);
@@ -240,6 +342,7 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
       } else {
         float b2_4ac = (b * b) - 4 * (a * c);
         if (b2_4ac < 0) {
+          positions[column] = std::numeric_limits<float>::quiet_NaN();
           continue;
         }
         float root = sqrt(b2_4ac);
@@ -254,23 +357,16 @@ void DrawRadialShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
           s = (s2 <= 1.0f || bEndExtend) ? s2 : s1;
         }
         if (start_r + s * dr < 0) {
+          positions[column] = std::numeric_limits<float>::quiet_NaN();
           continue;
         }
       }
-      int index = static_cast<int32_t>(s * (kShadingSteps - 1));
-      if (index < 0) {
-        if (!bStartExtend) {
-          continue;
-        }
-        index = 0;
-      } else if (index >= kShadingSteps) {
-        if (!bEndExtend) {
-          continue;
-        }
-        index = kShadingSteps - 1;
-      }
-      pix = shading_steps[index];
+      positions[column] = s * max_index;
     }
+    FillRowFromShadingSteps(
+        positions, shading_steps, bStartExtend, bEndExtend,
+        pBitmap->GetWritableScanlineAs<uint32_t>(row).first(
+            static_cast<size_t>(width)));
   }
 }
 
@@ -306,9 +402,14 @@ void DrawFuncShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
 
   CHECK_GE(total_results, CountOutputsFromFunctions(funcs));
   CHECK_GE(total_results, pCS->ComponentCount());
-  std::vector<float> result_array(total_results);
+  // Each row is evaluated in one batch. `columns` records which pixels of
+  // the row fall inside the domain.
+  std::vector<int> columns;
+  std::vector<float> inputs;
+  std::vector<float> result_array;
   for (int row = 0; row < height; ++row) {
-    auto dib_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row);
+    columns.clear();
+    inputs.clear();
     for (int column = 0; column < width; column++) {
       CFX_PointF pos = matrix.Transform(
           CFX_PointF(static_cast<float>(column), static_cast<float>(row)));
@@ -316,141 +417,26 @@ void DrawFuncShading(const RetainPtr<CFX_DIBitmap>& pBitmap,
         continue;
       }
 
-      float input[2] = {pos.x, pos.y};
-      pdfium::span<float> result_span = pdfium::span(result_array);
-      for (const auto& func : funcs) {
-        if (!func) {
-          continue;
-        }
-        std::optional<uint32_t> nresults = func->Call(input, result_span);
-        if (nresults.has_value()) {
-          result_span = result_span.subspan(nresults.value());
-        }
-      }
-      auto rgb = pCS->GetRGBOrZerosOnError(result_array);
-      dib_buf[column] = ArgbEncode(alpha, static_cast<int32_t>(rgb.red * 255),
-                                   static_cast<int32_t>(rgb.green * 255),
-                                   static_cast<int32_t>(rgb.blue * 255));
-    }
-  }
-}
-
-bool GetScanlineIntersect(int y,
-                          const CFX_PointF& first,
-                          const CFX_PointF& second,
-                          float* x) {
-  if (first.y == second.y) {
-    return false;
-  }
-
-  if (first.y < second.y) {
-    if (y < first.y || y > second.y) {
-      return false;
+      columns.push_back(column);
+      inputs.push_back(pos.x);
+      inputs.push_back(pos.y);
     }
-  } else if (y < second.y || y > first.y) {
-    return false;
-  }
-  *x = first.x + ((second.x - first.x) * (y - first.y) / (second.y - first.y));
-  return true;
-}
-
-void DrawGouraud(const RetainPtr<CFX_DIBitmap>& pBitmap,
-                 int alpha,
-                 pdfium::span<CPDF_MeshVertex, 3> triangle,
-                 const std::array<FX_ARGB, kShadingSteps>* shading_steps) {
-  float min_y = triangle[0].position.y;
-  float max_y = triangle[0].position.y;
-  for (int i = 1; i < 3; i++) {
-    min_y = std::min(min_y, triangle[i].position.y);
-    max_y = std::max(max_y, triangle[i].position.y);
-  }
-  if (min_y == max_y) {
-    return;
-  }
-
-  int min_yi = std::max(static_cast<int>(floorf(min_y)), 0);
-  int max_yi = static_cast<int>(ceilf(max_y));
-  if (max_yi >= pBitmap->GetHeight()) {
-    max_yi = pBitmap->GetHeight() - 1;
-  }
-
-  for (int y = min_yi; y <= max_yi; y++) {
-    int nIntersects = 0;
-    std::array<float, 3> inter_x;
-    std::array<float, 3> r;
-    std::array<float, 3> g;
-    std::array<float, 3> b;
-    for (int i = 0; i < 3; i++) {
-      const CPDF_MeshVertex& vertex1 = triangle[i];
-      const CPDF_MeshVertex& vertex2 = triangle[(i + 1) % 3];
-      const CFX_PointF& position1 = vertex1.position;
-      const CFX_PointF& position2 = vertex2.position;
-      bool bIntersect =
-          GetScanlineIntersect(y, position1, position2, &inter_x[nIntersects]);
-      if (!bIntersect) {
-        continue;
-      }
-
-      float y_dist = (y - position1.y) / (position2.y - position1.y);
-      r[nIntersects] =
-          vertex1.rgb.red + ((vertex2.rgb.red - vertex1.rgb.red) * y_dist);
-      g[nIntersects] = vertex1.rgb.green +
-                       ((vertex2.rgb.green - vertex1.rgb.green) * y_dist);
-      b[nIntersects] =
-          vertex1.rgb.blue + ((vertex2.rgb.blue - vertex1.rgb.blue) * y_dist);
-      nIntersects++;
-    }
-    if (nIntersects != 2) {
+    if (columns.empty()) {
       continue;
     }
 
-    int min_x;
-    int max_x;
-    int start_index;
-    int end_index;
-    if (inter_x[0] < inter_x[1]) {
-      min_x = static_cast<int>(floorf(inter_x[0]));
-      max_x = static_cast<int>(ceilf(inter_x[1]));
-      start_index = 0;
-      end_index = 1;
-    } else {
-      min_x = static_cast<int>(floorf(inter_x[1]));
-      max_x = static_cast<int>(ceilf(inter_x[0]));
-      start_index = 1;
-      end_index = 0;
-    }
-
-    int start_x = std::clamp(min_x, 0, pBitmap->GetWidth());
-    int end_x = std::clamp(max_x, 0, pBitmap->GetWidth());
-    const int range_x = pdfium::ClampSub(max_x, min_x);
-    float r_unit = (r[end_index] - r[start_index]) / range_x;
-    float g_unit = (g[end_index] - g[start_index]) / range_x;
-    float b_unit = (b[end_index] - b[start_index]) / range_x;
-    const int diff_x = pdfium::ClampSub(start_x, min_x);
-    float r_result = r[start_index] + diff_x * r_unit;
-    float g_result = g[start_index] + diff_x * g_unit;
-    float b_result = b[start_index] + diff_x * b_unit;
-    auto dib_span = pBitmap->GetWritableScanlineAs<FX_ARGB>(y).subspan(
-        static_cast<size_t>(start_x));
-
-    for (int x = start_x; x < end_x; x++) {
-      r_result += r_unit;
-      if (shading_steps) {
-        int index = static_cast<int32_t>(r_result);
-        if (index < 0) {
-          index = 0;
-        } else if (index >= kShadingSteps) {
-          index = kShadingSteps - 1;
-        }
-        dib_span.front() = (*shading_steps)[index];
-      } else {
-        g_result += g_unit;
-        b_result += b_unit;
-        dib_span.front() = ArgbEncode(alpha, static_cast<int>(r_result * 255),
-                                      static_cast<int>(g_result * 255),
-                                      static_cast<int>(b_result * 255));
-      }
-      dib_span = dib_span.subspan<1u>();
+    result_array.assign(Fx2DSizeOrDie(columns.size(), total_results), 0.0f);
+    CallFunctions(funcs, /*input_count=*/2, inputs, total_results,
+                  result_array);
+    auto dib_buf = pBitmap->GetWritableScanlineAs<uint32_t>(row);
+    for (size_t i = 0; i < columns.size(); ++i) {
+      auto rgb = pCS->GetRGBOrZerosOnError(
+          pdfium::span(result_array)
+              .subspan(i * total_results, total_results));
+      dib_buf[columns[i]] =
+          ArgbEncode(alpha, static_cast<int32_t>(rgb.red * 255),
+                     static_cast<int32_t>(rgb.green * 255),
+                     static_cast<int32_t>(rgb.blue * 255));
     }
   }
 }
@@ -473,19 +459,22 @@ void DrawFreeGouraudShading(
   std::array<FX_ARGB, kShadingSteps> shading_steps;
   if (!funcs.empty()) {
     if (!GetShadingSteps(stream.component_min(0), stream.component_max(0),
-                         funcs, pCS, alpha, &shading_steps)) {
+                         funcs, pCS, alpha, shading_steps)) {
       return;
     }
   }
   float c0_min = stream.component_min(0);
   float c0_max = stream.component_max(0);
 
+  CPDF_MeshRasterizer rasterizer(
+      pBitmap->GetWidth(), pBitmap->GetHeight(), alpha,
+      funcs.empty() ? pdfium::span<const FX_ARGB>() : shading_steps);
   std::array<CPDF_MeshVertex, 3> triangle;
   while (!stream.IsEOF()) {
     CPDF_MeshVertex vertex;
     uint32_t flag;
     if (!stream.ReadVertex(mtObject2Bitmap, &vertex, &flag)) {
-      return;
+      break;
     }
     if (!funcs.empty()) {
       vertex.rgb.red = ComponentToShadingIndex(vertex.rgb.red, c0_min, c0_max);
@@ -493,16 +482,21 @@ void DrawFreeGouraudShading(
 
     if (flag == 0) {
       triangle[0] = vertex;
+      bool read_all = true;
       for (int i = 1; i < 3; ++i) {
         uint32_t dummy_flag;
         if (!stream.ReadVertex(mtObject2Bitmap, &triangle[i], &dummy_flag)) {
-          return;
+          read_all = false;
+          break;
         }
         if (!funcs.empty()) {
           triangle[i].rgb.red =
               ComponentToShadingIndex(triangle[i].rgb.red, c0_min, c0_max);
         }
       }
+      if (!read_all) {
+        break;
+      }
     } else {
       if (flag == 1) {
         triangle[0] = triangle[1];
@@ -511,9 +505,12 @@ void DrawFreeGouraudShading(
       triangle[1] = triangle[2];
       triangle[2] = vertex;
     }
-    DrawGouraud(pBitmap, alpha, triangle,
-                funcs.empty() ? nullptr : &shading_steps);
+    rasterizer.AddTriangle(triangle);
+    if (rasterizer.IsFull()) {
+      rasterizer.Flush(pBitmap);
+    }
   }
+  rasterizer.Flush(pBitmap);
 }
 
 void DrawLatticeGouraudShading(
@@ -539,7 +536,7 @@ void DrawLatticeGouraudShading(
   std::array<FX_ARGB, kShadingSteps> shading_steps;
   if (!funcs.empty()) {
     if (!GetShadingSteps(stream.component_min(0), stream.component_max(0),
-                         funcs, pCS, alpha, &shading_steps)) {
+                         funcs, pCS, alpha, shading_steps)) {
       return;
     }
   }
@@ -557,11 +554,14 @@ void DrawLatticeGouraudShading(
     }
   }
 
+  CPDF_MeshRasterizer rasterizer(
+      pBitmap->GetWidth(), pBitmap->GetHeight(), alpha,
+      funcs.empty() ? pdfium::span<const FX_ARGB>() : shading_steps);
   int last_index = 0;
   while (true) {
     vertices[1 - last_index] = stream.ReadVertexRow(mtObject2Bitmap, row_verts);
     if (vertices[1 - last_index].empty()) {
-      return;
+      break;
     }
     for (auto& vertex : vertices[1 - last_index]) {
       if (!funcs.empty()) {
@@ -575,14 +575,16 @@ void DrawLatticeGouraudShading(
       triangle[0] = vertices[last_index][i];
       triangle[1] = vertices[1 - last_index][i - 1];
       triangle[2] = vertices[last_index][i - 1];
-      DrawGouraud(pBitmap, alpha, triangle,
-                  funcs.empty() ? nullptr : &shading_steps);
+      rasterizer.AddTriangle(triangle);
       triangle[2] = vertices[1 - last_index][i];
-      DrawGouraud(pBitmap, alpha, triangle,
-                  funcs.empty() ? nullptr : &shading_steps);
+      rasterizer.AddTriangle(triangle);
+      if (rasterizer.IsFull()) {
+        rasterizer.Flush(pBitmap);
+      }
     }
     last_index = 1 - last_index;
   }
+  rasterizer.Flush(pBitmap);
 }
 
 struct CubicBezierPatch {
@@ -867,7 +869,7 @@ void DrawCoonPatchMeshes(
   std::array<FX_ARGB, kShadingSteps> shading_steps;
   if (!funcs.empty()) {
     if (!GetShadingSteps(stream.component_min(0), stream.component_max(0),
-                         funcs, pCS, alpha, &shading_steps)) {
+                         funcs, pCS, alpha, shading_steps)) {
       return;
     }
   }
@@ -9,6 +9,7 @@
 #include <math.h>
 
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "core/fpdfapi/font/cpdf_type3char.h"
@@ -79,6 +80,35 @@ int DetectLastScan(const RetainPtr<CFX_DIBitmap>& pBitmap) {
   return -1;
 }
 
+CFX_Matrix GetImageMatrix(const CPDF_Type3Char* pChar,
+                          const CFX_Matrix& mtMatrix) {
+  CFX_Matrix text_matrix(mtMatrix.a, mtMatrix.b, mtMatrix.c, mtMatrix.d, 0, 0);
+  return pChar->matrix() * text_matrix;
+}
+
+// Snaps the top and bottom of axis-aligned glyphs which fill their whole image
+// to the blue zones of `pSize`. Returns the snapped lines, or std::nullopt if
+// the glyph does not get snapped.
+std::optional<std::pair<int, int>> SnapToBlues(
+    CPDF_Type3GlyphMap* pSize,
+    const RetainPtr<CFX_DIBitmap>& pBitmap,
+    const CFX_Matrix& image_matrix) {
+  if (fabs(image_matrix.b) >= fabs(image_matrix.a) / 100 ||
+      fabs(image_matrix.c) >= fabs(image_matrix.d) / 100) {
+    return std::nullopt;
+  }
+  if (DetectFirstScan(pBitmap) != 0 ||
+      DetectLastScan(pBitmap) != pBitmap->GetHeight() - 1) {
+    return std::nullopt;
+  }
+  float top_y = image_matrix.d + image_matrix.f;
+  float bottom_y = image_matrix.f;
+  if (top_y > bottom_y) {
+    std::swap(top_y, bottom_y);
+  }
+  return pSize->AdjustBlue(top_y, bottom_y);
+}
+
 }  // namespace
 
 CPDF_Type3Cache::CPDF_Type3Cache(CPDF_Type3Font* font) : font_(font) {}
@@ -87,12 +117,8 @@ CPDF_Type3Cache::~CPDF_Type3Cache() = default;
 
 const CFX_GlyphBitmap* CPDF_Type3Cache::LoadGlyph(uint32_t charcode,
                                                   const CFX_Matrix& mtMatrix) {
-  SizeKey keygen = {
-      FXSYS_roundf(mtMatrix.a * 10000),
-      FXSYS_roundf(mtMatrix.b * 10000),
-      FXSYS_roundf(mtMatrix.c * 10000),
-      FXSYS_roundf(mtMatrix.d * 10000),
-  };
+  const CPDF_Type3GlyphCache::SizeKey keygen =
+      CPDF_Type3GlyphCache::GetSizeKey(mtMatrix);
   CPDF_Type3GlyphMap* pSizeCache;
   auto it = size_map_.find(keygen);
   if (it == size_map_.end()) {
@@ -107,17 +133,6 @@ const CFX_GlyphBitmap* CPDF_Type3Cache::LoadGlyph(uint32_t charcode,
     return pExisting;
   }
 
-  std::unique_ptr<CFX_GlyphBitmap> pNewBitmap =
-      RenderGlyph(pSizeCache, charcode, mtMatrix);
-  CFX_GlyphBitmap* pGlyphBitmap = pNewBitmap.get();
-  pSizeCache->SetBitmap(charcode, std::move(pNewBitmap));
-  return pGlyphBitmap;
-}
-
-std::unique_ptr<CFX_GlyphBitmap> CPDF_Type3Cache::RenderGlyph(
-    CPDF_Type3GlyphMap* pSize,
-    uint32_t charcode,
-    const CFX_Matrix& mtMatrix) {
   CPDF_Type3Char* pChar = font_->LoadChar(charcode);
   if (!pChar) {
     return nullptr;
@@ -128,39 +143,53 @@ std::unique_ptr<CFX_GlyphBitmap> CPDF_Type3Cache::RenderGlyph(
     return nullptr;
   }
 
-  CFX_Matrix text_matrix(mtMatrix.a, mtMatrix.b, mtMatrix.c, mtMatrix.d, 0, 0);
-  CFX_Matrix image_matrix = pChar->matrix() * text_matrix;
+  // Snapping depends on the glyphs this font drew before at this size, so it
+  // has to happen before looking up the process-wide cache, and the snapped
+  // lines are part of the key.
+  const CFX_Matrix image_matrix = GetImageMatrix(pChar, mtMatrix);
+  const CPDF_Type3GlyphCache::SnappedLines snapped_lines =
+      SnapToBlues(pSizeCache, pBitmap, image_matrix);
+
+  // Glyphs drawn from identical images are shared with other fonts and
+  // documents through the process-wide cache.
+  CPDF_Type3GlyphCache* pGlyphCache = CPDF_Type3GlyphCache::GetInstance();
+  RetainPtr<const CPDF_Type3GlyphCache::Glyph> pGlyph =
+      pGlyphCache->Find(pBitmap, pChar->matrix(), keygen, snapped_lines);
+  if (!pGlyph) {
+    pGlyph = pGlyphCache->Add(pBitmap, pChar->matrix(), keygen, snapped_lines,
+                              RenderGlyph(pBitmap, image_matrix,
+                                          snapped_lines));
+  }
+  const CFX_GlyphBitmap* pGlyphBitmap = pGlyph ? pGlyph->bitmap() : nullptr;
+  pSizeCache->SetGlyph(charcode, std::move(pGlyph));
+  return pGlyphBitmap;
+}
 
+// static
+std::unique_ptr<CFX_GlyphBitmap> CPDF_Type3Cache::RenderGlyph(
+    const RetainPtr<CFX_DIBitmap>& pBitmap,
+    const CFX_Matrix& image_matrix,
+    const CPDF_Type3GlyphCache::SnappedLines& snapped_lines) {
   RetainPtr<CFX_DIBitmap> pResBitmap;
   int left = 0;
   int top = 0;
-  if (fabs(image_matrix.b) < fabs(image_matrix.a) / 100 &&
-      fabs(image_matrix.c) < fabs(image_matrix.d) / 100) {
-    int top_line = DetectFirstScan(pBitmap);
-    int bottom_line = DetectLastScan(pBitmap);
-    if (top_line == 0 && bottom_line == pBitmap->GetHeight() - 1) {
-      float top_y = image_matrix.d + image_matrix.f;
-      float bottom_y = image_matrix.f;
-      bool bFlipped = top_y > bottom_y;
-      if (bFlipped) {
-        std::swap(top_y, bottom_y);
-      }
-      std::tie(top_line, bottom_line) = pSize->AdjustBlue(top_y, bottom_y);
-      FX_SAFE_INT32 safe_height = bFlipped ? top_line : bottom_line;
-      safe_height -= bFlipped ? bottom_line : top_line;
-      if (!safe_height.IsValid()) {
-        return nullptr;
-      }
-
-      pResBitmap = pBitmap->StretchTo(static_cast<int>(image_matrix.a),
-                                      safe_height.ValueOrDie(),
-                                      FXDIB_ResampleOptions(), nullptr);
-      top = top_line;
-      if (image_matrix.a < 0) {
-        left = FXSYS_roundf(image_matrix.e + image_matrix.a);
-      } else {
-        left = FXSYS_roundf(image_matrix.e);
-      }
+  if (snapped_lines.has_value()) {
+    const auto [top_line, bottom_line] = snapped_lines.value();
+    const bool bFlipped = image_matrix.d > 0;
+    FX_SAFE_INT32 safe_height = bFlipped ? top_line : bottom_line;
+    safe_height -= bFlipped ? bottom_line : top_line;
+    if (!safe_height.IsValid()) {
+      return nullptr;
+    }
+
+    pResBitmap = pBitmap->StretchTo(static_cast<int>(image_matrix.a),
+                                    safe_height.ValueOrDie(),
+                                    FXDIB_ResampleOptions(), nullptr);
+    top = top_line;
+    if (image_matrix.a < 0) {
+      left = FXSYS_roundf(image_matrix.e + image_matrix.a);
+    } else {
+      left = FXSYS_roundf(image_matrix.e);
     }
   }
   if (!pResBitmap) {
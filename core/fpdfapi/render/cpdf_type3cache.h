@@ -11,12 +11,12 @@
 
 #include <map>
 #include <memory>
-#include <tuple>
 
-#include "core/fxcrt/bytestring.h"
+#include "core/fpdfapi/render/cpdf_type3glyphcache.h"
 #include "core/fxcrt/observed_ptr.h"
 #include "core/fxcrt/retain_ptr.h"
 
+class CFX_DIBitmap;
 class CFX_GlyphBitmap;
 class CFX_Matrix;
 class CPDF_Type3Font;
@@ -30,17 +30,17 @@ class CPDF_Type3Cache final : public Retainable, public Observable {
                                    const CFX_Matrix& mtMatrix);
 
  private:
-  using SizeKey = std::tuple<int, int, int, int>;
-
   explicit CPDF_Type3Cache(CPDF_Type3Font* font);
   ~CPDF_Type3Cache() override;
 
-  std::unique_ptr<CFX_GlyphBitmap> RenderGlyph(CPDF_Type3GlyphMap* pSize,
-                                               uint32_t charcode,
-                                               const CFX_Matrix& mtMatrix);
+  static std::unique_ptr<CFX_GlyphBitmap> RenderGlyph(
+      const RetainPtr<CFX_DIBitmap>& pBitmap,
+      const CFX_Matrix& image_matrix,
+      const CPDF_Type3GlyphCache::SnappedLines& snapped_lines);
 
   RetainPtr<CPDF_Type3Font> const font_;
-  std::map<SizeKey, std::unique_ptr<CPDF_Type3GlyphMap>> size_map_;
+  std::map<CPDF_Type3GlyphCache::SizeKey, std::unique_ptr<CPDF_Type3GlyphMap>>
+      size_map_;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_TYPE3CACHE_H_
@@ -0,0 +1,173 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_type3glyphcache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/fx_system.h"
+#include "core/fxge/cfx_glyphbitmap.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace {
+
+CPDF_Type3GlyphCache* g_Type3GlyphCache = nullptr;
+
+bool SourcesMatch(const RetainPtr<CFX_DIBitmap>& a,
+                  const RetainPtr<CFX_DIBitmap>& b) {
+  if (a == b) {
+    return true;
+  }
+  return a->GetWidth() == b->GetWidth() && a->GetHeight() == b->GetHeight() &&
+         a->GetFormat() == b->GetFormat() && a->GetPitch() == b->GetPitch() &&
+         std::ranges::equal(a->GetPaletteSpan(), b->GetPaletteSpan()) &&
+         std::ranges::equal(a->GetBuffer(), b->GetBuffer());
+}
+
+}  // namespace
+
+CPDF_Type3GlyphCache::Glyph::Glyph(std::unique_ptr<CFX_GlyphBitmap> bitmap)
+    : bitmap_(std::move(bitmap)) {
+  CHECK(bitmap_);
+}
+
+CPDF_Type3GlyphCache::Glyph::~Glyph() = default;
+
+// static
+void CPDF_Type3GlyphCache::Create() {
+  DCHECK(!g_Type3GlyphCache);
+  g_Type3GlyphCache = new CPDF_Type3GlyphCache();
+}
+
+// static
+void CPDF_Type3GlyphCache::Destroy() {
+  DCHECK(g_Type3GlyphCache);
+  delete g_Type3GlyphCache;
+  g_Type3GlyphCache = nullptr;
+}
+
+// static
+CPDF_Type3GlyphCache* CPDF_Type3GlyphCache::GetInstance() {
+  DCHECK(g_Type3GlyphCache);
+  return g_Type3GlyphCache;
+}
+
+// static
+CPDF_Type3GlyphCache::SizeKey CPDF_Type3GlyphCache::GetSizeKey(
+    const CFX_Matrix& matrix) {
+  return {
+      FXSYS_roundf(matrix.a * 10000),
+      FXSYS_roundf(matrix.b * 10000),
+      FXSYS_roundf(matrix.c * 10000),
+      FXSYS_roundf(matrix.d * 10000),
+  };
+}
+
+CPDF_Type3GlyphCache::CPDF_Type3GlyphCache()
+    : CPDF_Type3GlyphCache(kDefaultMaxBytes) {}
+
+CPDF_Type3GlyphCache::CPDF_Type3GlyphCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+CPDF_Type3GlyphCache::~CPDF_Type3GlyphCache() = default;
+
+RetainPtr<const CPDF_Type3GlyphCache::Glyph> CPDF_Type3GlyphCache::Find(
+    const RetainPtr<CFX_DIBitmap>& source,
+    const CFX_Matrix& source_matrix,
+    const SizeKey& size,
+    const SnappedLines& snapped_lines) {
+  CHECK(source);
+  auto range = index_.equal_range({HashSource(*source), size});
+  for (auto it = range.first; it != range.second; ++it) {
+    auto entry_it = it->second;
+    if (entry_it->source_matrix != source_matrix ||
+        entry_it->snapped_lines != snapped_lines ||
+        !SourcesMatch(entry_it->source, source)) {
+      continue;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, entry_it);
+    return entries_.front().glyph;
+  }
+  ++stats_.misses;
+  return nullptr;
+}
+
+RetainPtr<const CPDF_Type3GlyphCache::Glyph> CPDF_Type3GlyphCache::Add(
+    const RetainPtr<CFX_DIBitmap>& source,
+    const CFX_Matrix& source_matrix,
+    const SizeKey& size,
+    const SnappedLines& snapped_lines,
+    std::unique_ptr<CFX_GlyphBitmap> bitmap) {
+  CHECK(source);
+  if (!bitmap) {
+    return nullptr;
+  }
+
+  // Entries keep `source` alive for comparisons, so it counts against the
+  // budget as well.
+  const RetainPtr<CFX_DIBitmap>& pixels = bitmap->GetBitmap();
+  const size_t bytes =
+      static_cast<size_t>(pixels->GetPitch()) * pixels->GetHeight() +
+      static_cast<size_t>(source->GetPitch()) * source->GetHeight();
+  auto glyph = pdfium::MakeRetain<Glyph>(std::move(bitmap));
+  const uint32_t hash = HashSource(*source);
+  entries_.emplace_front(hash, source, source_matrix, size, snapped_lines,
+                         glyph, bytes);
+  index_.emplace(IndexKey(hash, size), entries_.begin());
+  bytes_ += bytes;
+  // Always keep the newest entry, even if it exceeds the budget on its own.
+  while (bytes_ > max_bytes_ && entries_.size() > 1) {
+    EvictLeastRecentlyUsed();
+  }
+  return glyph;
+}
+
+void CPDF_Type3GlyphCache::Clear() {
+  index_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+// static
+uint32_t CPDF_Type3GlyphCache::HashSource(const CFX_DIBitmap& source) {
+  return FX_HashCode_GetA(ByteStringView(source.GetBuffer()));
+}
+
+void CPDF_Type3GlyphCache::EvictLeastRecentlyUsed() {
+  auto entry_it = std::prev(entries_.end());
+  auto range = index_.equal_range({entry_it->hash, entry_it->size});
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == entry_it) {
+      index_.erase(it);
+      break;
+    }
+  }
+  bytes_ -= entry_it->bytes;
+  entries_.erase(entry_it);
+  ++stats_.evictions;
+}
+
+CPDF_Type3GlyphCache::Entry::Entry(uint32_t hash,
+                                   RetainPtr<CFX_DIBitmap> source,
+                                   const CFX_Matrix& source_matrix,
+                                   const SizeKey& size,
+                                   const SnappedLines& snapped_lines,
+                                   RetainPtr<const Glyph> glyph,
+                                   size_t bytes)
+    : hash(hash),
+      source(std::move(source)),
+      source_matrix(source_matrix),
+      size(size),
+      snapped_lines(snapped_lines),
+      glyph(std::move(glyph)),
+      bytes(bytes) {}
+
+CPDF_Type3GlyphCache::Entry::Entry(Entry&& that) noexcept = default;
+
+CPDF_Type3GlyphCache::Entry::~Entry() = default;
@@ -0,0 +1,136 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFAPI_RENDER_CPDF_TYPE3GLYPHCACHE_H_
+#define CORE_FPDFAPI_RENDER_CPDF_TYPE3GLYPHCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+
+class CFX_DIBitmap;
+class CFX_GlyphBitmap;
+
+// Process-wide cache of rendered Type 3 glyphs. CPDF_Type3Cache instances only
+// live as long as the text object being rendered, so without this cache every
+// text object re-rasterizes its Type 3 glyphs.
+//
+// Entries are keyed by the image a CharProc draws, the matrix the CharProc
+// applies to it, and the scale and rotation components of the device matrix.
+// Translation is not part of the key, as glyphs get positioned by the caller.
+// Glyphs snapped to the blue zones of their font also get keyed by the lines
+// they got snapped to, as those depend on the font's earlier glyphs.
+// Since the key does not depend on the font or the document, Type 3 fonts with
+// identical glyph images share bitmaps, even across documents. Once the glyph
+// bitmaps and the source images kept for comparison exceed the memory budget,
+// the least recently used entries get evicted.
+class CPDF_Type3GlyphCache {
+ public:
+  // Ref-counted, so glyphs can outlive their cache entries while in use.
+  class Glyph final : public Retainable {
+   public:
+    CONSTRUCT_VIA_MAKE_RETAIN;
+
+    const CFX_GlyphBitmap* bitmap() const { return bitmap_.get(); }
+
+   private:
+    explicit Glyph(std::unique_ptr<CFX_GlyphBitmap> bitmap);
+    ~Glyph() override;
+
+    const std::unique_ptr<CFX_GlyphBitmap> bitmap_;
+  };
+
+  // The quantized a, b, c and d components of the device matrix.
+  using SizeKey = std::tuple<int, int, int, int>;
+
+  // The top and bottom lines a glyph got snapped to, if any.
+  using SnappedLines = std::optional<std::pair<int, int>>;
+
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  static constexpr size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  // Per-process singleton which must be managed by callers.
+  static void Create();
+  static void Destroy();
+  static CPDF_Type3GlyphCache* GetInstance();
+
+  static SizeKey GetSizeKey(const CFX_Matrix& matrix);
+
+  CPDF_Type3GlyphCache();
+  explicit CPDF_Type3GlyphCache(size_t max_bytes);
+  ~CPDF_Type3GlyphCache();
+
+  // Returns the glyph previously added for `source` drawn with
+  // `source_matrix` at `size` and snapped to `snapped_lines`, or nullptr on a
+  // cache miss.
+  RetainPtr<const Glyph> Find(const RetainPtr<CFX_DIBitmap>& source,
+                              const CFX_Matrix& source_matrix,
+                              const SizeKey& size,
+                              const SnappedLines& snapped_lines);
+
+  // Adds `bitmap` as the rendering of `source` drawn with `source_matrix` at
+  // `size` and snapped to `snapped_lines`. Returns nullptr if `bitmap` is
+  // null.
+  RetainPtr<const Glyph> Add(const RetainPtr<CFX_DIBitmap>& source,
+                             const CFX_Matrix& source_matrix,
+                             const SizeKey& size,
+                             const SnappedLines& snapped_lines,
+                             std::unique_ptr<CFX_GlyphBitmap> bitmap);
+
+  void Clear();
+
+  size_t size() const { return entries_.size(); }
+  size_t bytes() const { return bytes_; }
+  const Stats& stats() const { return stats_; }
+
+ private:
+  using IndexKey = std::tuple<uint32_t, SizeKey>;
+
+  struct Entry {
+    Entry(uint32_t hash,
+          RetainPtr<CFX_DIBitmap> source,
+          const CFX_Matrix& source_matrix,
+          const SizeKey& size,
+          const SnappedLines& snapped_lines,
+          RetainPtr<const Glyph> glyph,
+          size_t bytes);
+    Entry(Entry&& that) noexcept;
+    ~Entry();
+
+    uint32_t hash;
+    RetainPtr<CFX_DIBitmap> source;
+    CFX_Matrix source_matrix;
+    SizeKey size;
+    SnappedLines snapped_lines;
+    RetainPtr<const Glyph> glyph;
+    size_t bytes;
+  };
+
+  static uint32_t HashSource(const CFX_DIBitmap& source);
+
+  void EvictLeastRecentlyUsed();
+
+  const size_t max_bytes_;
+  size_t bytes_ = 0;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::multimap<IndexKey, std::list<Entry>::iterator> index_;
+  Stats stats_;
+};
+
+#endif  // CORE_FPDFAPI_RENDER_CPDF_TYPE3GLYPHCACHE_H_
@@ -0,0 +1,146 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdfapi/render/cpdf_type3glyphcache.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <utility>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/cfx_glyphbitmap.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Each source takes up 8 * 8 = 64 bytes.
+RetainPtr<CFX_DIBitmap> CreateSource(uint8_t value) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(8, 8, FXDIB_Format::k8bppMask));
+  bitmap->Clear(static_cast<uint32_t>(value) << 24);
+  return bitmap;
+}
+
+// Each glyph takes up 32 * 32 = 1024 bytes.
+std::unique_ptr<CFX_GlyphBitmap> CreateGlyph() {
+  auto glyph = std::make_unique<CFX_GlyphBitmap>(1, 2);
+  CHECK(glyph->GetBitmap()->Create(32, 32, FXDIB_Format::k8bppMask));
+  return glyph;
+}
+
+constexpr CPDF_Type3GlyphCache::SnappedLines kUnsnapped;
+
+}  // namespace
+
+TEST(CPDFType3GlyphCache, SizeKeyIgnoresTranslation) {
+  EXPECT_EQ(CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(1, 0, 0, 2, 0, 0)),
+            CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(1, 0, 0, 2, 30, 40)));
+  EXPECT_NE(CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(1, 0, 0, 2, 0, 0)),
+            CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(1, 0, 0, 3, 0, 0)));
+}
+
+TEST(CPDFType3GlyphCache, SharesIdenticalSources) {
+  CPDF_Type3GlyphCache cache;
+  const CFX_Matrix source_matrix(10, 0, 0, 10, 0, 0);
+  const CPDF_Type3GlyphCache::SizeKey size =
+      CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(1, 0, 0, 1, 0, 0));
+  RetainPtr<CFX_DIBitmap> source = CreateSource(0xff);
+  EXPECT_FALSE(cache.Find(source, source_matrix, size, kUnsnapped));
+  RetainPtr<const CPDF_Type3GlyphCache::Glyph> glyph =
+      cache.Add(source, source_matrix, size, kUnsnapped, CreateGlyph());
+  ASSERT_TRUE(glyph);
+  EXPECT_EQ(1, glyph->bitmap()->left());
+  EXPECT_EQ(2, glyph->bitmap()->top());
+
+  // A different bitmap object with the same pixels, e.g. one from another
+  // document, finds the same glyph.
+  EXPECT_EQ(glyph,
+            cache.Find(CreateSource(0xff), source_matrix, size, kUnsnapped));
+  EXPECT_EQ(1u, cache.stats().hits);
+  EXPECT_EQ(1u, cache.stats().misses);
+
+  // Different pixels, matrices, or sizes do not.
+  EXPECT_FALSE(cache.Find(CreateSource(0x80), source_matrix, size, kUnsnapped));
+  EXPECT_FALSE(cache.Find(source, CFX_Matrix(), size, kUnsnapped));
+  EXPECT_FALSE(cache.Find(
+      source, source_matrix,
+      CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(2, 0, 0, 2, 0, 0)),
+      kUnsnapped));
+  EXPECT_EQ(1u, cache.stats().hits);
+  EXPECT_EQ(4u, cache.stats().misses);
+
+  // Failed renderings are not cached.
+  EXPECT_FALSE(cache.Add(CreateSource(0x80), source_matrix, size, kUnsnapped,
+                         nullptr));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(1024u + 64u, cache.bytes());
+
+  // Glyphs outlive the cache entries.
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.bytes());
+  EXPECT_EQ(32, glyph->bitmap()->GetBitmap()->GetWidth());
+}
+
+TEST(CPDFType3GlyphCache, KeysOnSnappedLines) {
+  CPDF_Type3GlyphCache cache;
+  const CFX_Matrix source_matrix(10, 0, 0, 10, 0, 0);
+  const CPDF_Type3GlyphCache::SizeKey size =
+      CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix(1, 0, 0, 1, 0, 0));
+  RetainPtr<CFX_DIBitmap> source = CreateSource(0xff);
+  const CPDF_Type3GlyphCache::SnappedLines snapped = std::make_pair(-10, 0);
+  RetainPtr<const CPDF_Type3GlyphCache::Glyph> glyph =
+      cache.Add(source, source_matrix, size, snapped, CreateGlyph());
+  ASSERT_TRUE(glyph);
+  EXPECT_EQ(glyph, cache.Find(source, source_matrix, size, snapped));
+
+  // Fonts which snapped the same image to other lines, or not at all, must
+  // not get this glyph.
+  EXPECT_FALSE(cache.Find(source, source_matrix, size, std::make_pair(-9, 0)));
+  EXPECT_FALSE(cache.Find(source, source_matrix, size, kUnsnapped));
+}
+
+TEST(CPDFType3GlyphCache, CountsSourcesAgainstBudget) {
+  // Room for two glyphs, but not for two glyphs and their sources.
+  CPDF_Type3GlyphCache cache(2 * 1024);
+  const CFX_Matrix source_matrix;
+  const CPDF_Type3GlyphCache::SizeKey size =
+      CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix());
+  cache.Add(CreateSource(1), source_matrix, size, kUnsnapped, CreateGlyph());
+  cache.Add(CreateSource(2), source_matrix, size, kUnsnapped, CreateGlyph());
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(1024u + 64u, cache.bytes());
+  EXPECT_EQ(1u, cache.stats().evictions);
+}
+
+TEST(CPDFType3GlyphCache, EvictsLeastRecentlyUsed) {
+  CPDF_Type3GlyphCache cache(3 * (1024 + 64));
+  const CFX_Matrix source_matrix;
+  RetainPtr<CFX_DIBitmap> sources[] = {CreateSource(1), CreateSource(2),
+                                       CreateSource(3), CreateSource(4)};
+  const CPDF_Type3GlyphCache::SizeKey size =
+      CPDF_Type3GlyphCache::GetSizeKey(CFX_Matrix());
+  RetainPtr<const CPDF_Type3GlyphCache::Glyph> first =
+      cache.Add(sources[0], source_matrix, size, kUnsnapped, CreateGlyph());
+  cache.Add(sources[1], source_matrix, size, kUnsnapped, CreateGlyph());
+  cache.Add(sources[2], source_matrix, size, kUnsnapped, CreateGlyph());
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(0u, cache.stats().evictions);
+
+  // Touch the oldest entry, so the second oldest one gets evicted instead.
+  EXPECT_EQ(first, cache.Find(sources[0], source_matrix, size, kUnsnapped));
+  cache.Add(sources[3], source_matrix, size, kUnsnapped, CreateGlyph());
+  EXPECT_EQ(3u, cache.size());
+  EXPECT_EQ(3 * (1024u + 64u), cache.bytes());
+  EXPECT_EQ(1u, cache.stats().evictions);
+  EXPECT_TRUE(cache.Find(sources[0], source_matrix, size, kUnsnapped));
+  EXPECT_FALSE(cache.Find(sources[1], source_matrix, size, kUnsnapped));
+  EXPECT_TRUE(cache.Find(sources[2], source_matrix, size, kUnsnapped));
+  EXPECT_TRUE(cache.Find(sources[3], source_matrix, size, kUnsnapped));
+}
@@ -52,10 +52,12 @@ std::pair<int, int> CPDF_Type3GlyphMap::AdjustBlue(float top, float bottom) {
 
 const CFX_GlyphBitmap* CPDF_Type3GlyphMap::GetBitmap(uint32_t charcode) const {
   auto it = glyph_map_.find(charcode);
-  return it != glyph_map_.end() ? it->second.get() : nullptr;
+  return it != glyph_map_.end() && it->second ? it->second->bitmap()
+                                               : nullptr;
 }
 
-void CPDF_Type3GlyphMap::SetBitmap(uint32_t charcode,
-                                   std::unique_ptr<CFX_GlyphBitmap> bitmap) {
-  glyph_map_[charcode] = std::move(bitmap);
+void CPDF_Type3GlyphMap::SetGlyph(
+    uint32_t charcode,
+    RetainPtr<const CPDF_Type3GlyphCache::Glyph> glyph) {
+  glyph_map_[charcode] = std::move(glyph);
 }
@@ -10,10 +10,12 @@
 #include <stdint.h>
 
 #include <map>
-#include <memory>
 #include <utility>
 #include <vector>
 
+#include "core/fpdfapi/render/cpdf_type3glyphcache.h"
+#include "core/fxcrt/retain_ptr.h"
+
 class CFX_GlyphBitmap;
 
 class CPDF_Type3GlyphMap {
@@ -25,12 +27,13 @@ class CPDF_Type3GlyphMap {
   std::pair<int, int> AdjustBlue(float top, float bottom);
 
   const CFX_GlyphBitmap* GetBitmap(uint32_t charcode) const;
-  void SetBitmap(uint32_t charcode, std::unique_ptr<CFX_GlyphBitmap> bitmap);
+  void SetGlyph(uint32_t charcode,
+                RetainPtr<const CPDF_Type3GlyphCache::Glyph> glyph);
 
  private:
   std::vector<int> top_blue_;
   std::vector<int> bottom_blue_;
-  std::map<uint32_t, std::unique_ptr<CFX_GlyphBitmap>> glyph_map_;
+  std::map<uint32_t, RetainPtr<const CPDF_Type3GlyphCache::Glyph>> glyph_map_;
 };
 
 #endif  // CORE_FPDFAPI_RENDER_CPDF_TYPE3GLYPHMAP_H_
@@ -2,6 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <set>
+
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/cfx_defaultrenderdevice.h"
 #include "public/cpp/fpdf_scopers.h"
 #include "testing/embedder_test.h"
 #include "testing/embedder_test_constants.h"
@@ -17,3 +25,37 @@ TEST_F(FPDFRenderPatternEmbedderTest, LoadError547706) {
   ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
   CompareBitmap(bitmap.get(), 612, 792, pdfium::kBlankPage612By792Checksum);
 }
+
+TEST_F(FPDFRenderPatternEmbedderTest, LongAxialShadingHasNoBands) {
+  if (CFX_DefaultRenderDevice::UseSkiaRenderer()) {
+    GTEST_SKIP() << "Skia draws axial shadings itself";
+  }
+
+  // The shading spans 8192 device pixels, but only its first eighth is on the
+  // 1024 pixel wide page, where it ramps from black to white. A 256 entry
+  // color table only has 32 entries in view, which shows up as 32 pixel wide
+  // bands. Sizing the table from the device extent brings every gray level
+  // into view.
+  ASSERT_TRUE(OpenDocument("long_axial_shading.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+  const int width = FPDFBitmap_GetWidth(bitmap.get());
+  ASSERT_EQ(1024, width);
+  ASSERT_EQ(4, BytesPerPixelForFormat(FPDFBitmap_GetFormat(bitmap.get())));
+
+  auto row = UNSAFE_BUFFERS(pdfium::span(
+      static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap.get())),
+      static_cast<size_t>(width) * 4));
+  std::set<uint8_t> grays;
+  int longest_run = 0;
+  int run = 0;
+  for (int x = 0; x < width; ++x) {
+    const uint8_t gray = row[x * 4];
+    grays.insert(gray);
+    run = x > 0 && gray == row[(x - 1) * 4] ? run + 1 : 1;
+    longest_run = std::max(longest_run, run);
+  }
+  EXPECT_GT(grays.size(), 200u);
+  EXPECT_LE(longest_run, 16);
+}
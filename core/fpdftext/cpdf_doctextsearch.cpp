@@ -0,0 +1,222 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_doctextsearch.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "core/fpdfapi/page/cpdf_page.h"
+#include "core/fpdfapi/page/cpdf_pageobjectholder.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdftext/cpdf_multipatternmatcher.h"
+#include "core/fpdftext/cpdf_textpage.h"
+#include "core/fpdftext/unicodenormalizationdata.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/fx_extension.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/stl_util.h"
+
+namespace {
+
+constexpr wchar_t kNonBreakingSpace = 160;
+
+bool IsCollapsibleSpace(wchar_t ch) {
+  return ch == L' ' || ch == L'\t' || ch == L'\r' || ch == L'\n' ||
+         ch == kNonBreakingSpace;
+}
+
+// Appends the normalized form of `text` to `out`. Whitespace runs collapse to
+// a single space and control characters are dropped. If `char_indices` is
+// non-null, `char_index_for(i)` is recorded for every character appended on
+// behalf of `text[i]`.
+template <typename CharIndexFn>
+void AppendNormalized(WideStringView text,
+                      WideString* out,
+                      DataVector<int>* char_indices,
+                      CharIndexFn char_index_for) {
+  for (size_t i = 0; i < text.GetLength(); ++i) {
+    const wchar_t ch = text[i];
+    if (IsCollapsibleSpace(ch)) {
+      if (!out->IsEmpty() && out->Back() != L' ') {
+        *out += L' ';
+        if (char_indices) {
+          char_indices->push_back(char_index_for(i));
+        }
+      }
+      continue;
+    }
+    if (ch < 0x20 || ch == 0xFFFE) {
+      continue;
+    }
+    if (static_cast<uint32_t>(ch) > 0xFFFF) {
+      *out += ch;
+      if (char_indices) {
+        char_indices->push_back(char_index_for(i));
+      }
+      continue;
+    }
+    for (wchar_t normalized : GetUnicodeNormalization(ch)) {
+      *out += normalized;
+      if (char_indices) {
+        char_indices->push_back(char_index_for(i));
+      }
+    }
+  }
+}
+
+WideString NormalizeTerm(const WideString& term, bool match_case) {
+  WideString normalized;
+  AppendNormalized(term.AsStringView(), &normalized, nullptr,
+                   [](size_t) { return 0; });
+  normalized.Trim(L' ');
+  if (!match_case) {
+    normalized.MakeLower();
+  }
+  return normalized;
+}
+
+bool IsWholeWord(const WideString& text, size_t start, size_t length) {
+  if (start > 0 && FXSYS_iswalnum(text[start - 1])) {
+    return false;
+  }
+  const size_t end = start + length;
+  return end >= text.GetLength() || !FXSYS_iswalnum(text[end]);
+}
+
+}  // namespace
+
+CPDF_DocTextSearch::PageText::PageText() = default;
+
+CPDF_DocTextSearch::PageText::PageText(PageText&&) = default;
+
+CPDF_DocTextSearch::PageText& CPDF_DocTextSearch::PageText::operator=(
+    PageText&&) = default;
+
+CPDF_DocTextSearch::PageText::~PageText() = default;
+
+CPDF_DocTextSearch::CPDF_DocTextSearch(CPDF_Document* doc, bool rtl)
+    : doc_(doc), rtl_(rtl) {
+  page_texts_.resize(std::max(doc_->GetPageCount(), 0));
+}
+
+CPDF_DocTextSearch::~CPDF_DocTextSearch() = default;
+
+void CPDF_DocTextSearch::Find(pdfium::span<const WideString> terms,
+                              const Options& options) {
+  results_.clear();
+  sel_rects_.clear();
+  std::vector<WideString> patterns;
+  patterns.reserve(terms.size());
+  for (const WideString& term : terms) {
+    patterns.push_back(NormalizeTerm(term, options.bMatchCase));
+  }
+  const CPDF_MultiPatternMatcher matcher(patterns);
+
+  for (size_t page = 0; page < page_texts_.size(); ++page) {
+    const int page_index = pdfium::checked_cast<int>(page);
+    const PageText& page_text = GetPageText(page_index);
+    if (page_text.text.IsEmpty()) {
+      continue;
+    }
+
+    WideString lowered;
+    if (!options.bMatchCase) {
+      lowered = page_text.text;
+      lowered.MakeLower();
+    }
+    const WideString& haystack = options.bMatchCase ? page_text.text : lowered;
+    for (const auto& match : matcher.Find(haystack.AsStringView())) {
+      if (options.bMatchWholeWord &&
+          !IsWholeWord(haystack, match.start, match.length)) {
+        continue;
+      }
+      const int first = page_text.char_indices[match.start];
+      const int last = page_text.char_indices[match.start + match.length - 1];
+      if (first < 0 || last < first) {
+        continue;
+      }
+      results_.push_back({page_index,
+                          pdfium::checked_cast<int>(match.pattern_index), first,
+                          last - first + 1});
+    }
+  }
+}
+
+std::vector<CFX_FloatRect> CPDF_DocTextSearch::GetResultRects(
+    const Result& result) {
+  const CPDF_TextPage* text_page = LoadTextPage(result.page_index);
+  if (!text_page) {
+    return {};
+  }
+  return text_page->GetRectArray(result.char_index, result.char_count);
+}
+
+int CPDF_DocTextSearch::CountRects(int index) {
+  if (!fxcrt::IndexInBounds(results_, index)) {
+    return -1;
+  }
+
+  sel_rects_ = GetResultRects(results_[index]);
+  return fxcrt::CollectionSize<int>(sel_rects_);
+}
+
+bool CPDF_DocTextSearch::GetRect(int rect_index, CFX_FloatRect* rect) const {
+  if (!fxcrt::IndexInBounds(sel_rects_, rect_index)) {
+    return false;
+  }
+
+  *rect = sel_rects_[rect_index];
+  return true;
+}
+
+const CPDF_DocTextSearch::PageText& CPDF_DocTextSearch::GetPageText(
+    int page_index) {
+  std::optional<PageText>& cached = page_texts_[page_index];
+  if (cached.has_value()) {
+    return cached.value();
+  }
+
+  cached.emplace();
+  const CPDF_TextPage* text_page = LoadTextPage(page_index);
+  if (!text_page) {
+    return cached.value();
+  }
+
+  // Same text and indexing that CPDF_TextPageFind searches.
+  const WideString all_text = text_page->GetAllPageText();
+  cached->text.Reserve(all_text.GetLength());
+  cached->char_indices.reserve(all_text.GetLength());
+  AppendNormalized(all_text.AsStringView(), &cached->text,
+                   &cached->char_indices, [text_page](size_t i) {
+                     return text_page->CharIndexFromTextIndex(
+                         pdfium::checked_cast<int>(i));
+                   });
+  return cached.value();
+}
+
+const CPDF_TextPage* CPDF_DocTextSearch::LoadTextPage(int page_index) {
+  if (page_index < 0 ||
+      static_cast<size_t>(page_index) >= page_texts_.size()) {
+    return nullptr;
+  }
+  if (loaded_text_page_ && loaded_page_index_ == page_index) {
+    return loaded_text_page_.get();
+  }
+
+  loaded_text_page_.reset();
+  loaded_page_index_ = -1;
+  RetainPtr<CPDF_Dictionary> dict = doc_->GetMutablePageDictionary(page_index);
+  if (!dict) {
+    return nullptr;
+  }
+
+  auto page = pdfium::MakeRetain<CPDF_Page>(doc_, std::move(dict));
+  page->SetParseMode(CPDF_PageObjectHolder::ParseMode::kTextOnly);
+  page->ParseContent();
+  loaded_text_page_ = std::make_unique<CPDF_TextPage>(std::move(page), rtl_);
+  loaded_page_index_ = page_index;
+  return loaded_text_page_.get();
+}
@@ -0,0 +1,83 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFTEXT_CPDF_DOCTEXTSEARCH_H_
+#define CORE_FPDFTEXT_CPDF_DOCTEXTSEARCH_H_
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/unowned_ptr.h"
+#include "core/fxcrt/widestring.h"
+
+class CPDF_Document;
+class CPDF_TextPage;
+
+// Searches every page of a document for several terms at once. The
+// normalized text of each page is extracted on first use and kept, so later
+// queries do not need to reload pages.
+class CPDF_DocTextSearch {
+ public:
+  struct Options {
+    bool bMatchCase = false;
+    bool bMatchWholeWord = false;
+  };
+
+  struct Result {
+    int page_index;
+    int term_index;
+    // Range of the match in the page's CPDF_TextPage character list.
+    int char_index;
+    int char_count;
+  };
+
+  CPDF_DocTextSearch(CPDF_Document* doc, bool rtl);
+  ~CPDF_DocTextSearch();
+
+  // Finds all matches of all `terms` and replaces results(), which are
+  // ordered by page, then by position on the page, then by term index. Terms
+  // are normalized the same way as the page text, so e.g. "fi" finds U+FB01
+  // and runs of whitespace match a single space.
+  void Find(pdfium::span<const WideString> terms, const Options& options);
+  const std::vector<Result>& results() const { return results_; }
+
+  // Returns the bounding rects of `result` in page space.
+  std::vector<CFX_FloatRect> GetResultRects(const Result& result);
+
+  // Like CPDF_TextPage::CountRects() and GetRect(), for results()[index].
+  int CountRects(int index);
+  bool GetRect(int rect_index, CFX_FloatRect* rect) const;
+
+ private:
+  // Normalized text of one page, with the page char index that produced each
+  // normalized character.
+  struct PageText {
+    PageText();
+    PageText(PageText&&);
+    PageText& operator=(PageText&&);
+    ~PageText();
+
+    WideString text;
+    DataVector<int> char_indices;
+  };
+
+  const PageText& GetPageText(int page_index);
+  const CPDF_TextPage* LoadTextPage(int page_index);
+
+  UnownedPtr<CPDF_Document> const doc_;
+  const bool rtl_;
+  std::vector<std::optional<PageText>> page_texts_;
+  std::vector<Result> results_;
+  std::vector<CFX_FloatRect> sel_rects_;
+  // Most recently loaded text page, kept for consecutive GetResultRects()
+  // calls on the same page.
+  int loaded_page_index_ = -1;
+  std::unique_ptr<CPDF_TextPage> loaded_text_page_;
+};
+
+#endif  // CORE_FPDFTEXT_CPDF_DOCTEXTSEARCH_H_
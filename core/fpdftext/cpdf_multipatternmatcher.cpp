@@ -0,0 +1,117 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_multipatternmatcher.h"
+
+#include <algorithm>
+#include <queue>
+
+#include "core/fxcrt/numerics/safe_conversions.h"
+
+CPDF_MultiPatternMatcher::Node::Node() = default;
+
+CPDF_MultiPatternMatcher::Node::Node(Node&&) = default;
+
+CPDF_MultiPatternMatcher::Node::~Node() = default;
+
+CPDF_MultiPatternMatcher::CPDF_MultiPatternMatcher(
+    pdfium::span<const WideString> patterns) {
+  nodes_.emplace_back();
+  pattern_lengths_.reserve(patterns.size());
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    const WideString& pattern = patterns[i];
+    pattern_lengths_.push_back(pattern.GetLength());
+    if (pattern.IsEmpty()) {
+      continue;
+    }
+
+    uint32_t node = 0;
+    for (wchar_t ch : pattern) {
+      auto it = nodes_[node].next.find(ch);
+      if (it != nodes_[node].next.end()) {
+        node = it->second;
+        continue;
+      }
+      const uint32_t new_node = pdfium::checked_cast<uint32_t>(nodes_.size());
+      nodes_[node].next[ch] = new_node;
+      nodes_.emplace_back();
+      node = new_node;
+    }
+    nodes_[node].patterns.push_back(pdfium::checked_cast<uint32_t>(i));
+  }
+  BuildLinks();
+}
+
+CPDF_MultiPatternMatcher::~CPDF_MultiPatternMatcher() = default;
+
+void CPDF_MultiPatternMatcher::BuildLinks() {
+  // Breadth-first, so every node's `fail` target is final before its children
+  // are visited.
+  std::queue<uint32_t> pending;
+  for (const auto& [ch, child] : nodes_[0].next) {
+    nodes_[child].fail = 0;
+    pending.push(child);
+  }
+  while (!pending.empty()) {
+    const uint32_t node = pending.front();
+    pending.pop();
+    for (const auto& [ch, child] : nodes_[node].next) {
+      uint32_t fail = nodes_[node].fail;
+      while (true) {
+        auto it = nodes_[fail].next.find(ch);
+        if (it != nodes_[fail].next.end()) {
+          fail = it->second;
+          break;
+        }
+        if (fail == 0) {
+          break;
+        }
+        fail = nodes_[fail].fail;
+      }
+      Node& child_node = nodes_[child];
+      child_node.fail = fail;
+      child_node.output_link = nodes_[fail].patterns.empty()
+                                   ? nodes_[fail].output_link
+                                   : fail;
+      pending.push(child);
+    }
+  }
+}
+
+std::vector<CPDF_MultiPatternMatcher::Match> CPDF_MultiPatternMatcher::Find(
+    WideStringView text) const {
+  std::vector<Match> matches;
+  uint32_t node = 0;
+  for (size_t pos = 0; pos < text.GetLength(); ++pos) {
+    const wchar_t ch = text[pos];
+    while (true) {
+      auto it = nodes_[node].next.find(ch);
+      if (it != nodes_[node].next.end()) {
+        node = it->second;
+        break;
+      }
+      if (node == 0) {
+        break;
+      }
+      node = nodes_[node].fail;
+    }
+
+    for (uint32_t out = nodes_[node].patterns.empty()
+                            ? nodes_[node].output_link
+                            : node;
+         out != kNoNode; out = nodes_[out].output_link) {
+      for (uint32_t pattern : nodes_[out].patterns) {
+        const size_t length = pattern_lengths_[pattern];
+        matches.push_back({pattern, pos + 1 - length, length});
+      }
+    }
+  }
+  std::ranges::sort(matches, [](const Match& a, const Match& b) {
+    if (a.start != b.start) {
+      return a.start < b.start;
+    }
+    return a.pattern_index < b.pattern_index;
+  });
+  return matches;
+}
@@ -0,0 +1,58 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FPDFTEXT_CPDF_MULTIPATTERNMATCHER_H_
+#define CORE_FPDFTEXT_CPDF_MULTIPATTERNMATCHER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/widestring.h"
+
+// Aho-Corasick automaton. Finds every occurrence of any of a set of patterns
+// in a single pass over the text, regardless of the number of patterns.
+class CPDF_MultiPatternMatcher {
+ public:
+  struct Match {
+    size_t pattern_index;
+    size_t start;
+    size_t length;
+  };
+
+  // Empty patterns never match.
+  explicit CPDF_MultiPatternMatcher(pdfium::span<const WideString> patterns);
+  ~CPDF_MultiPatternMatcher();
+
+  // Returns all matches, including overlapping ones, ordered by `start` and
+  // then by `pattern_index`.
+  std::vector<Match> Find(WideStringView text) const;
+
+ private:
+  static constexpr uint32_t kNoNode = 0xFFFFFFFF;
+
+  struct Node {
+    Node();
+    Node(Node&&);
+    ~Node();
+
+    std::map<wchar_t, uint32_t> next;
+    // Longest proper suffix of this node that is also in the trie.
+    uint32_t fail = 0;
+    // Nearest node along the `fail` chain that ends a pattern.
+    uint32_t output_link = kNoNode;
+    // Patterns that end exactly at this node.
+    std::vector<uint32_t> patterns;
+  };
+
+  void BuildLinks();
+
+  std::vector<Node> nodes_;
+  std::vector<size_t> pattern_lengths_;
+};
+
+#endif  // CORE_FPDFTEXT_CPDF_MULTIPATTERNMATCHER_H_
@@ -0,0 +1,68 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fpdftext/cpdf_multipatternmatcher.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+struct ExpectedMatch {
+  size_t pattern_index;
+  size_t start;
+  size_t length;
+};
+
+void CheckMatches(const std::vector<CPDF_MultiPatternMatcher::Match>& actual,
+                  const std::vector<ExpectedMatch>& expected) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].pattern_index, actual[i].pattern_index) << i;
+    EXPECT_EQ(expected[i].start, actual[i].start) << i;
+    EXPECT_EQ(expected[i].length, actual[i].length) << i;
+  }
+}
+
+}  // namespace
+
+TEST(CPDFMultiPatternMatcherTest, NoPatterns) {
+  CPDF_MultiPatternMatcher matcher({});
+  EXPECT_TRUE(matcher.Find(L"abc").empty());
+}
+
+TEST(CPDFMultiPatternMatcherTest, EmptyPatternsNeverMatch) {
+  const WideString kPatterns[] = {L"", L"b"};
+  CPDF_MultiPatternMatcher matcher(kPatterns);
+  CheckMatches(matcher.Find(L"abc"), {{1, 1, 1}});
+  EXPECT_TRUE(matcher.Find(L"").empty());
+}
+
+TEST(CPDFMultiPatternMatcherTest, Overlapping) {
+  // The classic example: "ushers" contains "she", "he" and "hers".
+  const WideString kPatterns[] = {L"he", L"she", L"his", L"hers"};
+  CPDF_MultiPatternMatcher matcher(kPatterns);
+  CheckMatches(matcher.Find(L"ushers"), {{1, 1, 3}, {0, 2, 2}, {3, 2, 4}});
+}
+
+TEST(CPDFMultiPatternMatcherTest, RepeatedAndDuplicatePatterns) {
+  const WideString kPatterns[] = {L"aa", L"a", L"aa"};
+  CPDF_MultiPatternMatcher matcher(kPatterns);
+  CheckMatches(matcher.Find(L"aaa"), {{0, 0, 2},
+                                      {1, 0, 1},
+                                      {2, 0, 2},
+                                      {0, 1, 2},
+                                      {1, 1, 1},
+                                      {2, 1, 2},
+                                      {1, 2, 1}});
+}
+
+TEST(CPDFMultiPatternMatcherTest, NonAscii) {
+  const WideString kPatterns[] = {L"été", L"世界"};
+  CPDF_MultiPatternMatcher matcher(kPatterns);
+  CheckMatches(matcher.Find(L"l'été 世界"),
+               {{0, 2, 3}, {1, 6, 2}});
+  EXPECT_TRUE(matcher.Find(L"ete").empty());
+}
@@ -10,7 +10,6 @@
 #include <stdint.h>
 
 #include <algorithm>
-#include <array>
 #include <utility>
 #include <vector>
 
@@ -39,11 +38,6 @@ namespace {
 
 constexpr float kDefaultFontSize = 1.0f;
 constexpr float kSizeEpsilon = 0.01f;
-constexpr std::array<pdfium::span<const uint16_t>, 3>
-    kUnicodeDataNormalizationMaps = {{kUnicodeDataNormalizationMap2,
-                                      kUnicodeDataNormalizationMap3,
-                                      kUnicodeDataNormalizationMap4}};
-
 float NormalizeThreshold(float threshold, int t1, int t2, int t3) {
   DCHECK(t1 < t2);
   DCHECK(t2 < t3);
@@ -98,28 +92,6 @@ float CalculateBaseSpaceAdjustment(const CPDF_TextObject* pTextObj,
   return 0.0f;
 }
 
-DataVector<wchar_t> GetUnicodeNormalization(wchar_t wch) {
-  wch = wch & 0xFFFF;
-  wchar_t wFind = kUnicodeDataNormalization[wch];
-  if (!wFind) {
-    return DataVector<wchar_t>(1, wch);
-  }
-  if (wFind >= 0x8000) {
-    return DataVector<wchar_t>(1,
-                               kUnicodeDataNormalizationMap1[wFind - 0x8000]);
-  }
-  wch = wFind & 0x0FFF;
-  wFind >>= 12;
-  auto maps = kUnicodeDataNormalizationMaps[wFind - 2].subspan(
-      static_cast<size_t>(wch));
-  if (wFind == 4) {
-    wFind = maps.front();
-    maps = maps.subspan<1u>();
-  }
-  const auto range = maps.first(static_cast<size_t>(wFind));
-  return DataVector<wchar_t>(range.begin(), range.end());
-}
-
 float MaskPercentFilled(const std::vector<bool>& mask,
                         int32_t start,
                         int32_t end) {
@@ -167,12 +139,14 @@ bool IsRightToLeft(const CPDF_TextObject& text_obj) {
   const size_t nItems = text_obj.CountItems();
   WideString str;
   str.Reserve(nItems);
+  WideString unicode;
   for (size_t i = 0; i < nItems; ++i) {
     CPDF_TextObject::Item item = text_obj.GetItemInfo(i);
     if (item.char_code_ == 0xffffffff) {
       continue;
     }
-    WideString unicode = font->UnicodeFromCharCode(item.char_code_);
+    unicode.clear();
+    font->AppendUnicodeFromCharCode(item.char_code_, &unicode);
     wchar_t wChar = !unicode.IsEmpty() ? unicode[0] : 0;
     if (wChar == 0) {
       wChar = item.char_code_;
@@ -375,6 +349,14 @@ CPDF_TextPage::CPDF_TextPage(const CPDF_Page* pPage, bool rtl)
   Init();
 }
 
+CPDF_TextPage::CPDF_TextPage(RetainPtr<CPDF_Page> page, bool rtl)
+    : owned_page_(std::move(page)),
+      page_(owned_page_.Get()),
+      rtl_(rtl),
+      display_matrix_(page_->GetDisplayMatrix()) {
+  Init();
+}
+
 CPDF_TextPage::~CPDF_TextPage() = default;
 
 void CPDF_TextPage::Init() {
@@ -383,7 +365,7 @@ void CPDF_TextPage::Init() {
 
   const int nCount = CountChars();
   if (nCount) {
-    char_indices_.push_back({0, 0});
+    char_indices_.push_back({0, 0, 0});
   }
 
   bool skipped = false;
@@ -395,13 +377,42 @@ void CPDF_TextPage::Init() {
       skipped = true;
     } else {
       if (skipped) {
-        char_indices_.push_back({i + 1, 0});
+        const TextPageCharSegment& prev = char_indices_.back();
+        char_indices_.push_back({i + 1, 0, prev.text_index + prev.count});
         skipped = false;
       } else {
         char_indices_.back().index = i + 1;
       }
     }
   }
+  BuildLineIndex();
+}
+
+void CPDF_TextPage::BuildLineIndex() {
+  // Cap the run length so that pages without generated line breaks, or with
+  // very long lines, still get reasonably tight bounds.
+  static constexpr int kMaxCharsPerLineIndexEntry = 64;
+
+  const int nCount = CountChars();
+  char_boxes_.reserve(nCount);
+  bool start_new_entry = true;
+  for (int i = 0; i < nCount; ++i) {
+    const CharInfo& charinfo = char_list_[i];
+    CFX_FloatRect char_box = charinfo.char_box();
+    char_box.Normalize();
+    char_boxes_.push_back(char_box);
+    if (start_new_entry) {
+      line_index_.push_back({i, i + 1, char_box});
+    } else {
+      line_index_.back().end = i + 1;
+      line_index_.back().bounds.Union(char_box);
+    }
+    start_new_entry =
+        (charinfo.char_type() == CharType::kGenerated &&
+         charinfo.unicode() == L'\n') ||
+        line_index_.back().end - line_index_.back().start >=
+            kMaxCharsPerLineIndexEntry;
+  }
 }
 
 int CPDF_TextPage::CountChars() const {
@@ -409,27 +420,30 @@ int CPDF_TextPage::CountChars() const {
 }
 
 int CPDF_TextPage::CharIndexFromTextIndex(int text_index) const {
-  int count = 0;
-  for (const auto& info : char_indices_) {
-    count += info.count;
-    if (count > text_index) {
-      return text_index - count + info.count + info.index;
-    }
+  // `char_indices_` is sorted by `text_index`, so binary search for the first
+  // segment that ends past `text_index`.
+  auto it = std::partition_point(
+      char_indices_.begin(), char_indices_.end(),
+      [text_index](const TextPageCharSegment& info) {
+        return info.text_index + info.count <= text_index;
+      });
+  if (it == char_indices_.end()) {
+    return -1;
   }
-  return -1;
+  return text_index - it->text_index + it->index;
 }
 
 int CPDF_TextPage::TextIndexFromCharIndex(int char_index) const {
-  int count = 0;
-  for (const auto& info : char_indices_) {
-    int text_index = char_index - info.index;
-    if (text_index < info.count) {
-      return text_index >= 0 ? text_index + count : -1;
-    }
-
-    count += info.count;
+  auto it = std::partition_point(
+      char_indices_.begin(), char_indices_.end(),
+      [char_index](const TextPageCharSegment& info) {
+        return info.index + info.count <= char_index;
+      });
+  if (it == char_indices_.end()) {
+    return -1;
   }
-  return -1;
+  int text_index = char_index - it->index;
+  return text_index >= 0 ? text_index + it->text_index : -1;
 }
 
 std::vector<CFX_FloatRect> CPDF_TextPage::GetRectArray(int start,
@@ -484,42 +498,51 @@ std::vector<CFX_FloatRect> CPDF_TextPage::GetRectArray(int start,
 
 int CPDF_TextPage::GetIndexAtPos(const CFX_PointF& point,
                                  const CFX_SizeF& tolerance) const {
-  int pos;
+  const bool use_tolerance = tolerance.width > 0 || tolerance.height > 0;
+  // A negative tolerance can produce an inverted extended rect, which
+  // Contains() normalizes, so inflate the line bounds by the magnitude.
+  const float half_width = use_tolerance ? fabsf(tolerance.width) / 2 : 0;
+  const float half_height = use_tolerance ? fabsf(tolerance.height) / 2 : 0;
   int NearPos = -1;
   double xdif = 5000;
   double ydif = 5000;
-  const int nCount = CountChars();
-  for (pos = 0; pos < nCount; ++pos) {
-    const CFX_FloatRect& orig_charrect = char_list_[pos].char_box();
-    if (orig_charrect.Contains(point)) {
-      break;
-    }
-
-    if (tolerance.width <= 0 && tolerance.height <= 0) {
+  for (const LineIndexEntry& line : line_index_) {
+    CFX_FloatRect line_rect = line.bounds;
+    line_rect.Inflate(half_width, half_height);
+    if (!line_rect.Contains(point)) {
       continue;
     }
 
-    CFX_FloatRect charrect = orig_charrect;
-    charrect.Normalize();
-    CFX_FloatRect char_rect_ext(charrect.left - tolerance.width / 2,
-                                charrect.bottom - tolerance.height / 2,
-                                charrect.right + tolerance.width / 2,
-                                charrect.top + tolerance.height / 2);
-    if (!char_rect_ext.Contains(point)) {
-      continue;
-    }
+    for (int pos = line.start; pos < line.end; ++pos) {
+      const CFX_FloatRect& charrect = char_boxes_[pos];
+      if (charrect.Contains(point)) {
+        return pos;
+      }
+
+      if (!use_tolerance) {
+        continue;
+      }
 
-    double curXdif =
-        std::min(fabs(point.x - charrect.left), fabs(point.x - charrect.right));
-    double curYdif =
-        std::min(fabs(point.y - charrect.bottom), fabs(point.y - charrect.top));
-    if (curYdif + curXdif < xdif + ydif) {
-      ydif = curYdif;
-      xdif = curXdif;
-      NearPos = pos;
+      CFX_FloatRect char_rect_ext(charrect.left - tolerance.width / 2,
+                                  charrect.bottom - tolerance.height / 2,
+                                  charrect.right + tolerance.width / 2,
+                                  charrect.top + tolerance.height / 2);
+      if (!char_rect_ext.Contains(point)) {
+        continue;
+      }
+
+      double curXdif = std::min(fabs(point.x - charrect.left),
+                                fabs(point.x - charrect.right));
+      double curYdif = std::min(fabs(point.y - charrect.bottom),
+                                fabs(point.y - charrect.top));
+      if (curYdif + curXdif < xdif + ydif) {
+        ydif = curYdif;
+        xdif = curXdif;
+        NearPos = pos;
+      }
     }
   }
-  return pos < nCount ? pos : NearPos;
+  return NearPos;
 }
 
 WideString CPDF_TextPage::GetTextByPredicate(
@@ -1380,6 +1403,7 @@ void CPDF_TextPage::ProcessTextObjectItems(CPDF_TextObject* text_object,
   RetainPtr<CPDF_Font> const font = text_object->GetFont();
 
   float spacing = 0;
+  WideString unicode;
   const size_t nItems = text_object->CountItems();
   for (size_t i = 0; i < nItems; ++i) {
     CPDF_TextObject::Item item = text_object->GetItemInfo(i);
@@ -1414,7 +1438,8 @@ void CPDF_TextPage::ProcessTextObjectItems(CPDF_TextObject* text_object,
     }
 
     spacing = 0;
-    WideString unicode = font->UnicodeFromCharCode(item.char_code_);
+    unicode.clear();
+    font->AppendUnicodeFromCharCode(item.char_code_, &unicode);
     CharType char_type = CharType::kNormal;
     if (unicode.IsEmpty() && item.char_code_) {
       unicode += static_cast<wchar_t>(item.char_code_);
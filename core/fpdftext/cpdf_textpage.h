@@ -9,7 +9,6 @@
 
 #include <stdint.h>
 
-#include <deque>
 #include <functional>
 #include <optional>
 #include <vector>
@@ -18,6 +17,7 @@
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/fx_memory_wrappers.h"
+#include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxcrt/widestring.h"
 #include "core/fxcrt/widetext_buffer.h"
@@ -29,6 +29,7 @@ class CPDF_TextObject;
 struct TextPageCharSegment {
   int index;
   int count;
+  int text_index;  // Index into the page text of the segment's first char.
 };
 
 FX_DATA_PARTITION_EXCEPTION(TextPageCharSegment);
@@ -86,6 +87,8 @@ class CPDF_TextPage {
   };
 
   CPDF_TextPage(const CPDF_Page* pPage, bool rtl);
+  // Same as above, but also keeps `page` alive for as long as the text page.
+  CPDF_TextPage(RetainPtr<CPDF_Page> page, bool rtl);
   ~CPDF_TextPage();
 
   int CharIndexFromTextIndex(int text_index) const;
@@ -129,6 +132,15 @@ class CPDF_TextPage {
 
   enum class MarkedContentState { kPass = 0, kDone, kDelay };
 
+  // A run of consecutive entries in `char_list_`, usually one text line, along
+  // with the union of their normalized char boxes. Lets GetIndexAtPos() skip
+  // whole lines that cannot contain the point.
+  struct LineIndexEntry {
+    int start;
+    int end;
+    CFX_FloatRect bounds;
+  };
+
   struct TransformedTextObject {
     TransformedTextObject();
     TransformedTextObject(const TransformedTextObject& that);
@@ -139,6 +151,7 @@ class CPDF_TextPage {
   };
 
   void Init();
+  void BuildLineIndex();
   bool IsHyphen(wchar_t curChar) const;
   void ProcessObject();
   void ProcessFormObject(CPDF_FormObject* pFormObj,
@@ -181,10 +194,15 @@ class CPDF_TextPage {
   WideString GetTextByPredicate(
       const std::function<bool(const CharInfo&)>& predicate) const;
 
+  RetainPtr<const CPDF_Page> const owned_page_;
   UnownedPtr<const CPDF_Page> const page_;
   DataVector<TextPageCharSegment> char_indices_;
-  std::deque<CharInfo> char_list_;
-  std::deque<CharInfo> temp_char_list_;
+  std::vector<CharInfo> char_list_;
+  std::vector<CharInfo> temp_char_list_;
+  // Normalized `char_box()` of every entry in `char_list_`, stored densely so
+  // position queries do not have to walk the much larger CharInfo objects.
+  std::vector<CFX_FloatRect> char_boxes_;
+  std::vector<LineIndexEntry> line_index_;
   WideTextBuffer text_buf_;
   WideTextBuffer temp_text_buf_;
   UnownedPtr<const CPDF_TextObject> prev_text_obj_;
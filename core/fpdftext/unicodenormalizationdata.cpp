@@ -5,7 +5,9 @@
 // Original code copyright 2014 Foxit Software Inc. http://www.foxitsoftware.com
 
 #include "core/fpdftext/unicodenormalizationdata.h"
+
 #include "core/fxcrt/fx_system.h"
+#include "core/fxcrt/span.h"
 
 const std::array<uint16_t, 65536> kUnicodeDataNormalization = {
     {0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
@@ -8273,3 +8275,34 @@ const std::array<uint16_t, 488> kUnicodeDataNormalizationMap4 = {
      0x0647, 0x0020, 0x0648, 0x0633, 0x0644, 0x0645, 0x0008, 0x062C, 0x0644,
      0x0020, 0x062C, 0x0644, 0x0627, 0x0644, 0x0647, 0x0004, 0x0631, 0x06CC,
      0x0627, 0x0644}};
+
+namespace {
+
+constexpr std::array<pdfium::span<const uint16_t>, 3>
+    kUnicodeDataNormalizationMaps = {{kUnicodeDataNormalizationMap2,
+                                      kUnicodeDataNormalizationMap3,
+                                      kUnicodeDataNormalizationMap4}};
+
+}  // namespace
+
+DataVector<wchar_t> GetUnicodeNormalization(wchar_t wch) {
+  wch = wch & 0xFFFF;
+  wchar_t wFind = kUnicodeDataNormalization[wch];
+  if (!wFind) {
+    return DataVector<wchar_t>(1, wch);
+  }
+  if (wFind >= 0x8000) {
+    return DataVector<wchar_t>(1,
+                               kUnicodeDataNormalizationMap1[wFind - 0x8000]);
+  }
+  wch = wFind & 0x0FFF;
+  wFind >>= 12;
+  auto maps = kUnicodeDataNormalizationMaps[wFind - 2].subspan(
+      static_cast<size_t>(wch));
+  if (wFind == 4) {
+    wFind = maps.front();
+    maps = maps.subspan<1u>();
+  }
+  const auto range = maps.first(static_cast<size_t>(wFind));
+  return DataVector<wchar_t>(range.begin(), range.end());
+}
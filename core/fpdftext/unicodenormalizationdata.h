@@ -11,10 +11,16 @@
 
 #include <array>
 
+#include "core/fxcrt/data_vector.h"
+
 extern const std::array<uint16_t, 65536> kUnicodeDataNormalization;
 extern const std::array<uint16_t, 5376> kUnicodeDataNormalizationMap1;
 extern const std::array<uint16_t, 1724> kUnicodeDataNormalizationMap2;
 extern const std::array<uint16_t, 1164> kUnicodeDataNormalizationMap3;
 extern const std::array<uint16_t, 488> kUnicodeDataNormalizationMap4;
 
+// Returns the normalized form of the BMP character `wch`, which may consist of
+// several characters. e.g. U+00E9 becomes "e" and U+FB01 becomes "fi".
+DataVector<wchar_t> GetUnicodeNormalization(wchar_t wch);
+
 #endif  // CORE_FPDFTEXT_UNICODENORMALIZATIONDATA_H_
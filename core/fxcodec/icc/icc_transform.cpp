@@ -9,12 +9,10 @@
 #include <stdint.h>
 
 #include <algorithm>
-#include <memory>
 
 #include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
-#include "core/fxcrt/ptr_util.h"
 
 namespace fxcodec {
 
@@ -53,8 +51,9 @@ IccTransform::~IccTransform() {
 }
 
 // static
-std::unique_ptr<IccTransform> IccTransform::CreateTransformSRGB(
-    pdfium::span<const uint8_t> span) {
+RetainPtr<IccTransform> IccTransform::CreateTransformSRGB(
+    pdfium::span<const uint8_t> span,
+    uint32_t intent) {
   ScopedCmsProfile srcProfile(cmsOpenProfileFromMem(
       span.data(), pdfium::checked_cast<cmsUInt32Number>(span.size())));
   if (!srcProfile) {
@@ -98,7 +97,7 @@ std::unique_ptr<IccTransform> IccTransform::CreateTransformSRGB(
     case cmsSigRgbData:
       hTransform =
           cmsCreateTransform(srcProfile.get(), srcFormat, dstProfile.get(),
-                             TYPE_BGR_8, INTENT_PERCEPTUAL, /*dwFlags=*/0);
+                             TYPE_BGR_8, intent, /*dwFlags=*/0);
       break;
     case cmsSigGrayData:
     case cmsSigCmykData:
@@ -111,9 +110,8 @@ std::unique_ptr<IccTransform> IccTransform::CreateTransformSRGB(
     return nullptr;
   }
 
-  // Private ctor.
-  return pdfium::WrapUnique(
-      new IccTransform(hTransform, nSrcComponents, bLab, bNormal));
+  return pdfium::MakeRetain<IccTransform>(hTransform, nSrcComponents, bLab,
+                                          bNormal);
 }
 
 void IccTransform::Translate(pdfium::span<const float> pSrcValues,
@@ -9,9 +9,8 @@
 
 #include <stdint.h>
 
-#include <memory>
-
 #include "core/fxcodec/fx_codec_def.h"
+#include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 
 #if defined(USE_SYSTEM_LCMS2)
@@ -22,12 +21,16 @@
 
 namespace fxcodec {
 
-class IccTransform {
+// Transforms hold no reference to the profile data they were created from,
+// so they can be shared and outlive it.
+class IccTransform final : public Retainable {
  public:
-  static std::unique_ptr<IccTransform> CreateTransformSRGB(
-      pdfium::span<const uint8_t> span);
+  CONSTRUCT_VIA_MAKE_RETAIN;
 
-  ~IccTransform();
+  // `intent` is one of the lcms INTENT_* values.
+  static RetainPtr<IccTransform> CreateTransformSRGB(
+      pdfium::span<const uint8_t> span,
+      uint32_t intent);
 
   void Translate(pdfium::span<const float> pSrcValues,
                  pdfium::span<float> pDestValues);
@@ -45,6 +48,7 @@ class IccTransform {
                int srcComponents,
                bool bIsLab,
                bool bNormal);
+  ~IccTransform() override;
 
   const cmsHTRANSFORM transform_;
   const int src_components_;
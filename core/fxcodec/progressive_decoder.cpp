@@ -925,6 +925,22 @@ void ProgressiveDecoder::ResampleScanline(
   uint8_t* dest_scan = pDeviceBitmap->GetWritableScanline(dest_line).data();
   const int src_bytes_per_pixel = (src_format & 0xff) / 8;
   const int dest_bytes_per_pixel = pDeviceBitmap->GetBPP() / 8;
+  if (trans_method_ == TransformMethod::kCmykToRgbMaybeAlpha) {
+    // Convert the whole line once, instead of once per weighted source pixel.
+    // The decoded CMYK values are inverted.
+    auto cmyk_in =
+        fxcrt::reinterpret_span<const FX_CMYK_STRUCT<uint8_t>>(src_span).first(
+            static_cast<size_t>(src_width_));
+    cmyk_buf_.resize(cmyk_in.size());
+    for (size_t i = 0; i < cmyk_in.size(); ++i) {
+      cmyk_buf_[i] = {static_cast<uint8_t>(255 - cmyk_in[i].cyan),
+                      static_cast<uint8_t>(255 - cmyk_in[i].magenta),
+                      static_cast<uint8_t>(255 - cmyk_in[i].yellow),
+                      static_cast<uint8_t>(255 - cmyk_in[i].key)};
+    }
+    cmyk_to_bgr_buf_.resize(cmyk_buf_.size());
+    AdobeCMYK_to_sRGB_Line(cmyk_buf_, cmyk_to_bgr_buf_);
+  }
   for (int dest_col = 0; dest_col < src_width_; dest_col++) {
     CStretchEngine::PixelWeight* pPixelWeights =
         weight_horz_.GetPixelWeight(dest_col);
@@ -1042,10 +1058,7 @@ void ProgressiveDecoder::ResampleScanline(
                j++) {
             uint32_t pixel_weight =
                 pPixelWeights->weights_[j - pPixelWeights->src_start_];
-            const uint8_t* src_pixel = src_scan + j * src_bytes_per_pixel;
-            FX_RGB_STRUCT<uint8_t> src_rgb =
-                AdobeCMYK_to_sRGB1(255 - src_pixel[0], 255 - src_pixel[1],
-                                   255 - src_pixel[2], 255 - src_pixel[3]);
+            const FX_BGR_STRUCT<uint8_t>& src_rgb = cmyk_to_bgr_buf_[j];
             dest_b += pixel_weight * src_rgb.blue;
             dest_g += pixel_weight * src_rgb.green;
             dest_r += pixel_weight * src_rgb.red;
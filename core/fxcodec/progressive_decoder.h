@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "core/fxcodec/fx_codec_def.h"
 #include "core/fxcodec/jpeg/jpegmodule.h"
@@ -197,6 +198,9 @@ class ProgressiveDecoder final :
   RetainPtr<CFX_DIBitmap> device_bitmap_;
   RetainPtr<CFX_CodecMemory> codec_memory_;
   DataVector<uint8_t> decode_buf_;
+  // Scratch space for converting CMYK lines in ResampleScanline().
+  std::vector<FX_CMYK_STRUCT<uint8_t>> cmyk_buf_;
+  std::vector<FX_BGR_STRUCT<uint8_t>> cmyk_to_bgr_buf_;
   DataVector<FX_ARGB> src_palette_;
   std::unique_ptr<ProgressiveDecoderContext> jpeg_context_;
 #ifdef PDF_ENABLE_XFA_BMP
@@ -7,6 +7,8 @@
 #ifndef CORE_FXCRT_FX_FOLDER_H_
 #define CORE_FXCRT_FX_FOLDER_H_
 
+#include <stdint.h>
+
 #include <memory>
 
 #include "core/fxcrt/bytestring.h"
@@ -15,10 +17,20 @@ class FX_Folder {
  public:
   static std::unique_ptr<FX_Folder> OpenFolder(const ByteString& path);
 
+  // Enough information about a file to tell whether it changed.
+  struct FileInfo {
+    int64_t size = 0;
+    // In platform-specific units.
+    int64_t modification_time = 0;
+  };
+
   virtual ~FX_Folder() = default;
 
-  // `filename` and `folder` are required out-parameters.
-  virtual bool GetNextFile(ByteString* filename, bool* bFolder) = 0;
+  // `filename` and `folder` are required out-parameters. `info` is an
+  // optional out-parameter, and is only filled in for files.
+  virtual bool GetNextFile(ByteString* filename,
+                           bool* bFolder,
+                           FileInfo* info) = 0;
 };
 
 #endif  // CORE_FXCRT_FX_FOLDER_H_
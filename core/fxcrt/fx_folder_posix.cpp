@@ -24,7 +24,9 @@ class FX_PosixFolder : public FX_Folder {
  public:
   ~FX_PosixFolder() override;
 
-  bool GetNextFile(ByteString* filename, bool* bFolder) override;
+  bool GetNextFile(ByteString* filename,
+                   bool* bFolder,
+                   FileInfo* info) override;
 
  private:
   friend class FX_Folder;
@@ -51,7 +53,9 @@ FX_PosixFolder::~FX_PosixFolder() {
   closedir(dir_.ExtractAsDangling());
 }
 
-bool FX_PosixFolder::GetNextFile(ByteString* filename, bool* bFolder) {
+bool FX_PosixFolder::GetNextFile(ByteString* filename,
+                                 bool* bFolder,
+                                 FileInfo* info) {
   struct dirent* de = readdir(dir_);
   if (!de) {
     return false;
@@ -65,5 +69,17 @@ bool FX_PosixFolder::GetNextFile(ByteString* filename, bool* bFolder) {
 
   *filename = de->d_name;
   *bFolder = S_ISDIR(deStat.st_mode);
+  if (info && !*bFolder) {
+    info->size = deStat.st_size;
+#if BUILDFLAG(IS_APPLE)
+    const struct timespec& mtime = deStat.st_mtimespec;
+#else
+    const struct timespec& mtime = deStat.st_mtim;
+#endif
+    // In nanoseconds, as files rewritten within the same second must not
+    // look unchanged.
+    info->modification_time =
+        static_cast<int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec;
+  }
   return true;
 }
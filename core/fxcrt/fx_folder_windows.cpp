@@ -20,7 +20,9 @@
 class FX_WindowsFolder : public FX_Folder {
  public:
   ~FX_WindowsFolder() override;
-  bool GetNextFile(ByteString* filename, bool* bFolder) override;
+  bool GetNextFile(ByteString* filename,
+                   bool* bFolder,
+                   FileInfo* info) override;
 
  private:
   friend class FX_Folder;
@@ -53,13 +55,23 @@ FX_WindowsFolder::~FX_WindowsFolder() {
   }
 }
 
-bool FX_WindowsFolder::GetNextFile(ByteString* filename, bool* bFolder) {
+bool FX_WindowsFolder::GetNextFile(ByteString* filename,
+                                   bool* bFolder,
+                                   FileInfo* info) {
   if (reached_end_) {
     return false;
   }
 
   *filename = find_data_.cFileName;
   *bFolder = !!(find_data_.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+  if (info && !*bFolder) {
+    info->size = (static_cast<int64_t>(find_data_.nFileSizeHigh) << 32) |
+                 find_data_.nFileSizeLow;
+    info->modification_time =
+        (static_cast<int64_t>(find_data_.ftLastWriteTime.dwHighDateTime)
+         << 32) |
+        find_data_.ftLastWriteTime.dwLowDateTime;
+  }
   if (!FindNextFileA(handle_, &find_data_)) {
     reached_end_ = true;
   }
@@ -8,13 +8,209 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <utility>
 
+#include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
-#include "core/fxcrt/notreached.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/stl_util.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 
+namespace {
+
+// Shorter stretches of fully covered or uncovered pixels are cheaper to keep
+// inline with their neighbors than to store as separate runs.
+constexpr size_t kMinSolidRun = 8;
+
+// Returns the coverage of the intersection of `a` and `b` within `box`.
+RetainPtr<const CFX_AggClipRgn::Coverage> IntersectCoverages(
+    const CFX_AggClipRgn::Coverage& a,
+    const CFX_AggClipRgn::Coverage& b,
+    const FX_RECT& box) {
+  auto result = pdfium::MakeRetain<CFX_AggClipRgn::Coverage>(box.top);
+  DataVector<uint8_t> covers;
+  const int top = std::max({box.top, a.top(), b.top()});
+  const int bottom = std::min({box.bottom, a.bottom(), b.bottom()});
+  for (int y = top; y < bottom; ++y) {
+    result->StartRow(y);
+    pdfium::span<const CFX_AggClipRgn::Coverage::Run> a_runs = a.GetRow(y);
+    pdfium::span<const CFX_AggClipRgn::Coverage::Run> b_runs = b.GetRow(y);
+    while (!a_runs.empty() && !b_runs.empty()) {
+      const CFX_AggClipRgn::Coverage::Run& a_run = a_runs.front();
+      const CFX_AggClipRgn::Coverage::Run& b_run = b_runs.front();
+      const int left = std::max({box.left, a_run.left, b_run.left});
+      const int right = std::min({box.right, a_run.right, b_run.right});
+      if (left < right) {
+        if (a_run.IsFull() && b_run.IsFull()) {
+          result->AppendFullRun(left, right);
+        } else if (a_run.IsFull() || b_run.IsFull()) {
+          const CFX_AggClipRgn::Coverage::Run& run =
+              a_run.IsFull() ? b_run : a_run;
+          const CFX_AggClipRgn::Coverage& coverage = a_run.IsFull() ? b : a;
+          result->AppendCovers(left, coverage.GetCovers(run).subspan(
+                                         static_cast<size_t>(left - run.left),
+                                         static_cast<size_t>(right - left)));
+        } else {
+          pdfium::span<const uint8_t> a_covers = a.GetCovers(a_run).subspan(
+              static_cast<size_t>(left - a_run.left),
+              static_cast<size_t>(right - left));
+          pdfium::span<const uint8_t> b_covers = b.GetCovers(b_run).subspan(
+              static_cast<size_t>(left - b_run.left),
+              static_cast<size_t>(right - left));
+          covers.resize(a_covers.size());
+          for (size_t i = 0; i < covers.size(); ++i) {
+            covers[i] = a_covers[i] * b_covers[i] / 255;
+          }
+          result->AppendCovers(left, covers);
+        }
+      }
+      // Advance past whichever run ends first.
+      if (a_run.right <= b_run.right) {
+        a_runs = a_runs.subspan<1u>();
+      } else {
+        b_runs = b_runs.subspan<1u>();
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+CFX_AggClipRgn::Coverage::Coverage(int top) : top_(top) {}
+
+CFX_AggClipRgn::Coverage::~Coverage() = default;
+
+void CFX_AggClipRgn::Coverage::StartRow(int y) {
+  CHECK_GE(y, bottom());
+  const uint32_t end = pdfium::checked_cast<uint32_t>(runs_.size());
+  row_ends_.resize(static_cast<size_t>(y - top_) + 1, end);
+}
+
+void CFX_AggClipRgn::Coverage::AppendFullRun(int left, int right) {
+  CHECK(!row_ends_.empty());
+  CHECK_LT(left, right);
+  const size_t row_begin = row_ends_.size() > 1 ? row_ends_.rbegin()[1] : 0;
+  if (runs_.size() > row_begin) {
+    Run& last = runs_.back();
+    CHECK_LE(last.right, left);
+    if (last.IsFull() && last.right == left) {
+      last.right = right;
+      return;
+    }
+  }
+  runs_.push_back({left, right, Run::kFull});
+  row_ends_.back() = pdfium::checked_cast<uint32_t>(runs_.size());
+}
+
+void CFX_AggClipRgn::Coverage::AppendCoversRun(
+    int left,
+    pdfium::span<const uint8_t> covers) {
+  CHECK(!row_ends_.empty());
+  const int right = left + pdfium::checked_cast<int>(covers.size());
+  const size_t row_begin = row_ends_.size() > 1 ? row_ends_.rbegin()[1] : 0;
+  const uint32_t offset = pdfium::checked_cast<uint32_t>(covers_.size());
+  covers_.insert(covers_.end(), covers.begin(), covers.end());
+  if (runs_.size() > row_begin) {
+    Run& last = runs_.back();
+    CHECK_LE(last.right, left);
+    if (!last.IsFull() && last.right == left &&
+        last.covers_offset + static_cast<uint32_t>(last.right - last.left) ==
+            offset) {
+      last.right = right;
+      return;
+    }
+  }
+  runs_.push_back({left, right, offset});
+  row_ends_.back() = pdfium::checked_cast<uint32_t>(runs_.size());
+}
+
+void CFX_AggClipRgn::Coverage::AppendCovers(
+    int left,
+    pdfium::span<const uint8_t> covers) {
+  // Returns the end of the stretch of identical values starting at `start`.
+  auto solid_end = [covers](size_t start) {
+    size_t end = start + 1;
+    while (end < covers.size() && covers[end] == covers[start]) {
+      ++end;
+    }
+    return end;
+  };
+
+  size_t start = 0;
+  size_t pos = 0;
+  while (pos < covers.size()) {
+    const uint8_t value = covers[pos];
+    if (value != 0 && value != 255) {
+      ++pos;
+      continue;
+    }
+    const size_t end = solid_end(pos);
+    if (end - pos < kMinSolidRun) {
+      pos = end;
+      continue;
+    }
+    if (pos > start) {
+      AppendCoversRun(left + static_cast<int>(start),
+                      covers.subspan(start, pos - start));
+    }
+    if (value == 255) {
+      AppendFullRun(left + static_cast<int>(pos), left + static_cast<int>(end));
+    }
+    start = end;
+    pos = end;
+  }
+  if (covers.size() > start) {
+    AppendCoversRun(left + static_cast<int>(start), covers.subspan(start));
+  }
+}
+
+pdfium::span<const CFX_AggClipRgn::Coverage::Run>
+CFX_AggClipRgn::Coverage::GetRow(int y) const {
+  if (y < top() || y >= bottom()) {
+    return {};
+  }
+  const size_t row = static_cast<size_t>(y - top_);
+  const size_t begin = row > 0 ? row_ends_[row - 1] : 0;
+  return pdfium::span<const Run>(runs_).subspan(begin, row_ends_[row] - begin);
+}
+
+pdfium::span<const uint8_t> CFX_AggClipRgn::Coverage::GetCovers(
+    const Run& run) const {
+  CHECK(!run.IsFull());
+  return pdfium::span<const uint8_t>(covers_).subspan(
+      run.covers_offset, static_cast<size_t>(run.right - run.left));
+}
+
+void CFX_AggClipRgn::Coverage::GetRowValues(int y,
+                                            int left,
+                                            pdfium::span<uint8_t> dest) const {
+  std::ranges::fill(dest, 0);
+  const int right = left + pdfium::checked_cast<int>(dest.size());
+  for (const Run& run : GetRow(y)) {
+    if (run.left >= right) {
+      break;
+    }
+    const int run_left = std::max(left, run.left);
+    const int run_right = std::min(right, run.right);
+    if (run_left >= run_right) {
+      continue;
+    }
+    pdfium::span<uint8_t> dest_run =
+        dest.subspan(static_cast<size_t>(run_left - left),
+                     static_cast<size_t>(run_right - run_left));
+    if (run.IsFull()) {
+      std::ranges::fill(dest_run, 255);
+    } else {
+      fxcrt::Copy(GetCovers(run).subspan(
+                      static_cast<size_t>(run_left - run.left),
+                      dest_run.size()),
+                  dest_run);
+    }
+  }
+}
+
 CFX_AggClipRgn::CFX_AggClipRgn(int width, int height)
     : box_(0, 0, width, height) {}
 
@@ -22,77 +218,53 @@ CFX_AggClipRgn::CFX_AggClipRgn(const CFX_AggClipRgn& src) = default;
 
 CFX_AggClipRgn::~CFX_AggClipRgn() = default;
 
-void CFX_AggClipRgn::IntersectRect(const FX_RECT& rect) {
-  if (type_ == kRectI) {
-    box_.Intersect(rect);
-    return;
+RetainPtr<CFX_DIBitmap> CFX_AggClipRgn::GetMask() const {
+  if (type_ == kMaskF && !mask_) {
+    mask_ = pdfium::MakeRetain<CFX_DIBitmap>();
+    CHECK(mask_->Create(box_.Width(), box_.Height(), FXDIB_Format::k8bppMask));
+    const int top = std::max(box_.top, coverage_->top());
+    const int bottom = std::min(box_.bottom, coverage_->bottom());
+    for (int row = top; row < bottom; ++row) {
+      coverage_->GetRowValues(
+          row, box_.left,
+          mask_->GetWritableScanline(row - box_.top)
+              .first(static_cast<size_t>(box_.Width())));
+    }
   }
-  IntersectMaskRect(rect, box_, mask_);
+  return mask_;
 }
 
-void CFX_AggClipRgn::IntersectMaskRect(FX_RECT rect,
-                                       FX_RECT mask_rect,
-                                       RetainPtr<CFX_DIBitmap> pOldMask) {
-  type_ = kMaskF;
-  box_ = rect;
-  box_.Intersect(mask_rect);
-  if (box_.IsEmpty()) {
+void CFX_AggClipRgn::IntersectRect(const FX_RECT& rect) {
+  FX_RECT new_box = box_;
+  new_box.Intersect(rect);
+  if (type_ == kMaskF && new_box.IsEmpty()) {
     type_ = kRectI;
-    return;
+    coverage_.Reset();
   }
-  if (box_ == mask_rect) {
-    mask_ = std::move(pOldMask);
-    return;
-  }
-  mask_ = pdfium::MakeRetain<CFX_DIBitmap>();
-  CHECK(mask_->Create(box_.Width(), box_.Height(), FXDIB_Format::k8bppMask));
-  const int offset = box_.left - mask_rect.left;
-  for (int row = box_.top; row < box_.bottom; row++) {
-    pdfium::span<uint8_t> dest_scan =
-        mask_->GetWritableScanline(row - box_.top);
-    pdfium::span<const uint8_t> src_scan =
-        pOldMask->GetScanline(row - mask_rect.top);
-    fxcrt::Copy(src_scan.subspan(static_cast<size_t>(offset),
-                                 static_cast<size_t>(box_.Width())),
-                dest_scan);
+  if (new_box != box_) {
+    // The coverage runs stay as they are, but a materialized mask has to
+    // match the box.
+    mask_.Reset();
   }
+  box_ = new_box;
 }
 
-void CFX_AggClipRgn::IntersectMaskF(int left,
-                                    int top,
-                                    RetainPtr<CFX_DIBitmap> pMask) {
-  FX_RECT mask_box(left, top, left + pMask->GetWidth(),
-                   top + pMask->GetHeight());
-  if (!mask_box.IsEmpty()) {
-    // Make sure non-empty masks have the right format. If the mask is empty,
-    // then the format does not matter as it will not get used.
-    CHECK_EQ(pMask->GetFormat(), FXDIB_Format::k8bppMask);
-  }
-  if (type_ == kRectI) {
-    IntersectMaskRect(box_, mask_box, std::move(pMask));
-    return;
-  }
-
+void CFX_AggClipRgn::IntersectCoverage(const FX_RECT& coverage_box,
+                                       RetainPtr<const Coverage> coverage) {
   FX_RECT new_box = box_;
-  new_box.Intersect(mask_box);
+  new_box.Intersect(coverage_box);
+  mask_.Reset();
   if (new_box.IsEmpty()) {
     type_ = kRectI;
-    mask_ = nullptr;
     box_ = new_box;
+    coverage_.Reset();
     return;
   }
-  auto new_dib = pdfium::MakeRetain<CFX_DIBitmap>();
-  CHECK(new_dib->Create(new_box.Width(), new_box.Height(),
-                        FXDIB_Format::k8bppMask));
-  for (int row = new_box.top; row < new_box.bottom; row++) {
-    pdfium::span<const uint8_t> old_scan = mask_->GetScanline(row - box_.top);
-    pdfium::span<const uint8_t> mask_scan = pMask->GetScanline(row - top);
-    auto new_scan = new_dib->GetWritableScanline(row - new_box.top);
-    for (int col = new_box.left; col < new_box.right; col++) {
-      new_scan[col - new_box.left] =
-          old_scan[col - box_.left] * mask_scan[col - left] / 255;
-    }
+  if (type_ == kRectI) {
+    type_ = kMaskF;
+    coverage_ = std::move(coverage);
+  } else {
+    coverage_ = IntersectCoverages(*coverage_, *coverage, new_box);
   }
   box_ = new_box;
-  mask_ = std::move(new_dib);
 }
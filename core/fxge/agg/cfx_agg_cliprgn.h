@@ -7,8 +7,15 @@
 #ifndef CORE_FXGE_AGG_CFX_AGG_CLIPRGN_H_
 #define CORE_FXGE_AGG_CFX_AGG_CLIPRGN_H_
 
+#include <stdint.h>
+
+#include <limits>
+#include <vector>
+
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
 
 class CFX_DIBitmap;
 
@@ -16,25 +23,90 @@ class CFX_AggClipRgn {
  public:
   enum ClipType : bool { kRectI, kMaskF };
 
+  // Coverage of a non-rectangular clip, stored as run-length encoded rows in
+  // device coordinates. Each row holds sorted, non-overlapping runs. A run is
+  // either fully covered, or has one coverage value per pixel. Pixels outside
+  // of all runs are not covered at all.
+  class Coverage final : public Retainable {
+   public:
+    CONSTRUCT_VIA_MAKE_RETAIN;
+
+    struct Run {
+      // Value of `covers_offset` for fully covered runs.
+      static constexpr uint32_t kFull = std::numeric_limits<uint32_t>::max();
+
+      bool IsFull() const { return covers_offset == kFull; }
+
+      int left;
+      int right;
+      uint32_t covers_offset;
+    };
+
+    // Adds empty rows until the last row is `y`, which must be below all
+    // existing rows. Runs always get appended to the last row.
+    void StartRow(int y);
+
+    // `left` must not be less than the right edge of the last run in the row.
+    void AppendFullRun(int left, int right);
+
+    // Appends one run per stretch of `covers`, starting at `left`. Long
+    // stretches of fully covered or uncovered pixels do not get stored
+    // per-pixel.
+    void AppendCovers(int left, pdfium::span<const uint8_t> covers);
+
+    int top() const { return top_; }
+    int bottom() const { return top_ + static_cast<int>(row_ends_.size()); }
+
+    // Returns an empty span for rows outside of [top(), bottom()).
+    pdfium::span<const Run> GetRow(int y) const;
+
+    // `run` must be a row's run which is not fully covered.
+    pdfium::span<const uint8_t> GetCovers(const Run& run) const;
+
+    // Writes the coverage of row `y` for the pixels starting at `left` into
+    // `dest`.
+    void GetRowValues(int y, int left, pdfium::span<uint8_t> dest) const;
+
+   private:
+    explicit Coverage(int top);
+    ~Coverage() override;
+
+    void AppendCoversRun(int left, pdfium::span<const uint8_t> covers);
+
+    const int top_;
+    // Index into `runs_` one past the last run of each row.
+    std::vector<uint32_t> row_ends_;
+    std::vector<Run> runs_;
+    DataVector<uint8_t> covers_;
+  };
+
   CFX_AggClipRgn(int device_width, int device_height);
   CFX_AggClipRgn(const CFX_AggClipRgn& src);
   ~CFX_AggClipRgn();
 
   ClipType GetType() const { return type_; }
   const FX_RECT& GetBox() const { return box_; }
-  RetainPtr<CFX_DIBitmap> GetMask() const { return mask_; }
+
+  // Only valid for kMaskF. Clip regions are usually consumed through
+  // GetCoverage(). GetMask() creates a k8bppMask bitmap the size of GetBox()
+  // on first use, for callers that need one.
+  const Coverage* GetCoverage() const { return coverage_.Get(); }
+  RetainPtr<CFX_DIBitmap> GetMask() const;
 
   void IntersectRect(const FX_RECT& rect);
-  void IntersectMaskF(int left, int top, RetainPtr<CFX_DIBitmap> Mask);
 
- private:
-  void IntersectMaskRect(FX_RECT rect,
-                         FX_RECT mask_rect,
-                         RetainPtr<CFX_DIBitmap> pOldMask);
+  // Intersects with `coverage`, which must not cover anything outside of
+  // `coverage_box`.
+  void IntersectCoverage(const FX_RECT& coverage_box,
+                         RetainPtr<const Coverage> coverage);
 
+ private:
   ClipType type_ = kRectI;
   FX_RECT box_;
-  RetainPtr<CFX_DIBitmap> mask_;
+  // Runs may extend beyond `box_`, which takes precedence.
+  RetainPtr<const Coverage> coverage_;
+  // Lazily created by GetMask().
+  mutable RetainPtr<CFX_DIBitmap> mask_;
 };
 
 #endif  // CORE_FXGE_AGG_CFX_AGG_CLIPRGN_H_
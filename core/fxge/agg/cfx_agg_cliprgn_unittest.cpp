@@ -0,0 +1,126 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/agg/cfx_agg_cliprgn.h"
+
+#include <stdint.h>
+
+#include <array>
+
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Coverage = CFX_AggClipRgn::Coverage;
+
+// Creates a coverage with `covers` in every row of `rect`.
+RetainPtr<const Coverage> CreateCoverage(const FX_RECT& rect,
+                                         pdfium::span<const uint8_t> covers) {
+  auto coverage = pdfium::MakeRetain<Coverage>(rect.top);
+  for (int y = rect.top; y < rect.bottom; ++y) {
+    coverage->StartRow(y);
+    coverage->AppendCovers(rect.left, covers);
+  }
+  return coverage;
+}
+
+}  // namespace
+
+TEST(CFXAggClipRgn, AppendCovers) {
+  static constexpr std::array<uint8_t, 24> kCovers = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   128, 255, 255,
+      255, 255, 255, 255, 255, 255, 255, 255, 255, 64,  0,   0};
+  auto coverage = pdfium::MakeRetain<Coverage>(3);
+  coverage->StartRow(5);
+  coverage->AppendCovers(10, kCovers);
+  EXPECT_EQ(3, coverage->top());
+  EXPECT_EQ(6, coverage->bottom());
+  EXPECT_TRUE(coverage->GetRow(3).empty());
+  EXPECT_TRUE(coverage->GetRow(4).empty());
+  EXPECT_TRUE(coverage->GetRow(6).empty());
+
+  // The leading uncovered pixels are dropped, and the fully covered ones get
+  // their own run.
+  pdfium::span<const Coverage::Run> runs = coverage->GetRow(5);
+  ASSERT_EQ(3u, runs.size());
+  EXPECT_EQ(19, runs[0].left);
+  EXPECT_EQ(20, runs[0].right);
+  EXPECT_EQ(20, runs[1].left);
+  EXPECT_EQ(31, runs[1].right);
+  EXPECT_TRUE(runs[1].IsFull());
+  EXPECT_EQ(31, runs[2].left);
+  EXPECT_EQ(34, runs[2].right);
+  EXPECT_THAT(coverage->GetCovers(runs[0]), testing::ElementsAre(128));
+  EXPECT_THAT(coverage->GetCovers(runs[2]), testing::ElementsAre(64, 0, 0));
+
+  std::array<uint8_t, 6> values;
+  coverage->GetRowValues(5, 17, values);
+  EXPECT_THAT(values, testing::ElementsAre(0, 0, 128, 255, 255, 255));
+  coverage->GetRowValues(4, 17, values);
+  EXPECT_THAT(values, testing::Each(0));
+}
+
+TEST(CFXAggClipRgn, IntersectCoverage) {
+  static constexpr uint8_t kCovers[] = {255, 128, 0, 64};
+  CFX_AggClipRgn clip(100, 100);
+  clip.IntersectCoverage(FX_RECT(10, 20, 14, 22),
+                         CreateCoverage(FX_RECT(10, 20, 14, 22), kCovers));
+  ASSERT_EQ(CFX_AggClipRgn::kMaskF, clip.GetType());
+  EXPECT_EQ(FX_RECT(10, 20, 14, 22), clip.GetBox());
+
+  RetainPtr<CFX_DIBitmap> mask = clip.GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(4, mask->GetWidth());
+  EXPECT_EQ(2, mask->GetHeight());
+  EXPECT_THAT(mask->GetScanline(1).first(4u),
+              testing::ElementsAre(255, 128, 0, 64));
+  EXPECT_EQ(mask, clip.GetMask());
+
+  // Coverages multiply, and the box shrinks to the overlap.
+  static constexpr uint8_t kOtherCovers[] = {128, 128, 255};
+  clip.IntersectCoverage(FX_RECT(11, 21, 14, 30),
+                         CreateCoverage(FX_RECT(11, 21, 14, 30), kOtherCovers));
+  ASSERT_EQ(CFX_AggClipRgn::kMaskF, clip.GetType());
+  EXPECT_EQ(FX_RECT(11, 21, 14, 22), clip.GetBox());
+  mask = clip.GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(3, mask->GetWidth());
+  EXPECT_EQ(1, mask->GetHeight());
+  EXPECT_THAT(mask->GetScanline(0).first(3u), testing::ElementsAre(64, 0, 64));
+
+  clip.IntersectCoverage(FX_RECT(50, 50, 60, 60),
+                         CreateCoverage(FX_RECT(50, 50, 60, 60), kCovers));
+  EXPECT_EQ(CFX_AggClipRgn::kRectI, clip.GetType());
+  EXPECT_TRUE(clip.GetBox().IsEmpty());
+}
+
+TEST(CFXAggClipRgn, IntersectRect) {
+  static constexpr uint8_t kCovers[] = {10, 20, 30, 40};
+  CFX_AggClipRgn clip(100, 100);
+  clip.IntersectRect(FX_RECT(5, 5, 50, 50));
+  EXPECT_EQ(CFX_AggClipRgn::kRectI, clip.GetType());
+  EXPECT_EQ(FX_RECT(5, 5, 50, 50), clip.GetBox());
+
+  clip.IntersectCoverage(FX_RECT(10, 10, 14, 13),
+                         CreateCoverage(FX_RECT(10, 10, 14, 13), kCovers));
+  RetainPtr<CFX_DIBitmap> mask = clip.GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(4, mask->GetWidth());
+
+  clip.IntersectRect(FX_RECT(11, 11, 13, 20));
+  ASSERT_EQ(CFX_AggClipRgn::kMaskF, clip.GetType());
+  EXPECT_EQ(FX_RECT(11, 11, 13, 13), clip.GetBox());
+  mask = clip.GetMask();
+  ASSERT_TRUE(mask);
+  EXPECT_EQ(2, mask->GetWidth());
+  EXPECT_EQ(2, mask->GetHeight());
+  EXPECT_THAT(mask->GetScanline(0).first(2u), testing::ElementsAre(20, 30));
+
+  clip.IntersectRect(FX_RECT(0, 0, 11, 11));
+  EXPECT_EQ(CFX_AggClipRgn::kRectI, clip.GetType());
+  EXPECT_TRUE(clip.GetBox().IsEmpty());
+}
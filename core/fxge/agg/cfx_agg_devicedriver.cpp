@@ -10,12 +10,15 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <array>
 #include <utility>
 
 #include "build/build_config.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_memcpy_wrappers.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/notreached.h"
 #include "core/fxcrt/span.h"
@@ -39,7 +42,6 @@
 #include "third_party/agg23/agg_conv_stroke.h"
 #include "third_party/agg23/agg_curves.h"
 #include "third_party/agg23/agg_path_storage.h"
-#include "third_party/agg23/agg_pixfmt_gray.h"
 #include "third_party/agg23/agg_rasterizer_scanline_aa.h"
 #include "third_party/agg23/agg_renderer_scanline.h"
 #include "third_party/agg23/agg_scanline_u.h"
@@ -347,8 +349,11 @@ agg::filling_rule_e GetAlternateOrWindingFillType(
              : agg::fill_even_odd;
 }
 
-RetainPtr<CFX_DIBitmap> GetClipMaskFromRegion(const CFX_AggClipRgn* r) {
-  return (r && r->GetType() == CFX_AggClipRgn::kMaskF) ? r->GetMask() : nullptr;
+RetainPtr<const CFX_AggClipRgn::Coverage> GetClipCoverageFromRegion(
+    const CFX_AggClipRgn* r) {
+  return pdfium::WrapRetain(
+      (r && r->GetType() == CFX_AggClipRgn::kMaskF) ? r->GetCoverage()
+                                                    : nullptr);
 }
 
 FX_RECT GetClipBoxFromRegion(const RetainPtr<CFX_DIBitmap>& device,
@@ -391,6 +396,19 @@ class CFX_AggRenderer {
                      const uint8_t* cover_scan,
                      const uint8_t* clip_scan);
 
+  // Composites a span without a clip scanline. Stretches of fully covered
+  // pixels, which make up most of a large fill, go to CompositeSolidSpan().
+  void CompositeUnclippedSpan(uint8_t* dest_scan,
+                              int bytes_per_pixel,
+                              int col_start,
+                              int col_end,
+                              const uint8_t* cover_scan);
+
+  void CompositeSolidSpan(uint8_t* dest_scan,
+                          int bytes_per_pixel,
+                          int col_start,
+                          int col_end);
+
   void CompositeSpanGray(uint8_t* dest_scan,
                          int bytes_per_pixel,
                          int col_start,
@@ -459,10 +477,12 @@ class CFX_AggRenderer {
   const bool rgb_byte_order_;
   const FX_RECT clip_box_;
   RetainPtr<CFX_DIBitmap> const backdrop_device_;
-  RetainPtr<CFX_DIBitmap> const clip_mask_;
+  RetainPtr<const CFX_AggClipRgn::Coverage> const clip_coverage_;
   RetainPtr<CFX_DIBitmap> const device_;
   UnownedPtr<const CFX_AggClipRgn> clip_rgn_;
   const CompositeSpanFunc composite_span_func_;
+  // Expanded clip coverage for CompositeSpan(), which writes every pixel.
+  DataVector<uint8_t> clip_scan_buf_;
 };
 
 void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
@@ -606,6 +626,97 @@ void CFX_AggRenderer::CompositeSpan(uint8_t* dest_scan,
   });
 }
 
+void CFX_AggRenderer::CompositeUnclippedSpan(uint8_t* dest_scan,
+                                             int bytes_per_pixel,
+                                             int col_start,
+                                             int col_end,
+                                             const uint8_t* cover_scan) {
+  // Blending into ARGB depends on the destination alpha, so only opaque
+  // colors get the solid fast path there.
+  if (alpha_ != 255 &&
+      composite_span_func_ == &CFX_AggRenderer::CompositeSpanARGB) {
+    (this->*composite_span_func_)(dest_scan, bytes_per_pixel, col_start,
+                                  col_end, cover_scan, nullptr);
+    return;
+  }
+  // Without a clip scanline, every compositor treats fully covered pixels
+  // the same way: it merges the color in with the color's own alpha.
+  UNSAFE_TODO({
+    int col = col_start;
+    while (col < col_end) {
+      const int partial_start = col;
+      while (col < col_end && cover_scan[col] != 255) {
+        ++col;
+      }
+      if (col > partial_start) {
+        (this->*composite_span_func_)(dest_scan, bytes_per_pixel,
+                                      partial_start, col, cover_scan, nullptr);
+      }
+      const int solid_start = col;
+      while (col < col_end && cover_scan[col] == 255) {
+        ++col;
+      }
+      if (col > solid_start) {
+        CompositeSolidSpan(dest_scan, bytes_per_pixel, solid_start, col);
+      }
+    }
+  });
+}
+
+void CFX_AggRenderer::CompositeSolidSpan(uint8_t* dest_scan,
+                                         int bytes_per_pixel,
+                                         int col_start,
+                                         int col_end) {
+  const size_t count = static_cast<size_t>(col_end - col_start);
+  // `color_` is already in the device's byte order.
+  const std::array<uint8_t, 3> pixel = {static_cast<uint8_t>(color_),
+                                        static_cast<uint8_t>(color_ >> 8),
+                                        static_cast<uint8_t>(color_ >> 16)};
+  UNSAFE_TODO({
+    if (alpha_ == 255) {
+      switch (bytes_per_pixel) {
+        case 1:
+          FXSYS_memset(dest_scan + col_start, GetGray(), count);
+          return;
+        case 3: {
+          uint8_t* dest = dest_scan + col_start * 3;
+          for (size_t i = 0; i < count; ++i) {
+            FXSYS_memcpy(dest, pixel.data(), 3);
+            dest += 3;
+          }
+          return;
+        }
+        case 4:
+          std::fill_n(reinterpret_cast<uint32_t*>(dest_scan) + col_start,
+                      count, color_);
+          return;
+        default:
+          NOTREACHED();
+      }
+    }
+    // Precompute the color's share of FXDIB_ALPHA_MERGE().
+    const int inverse_alpha = 255 - alpha_;
+    if (bytes_per_pixel == 1) {
+      const int gray = GetGray() * alpha_;
+      uint8_t* dest = dest_scan + col_start;
+      for (size_t i = 0; i < count; ++i) {
+        dest[i] = (dest[i] * inverse_alpha + gray) / 255;
+      }
+      return;
+    }
+    const int c0 = pixel[0] * alpha_;
+    const int c1 = pixel[1] * alpha_;
+    const int c2 = pixel[2] * alpha_;
+    uint8_t* dest = dest_scan + col_start * bytes_per_pixel;
+    for (size_t i = 0; i < count; ++i) {
+      dest[0] = (dest[0] * inverse_alpha + c0) / 255;
+      dest[1] = (dest[1] * inverse_alpha + c1) / 255;
+      dest[2] = (dest[2] * inverse_alpha + c2) / 255;
+      dest += bytes_per_pixel;
+    }
+  });
+}
+
 void CFX_AggRenderer::CompositeSpanGray(uint8_t* dest_scan,
                                         int bytes_per_pixel,
                                         int col_start,
@@ -774,7 +885,7 @@ CFX_AggRenderer::CFX_AggRenderer(const RetainPtr<CFX_DIBitmap>& pDevice,
       rgb_byte_order_(bRgbByteOrder),
       clip_box_(GetClipBoxFromRegion(pDevice, pClipRgn)),
       backdrop_device_(pBackdropDevice),
-      clip_mask_(GetClipMaskFromRegion(pClipRgn)),
+      clip_coverage_(GetClipCoverageFromRegion(pClipRgn)),
       device_(pDevice),
       clip_rgn_(pClipRgn),
       composite_span_func_(GetCompositeSpanFunc(device_)) {
@@ -822,21 +933,49 @@ void CFX_AggRenderer::render(const Scanline& sl) {
       uint8_t* dest_pos = dest_scan + x * bytes_per_pixel;
       const uint8_t* backdrop_pos =
           backdrop_scan ? backdrop_scan + x * bytes_per_pixel : nullptr;
-      const uint8_t* clip_pos = nullptr;
-      if (clip_mask_) {
-        // TODO(crbug.com/1382604): use subspan arithmetic.
-        clip_pos = clip_mask_->GetBuffer().data() +
-                   (y - clip_box_.top) * clip_mask_->GetPitch() + x -
-                   clip_box_.left;
-      }
       const int col_start = GetColStart(x, clip_box_.left);
       const int col_end = GetColEnd(x, span->len, clip_box_.right);
-      if (backdrop_pos) {
-        CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha,
-                      col_start, col_end, span->covers, clip_pos);
+      if (!clip_coverage_) {
+        if (backdrop_pos) {
+          CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha,
+                        col_start, col_end, span->covers, nullptr);
+        } else {
+          CompositeUnclippedSpan(dest_pos, bytes_per_pixel, col_start,
+                                 col_end, span->covers);
+        }
+      } else if (backdrop_pos) {
+        if (col_start < col_end) {
+          clip_scan_buf_.resize(static_cast<size_t>(col_end - col_start));
+          clip_coverage_->GetRowValues(y, x + col_start, clip_scan_buf_);
+          // TODO(crbug.com/1382604): use subspan arithmetic.
+          CompositeSpan(dest_pos, backdrop_pos, bytes_per_pixel, bDestAlpha,
+                        col_start, col_end, span->covers,
+                        clip_scan_buf_.data() - col_start);
+        }
       } else {
-        (this->*composite_span_func_)(dest_pos, bytes_per_pixel, col_start,
-                                      col_end, span->covers, clip_pos);
+        // Uncovered pixels are left alone, so only composite the parts of
+        // the span that overlap with clip runs. Fully covered runs need no
+        // clip scanline at all.
+        for (const auto& run : clip_coverage_->GetRow(y)) {
+          if (run.left - x >= col_end) {
+            break;
+          }
+          const int run_start = std::max(col_start, run.left - x);
+          const int run_end = std::min(col_end, run.right - x);
+          if (run_start >= run_end) {
+            continue;
+          }
+          if (run.IsFull()) {
+            CompositeUnclippedSpan(dest_pos, bytes_per_pixel, run_start,
+                                   run_end, span->covers);
+            continue;
+          }
+          // TODO(crbug.com/1382604): use subspan arithmetic.
+          const uint8_t* clip_pos =
+              clip_coverage_->GetCovers(run).data() - (run.left - x);
+          (this->*composite_span_func_)(dest_pos, bytes_per_pixel, run_start,
+                                        run_end, span->covers, clip_pos);
+        }
       }
       if (--num_spans == 0) {
         break;
@@ -847,43 +986,60 @@ void CFX_AggRenderer::render(const Scanline& sl) {
   });
 }
 
-template <class BaseRenderer>
-class RendererScanLineAaOffset {
+// Returns the value AGG's gray8 pixel format stores when blending full
+// intensity at `cover` into an empty mask pixel.
+constexpr uint8_t GetClipMaskValue(unsigned cover) {
+  const unsigned alpha = (255 * (cover + 1)) >> 8;
+  return alpha == 255 ? 255 : static_cast<uint8_t>((255 * alpha) >> 8);
+}
+
+// Records rasterized scanlines as clip coverage, clipped to `rect`.
+class ClipCoverageRenderer {
  public:
-  typedef BaseRenderer base_ren_type;
-  typedef typename base_ren_type::color_type color_type;
-  RendererScanLineAaOffset(base_ren_type& ren, unsigned left, unsigned top)
-      : ren_(&ren), left_(left), top_(top) {}
-  void color(const color_type& c) { color_ = c; }
-  const color_type& color() const { return color_; }
+  ClipCoverageRenderer(CFX_AggClipRgn::Coverage* coverage, const FX_RECT& rect)
+      : coverage_(coverage), rect_(rect) {}
+
+  // Needed for agg caller
   void prepare(unsigned) {}
+
   template <class Scanline>
   void render(const Scanline& sl) {
-    int y = sl.y();
+    const int y = sl.y();
+    if (y < rect_.top || y >= rect_.bottom) {
+      return;
+    }
+    coverage_->StartRow(y);
     unsigned num_spans = sl.num_spans();
     typename Scanline::const_iterator span = sl.begin();
-    while (true) {
-      int x = span->x;
-      if (span->len > 0) {
-        ren_->blend_solid_hspan(x - left_, y - top_, (unsigned)span->len,
-                                color_, span->covers);
-      } else {
-        ren_->blend_hline(x - left_, y - top_, (unsigned)(x - span->len - 1),
-                          color_, *(span->covers));
-      }
-      if (--num_spans == 0) {
-        break;
-      }
+    UNSAFE_TODO({
+      while (true) {
+        const int x = span->x;
+        const bool solid = span->len < 0;
+        const int len = solid ? -span->len : span->len;
+        const int left = std::max(x, rect_.left);
+        const int right = std::min(x + len, rect_.right);
+        if (left < right) {
+          covers_.resize(static_cast<size_t>(right - left));
+          for (size_t i = 0; i < covers_.size(); ++i) {
+            covers_[i] =
+                GetClipMaskValue(solid ? *span->covers
+                                       : span->covers[left - x + i]);
+          }
+          coverage_->AppendCovers(left, covers_);
+        }
+        if (--num_spans == 0) {
+          break;
+        }
 
-      UNSAFE_TODO(++span);
-    }
+        ++span;
+      }
+    });
   }
 
  private:
-  UNOWNED_PTR_EXCLUSION base_ren_type* ren_;
-  color_type color_;
-  unsigned left_;
-  unsigned top_;
+  UnownedPtr<CFX_AggClipRgn::Coverage> const coverage_;
+  const FX_RECT rect_;
+  DataVector<uint8_t> covers_;
 };
 
 agg::path_storage BuildAggPath(const CFX_Path& path,
@@ -1031,24 +1187,14 @@ void CFX_AggDeviceDriver::SetClipMask(agg::rasterizer_scanline_aa& rasterizer) {
   FX_RECT path_rect(rasterizer.min_x(), rasterizer.min_y(),
                     rasterizer.max_x() + 1, rasterizer.max_y() + 1);
   path_rect.Intersect(clip_rgn_->GetBox());
-  auto pThisLayer = pdfium::MakeRetain<CFX_DIBitmap>();
+  auto coverage = pdfium::MakeRetain<CFX_AggClipRgn::Coverage>(path_rect.top);
   if (!path_rect.IsEmpty()) {
-    CHECK(pThisLayer->Create(path_rect.Width(), path_rect.Height(),
-                             FXDIB_Format::k8bppMask));
-    agg::rendering_buffer raw_buf(
-        pThisLayer->GetWritableBuffer().data(), pThisLayer->GetWidth(),
-        pThisLayer->GetHeight(), pThisLayer->GetPitch());
-    agg::pixfmt_gray8 pixel_buf(raw_buf);
-    agg::renderer_base<agg::pixfmt_gray8> base_buf(pixel_buf);
-    RendererScanLineAaOffset<agg::renderer_base<agg::pixfmt_gray8>>
-        final_render(base_buf, path_rect.left, path_rect.top);
-    final_render.color(agg::gray8(255));
+    ClipCoverageRenderer render(coverage.Get(), path_rect);
     agg::scanline_u8 scanline;
-    agg::render_scanlines(rasterizer, scanline, final_render,
+    agg::render_scanlines(rasterizer, scanline, render,
                           fill_options_.aliased_path);
   }
-  clip_rgn_->IntersectMaskF(path_rect.left, path_rect.top,
-                            std::move(pThisLayer));
+  clip_rgn_->IntersectCoverage(path_rect, std::move(coverage));
 }
 
 bool CFX_AggDeviceDriver::SetClip_PathFill(
@@ -356,7 +356,7 @@ void CFPF_SkiaFontMgr::ScanPath(const ByteString& path) {
 
   ByteString filename;
   bool is_folder = false;
-  while (handle->GetNextFile(&filename, &is_folder)) {
+  while (handle->GetNextFile(&filename, &is_folder, /*info=*/nullptr)) {
     if (is_folder) {
       if (filename == "." || filename == "..") {
         continue;
@@ -163,6 +163,7 @@ CApplePlatform::CreateDefaultSystemFontInfo() {
     pInfo->AddPath("/Library/Fonts");
     pInfo->AddPath("/System/Library/Fonts");
   }
+  pInfo->SetIndexCachePath(CFX_GEModule::Get()->GetFontIndexCachePath());
   return pInfo;
 }
 
@@ -6,25 +6,37 @@
 
 #include "core/fxge/cfx_folderfontinfo.h"
 
+#include <stdlib.h>
+
 #include <array>
 #include <iterator>
 #include <limits>
 #include <utility>
 
 #include "build/build_config.h"
+#include "core/fxcrt/binary_buffer.h"
 #include "core/fxcrt/byteorder.h"
 #include "core/fxcrt/check_op.h"
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/containers/contains.h"
+#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fixed_size_data_vector.h"
 #include "core/fxcrt/fx_codepage.h"
 #include "core/fxcrt/fx_extension.h"
 #include "core/fxcrt/fx_folder.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_system.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/stl_util.h"
 #include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/fx_font.h"
 
+#if BUILDFLAG(IS_WIN)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace {
 
 struct FontSubst {
@@ -56,6 +68,33 @@ struct FxFileCloser {
   }
 };
 
+// Creates a new file for writing next to `path`, and returns it along with its
+// name in `temp_path`. The name is unique to the calling process, so processes
+// writing to `path` at the same time do not clobber each other's files.
+std::unique_ptr<FILE, FxFileCloser> CreateTempFileNextTo(
+    const ByteString& path,
+    ByteString* temp_path) {
+#if BUILDFLAG(IS_WIN)
+  *temp_path = path + ByteString::Format(".%d.tmp", _getpid());
+  return std::unique_ptr<FILE, FxFileCloser>(fopen(temp_path->c_str(), "wb"));
+#else
+  ByteString name_template = path + ".XXXXXX";
+  DataVector<char> name(name_template.begin(), name_template.end());
+  name.push_back('\0');
+  const int fd = mkstemp(name.data());
+  if (fd < 0) {
+    return nullptr;
+  }
+  *temp_path = ByteString(name.data());
+  std::unique_ptr<FILE, FxFileCloser> file(fdopen(fd, "wb"));
+  if (!file) {
+    close(fd);
+    remove(temp_path->c_str());
+  }
+  return file;
+#endif
+}
+
 bool FindFamilyNameMatch(ByteStringView family_name,
                          const ByteString& installed_font_name) {
   std::optional<size_t> result = installed_font_name.Find(family_name, 0);
@@ -135,6 +174,64 @@ uint32_t GetCharset(FX_Charset charset) {
   return 0;
 }
 
+constexpr uint32_t kIndexCacheMagic =
+    CFX_FontMapper::MakeTag('F', 'F', 'I', 'X');
+constexpr uint32_t kIndexCacheVersion = 2;
+
+// Reads the values written by BinaryBuffer. Once a read runs past the end of
+// the data, all further reads fail.
+class IndexCacheReader {
+ public:
+  explicit IndexCacheReader(pdfium::span<const uint8_t> data) : data_(data) {}
+
+  bool ok() const { return ok_; }
+  bool AtEnd() const { return data_.empty(); }
+
+  uint32_t ReadUint32() {
+    uint32_t value = 0;
+    if (!ok_ || data_.size() < sizeof(value)) {
+      ok_ = false;
+      return 0;
+    }
+    fxcrt::Copy(data_.first<sizeof(value)>(),
+                pdfium::as_writable_bytes(pdfium::span_from_ref(value)));
+    data_ = data_.subspan<sizeof(value)>();
+    return value;
+  }
+
+  int64_t ReadInt64() {
+    const uint32_t low = ReadUint32();
+    const uint32_t high = ReadUint32();
+    return static_cast<int64_t>((static_cast<uint64_t>(high) << 32) | low);
+  }
+
+  ByteString ReadString() {
+    const uint32_t size = ReadUint32();
+    if (!ok_ || data_.size() < size) {
+      ok_ = false;
+      return ByteString();
+    }
+    ByteString result(ByteStringView(data_.first(size)));
+    data_ = data_.subspan(size);
+    return result;
+  }
+
+ private:
+  pdfium::span<const uint8_t> data_;
+  bool ok_ = true;
+};
+
+void AppendInt64(BinaryBuffer& buffer, int64_t value) {
+  const uint64_t bits = static_cast<uint64_t>(value);
+  buffer.AppendUint32(static_cast<uint32_t>(bits));
+  buffer.AppendUint32(static_cast<uint32_t>(bits >> 32));
+}
+
+void AppendSizedString(BinaryBuffer& buffer, const ByteString& str) {
+  buffer.AppendUint32(pdfium::checked_cast<uint32_t>(str.GetLength()));
+  buffer.AppendString(str);
+}
+
 }  // namespace
 
 CFX_FolderFontInfo::CFX_FolderFontInfo() = default;
@@ -145,11 +242,30 @@ void CFX_FolderFontInfo::AddPath(const ByteString& path) {
   path_list_.push_back(path);
 }
 
+void CFX_FolderFontInfo::SetIndexCachePath(const ByteString& path) {
+  index_cache_path_ = path;
+}
+
 void CFX_FolderFontInfo::EnumFontList(CFX_FontMapper* pMapper) {
   mapper_ = pMapper;
+  if (index_cache_path_.IsEmpty()) {
+    for (const auto& path : path_list_) {
+      ScanPath(path);
+    }
+    return;
+  }
+
+  LoadIndexCache();
+  index_changed_ = false;
   for (const auto& path : path_list_) {
     ScanPath(path);
   }
+  // Files left over from the cache no longer exist.
+  if (index_changed_ || !cached_files_.empty()) {
+    SaveIndexCache();
+  }
+  cached_files_.clear();
+  scanned_files_.clear();
 }
 
 void CFX_FolderFontInfo::ScanPath(const ByteString& path) {
@@ -160,7 +276,8 @@ void CFX_FolderFontInfo::ScanPath(const ByteString& path) {
 
   ByteString filename;
   bool bFolder;
-  while (handle->GetNextFile(&filename, &bFolder)) {
+  FX_Folder::FileInfo file_info;
+  while (handle->GetNextFile(&filename, &bFolder, &file_info)) {
     if (bFolder) {
       if (filename == "." || filename == "..") {
         continue;
@@ -181,14 +298,49 @@ void CFX_FolderFontInfo::ScanPath(const ByteString& path) {
 #endif
 
     fullpath += filename;
-    bFolder ? ScanPath(fullpath) : ScanFile(fullpath);
+    bFolder ? ScanPath(fullpath) : ScanFile(fullpath, file_info);
   }
 }
 
-void CFX_FolderFontInfo::ScanFile(const ByteString& path) {
+void CFX_FolderFontInfo::ScanFile(const ByteString& path,
+                                  const FX_Folder::FileInfo& file_info) {
+  if (index_cache_path_.IsEmpty()) {
+    for (auto& face : ParseFile(path)) {
+      ReportFace(std::move(face));
+    }
+    return;
+  }
+
+  if (pdfium::Contains(scanned_files_, path)) {
+    return;
+  }
+
+  IndexedFile indexed;
+  auto it = cached_files_.find(path);
+  if (it != cached_files_.end() &&
+      it->second.file_info.size == file_info.size &&
+      it->second.file_info.modification_time == file_info.modification_time) {
+    indexed = std::move(it->second);
+  } else {
+    indexed.file_info = file_info;
+    indexed.faces = ParseFile(path);
+    index_changed_ = true;
+  }
+  if (it != cached_files_.end()) {
+    cached_files_.erase(it);
+  }
+  for (const auto& face : indexed.faces) {
+    ReportFace(std::make_unique<FontFaceInfo>(*face));
+  }
+  scanned_files_[path] = std::move(indexed);
+}
+
+std::vector<std::unique_ptr<CFX_FolderFontInfo::FontFaceInfo>>
+CFX_FolderFontInfo::ParseFile(const ByteString& path) {
+  std::vector<std::unique_ptr<FontFaceInfo>> faces;
   std::unique_ptr<FILE, FxFileCloser> pFile(fopen(path.c_str(), "rb"));
   if (!pFile) {
-    return;
+    return faces;
   }
 
   fseek(pFile.get(), 0, SEEK_END);
@@ -201,12 +353,16 @@ void CFX_FolderFontInfo::ScanFile(const ByteString& path) {
   size_t items_read =
       UNSAFE_BUFFERS(fread(buffer, /*size=*/12, /*nmemb=*/1, pFile.get()));
   if (items_read != 1) {
-    return;
+    return faces;
   }
   uint32_t magic = fxcrt::GetUInt32MSBFirst(pdfium::span(buffer).first<4u>());
   if (magic != kTableTTCF) {
-    ReportFace(path, pFile.get(), filesize, 0);
-    return;
+    std::unique_ptr<FontFaceInfo> face =
+        ParseFace(path, pFile.get(), filesize, 0);
+    if (face) {
+      faces.push_back(std::move(face));
+    }
+    return faces;
   }
 
   uint32_t nFaces =
@@ -214,7 +370,7 @@ void CFX_FolderFontInfo::ScanFile(const ByteString& path) {
   FX_SAFE_SIZE_T safe_face_bytes = nFaces;
   safe_face_bytes *= 4;
   if (!safe_face_bytes.IsValid()) {
-    return;
+    return faces;
   }
 
   auto offsets =
@@ -223,34 +379,39 @@ void CFX_FolderFontInfo::ScanFile(const ByteString& path) {
   items_read = UNSAFE_TODO(fread(offsets_span.data(), /*size=*/1,
                                  /*nmemb=*/offsets_span.size(), pFile.get()));
   if (items_read != offsets_span.size()) {
-    return;
+    return faces;
   }
 
   for (uint32_t i = 0; i < nFaces; i++) {
-    ReportFace(
+    std::unique_ptr<FontFaceInfo> face = ParseFace(
         path, pFile.get(), filesize,
         fxcrt::GetUInt32MSBFirst(offsets_span.subspan(i * 4).first<4u>()));
+    if (face) {
+      faces.push_back(std::move(face));
+    }
   }
+  return faces;
 }
 
-void CFX_FolderFontInfo::ReportFace(const ByteString& path,
-                                    FILE* pFile,
-                                    FX_FILESIZE filesize,
-                                    uint32_t offset) {
+std::unique_ptr<CFX_FolderFontInfo::FontFaceInfo> CFX_FolderFontInfo::ParseFace(
+    const ByteString& path,
+    FILE* pFile,
+    FX_FILESIZE filesize,
+    uint32_t offset) {
   char buffer[16];
   if (fseek(pFile, offset, SEEK_SET) < 0) {
-    return;
+    return nullptr;
   }
   // SAFTEY: 12 byt read fits in 16 byte buffer.
   if (UNSAFE_BUFFERS(!fread(buffer, 12, 1, pFile))) {
-    return;
+    return nullptr;
   }
 
   uint32_t nTables =
       fxcrt::GetUInt16MSBFirst(pdfium::as_byte_span(buffer).subspan<4, 2>());
   ByteString tables = ReadStringFromFile(pFile, nTables * 16);
   if (tables.IsEmpty()) {
-    return;
+    return nullptr;
   }
 
   static constexpr uint32_t kNameTag =
@@ -258,12 +419,12 @@ void CFX_FolderFontInfo::ReportFace(const ByteString& path,
   ByteString names = LoadTableFromTT(pFile, tables.unsigned_str(), nTables,
                                      kNameTag, filesize);
   if (names.IsEmpty()) {
-    return;
+    return nullptr;
   }
 
   ByteString facename = GetNameFromTT(names.unsigned_span(), 1);
   if (facename.IsEmpty()) {
-    return;
+    return nullptr;
   }
 
   ByteString style = GetNameFromTT(names.unsigned_span(), 2);
@@ -271,10 +432,6 @@ void CFX_FolderFontInfo::ReportFace(const ByteString& path,
     facename += " " + style;
   }
 
-  if (pdfium::Contains(font_list_, facename)) {
-    return;
-  }
-
   auto pInfo =
       std::make_unique<FontFaceInfo>(path, facename, tables, offset, filesize);
   static constexpr uint32_t kOs2Tag =
@@ -285,27 +442,21 @@ void CFX_FolderFontInfo::ReportFace(const ByteString& path,
     pdfium::span<const uint8_t> p = os2.unsigned_span().subspan(78u);
     uint32_t codepages = fxcrt::GetUInt32MSBFirst(p.first<4u>());
     if (codepages & (1U << 17)) {
-      mapper_->AddInstalledFont(facename, FX_Charset::kShiftJIS);
       pInfo->charsets_ |= CHARSET_FLAG_SHIFTJIS;
     }
     if (codepages & (1U << 18)) {
-      mapper_->AddInstalledFont(facename, FX_Charset::kChineseSimplified);
       pInfo->charsets_ |= CHARSET_FLAG_GB;
     }
     if (codepages & (1U << 20)) {
-      mapper_->AddInstalledFont(facename, FX_Charset::kChineseTraditional);
       pInfo->charsets_ |= CHARSET_FLAG_BIG5;
     }
     if ((codepages & (1U << 19)) || (codepages & (1U << 21))) {
-      mapper_->AddInstalledFont(facename, FX_Charset::kHangul);
       pInfo->charsets_ |= CHARSET_FLAG_KOREAN;
     }
     if (codepages & (1U << 31)) {
-      mapper_->AddInstalledFont(facename, FX_Charset::kSymbol);
       pInfo->charsets_ |= CHARSET_FLAG_SYMBOL;
     }
   }
-  mapper_->AddInstalledFont(facename, FX_Charset::kANSI);
   pInfo->charsets_ |= CHARSET_FLAG_ANSI;
   pInfo->styles_ = 0;
   if (style.Contains("Bold")) {
@@ -317,8 +468,129 @@ void CFX_FolderFontInfo::ReportFace(const ByteString& path,
   if (facename.Contains("Serif")) {
     pInfo->styles_ |= pdfium::kFontStyleSerif;
   }
+  return pInfo;
+}
+
+void CFX_FolderFontInfo::ReportFace(std::unique_ptr<FontFaceInfo> info) {
+  const ByteString& facename = info->face_name_;
+  if (pdfium::Contains(font_list_, facename)) {
+    return;
+  }
+
+  const uint32_t charsets = info->charsets_;
+  if (charsets & CHARSET_FLAG_SHIFTJIS) {
+    mapper_->AddInstalledFont(facename, FX_Charset::kShiftJIS);
+  }
+  if (charsets & CHARSET_FLAG_GB) {
+    mapper_->AddInstalledFont(facename, FX_Charset::kChineseSimplified);
+  }
+  if (charsets & CHARSET_FLAG_BIG5) {
+    mapper_->AddInstalledFont(facename, FX_Charset::kChineseTraditional);
+  }
+  if (charsets & CHARSET_FLAG_KOREAN) {
+    mapper_->AddInstalledFont(facename, FX_Charset::kHangul);
+  }
+  if (charsets & CHARSET_FLAG_SYMBOL) {
+    mapper_->AddInstalledFont(facename, FX_Charset::kSymbol);
+  }
+  mapper_->AddInstalledFont(facename, FX_Charset::kANSI);
+  font_list_[facename] = std::move(info);
+}
+
+void CFX_FolderFontInfo::LoadIndexCache() {
+  cached_files_.clear();
+  scanned_files_.clear();
+  std::unique_ptr<FILE, FxFileCloser> pFile(
+      fopen(index_cache_path_.c_str(), "rb"));
+  if (!pFile) {
+    return;
+  }
+
+  DataVector<uint8_t> data;
+  uint8_t chunk[4096];
+  size_t read;
+  while ((read = UNSAFE_TODO(fread(chunk, 1, sizeof(chunk), pFile.get()))) >
+         0) {
+    data.insert(data.end(), chunk, UNSAFE_TODO(chunk + read));
+  }
 
-  font_list_[facename] = std::move(pInfo);
+  // A malformed cache is ignored, and rewritten after the scan.
+  IndexCacheReader reader(data);
+  if (reader.ReadUint32() != kIndexCacheMagic ||
+      reader.ReadUint32() != kIndexCacheVersion) {
+    return;
+  }
+  std::map<ByteString, IndexedFile> files;
+  const uint32_t file_count = reader.ReadUint32();
+  for (uint32_t i = 0; i < file_count && reader.ok(); ++i) {
+    ByteString path = reader.ReadString();
+    IndexedFile indexed;
+    indexed.file_info.size = reader.ReadInt64();
+    indexed.file_info.modification_time = reader.ReadInt64();
+    const uint32_t face_count = reader.ReadUint32();
+    for (uint32_t j = 0; j < face_count && reader.ok(); ++j) {
+      ByteString face_name = reader.ReadString();
+      ByteString tables = reader.ReadString();
+      const uint32_t font_offset = reader.ReadUint32();
+      const uint32_t file_size = reader.ReadUint32();
+      auto face = std::make_unique<FontFaceInfo>(
+          path, std::move(face_name), std::move(tables), font_offset,
+          file_size);
+      face->styles_ = reader.ReadUint32();
+      face->charsets_ = reader.ReadUint32();
+      indexed.faces.push_back(std::move(face));
+    }
+    files[std::move(path)] = std::move(indexed);
+  }
+  if (reader.ok() && reader.AtEnd()) {
+    cached_files_ = std::move(files);
+  }
+}
+
+void CFX_FolderFontInfo::SaveIndexCache() const {
+  BinaryBuffer buffer;
+  buffer.AppendUint32(kIndexCacheMagic);
+  buffer.AppendUint32(kIndexCacheVersion);
+  buffer.AppendUint32(pdfium::checked_cast<uint32_t>(scanned_files_.size()));
+  for (const auto& [path, indexed] : scanned_files_) {
+    AppendSizedString(buffer, path);
+    AppendInt64(buffer, indexed.file_info.size);
+    AppendInt64(buffer, indexed.file_info.modification_time);
+    buffer.AppendUint32(pdfium::checked_cast<uint32_t>(indexed.faces.size()));
+    for (const auto& face : indexed.faces) {
+      AppendSizedString(buffer, face->face_name_);
+      AppendSizedString(buffer, face->font_tables_);
+      buffer.AppendUint32(face->font_offset_);
+      buffer.AppendUint32(face->file_size_);
+      buffer.AppendUint32(face->styles_);
+      buffer.AppendUint32(face->charsets_);
+    }
+  }
+
+  // Write to a temporary file first, so concurrent readers never see a
+  // partially written cache.
+  ByteString temp_path;
+  {
+    std::unique_ptr<FILE, FxFileCloser> pFile =
+        CreateTempFileNextTo(index_cache_path_, &temp_path);
+    if (!pFile) {
+      return;
+    }
+    pdfium::span<const uint8_t> data = buffer.GetSpan();
+    if (UNSAFE_TODO(fwrite(data.data(), 1, data.size(), pFile.get())) !=
+        data.size()) {
+      pFile.reset();
+      remove(temp_path.c_str());
+      return;
+    }
+  }
+#if BUILDFLAG(IS_WIN)
+  // Unlike POSIX rename(), the Windows one does not replace existing files.
+  remove(index_cache_path_.c_str());
+#endif
+  if (rename(temp_path.c_str(), index_cache_path_.c_str()) != 0) {
+    remove(temp_path.c_str());
+  }
 }
 
 void* CFX_FolderFontInfo::GetSubstFont(const ByteString& face) {
@@ -476,6 +748,21 @@ CFX_FolderFontInfo::FontFaceInfo::FontFaceInfo(ByteString filePath,
       font_offset_(fontOffset),
       file_size_(fileSize) {}
 
+CFX_FolderFontInfo::FontFaceInfo::FontFaceInfo(const FontFaceInfo& that) =
+    default;
+
+CFX_FolderFontInfo::FontFaceInfo::~FontFaceInfo() = default;
+
+CFX_FolderFontInfo::IndexedFile::IndexedFile() = default;
+
+CFX_FolderFontInfo::IndexedFile::IndexedFile(IndexedFile&& that) noexcept =
+    default;
+
+CFX_FolderFontInfo::IndexedFile& CFX_FolderFontInfo::IndexedFile::operator=(
+    IndexedFile&& that) noexcept = default;
+
+CFX_FolderFontInfo::IndexedFile::~IndexedFile() = default;
+
 bool CFX_FolderFontInfo::FontFaceInfo::IsEligibleForFindFont(
     uint32_t flag,
     FX_Charset charset) const {
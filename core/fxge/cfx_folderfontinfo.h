@@ -7,11 +7,14 @@
 #ifndef CORE_FXGE_CFX_FOLDERFONTINFO_H_
 #define CORE_FXGE_CFX_FOLDERFONTINFO_H_
 
+#include <stdint.h>
+
 #include <map>
 #include <memory>
 #include <vector>
 
 #include "core/fxcrt/fx_codepage_forward.h"
+#include "core/fxcrt/fx_folder.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/systemfontinfo_iface.h"
@@ -30,6 +33,11 @@ class CFX_FolderFontInfo : public SystemFontInfoIface {
 
   void AddPath(const ByteString& path);
 
+  // Enables an on-disk index of the scanned fonts at `path`. When set,
+  // EnumFontList() only parses files that are not in the index, or whose
+  // size or modification time changed, and then updates the index.
+  void SetIndexCachePath(const ByteString& path);
+
   // SystemFontInfoIface:
   void EnumFontList(CFX_FontMapper* pMapper) override;
   void* MapFont(int weight,
@@ -57,6 +65,8 @@ class CFX_FolderFontInfo : public SystemFontInfoIface {
                  ByteString fontTables,
                  uint32_t fontOffset,
                  uint32_t fileSize);
+    FontFaceInfo(const FontFaceInfo& that);
+    ~FontFaceInfo();
 
     bool IsEligibleForFindFont(uint32_t flag, FX_Charset charset) const;
     int32_t SimilarityScore(int weight,
@@ -73,12 +83,27 @@ class CFX_FolderFontInfo : public SystemFontInfoIface {
     uint32_t charsets_ = 0;
   };
 
+  // The faces found in a font file, as stored in the index cache.
+  struct IndexedFile {
+    IndexedFile();
+    IndexedFile(IndexedFile&& that) noexcept;
+    IndexedFile& operator=(IndexedFile&& that) noexcept;
+    ~IndexedFile();
+
+    FX_Folder::FileInfo file_info;
+    std::vector<std::unique_ptr<FontFaceInfo>> faces;
+  };
+
   void ScanPath(const ByteString& path);
-  void ScanFile(const ByteString& path);
-  void ReportFace(const ByteString& path,
-                  FILE* pFile,
-                  FX_FILESIZE filesize,
-                  uint32_t offset);
+  void ScanFile(const ByteString& path, const FX_Folder::FileInfo& file_info);
+  std::vector<std::unique_ptr<FontFaceInfo>> ParseFile(const ByteString& path);
+  std::unique_ptr<FontFaceInfo> ParseFace(const ByteString& path,
+                                          FILE* pFile,
+                                          FX_FILESIZE filesize,
+                                          uint32_t offset);
+  void ReportFace(std::unique_ptr<FontFaceInfo> info);
+  void LoadIndexCache();
+  void SaveIndexCache() const;
   void* GetSubstFont(const ByteString& face);
   void* FindFont(int weight,
                  bool bItalic,
@@ -90,6 +115,12 @@ class CFX_FolderFontInfo : public SystemFontInfoIface {
   std::map<ByteString, std::unique_ptr<FontFaceInfo>> font_list_;
   std::vector<ByteString> path_list_;
   UnownedPtr<CFX_FontMapper> mapper_;
+  ByteString index_cache_path_;
+  // Files from the index cache that have not been scanned yet.
+  std::map<ByteString, IndexedFile> cached_files_;
+  // Files seen by the current scan.
+  std::map<ByteString, IndexedFile> scanned_files_;
+  bool index_changed_ = false;
 };
 
 #endif  // CORE_FXGE_CFX_FOLDERFONTINFO_H_
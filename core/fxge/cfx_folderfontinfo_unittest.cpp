@@ -4,11 +4,18 @@
 
 #include "core/fxge/cfx_folderfontinfo.h"
 
+#include <stdio.h>
+
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "core/fxcrt/fx_codepage.h"
+#include "core/fxcrt/fx_folder.h"
+#include "core/fxge/cfx_fontmapper.h"
 #include "core/fxge/fx_font.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/utils/path_service.h"
 
 namespace {
 
@@ -59,6 +66,10 @@ class CFXFolderFontInfoTest : public ::testing::Test {
     return static_cast<CFX_FolderFontInfo::FontFaceInfo*>(font)->face_name_;
   }
 
+  static bool IndexChanged(const CFX_FolderFontInfo& font_info) {
+    return font_info.index_changed_;
+  }
+
  private:
   void AddDummyFont(const char* font_name, uint32_t charsets) {
     auto info = std::make_unique<CFX_FolderFontInfo::FontFaceInfo>(
@@ -142,3 +153,66 @@ TEST_F(CFXFolderFontInfoTest, TestFindFont) {
   ASSERT_TRUE(font);
   EXPECT_EQ(GetFaceName(font), kComicSansMS);
 }
+
+TEST_F(CFXFolderFontInfoTest, IndexCache) {
+  std::string test_data_dir;
+  ASSERT_TRUE(PathService::GetTestDataDir(&test_data_dir));
+  std::string cache_path;
+  ASSERT_TRUE(PathService::GetExecutableDir(&cache_path));
+  cache_path += PATH_SEPARATOR;
+  cache_path += "cfx_folderfontinfo_index_cache";
+  remove(cache_path.c_str());
+
+  const ByteString font_dir(
+      (test_data_dir + PATH_SEPARATOR + "font_tests").c_str());
+  CFX_FontMapper font_mapper(nullptr);
+  {
+    // Without an index, the font file gets parsed and the index is written.
+    CFX_FolderFontInfo folder_font_info;
+    folder_font_info.AddPath(font_dir);
+    folder_font_info.SetIndexCachePath(cache_path.c_str());
+    folder_font_info.EnumFontList(&font_mapper);
+    EXPECT_TRUE(IndexChanged(folder_font_info));
+    EXPECT_TRUE(folder_font_info.GetFont("Test"));
+  }
+  {
+    // The index got written to a temporary file and renamed into place,
+    // leaving nothing else behind.
+    std::string exe_dir;
+    ASSERT_TRUE(PathService::GetExecutableDir(&exe_dir));
+    std::unique_ptr<FX_Folder> folder =
+        FX_Folder::OpenFolder(ByteString(exe_dir.c_str()));
+    ASSERT_TRUE(folder);
+    ByteString filename;
+    bool is_folder;
+    while (folder->GetNextFile(&filename, &is_folder, nullptr)) {
+      EXPECT_FALSE(filename.First(31) == "cfx_folderfontinfo_index_cache.")
+          << filename;
+    }
+  }
+  {
+    // The second scan reports the same font from the index, without
+    // rewriting it.
+    CFX_FolderFontInfo folder_font_info;
+    folder_font_info.AddPath(font_dir);
+    folder_font_info.SetIndexCachePath(cache_path.c_str());
+    folder_font_info.EnumFontList(&font_mapper);
+    EXPECT_FALSE(IndexChanged(folder_font_info));
+    EXPECT_TRUE(folder_font_info.GetFont("Test"));
+  }
+  {
+    // A corrupt index is ignored.
+    FILE* file = fopen(cache_path.c_str(), "wb");
+    ASSERT_TRUE(file);
+    fputs("garbage", file);
+    fclose(file);
+
+    CFX_FolderFontInfo folder_font_info;
+    folder_font_info.AddPath(font_dir);
+    folder_font_info.SetIndexCachePath(cache_path.c_str());
+    folder_font_info.EnumFontList(&font_mapper);
+    EXPECT_TRUE(IndexChanged(folder_font_info));
+    EXPECT_TRUE(folder_font_info.GetFont("Test"));
+  }
+  remove(cache_path.c_str());
+}
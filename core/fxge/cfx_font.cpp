@@ -15,7 +15,6 @@
 
 #include "build/build_config.h"
 #include "core/fxcrt/check.h"
-#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_codepage.h"
 #include "core/fxcrt/fx_stream.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
@@ -247,11 +246,12 @@ bool CFX_Font::LoadEmbedded(pdfium::span<const uint8_t> src_span,
                             uint64_t object_tag) {
   vertical_ = force_vertical;
   object_tag_ = object_tag;
-  font_data_allocation_ = DataVector<uint8_t>(src_span.begin(), src_span.end());
-  face_ = CFX_GEModule::Get()->GetFontMgr()->NewFixedFace(
-      nullptr, font_data_allocation_, 0);
-  font_data_ = font_data_allocation_;
-  return !!face_;
+  face_ = CFX_GEModule::Get()->GetFontCache()->GetEmbeddedFace(src_span);
+  if (!face_) {
+    return false;
+  }
+  font_data_ = face_->GetData();
+  return true;
 }
 
 bool CFX_Font::IsTTFont() const {
@@ -14,7 +14,6 @@
 
 #include "build/build_config.h"
 #include "core/fxcrt/bytestring.h"
-#include "core/fxcrt/data_vector.h"
 #include "core/fxcrt/fx_codepage_forward.h"
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/raw_span.h"
@@ -143,7 +142,6 @@ class CFX_Font {
   mutable RetainPtr<CFX_Face> face_;
   mutable RetainPtr<CFX_GlyphCache> glyph_cache_;
   std::unique_ptr<CFX_SubstFont> subst_font_;
-  DataVector<uint8_t> font_data_allocation_;
   pdfium::raw_span<uint8_t> font_data_;
   FontType font_type_ = FontType::kUnknown;
   uint64_t object_tag_ = 0;
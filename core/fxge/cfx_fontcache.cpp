@@ -6,16 +6,86 @@
 
 #include "core/fxge/cfx_fontcache.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "core/fxcrt/bytestring.h"
+#include "core/fxcrt/fixed_size_data_vector.h"
+#include "core/fxcrt/stl_util.h"
 #include "core/fxge/cfx_font.h"
+#include "core/fxge/cfx_gemodule.h"
 #include "core/fxge/cfx_glyphcache.h"
 #include "core/fxge/fx_font.h"
 
-CFX_FontCache::CFX_FontCache() = default;
+CFX_FontCache::CFX_FontCache()
+    : CFX_FontCache(kDefaultMaxEmbeddedFaces, kDefaultMaxEmbeddedFaceBytes) {}
+
+CFX_FontCache::CFX_FontCache(size_t max_embedded_faces,
+                             size_t max_embedded_face_bytes)
+    : max_embedded_faces_(max_embedded_faces),
+      max_embedded_face_bytes_(max_embedded_face_bytes) {}
 
 CFX_FontCache::~CFX_FontCache() = default;
 
 RetainPtr<CFX_GlyphCache> CFX_FontCache::GetGlyphCache(const CFX_Font* font) {
-  RetainPtr<CFX_Face> face = font->GetFace();
+  return GetGlyphCacheForFace(font->GetFace());
+}
+
+#if defined(PDF_USE_SKIA)
+CFX_TypeFace* CFX_FontCache::GetDeviceCache(const CFX_Font* font) {
+  return GetGlyphCache(font)->GetDeviceCache(font);
+}
+#endif
+
+RetainPtr<CFX_Face> CFX_FontCache::GetEmbeddedFace(
+    pdfium::span<const uint8_t> font_data) {
+  CFX_FontMgr* font_mgr = CFX_GEModule::Get()->GetFontMgr();
+  const uint32_t hash = FX_HashCode_GetA(ByteStringView(font_data));
+  auto it = std::ranges::find_if(embedded_faces_, [&](const EmbeddedFace& e) {
+    return e.hash == hash && std::ranges::equal(e.desc->FontData(), font_data);
+  });
+  if (it != embedded_faces_.end()) {
+    ++embedded_face_stats_.hits;
+    embedded_faces_.splice(embedded_faces_.begin(), embedded_faces_, it);
+    EmbeddedFace& entry = embedded_faces_.front();
+    if (!entry.face->HasOneRef()) {
+      return font_mgr->NewFixedFace(entry.desc, entry.desc->FontData(), 0);
+    }
+    // Undo whatever the previous user of the face changed.
+    entry.face->SetCharMap(entry.initial_charmap);
+    entry.face->SetPixelSize(64, 64);
+    return entry.face;
+  }
+
+  ++embedded_face_stats_.misses;
+  auto data = FixedSizeDataVector<uint8_t>::Uninit(font_data.size());
+  fxcrt::Copy(font_data, data.span());
+  auto desc = pdfium::MakeRetain<CFX_FontMgr::FontDesc>(std::move(data));
+  RetainPtr<CFX_Face> face =
+      font_mgr->NewFixedFace(desc, desc->FontData(), /*face_index=*/0);
+  if (!face || max_embedded_faces_ == 0 ||
+      font_data.size() > max_embedded_face_bytes_) {
+    return face;
+  }
+
+  while (embedded_faces_.size() >= max_embedded_faces_ ||
+         embedded_face_bytes_ + font_data.size() > max_embedded_face_bytes_) {
+    ++embedded_face_stats_.evictions;
+    embedded_face_bytes_ -= embedded_faces_.back().desc->FontData().size();
+    embedded_faces_.pop_back();
+  }
+  embedded_face_bytes_ += font_data.size();
+  embedded_faces_.emplace_front(hash, std::move(desc), face);
+  return face;
+}
+
+void CFX_FontCache::ClearEmbeddedFaces() {
+  embedded_faces_.clear();
+  embedded_face_bytes_ = 0;
+}
+
+RetainPtr<CFX_GlyphCache> CFX_FontCache::GetGlyphCacheForFace(
+    RetainPtr<CFX_Face> face) {
   const bool bExternal = !face;
   auto& map = bExternal ? ext_glyph_cache_map_ : glyph_cache_map_;
   auto it = map.find(face.Get());
@@ -28,8 +98,16 @@ RetainPtr<CFX_GlyphCache> CFX_FontCache::GetGlyphCache(const CFX_Font* font) {
   return new_cache;
 }
 
-#if defined(PDF_USE_SKIA)
-CFX_TypeFace* CFX_FontCache::GetDeviceCache(const CFX_Font* font) {
-  return GetGlyphCache(font)->GetDeviceCache(font);
-}
-#endif
+CFX_FontCache::EmbeddedFace::EmbeddedFace(
+    uint32_t hash,
+    RetainPtr<CFX_FontMgr::FontDesc> desc,
+    RetainPtr<CFX_Face> face)
+    : hash(hash),
+      desc(std::move(desc)),
+      face(std::move(face)),
+      initial_charmap(this->face->GetCurrentCharMap()) {}
+
+CFX_FontCache::EmbeddedFace::EmbeddedFace(EmbeddedFace&& that) noexcept =
+    default;
+
+CFX_FontCache::EmbeddedFace::~EmbeddedFace() = default;
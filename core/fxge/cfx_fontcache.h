@@ -7,17 +7,36 @@
 #ifndef CORE_FXGE_CFX_FONTCACHE_H_
 #define CORE_FXGE_CFX_FONTCACHE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
 #include <map>
 
 #include "core/fxcrt/fx_system.h"
 #include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/cfx_face.h"
+#include "core/fxge/cfx_fontmgr.h"
 #include "core/fxge/cfx_glyphcache.h"
 
 class CFX_Font;
 
 class CFX_FontCache {
  public:
+  struct EmbeddedFaceStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  // Default upper bounds on the number of faces in the embedded face pool,
+  // and on the font data they keep alive.
+  static constexpr size_t kDefaultMaxEmbeddedFaces = 64;
+  static constexpr size_t kDefaultMaxEmbeddedFaceBytes = 32 * 1024 * 1024;
+
   CFX_FontCache();
+  CFX_FontCache(size_t max_embedded_faces, size_t max_embedded_face_bytes);
   ~CFX_FontCache();
 
   RetainPtr<CFX_GlyphCache> GetGlyphCache(const CFX_Font* font);
@@ -25,9 +44,45 @@ class CFX_FontCache {
   CFX_TypeFace* GetDeviceCache(const CFX_Font* font);
 #endif
 
+  // Returns a face for the embedded font program in `font_data`. Documents
+  // often embed byte-identical font programs, so faces are pooled by content,
+  // and outlive the fonts that use them. Their glyph caches do not: those go
+  // away with the last font using the face, as for any other face. A pooled
+  // face is only handed out while no other font uses it, since fonts select
+  // charmaps on their faces. Otherwise, the caller gets a new face that still
+  // shares the pooled font data.
+  RetainPtr<CFX_Face> GetEmbeddedFace(pdfium::span<const uint8_t> font_data);
+  void ClearEmbeddedFaces();
+
+  size_t embedded_face_count() const { return embedded_faces_.size(); }
+  const EmbeddedFaceStats& embedded_face_stats() const {
+    return embedded_face_stats_;
+  }
+
  private:
+  struct EmbeddedFace {
+    EmbeddedFace(uint32_t hash,
+                 RetainPtr<CFX_FontMgr::FontDesc> desc,
+                 RetainPtr<CFX_Face> face);
+    EmbeddedFace(EmbeddedFace&& that) noexcept;
+    ~EmbeddedFace();
+
+    uint32_t hash;
+    RetainPtr<CFX_FontMgr::FontDesc> desc;
+    RetainPtr<CFX_Face> face;
+    CFX_Face::CharMap initial_charmap;
+  };
+
+  RetainPtr<CFX_GlyphCache> GetGlyphCacheForFace(RetainPtr<CFX_Face> face);
+
+  const size_t max_embedded_faces_;
+  const size_t max_embedded_face_bytes_;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> glyph_cache_map_;
   std::map<CFX_Face*, ObservedPtr<CFX_GlyphCache>> ext_glyph_cache_map_;
+  // Most recently used first.
+  std::list<EmbeddedFace> embedded_faces_;
+  size_t embedded_face_bytes_ = 0;
+  EmbeddedFaceStats embedded_face_stats_;
 };
 
 #endif  // CORE_FXGE_CFX_FONTCACHE_H_
@@ -0,0 +1,118 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/cfx_fontcache.h"
+
+#include <stdint.h>
+
+#include "core/fxcrt/observed_ptr.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/cfx_face.h"
+#include "core/fxge/cfx_font.h"
+#include "core/fxge/cfx_fontmgr.h"
+#include "core/fxge/cfx_gemodule.h"
+#include "core/fxge/cfx_glyphcache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(CFXFontCacheTest, EmbeddedFaces) {
+  const pdfium::span<const uint8_t> font_data = CFX_FontMgr::GetStandardFont(0);
+  CFX_FontCache font_cache;
+
+  RetainPtr<CFX_Face> face = font_cache.GetEmbeddedFace(font_data);
+  ASSERT_TRUE(face);
+  EXPECT_EQ(0u, font_cache.embedded_face_stats().hits);
+  EXPECT_EQ(1u, font_cache.embedded_face_stats().misses);
+  EXPECT_EQ(1u, font_cache.embedded_face_count());
+
+  // While `face` is in use, another face shares its data.
+  RetainPtr<CFX_Face> other_face = font_cache.GetEmbeddedFace(font_data);
+  ASSERT_TRUE(other_face);
+  EXPECT_NE(face, other_face);
+  EXPECT_EQ(face->GetData().data(), other_face->GetData().data());
+  EXPECT_EQ(1u, font_cache.embedded_face_stats().hits);
+  EXPECT_EQ(1u, font_cache.embedded_face_count());
+
+  // Once it is no longer in use, the pooled face gets handed out again.
+  const CFX_Face* const pooled_face = face.Get();
+  face.Reset();
+  other_face.Reset();
+  face = font_cache.GetEmbeddedFace(font_data);
+  EXPECT_EQ(pooled_face, face.Get());
+  EXPECT_EQ(2u, font_cache.embedded_face_stats().hits);
+  EXPECT_EQ(1u, font_cache.embedded_face_stats().misses);
+
+  // Invalid font data does not get pooled.
+  static constexpr uint8_t kGarbage[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_FALSE(font_cache.GetEmbeddedFace(kGarbage));
+  EXPECT_EQ(1u, font_cache.embedded_face_count());
+
+  font_cache.ClearEmbeddedFaces();
+  EXPECT_EQ(0u, font_cache.embedded_face_count());
+  EXPECT_TRUE(face->GetData().data());
+}
+
+TEST(CFXFontCacheTest, EmbeddedFacesEviction) {
+  const pdfium::span<const uint8_t> font_data0 =
+      CFX_FontMgr::GetStandardFont(0);
+  const pdfium::span<const uint8_t> font_data1 =
+      CFX_FontMgr::GetStandardFont(1);
+  const pdfium::span<const uint8_t> font_data2 =
+      CFX_FontMgr::GetStandardFont(2);
+  CFX_FontCache font_cache(CFX_FontCache::kDefaultMaxEmbeddedFaces,
+                           font_data0.size() + font_data1.size() +
+                               font_data2.size() - 1);
+
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(font_data0));
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(font_data1));
+  EXPECT_EQ(2u, font_cache.embedded_face_count());
+
+  // Touch the oldest face, so the second oldest one gets evicted instead.
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(font_data0));
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(font_data2));
+  EXPECT_EQ(2u, font_cache.embedded_face_count());
+  EXPECT_EQ(1u, font_cache.embedded_face_stats().evictions);
+
+  const size_t misses = font_cache.embedded_face_stats().misses;
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(font_data0));
+  EXPECT_EQ(misses, font_cache.embedded_face_stats().misses);
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(font_data1));
+  EXPECT_EQ(misses + 1, font_cache.embedded_face_stats().misses);
+}
+
+TEST(CFXFontCacheTest, EmbeddedFacesCountLimit) {
+  CFX_FontCache font_cache(/*max_embedded_faces=*/2,
+                           CFX_FontCache::kDefaultMaxEmbeddedFaceBytes);
+
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(CFX_FontMgr::GetStandardFont(0)));
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(CFX_FontMgr::GetStandardFont(1)));
+  EXPECT_EQ(2u, font_cache.embedded_face_count());
+  EXPECT_EQ(0u, font_cache.embedded_face_stats().evictions);
+
+  EXPECT_TRUE(font_cache.GetEmbeddedFace(CFX_FontMgr::GetStandardFont(2)));
+  EXPECT_EQ(2u, font_cache.embedded_face_count());
+  EXPECT_EQ(1u, font_cache.embedded_face_stats().evictions);
+}
+
+TEST(CFXFontCacheTest, EmbeddedFacesDoNotKeepGlyphCaches) {
+  CFX_FontCache* font_cache = CFX_GEModule::Get()->GetFontCache();
+  font_cache->ClearEmbeddedFaces();
+
+  ObservedPtr<CFX_GlyphCache> glyph_cache;
+  {
+    CFX_Font font;
+    ASSERT_TRUE(font.LoadEmbedded(CFX_FontMgr::GetStandardFont(0),
+                                  /*force_vertical=*/false,
+                                  /*object_tag=*/0));
+    // Makes `font` hold on to its glyph cache.
+    font.GetGlyphWidth(/*glyph_index=*/1);
+    glyph_cache.Reset(font_cache->GetGlyphCache(&font).Get());
+    ASSERT_TRUE(glyph_cache);
+  }
+
+  // The face stays pooled, but its glyph cache went away with the font.
+  EXPECT_FALSE(glyph_cache);
+  EXPECT_EQ(1u, font_cache->embedded_face_count());
+  font_cache->ClearEmbeddedFaces();
+}
@@ -17,18 +17,21 @@ CFX_GEModule* g_pGEModule = nullptr;
 
 }  // namespace
 
-CFX_GEModule::CFX_GEModule(const char** pUserFontPaths)
+CFX_GEModule::CFX_GEModule(const char** pUserFontPaths,
+                           const char* font_index_cache_path)
     : platform_(PlatformIface::Create()),
       font_mgr_(std::make_unique<CFX_FontMgr>()),
       font_cache_(std::make_unique<CFX_FontCache>()),
-      user_font_paths_(pUserFontPaths) {}
+      user_font_paths_(pUserFontPaths),
+      font_index_cache_path_(font_index_cache_path) {}
 
 CFX_GEModule::~CFX_GEModule() = default;
 
 // static
-void CFX_GEModule::Create(const char** pUserFontPaths) {
+void CFX_GEModule::Create(const char** pUserFontPaths,
+                          const char* font_index_cache_path) {
   DCHECK(!g_pGEModule);
-  g_pGEModule = new CFX_GEModule(pUserFontPaths);
+  g_pGEModule = new CFX_GEModule(pUserFontPaths, font_index_cache_path);
   g_pGEModule->platform_->Init();
   g_pGEModule->GetFontMgr()->GetBuiltinMapper()->SetSystemFontInfo(
       g_pGEModule->platform_->CreateDefaultSystemFontInfo());
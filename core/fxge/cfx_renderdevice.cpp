@@ -9,14 +9,12 @@
 #include <math.h>
 
 #include <algorithm>
-#include <array>
 #include <memory>
 #include <utility>
 
 #include "build/build_config.h"
 #include "core/fxcrt/check.h"
 #include "core/fxcrt/check_op.h"
-#include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/span.h"
 #include "core/fxcrt/zip.h"
@@ -35,6 +33,7 @@
 #include "core/fxge/fx_font.h"
 #include "core/fxge/renderdevicedriver_iface.h"
 #include "core/fxge/text_char_pos.h"
+#include "core/fxge/text_glyph_blend.h"
 #include "core/fxge/text_glyph_pos.h"
 
 #if defined(PDF_USE_SKIA)
@@ -85,225 +84,6 @@ void AdjustGlyphSpace(std::vector<TextGlyphPos>* pGlyphAndPos) {
   }
 }
 
-constexpr std::array<const uint8_t, 256> kTextGammaAdjust = {{
-    0,   2,   3,   4,   6,   7,   8,   10,  11,  12,  13,  15,  16,  17,  18,
-    19,  21,  22,  23,  24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,
-    36,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  51,  52,
-    53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,
-    68,  69,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,
-    84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,
-    99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113,
-    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
-    129, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142,
-    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 156,
-    157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171,
-    172, 173, 174, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185,
-    186, 187, 188, 189, 190, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
-    200, 201, 202, 203, 204, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213,
-    214, 215, 216, 217, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
-    228, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 239, 240,
-    241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 250, 251, 252, 253, 254,
-    255,
-}};
-
-int TextGammaAdjust(int value) {
-  return kTextGammaAdjust[value];
-}
-
-int CalcAlpha(int src, int alpha) {
-  return src * alpha / 255;
-}
-
-void MergeGammaAdjust(uint8_t src, int channel, int alpha, uint8_t* dest) {
-  *dest =
-      FXDIB_ALPHA_MERGE(*dest, channel, CalcAlpha(TextGammaAdjust(src), alpha));
-}
-
-void MergeGammaAdjustRgb(const uint8_t* src,
-                         const FX_BGRA_STRUCT<uint8_t>& bgra,
-                         uint8_t* dest) {
-  UNSAFE_TODO({
-    MergeGammaAdjust(src[2], bgra.blue, bgra.alpha, &dest[0]);
-    MergeGammaAdjust(src[1], bgra.green, bgra.alpha, &dest[1]);
-    MergeGammaAdjust(src[0], bgra.red, bgra.alpha, &dest[2]);
-  });
-}
-
-int AverageRgb(const uint8_t* src) {
-  return UNSAFE_TODO((src[0] + src[1] + src[2]) / 3);
-}
-
-uint8_t CalculateDestAlpha(uint8_t back_alpha, int src_alpha) {
-  return back_alpha + src_alpha - back_alpha * src_alpha / 255;
-}
-
-void ApplyAlpha(pdfium::span<uint8_t, 3> dest,
-                const FX_BGRA_STRUCT<uint8_t>& bgra,
-                int alpha) {
-  dest[0] = FXDIB_ALPHA_MERGE(dest[0], bgra.blue, alpha);
-  dest[1] = FXDIB_ALPHA_MERGE(dest[1], bgra.green, alpha);
-  dest[2] = FXDIB_ALPHA_MERGE(dest[2], bgra.red, alpha);
-}
-
-void ApplyDestAlpha(uint8_t back_alpha,
-                    int src_alpha,
-                    const FX_BGRA_STRUCT<uint8_t>& bgra,
-                    pdfium::span<uint8_t, 4> dest) {
-  uint8_t dest_alpha = CalculateDestAlpha(back_alpha, src_alpha);
-  ApplyAlpha(dest.first<3u>(), bgra, src_alpha * 255 / dest_alpha);
-  dest[3] = dest_alpha;
-}
-
-void NormalizeArgb(int src_value,
-                   const FX_BGRA_STRUCT<uint8_t>& bgra,
-                   pdfium::span<uint8_t, 4> dest,
-                   int src_alpha) {
-  uint8_t back_alpha = dest[3];
-  if (back_alpha == 0) {
-    FXARGB_SetDIB(dest, ArgbEncode(src_alpha, bgra.red, bgra.green, bgra.blue));
-  } else if (src_alpha != 0) {
-    ApplyDestAlpha(back_alpha, src_alpha, bgra, dest);
-  }
-}
-
-void NormalizeDest(bool has_alpha,
-                   int src_value,
-                   const FX_BGRA_STRUCT<uint8_t>& bgra,
-                   pdfium::span<uint8_t> dest) {
-  if (has_alpha) {
-    NormalizeArgb(src_value, bgra, dest.first<4u>(),
-                  CalcAlpha(TextGammaAdjust(src_value), bgra.alpha));
-    return;
-  }
-  int src_alpha = CalcAlpha(TextGammaAdjust(src_value), bgra.alpha);
-  if (src_alpha == 0) {
-    return;
-  }
-
-  ApplyAlpha(dest.first<3u>(), bgra, src_alpha);
-}
-
-void NormalizeSrc(bool has_alpha,
-                  int src_value,
-                  const FX_BGRA_STRUCT<uint8_t>& bgra,
-                  pdfium::span<uint8_t> dest) {
-  if (!has_alpha) {
-    ApplyAlpha(dest.first<3u>(), bgra,
-               CalcAlpha(TextGammaAdjust(src_value), bgra.alpha));
-    return;
-  }
-  int src_alpha = CalcAlpha(TextGammaAdjust(src_value), bgra.alpha);
-  if (src_alpha != 0) {
-    NormalizeArgb(src_value, bgra, dest.first<4u>(), src_alpha);
-  }
-}
-
-void SetAlpha(bool has_alpha, pdfium::span<uint8_t> alpha) {
-  if (has_alpha) {
-    alpha[3] = 255;
-  }
-}
-
-void DrawNormalTextHelper(const RetainPtr<CFX_DIBitmap>& bitmap,
-                          const RetainPtr<CFX_DIBitmap>& pGlyph,
-                          int nrows,
-                          int left,
-                          int top,
-                          int start_col,
-                          int end_col,
-                          bool normalize,
-                          int x_subpixel,
-                          const FX_BGRA_STRUCT<uint8_t>& bgra) {
-  // TODO(crbug.com/42271020): Add support for `FXDIB_Format::kBgraPremul`.
-  CHECK(!bitmap->IsPremultiplied());
-  const bool has_alpha = bitmap->IsAlphaFormat();
-  const size_t bytes_per_pixel = has_alpha ? 4 : bitmap->GetBPP() / 8;
-  for (int row = 0; row < nrows; ++row) {
-    FX_SAFE_INT32 safe_dest_row = row;
-    safe_dest_row += top;
-    const int dest_row = safe_dest_row.ValueOrDefault(-1);
-    if (dest_row < 0 || dest_row >= bitmap->GetHeight()) {
-      continue;
-    }
-
-    const uint8_t* src_scan =
-        pGlyph->GetScanline(row)
-            .subspan(static_cast<size_t>((start_col - left) * 3))
-            .data();
-    auto dest_span = bitmap->GetWritableScanline(dest_row).subspan(
-        static_cast<size_t>(start_col * bytes_per_pixel));
-    if (x_subpixel == 0) {
-      for (int col = start_col; col < end_col; ++col) {
-        if (normalize) {
-          int src_value = AverageRgb(&src_scan[0]);
-          NormalizeDest(has_alpha, src_value, bgra, dest_span);
-        } else {
-          MergeGammaAdjustRgb(&src_scan[0], bgra, &dest_span[0]);
-          SetAlpha(has_alpha, dest_span);
-        }
-        UNSAFE_TODO(src_scan += 3;);
-        dest_span = dest_span.subspan(bytes_per_pixel);
-      }
-      continue;
-    }
-    UNSAFE_TODO({
-      if (x_subpixel == 1) {
-        if (normalize) {
-          int src_value = start_col > left ? AverageRgb(&src_scan[-1])
-                                           : (src_scan[0] + src_scan[1]) / 3;
-          NormalizeSrc(has_alpha, src_value, bgra, dest_span);
-        } else {
-          if (start_col > left) {
-            MergeGammaAdjust(src_scan[-1], bgra.red, bgra.alpha, &dest_span[2]);
-          }
-          MergeGammaAdjust(src_scan[0], bgra.green, bgra.alpha, &dest_span[1]);
-          MergeGammaAdjust(src_scan[1], bgra.blue, bgra.alpha, &dest_span[0]);
-          SetAlpha(has_alpha, dest_span);
-        }
-        src_scan += 3;
-        dest_span = dest_span.subspan(bytes_per_pixel);
-        for (int col = start_col + 1; col < end_col; ++col) {
-          if (normalize) {
-            int src_value = AverageRgb(&src_scan[-1]);
-            NormalizeDest(has_alpha, src_value, bgra, dest_span);
-          } else {
-            MergeGammaAdjustRgb(&src_scan[-1], bgra, &dest_span[0]);
-            SetAlpha(has_alpha, dest_span);
-          }
-          src_scan += 3;
-          dest_span = dest_span.subspan(bytes_per_pixel);
-        }
-        continue;
-      }
-      if (normalize) {
-        int src_value =
-            start_col > left ? AverageRgb(&src_scan[-2]) : src_scan[0] / 3;
-        NormalizeSrc(has_alpha, src_value, bgra, dest_span);
-      } else {
-        if (start_col > left) {
-          MergeGammaAdjust(src_scan[-2], bgra.red, bgra.alpha, &dest_span[2]);
-          MergeGammaAdjust(src_scan[-1], bgra.green, bgra.alpha, &dest_span[1]);
-        }
-        MergeGammaAdjust(src_scan[0], bgra.blue, bgra.alpha, &dest_span[0]);
-        SetAlpha(has_alpha, dest_span);
-      }
-      src_scan += 3;
-      dest_span = dest_span.subspan(bytes_per_pixel);
-      for (int col = start_col + 1; col < end_col; ++col) {
-        if (normalize) {
-          int src_value = AverageRgb(&src_scan[-2]);
-          NormalizeDest(has_alpha, src_value, bgra, dest_span);
-        } else {
-          MergeGammaAdjustRgb(&src_scan[-2], bgra, &dest_span[0]);
-          SetAlpha(has_alpha, dest_span);
-        }
-        src_scan += 3;
-        dest_span = dest_span.subspan(bytes_per_pixel);
-      }
-    });
-  }
-}
-
 bool ShouldDrawDeviceText(const CFX_Font* font,
                           const CFX_TextRenderOptions& options) {
 #if BUILDFLAG(IS_APPLE)
@@ -1241,10 +1021,11 @@ bool CFX_RenderDevice::DrawNormalText(pdfium::span<const TextCharPos> pCharPos,
     }
   }
   int dest_width = pixel_width;
-  FX_BGRA_STRUCT<uint8_t> bgra;
-  if (anti_alias == FT_RENDER_MODE_LCD) {
-    bgra = ArgbToBGRAStruct(fill_color);
-  }
+  const FX_BGRA_STRUCT<uint8_t> bgra = ArgbToBGRAStruct(fill_color);
+  const fxge::TextAlphaTable alphas =
+      anti_alias == FT_RENDER_MODE_LCD
+          ? fxge::BuildLcdTextAlphaTable(bgra.alpha)
+          : fxge::BuildGrayTextAlphaTable(bgra.alpha);
 
   for (const TextGlyphPos& glyph : glyphs) {
     if (!glyph.glyph_) {
@@ -1260,6 +1041,10 @@ bool CFX_RenderDevice::DrawNormalText(pdfium::span<const TextCharPos> pCharPos,
     int ncols = pGlyph->GetWidth();
     int nrows = pGlyph->GetHeight();
     if (anti_alias == FT_RENDER_MODE_NORMAL) {
+      if (fxge::BlendGrayGlyph(bitmap, pGlyph, point->x, point->y, bgra,
+                               alphas)) {
+        continue;
+      }
       if (!bitmap->CompositeMask(point.value().x, point.value().y, ncols, nrows,
                                  pGlyph, fill_color, 0, 0, BlendMode::kNormal,
                                  nullptr, false)) {
@@ -1281,8 +1066,8 @@ bool CFX_RenderDevice::DrawNormalText(pdfium::span<const TextCharPos> pCharPos,
       continue;
     }
 
-    DrawNormalTextHelper(bitmap, pGlyph, nrows, point->x, point->y, start_col,
-                         end_col, normalize, x_subpixel, bgra);
+    fxge::BlendLcdGlyph(bitmap, pGlyph, nrows, point->x, point->y, start_col,
+                        end_col, normalize, x_subpixel, bgra, alphas);
   }
 
   if (bitmap->IsMaskFormat()) {
@@ -1665,6 +1665,67 @@ constexpr inline int IndexFromCMYK(int c, int m, int y, int k) {
   return 9 * 9 * 9 * c + 9 * 9 * m + 9 * y + k;
 }
 
+// The grid position and interpolation weight that AdobeCMYK_to_sRGB1()
+// derives from a single component value.
+struct ComponentStep {
+  // Index of the nearest grid point.
+  int8_t index;
+  // Offset from `index` to the adjacent grid point to interpolate towards.
+  int8_t neighbor;
+  // Weight of the adjacent grid point, in AdobeCMYK_to_sRGB1()'s fixed point.
+  int16_t rate;
+};
+
+constexpr std::array<ComponentStep, 256> kComponentSteps = [] {
+  std::array<ComponentStep, 256> steps = {};
+  for (int value = 0; value < 256; ++value) {
+    const int fix = value << 8;
+    const int index = (fix + 4096) >> 13;
+    int neighbor_index = fix >> 13;
+    if (neighbor_index == index) {
+      neighbor_index =
+          neighbor_index == 8 ? neighbor_index - 1 : neighbor_index + 1;
+    }
+    steps[value].index = static_cast<int8_t>(index);
+    steps[value].neighbor = static_cast<int8_t>(neighbor_index - index);
+    steps[value].rate =
+        static_cast<int16_t>((fix - (index << 13)) * (index - neighbor_index));
+  }
+  return steps;
+}();
+
+// Same as AdobeCMYK_to_sRGB1(), but with the per-component index and weight
+// computations replaced by lookups into `kComponentSteps`.
+FX_BGR_STRUCT<uint8_t> ConvertCMYKWithSteps(
+    const FX_CMYK_STRUCT<uint8_t>& cmyk) {
+  const ComponentStep& c_step = kComponentSteps[cmyk.cyan];
+  const ComponentStep& m_step = kComponentSteps[cmyk.magenta];
+  const ComponentStep& y_step = kComponentSteps[cmyk.yellow];
+  const ComponentStep& k_step = kComponentSteps[cmyk.key];
+  const int start_index =
+      IndexFromCMYK(c_step.index, m_step.index, y_step.index, k_step.index);
+  const auto& start_rgb = kCMYK[start_index];
+  int fix_r = start_rgb.red << 8;
+  int fix_g = start_rgb.green << 8;
+  int fix_b = start_rgb.blue << 8;
+  auto interpolate = [&](int neighbor_offset, int rate) {
+    const auto& neighbor_rgb = kCMYK[start_index + neighbor_offset];
+    fix_r += (start_rgb.red - neighbor_rgb.red) * rate / 32;
+    fix_g += (start_rgb.green - neighbor_rgb.green) * rate / 32;
+    fix_b += (start_rgb.blue - neighbor_rgb.blue) * rate / 32;
+  };
+  interpolate(IndexFromCMYK(c_step.neighbor, 0, 0, 0), c_step.rate);
+  interpolate(IndexFromCMYK(0, m_step.neighbor, 0, 0), m_step.rate);
+  interpolate(IndexFromCMYK(0, 0, y_step.neighbor, 0), y_step.rate);
+  interpolate(IndexFromCMYK(0, 0, 0, k_step.neighbor), k_step.rate);
+
+  FX_BGR_STRUCT<uint8_t> result;
+  result.red = static_cast<uint8_t>(std::max(fix_r, 0) >> 8);
+  result.green = static_cast<uint8_t>(std::max(fix_g, 0) >> 8);
+  result.blue = static_cast<uint8_t>(std::max(fix_b, 0) >> 8);
+  return result;
+}
+
 }  // namespace
 
 FX_RGB_STRUCT<uint8_t> AdobeCMYK_to_sRGB1(uint8_t c,
@@ -1769,4 +1830,26 @@ FX_RGB_STRUCT<float> AdobeCMYK_to_sRGB(float c, float m, float y, float k) {
   };
 }
 
+void AdobeCMYK_to_sRGB_Line(pdfium::span<const FX_CMYK_STRUCT<uint8_t>> src,
+                            pdfium::span<FX_BGR_STRUCT<uint8_t>> dest) {
+  CHECK_GE(dest.size(), src.size());
+  if (src.empty()) {
+    return;
+  }
+
+  // Images tend to have runs of identical pixels, so skip the interpolation
+  // when a pixel matches the one before it.
+  FX_CMYK_STRUCT<uint8_t> last_cmyk = src.front();
+  FX_BGR_STRUCT<uint8_t> last_bgr = ConvertCMYKWithSteps(last_cmyk);
+  for (size_t i = 0; i < src.size(); ++i) {
+    const FX_CMYK_STRUCT<uint8_t> cmyk = src[i];
+    if (cmyk.cyan != last_cmyk.cyan || cmyk.magenta != last_cmyk.magenta ||
+        cmyk.yellow != last_cmyk.yellow || cmyk.key != last_cmyk.key) {
+      last_cmyk = cmyk;
+      last_bgr = ConvertCMYKWithSteps(cmyk);
+    }
+    dest[i] = last_bgr;
+  }
+}
+
 }  // namespace fxge
@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 
+#include "core/fxcrt/span.h"
 #include "core/fxge/dib/fx_dib.h"
 
 namespace fxge {
@@ -19,9 +20,16 @@ FX_RGB_STRUCT<uint8_t> AdobeCMYK_to_sRGB1(uint8_t c,
                                           uint8_t y,
                                           uint8_t k);
 
+// Converts a line of pixels, with the same results as calling
+// AdobeCMYK_to_sRGB1() on each of them. `dest` must be at least as large as
+// `src`.
+void AdobeCMYK_to_sRGB_Line(pdfium::span<const FX_CMYK_STRUCT<uint8_t>> src,
+                            pdfium::span<FX_BGR_STRUCT<uint8_t>> dest);
+
 }  // namespace fxge
 
 using fxge::AdobeCMYK_to_sRGB;
 using fxge::AdobeCMYK_to_sRGB1;
+using fxge::AdobeCMYK_to_sRGB_Line;
 
 #endif  // CORE_FXGE_DIB_CFX_CMYK_TO_SRGB_H_
@@ -4,6 +4,10 @@
 
 #include "core/fxge/dib/cfx_cmyk_to_srgb.h"
 
+#include <stdint.h>
+
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 
 union Float_t {
@@ -28,3 +32,40 @@ TEST(fxge, CMYKRounding) {
   // Check various other 'special' numbers.
   rgb = AdobeCMYK_to_sRGB(0.0f, 0.25f, 0.5f, 1.0f);
 }
+
+TEST(fxge, CMYKLineMatchesPixels) {
+  // Every value of each component, combined with a spread of values for the
+  // other components, and some runs of identical pixels.
+  std::vector<FX_CMYK_STRUCT<uint8_t>> src;
+  uint32_t seed = 1;
+  for (int i = 0; i < 4; ++i) {
+    for (int value = 0; value < 256; ++value) {
+      for (int j = 0; j < 64; ++j) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t components[4] = {
+            static_cast<uint8_t>(seed >> 24), static_cast<uint8_t>(seed >> 16),
+            static_cast<uint8_t>(seed >> 8), static_cast<uint8_t>(seed)};
+        components[i] = static_cast<uint8_t>(value);
+        const FX_CMYK_STRUCT<uint8_t> cmyk = {components[0], components[1],
+                                              components[2], components[3]};
+        src.push_back(cmyk);
+        if (j % 16 == 0) {
+          src.push_back(cmyk);
+          src.push_back(cmyk);
+        }
+      }
+    }
+  }
+  src.push_back({0, 0, 0, 0});
+  src.push_back({255, 255, 255, 255});
+
+  std::vector<FX_BGR_STRUCT<uint8_t>> dest(src.size());
+  AdobeCMYK_to_sRGB_Line(src, dest);
+  for (size_t i = 0; i < src.size(); ++i) {
+    const FX_RGB_STRUCT<uint8_t> expected = AdobeCMYK_to_sRGB1(
+        src[i].cyan, src[i].magenta, src[i].yellow, src[i].key);
+    ASSERT_EQ(expected.red, dest[i].red) << i;
+    ASSERT_EQ(expected.green, dest[i].green) << i;
+    ASSERT_EQ(expected.blue, dest[i].blue) << i;
+  }
+}
@@ -184,6 +184,7 @@ class CLinuxPlatform : public CFX_GEModule::PlatformIface {
       pInfo->AddPath("/usr/share/X11/fonts/TTF");
       pInfo->AddPath("/usr/local/share/fonts");
     }
+    pInfo->SetIndexCachePath(CFX_GEModule::Get()->GetFontIndexCachePath());
     return pInfo;
   }
 };
@@ -0,0 +1,336 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/text_glyph_blend.h"
+
+#include <stddef.h>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/span.h"
+#include "core/fxcrt/zip.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+
+namespace fxge {
+
+namespace {
+
+constexpr std::array<const uint8_t, 256> kTextGammaAdjust = {{
+    0,   2,   3,   4,   6,   7,   8,   10,  11,  12,  13,  15,  16,  17,  18,
+    19,  21,  22,  23,  24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,
+    36,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  51,  52,
+    53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,
+    68,  69,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,
+    84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,
+    99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113,
+    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+    129, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 156,
+    157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171,
+    172, 173, 174, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185,
+    186, 187, 188, 189, 190, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+    200, 201, 202, 203, 204, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213,
+    214, 215, 216, 217, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
+    228, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 239, 240,
+    241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 250, 251, 252, 253, 254,
+    255,
+}};
+
+uint8_t CalculateDestAlpha(uint8_t back_alpha, int src_alpha) {
+  return back_alpha + src_alpha - back_alpha * src_alpha / 255;
+}
+
+void ApplyAlpha(pdfium::span<uint8_t, 3> dest,
+                const FX_BGRA_STRUCT<uint8_t>& bgra,
+                int alpha) {
+  dest[0] = FXDIB_ALPHA_MERGE(dest[0], bgra.blue, alpha);
+  dest[1] = FXDIB_ALPHA_MERGE(dest[1], bgra.green, alpha);
+  dest[2] = FXDIB_ALPHA_MERGE(dest[2], bgra.red, alpha);
+}
+
+void ApplyDestAlpha(uint8_t back_alpha,
+                    int src_alpha,
+                    const FX_BGRA_STRUCT<uint8_t>& bgra,
+                    pdfium::span<uint8_t, 4> dest) {
+  uint8_t dest_alpha = CalculateDestAlpha(back_alpha, src_alpha);
+  ApplyAlpha(dest.first<3u>(), bgra, src_alpha * 255 / dest_alpha);
+  dest[3] = dest_alpha;
+}
+
+// Blends one pixel of LCD glyph coverage into `dest`. When normalizing, the
+// subpixel coverages get averaged into a single alpha. With `kHasAlpha`,
+// a fully transparent `dest` pixel takes on the text color, even where there
+// is no coverage, unless `keep_transparent` is set.
+template <bool kNormalize, bool kHasAlpha>
+void BlendLcdTextPixel(int red,
+                       int green,
+                       int blue,
+                       bool keep_transparent,
+                       const FX_BGRA_STRUCT<uint8_t>& bgra,
+                       const TextAlphaTable& alphas,
+                       pdfium::span<uint8_t> dest) {
+  if constexpr (kNormalize) {
+    const int src_alpha = alphas[(red + green + blue) / 3];
+    if constexpr (kHasAlpha) {
+      const uint8_t back_alpha = dest[3];
+      if (back_alpha == 0) {
+        if (src_alpha != 0 || !keep_transparent) {
+          FXARGB_SetDIB(dest.first<4u>(), ArgbEncode(src_alpha, bgra.red,
+                                                     bgra.green, bgra.blue));
+        }
+      } else if (back_alpha == 255) {
+        // Same as ApplyDestAlpha(), which leaves opaque pixels opaque.
+        ApplyAlpha(dest.first<3u>(), bgra, src_alpha);
+      } else if (src_alpha != 0) {
+        ApplyDestAlpha(back_alpha, src_alpha, bgra, dest.first<4u>());
+      }
+    } else if (src_alpha != 0) {
+      ApplyAlpha(dest.first<3u>(), bgra, src_alpha);
+    }
+  } else {
+    if (red | green | blue) {
+      dest[0] = FXDIB_ALPHA_MERGE(dest[0], bgra.blue, alphas[blue]);
+      dest[1] = FXDIB_ALPHA_MERGE(dest[1], bgra.green, alphas[green]);
+      dest[2] = FXDIB_ALPHA_MERGE(dest[2], bgra.red, alphas[red]);
+    }
+    if constexpr (kHasAlpha) {
+      dest[3] = 255;
+    }
+  }
+}
+
+// Draws the columns from `start_col` up to `end_col` of an LCD glyph, whose
+// left edge is at `left`. The glyph's subpixels are shifted right by
+// `x_subpixel`, which is 0, 1 or 2.
+template <bool kNormalize, bool kHasAlpha, size_t kBytesPerPixel>
+void DrawLcdGlyphRows(const RetainPtr<CFX_DIBitmap>& bitmap,
+                      const RetainPtr<CFX_DIBitmap>& pGlyph,
+                      int nrows,
+                      int left,
+                      int top,
+                      int start_col,
+                      int end_col,
+                      int x_subpixel,
+                      const FX_BGRA_STRUCT<uint8_t>& bgra,
+                      const TextAlphaTable& alphas) {
+  const size_t dest_offset = static_cast<size_t>(start_col) * kBytesPerPixel;
+  const size_t dest_size =
+      static_cast<size_t>(end_col - start_col) * kBytesPerPixel;
+  // Index of the first pixel's red subpixel in the glyph's scanlines. It is
+  // negative when the first pixel is partly to the left of the glyph.
+  const int first_subpixel = (start_col - left) * 3 - x_subpixel;
+  const bool keep_transparent = x_subpixel != 0;
+  for (int row = 0; row < nrows; ++row) {
+    FX_SAFE_INT32 safe_dest_row = row;
+    safe_dest_row += top;
+    const int dest_row = safe_dest_row.ValueOrDefault(-1);
+    if (dest_row < 0 || dest_row >= bitmap->GetHeight()) {
+      continue;
+    }
+
+    pdfium::span<const uint8_t> coverage = pGlyph->GetScanline(row);
+    pdfium::span<uint8_t> dest_span =
+        bitmap->GetWritableScanline(dest_row).subspan(dest_offset, dest_size);
+    BlendLcdTextPixel<kNormalize, kHasAlpha>(
+        first_subpixel >= 0 ? coverage[first_subpixel] : 0,
+        first_subpixel >= -1 ? coverage[first_subpixel + 1] : 0,
+        coverage[first_subpixel + 2], keep_transparent, bgra, alphas,
+        dest_span.first<kBytesPerPixel>());
+    dest_span = dest_span.subspan<kBytesPerPixel>();
+    pdfium::span<const uint8_t> src_span =
+        coverage.subspan(static_cast<size_t>(first_subpixel + 3));
+    while (!dest_span.empty()) {
+      BlendLcdTextPixel<kNormalize, kHasAlpha>(
+          src_span[0], src_span[1], src_span[2],
+          /*keep_transparent=*/false, bgra, alphas,
+          dest_span.first<kBytesPerPixel>());
+      src_span = src_span.subspan<3u>();
+      dest_span = dest_span.subspan<kBytesPerPixel>();
+    }
+  }
+}
+
+// Blends one pixel of gray glyph coverage into `dest`, like
+// CompositeRow_ByteMask2Rgb() and CompositeRow_ByteMask2Bgra() do for
+// BlendMode::kNormal.
+template <bool kHasAlpha>
+void BlendGrayTextPixel(int src_alpha,
+                        const FX_BGRA_STRUCT<uint8_t>& bgra,
+                        pdfium::span<uint8_t> dest) {
+  if constexpr (kHasAlpha) {
+    const uint8_t back_alpha = dest[3];
+    if (back_alpha == 0) {
+      FXARGB_SetDIB(dest.first<4u>(),
+                    ArgbEncode(src_alpha, bgra.red, bgra.green, bgra.blue));
+      return;
+    }
+  }
+  if (src_alpha == 0) {
+    return;
+  }
+  if (src_alpha == 255) {
+    // Full coverage of an opaque color replaces the pixel, and leaves it
+    // opaque.
+    dest[0] = bgra.blue;
+    dest[1] = bgra.green;
+    dest[2] = bgra.red;
+    if constexpr (kHasAlpha) {
+      dest[3] = 255;
+    }
+    return;
+  }
+  if constexpr (kHasAlpha) {
+    ApplyDestAlpha(dest[3], src_alpha, bgra, dest.first<4u>());
+  } else {
+    ApplyAlpha(dest.first<3u>(), bgra, src_alpha);
+  }
+}
+
+template <bool kHasAlpha, size_t kBytesPerPixel>
+void BlendGrayGlyphRow(pdfium::span<const uint8_t> coverage,
+                       const FX_BGRA_STRUCT<uint8_t>& bgra,
+                       const TextAlphaTable& alphas,
+                       pdfium::span<uint8_t> dest) {
+  for (uint8_t value : coverage) {
+    BlendGrayTextPixel<kHasAlpha>(alphas[value], bgra,
+                                  dest.first<kBytesPerPixel>());
+    dest = dest.subspan<kBytesPerPixel>();
+  }
+}
+
+// Same as CompositeRow_ByteMask2Mask().
+void BlendGrayGlyphMaskRow(pdfium::span<const uint8_t> coverage,
+                           const TextAlphaTable& alphas,
+                           pdfium::span<uint8_t> dest) {
+  for (auto [value, back_alpha] : fxcrt::Zip(coverage, dest)) {
+    const uint8_t src_alpha = alphas[value];
+    if (back_alpha == 0) {
+      back_alpha = src_alpha;
+    } else if (src_alpha != 0) {
+      back_alpha = CalculateDestAlpha(back_alpha, src_alpha);
+    }
+  }
+}
+
+}  // namespace
+
+TextAlphaTable BuildLcdTextAlphaTable(int alpha) {
+  TextAlphaTable table;
+  for (size_t value = 0; value < table.size(); ++value) {
+    table[value] = static_cast<uint8_t>(kTextGammaAdjust[value] * alpha / 255);
+  }
+  return table;
+}
+
+TextAlphaTable BuildGrayTextAlphaTable(int alpha) {
+  TextAlphaTable table;
+  for (size_t value = 0; value < table.size(); ++value) {
+    table[value] = static_cast<uint8_t>(value * alpha / 255);
+  }
+  return table;
+}
+
+void BlendLcdGlyph(const RetainPtr<CFX_DIBitmap>& bitmap,
+                   const RetainPtr<CFX_DIBitmap>& glyph,
+                   int nrows,
+                   int left,
+                   int top,
+                   int start_col,
+                   int end_col,
+                   bool normalize,
+                   int x_subpixel,
+                   const FX_BGRA_STRUCT<uint8_t>& bgra,
+                   const TextAlphaTable& alphas) {
+  // TODO(crbug.com/42271020): Add support for `FXDIB_Format::kBgraPremul`.
+  CHECK(!bitmap->IsPremultiplied());
+  // Negative subpixel offsets get treated like 2.
+  if (x_subpixel != 0 && x_subpixel != 1) {
+    x_subpixel = 2;
+  }
+  if (bitmap->IsAlphaFormat()) {
+    if (normalize) {
+      DrawLcdGlyphRows<true, true, 4>(bitmap, glyph, nrows, left, top,
+                                      start_col, end_col, x_subpixel, bgra,
+                                      alphas);
+    } else {
+      DrawLcdGlyphRows<false, true, 4>(bitmap, glyph, nrows, left, top,
+                                       start_col, end_col, x_subpixel, bgra,
+                                       alphas);
+    }
+    return;
+  }
+  if (bitmap->GetBPP() == 24) {
+    if (normalize) {
+      DrawLcdGlyphRows<true, false, 3>(bitmap, glyph, nrows, left, top,
+                                       start_col, end_col, x_subpixel, bgra,
+                                       alphas);
+    } else {
+      DrawLcdGlyphRows<false, false, 3>(bitmap, glyph, nrows, left, top,
+                                        start_col, end_col, x_subpixel, bgra,
+                                        alphas);
+    }
+    return;
+  }
+  CHECK_EQ(bitmap->GetBPP(), 32);
+  if (normalize) {
+    DrawLcdGlyphRows<true, false, 4>(bitmap, glyph, nrows, left, top,
+                                     start_col, end_col, x_subpixel, bgra,
+                                     alphas);
+  } else {
+    DrawLcdGlyphRows<false, false, 4>(bitmap, glyph, nrows, left, top,
+                                      start_col, end_col, x_subpixel, bgra,
+                                      alphas);
+  }
+}
+
+bool BlendGrayGlyph(const RetainPtr<CFX_DIBitmap>& bitmap,
+                    const RetainPtr<CFX_DIBitmap>& glyph,
+                    int left,
+                    int top,
+                    const FX_BGRA_STRUCT<uint8_t>& bgra,
+                    const TextAlphaTable& alphas) {
+  CHECK_EQ(glyph->GetFormat(), FXDIB_Format::k8bppMask);
+  const FXDIB_Format format = bitmap->GetFormat();
+  if (format != FXDIB_Format::k8bppMask && format != FXDIB_Format::kBgr &&
+      format != FXDIB_Format::kBgrx && format != FXDIB_Format::kBgra) {
+    return false;
+  }
+
+  int width = glyph->GetWidth();
+  int height = glyph->GetHeight();
+  int src_left = 0;
+  int src_top = 0;
+  if (!bitmap->GetOverlapRect(left, top, width, height, glyph->GetWidth(),
+                              glyph->GetHeight(), src_left, src_top,
+                              /*pClipRgn=*/nullptr)) {
+    return true;
+  }
+  if (bgra.alpha == 0) {
+    return true;
+  }
+
+  const size_t bytes_per_pixel = bitmap->GetBPP() / 8;
+  for (int row = 0; row < height; ++row) {
+    pdfium::span<const uint8_t> coverage =
+        glyph->GetScanline(src_top + row)
+            .subspan(static_cast<size_t>(src_left),
+                     static_cast<size_t>(width));
+    pdfium::span<uint8_t> dest = bitmap->GetWritableScanline(top + row).subspan(
+        static_cast<size_t>(left) * bytes_per_pixel,
+        static_cast<size_t>(width) * bytes_per_pixel);
+    if (format == FXDIB_Format::k8bppMask) {
+      BlendGrayGlyphMaskRow(coverage, alphas, dest);
+    } else if (format == FXDIB_Format::kBgr) {
+      BlendGrayGlyphRow<false, 3>(coverage, bgra, alphas, dest);
+    } else if (format == FXDIB_Format::kBgrx) {
+      BlendGrayGlyphRow<false, 4>(coverage, bgra, alphas, dest);
+    } else {
+      BlendGrayGlyphRow<true, 4>(coverage, bgra, alphas, dest);
+    }
+  }
+  return true;
+}
+
+}  // namespace fxge
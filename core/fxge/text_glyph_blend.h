@@ -0,0 +1,60 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CORE_FXGE_TEXT_GLYPH_BLEND_H_
+#define CORE_FXGE_TEXT_GLYPH_BLEND_H_
+
+#include <stdint.h>
+
+#include <array>
+
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxge/dib/fx_dib.h"
+
+class CFX_DIBitmap;
+
+namespace fxge {
+
+// Maps glyph coverage values to the alpha they get blended with, for a given
+// text color alpha.
+using TextAlphaTable = std::array<uint8_t, 256>;
+
+// LCD glyph coverage is gamma adjusted before it scales `alpha`.
+TextAlphaTable BuildLcdTextAlphaTable(int alpha);
+
+// Gray anti-aliased glyph coverage scales `alpha` linearly.
+TextAlphaTable BuildGrayTextAlphaTable(int alpha);
+
+// Blends the columns from `start_col` up to `end_col` of an LCD glyph into
+// `bitmap`, which must be kBgr, kBgrx or kBgra. The glyph has 3 coverage
+// values per pixel, its left edge is at `left`, and its subpixels are shifted
+// right by `x_subpixel`. Negative shifts get treated like 2. When
+// `normalize` is set, each pixel's coverage values get averaged into one.
+void BlendLcdGlyph(const RetainPtr<CFX_DIBitmap>& bitmap,
+                   const RetainPtr<CFX_DIBitmap>& glyph,
+                   int nrows,
+                   int left,
+                   int top,
+                   int start_col,
+                   int end_col,
+                   bool normalize,
+                   int x_subpixel,
+                   const FX_BGRA_STRUCT<uint8_t>& bgra,
+                   const TextAlphaTable& alphas);
+
+// Blends an 8bpp mask glyph into `bitmap` with its top left corner at
+// (`left`, `top`), with the same results as CFX_DIBitmap::CompositeMask()
+// using BlendMode::kNormal and no clip region. `alphas` must come from
+// BuildGrayTextAlphaTable(`bgra.alpha`). Returns false, without drawing, if
+// `bitmap` is not a k8bppMask, kBgr, kBgrx or kBgra bitmap.
+bool BlendGrayGlyph(const RetainPtr<CFX_DIBitmap>& bitmap,
+                    const RetainPtr<CFX_DIBitmap>& glyph,
+                    int left,
+                    int top,
+                    const FX_BGRA_STRUCT<uint8_t>& bgra,
+                    const TextAlphaTable& alphas);
+
+}  // namespace fxge
+
+#endif  // CORE_FXGE_TEXT_GLYPH_BLEND_H_
@@ -0,0 +1,392 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "core/fxge/text_glyph_blend.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/compiler_specific.h"
+#include "core/fxcrt/fx_random.h"
+#include "core/fxcrt/fx_safe_types.h"
+#include "core/fxcrt/retain_ptr.h"
+#include "core/fxcrt/span.h"
+#include "core/fxge/dib/cfx_dibitmap.h"
+#include "core/fxge/dib/fx_dib.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr FXDIB_Format kLcdFormats[] = {
+    FXDIB_Format::kBgr, FXDIB_Format::kBgrx, FXDIB_Format::kBgra};
+constexpr FXDIB_Format kGrayFormats[] = {
+    FXDIB_Format::k8bppMask, FXDIB_Format::kBgr, FXDIB_Format::kBgrx,
+    FXDIB_Format::kBgra};
+constexpr int kSubpixelShifts[] = {0, 1, 2, -1, -2};
+
+class Random {
+ public:
+  explicit Random(uint32_t seed) : context_(FX_Random_MT_Start(seed)) {}
+  ~Random() { FX_Random_MT_Close(context_); }
+
+  uint32_t Next() { return FX_Random_MT_Generate(context_); }
+
+  // Returns a value from 0 to `max`, with extra weight on 0 and `max`.
+  int Value(int max) {
+    switch (Next() % 4) {
+      case 0:
+        return 0;
+      case 1:
+        return max;
+      default:
+        return Next() % (max + 1);
+    }
+  }
+
+ private:
+  void* const context_;
+};
+
+RetainPtr<CFX_DIBitmap> CreateRandomBitmap(Random& random,
+                                           int width,
+                                           int height,
+                                           FXDIB_Format format) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(bitmap->Create(width, height, format));
+  for (int row = 0; row < height; ++row) {
+    for (uint8_t& value : bitmap->GetWritableScanline(row)) {
+      value = random.Value(255);
+    }
+  }
+  return bitmap;
+}
+
+RetainPtr<CFX_DIBitmap> CopyBitmap(const RetainPtr<CFX_DIBitmap>& bitmap) {
+  auto copy = pdfium::MakeRetain<CFX_DIBitmap>();
+  CHECK(copy->Copy(bitmap));
+  return copy;
+}
+
+void ExpectSameBitmaps(const RetainPtr<CFX_DIBitmap>& expected,
+                       const RetainPtr<CFX_DIBitmap>& actual) {
+  ASSERT_EQ(expected->GetHeight(), actual->GetHeight());
+  for (int row = 0; row < expected->GetHeight(); ++row) {
+    ASSERT_TRUE(std::ranges::equal(expected->GetScanline(row),
+                                   actual->GetScanline(row)))
+        << "row " << row;
+  }
+}
+
+// The LCD glyph blending from before BlendLcdGlyph() got specialized for each
+// destination format, kept here to check that the output has not changed.
+namespace reference {
+
+constexpr std::array<uint8_t, 256> kTextGammaAdjust = {{
+    0,   2,   3,   4,   6,   7,   8,   10,  11,  12,  13,  15,  16,  17,  18,
+    19,  21,  22,  23,  24,  25,  26,  27,  29,  30,  31,  32,  33,  34,  35,
+    36,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  51,  52,
+    53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,
+    68,  69,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  81,  82,  83,
+    84,  85,  86,  87,  88,  89,  90,  91,  92,  93,  94,  95,  96,  97,  98,
+    99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113,
+    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+    129, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142,
+    143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 156,
+    157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171,
+    172, 173, 174, 174, 175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185,
+    186, 187, 188, 189, 190, 190, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+    200, 201, 202, 203, 204, 204, 205, 206, 207, 208, 209, 210, 211, 212, 213,
+    214, 215, 216, 217, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
+    228, 228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239, 239, 240,
+    241, 242, 243, 244, 245, 246, 247, 248, 249, 250, 250, 251, 252, 253, 254,
+    255,
+}};
+
+int CalcAlpha(int src, int alpha) {
+  return src * alpha / 255;
+}
+
+void MergeGammaAdjust(uint8_t src, int channel, int alpha, uint8_t* dest) {
+  *dest = FXDIB_ALPHA_MERGE(*dest, channel,
+                            CalcAlpha(kTextGammaAdjust[src], alpha));
+}
+
+void MergeGammaAdjustRgb(const uint8_t* src,
+                         const FX_BGRA_STRUCT<uint8_t>& bgra,
+                         uint8_t* dest) {
+  UNSAFE_TODO({
+    MergeGammaAdjust(src[2], bgra.blue, bgra.alpha, &dest[0]);
+    MergeGammaAdjust(src[1], bgra.green, bgra.alpha, &dest[1]);
+    MergeGammaAdjust(src[0], bgra.red, bgra.alpha, &dest[2]);
+  });
+}
+
+int AverageRgb(const uint8_t* src) {
+  return UNSAFE_TODO((src[0] + src[1] + src[2]) / 3);
+}
+
+void ApplyAlpha(pdfium::span<uint8_t> dest,
+                const FX_BGRA_STRUCT<uint8_t>& bgra,
+                int alpha) {
+  dest[0] = FXDIB_ALPHA_MERGE(dest[0], bgra.blue, alpha);
+  dest[1] = FXDIB_ALPHA_MERGE(dest[1], bgra.green, alpha);
+  dest[2] = FXDIB_ALPHA_MERGE(dest[2], bgra.red, alpha);
+}
+
+void NormalizeArgb(const FX_BGRA_STRUCT<uint8_t>& bgra,
+                   pdfium::span<uint8_t> dest,
+                   int src_alpha) {
+  const uint8_t back_alpha = dest[3];
+  if (back_alpha == 0) {
+    FXARGB_SetDIB(dest.first<4u>(),
+                  ArgbEncode(src_alpha, bgra.red, bgra.green, bgra.blue));
+  } else if (src_alpha != 0) {
+    const uint8_t dest_alpha =
+        back_alpha + src_alpha - back_alpha * src_alpha / 255;
+    ApplyAlpha(dest, bgra, src_alpha * 255 / dest_alpha);
+    dest[3] = dest_alpha;
+  }
+}
+
+void NormalizeDest(bool has_alpha,
+                   int src_value,
+                   const FX_BGRA_STRUCT<uint8_t>& bgra,
+                   pdfium::span<uint8_t> dest) {
+  const int src_alpha = CalcAlpha(kTextGammaAdjust[src_value], bgra.alpha);
+  if (has_alpha) {
+    NormalizeArgb(bgra, dest, src_alpha);
+  } else if (src_alpha != 0) {
+    ApplyAlpha(dest, bgra, src_alpha);
+  }
+}
+
+void NormalizeSrc(bool has_alpha,
+                  int src_value,
+                  const FX_BGRA_STRUCT<uint8_t>& bgra,
+                  pdfium::span<uint8_t> dest) {
+  const int src_alpha = CalcAlpha(kTextGammaAdjust[src_value], bgra.alpha);
+  if (!has_alpha) {
+    ApplyAlpha(dest, bgra, src_alpha);
+  } else if (src_alpha != 0) {
+    NormalizeArgb(bgra, dest, src_alpha);
+  }
+}
+
+void SetAlpha(bool has_alpha, pdfium::span<uint8_t> dest) {
+  if (has_alpha) {
+    dest[3] = 255;
+  }
+}
+
+void BlendLcdGlyph(const RetainPtr<CFX_DIBitmap>& bitmap,
+                   const RetainPtr<CFX_DIBitmap>& glyph,
+                   int nrows,
+                   int left,
+                   int top,
+                   int start_col,
+                   int end_col,
+                   bool normalize,
+                   int x_subpixel,
+                   const FX_BGRA_STRUCT<uint8_t>& bgra) {
+  const bool has_alpha = bitmap->IsAlphaFormat();
+  const size_t bytes_per_pixel = has_alpha ? 4 : bitmap->GetBPP() / 8;
+  for (int row = 0; row < nrows; ++row) {
+    FX_SAFE_INT32 safe_dest_row = row;
+    safe_dest_row += top;
+    const int dest_row = safe_dest_row.ValueOrDefault(-1);
+    if (dest_row < 0 || dest_row >= bitmap->GetHeight()) {
+      continue;
+    }
+
+    const uint8_t* src_scan =
+        glyph->GetScanline(row)
+            .subspan(static_cast<size_t>((start_col - left) * 3))
+            .data();
+    auto dest_span = bitmap->GetWritableScanline(dest_row).subspan(
+        static_cast<size_t>(start_col * bytes_per_pixel));
+    UNSAFE_TODO({
+      if (x_subpixel == 0) {
+        for (int col = start_col; col < end_col; ++col) {
+          if (normalize) {
+            NormalizeDest(has_alpha, AverageRgb(&src_scan[0]), bgra,
+                          dest_span);
+          } else {
+            MergeGammaAdjustRgb(&src_scan[0], bgra, &dest_span[0]);
+            SetAlpha(has_alpha, dest_span);
+          }
+          src_scan += 3;
+          dest_span = dest_span.subspan(bytes_per_pixel);
+        }
+        continue;
+      }
+      if (x_subpixel == 1) {
+        if (normalize) {
+          int src_value = start_col > left ? AverageRgb(&src_scan[-1])
+                                           : (src_scan[0] + src_scan[1]) / 3;
+          NormalizeSrc(has_alpha, src_value, bgra, dest_span);
+        } else {
+          if (start_col > left) {
+            MergeGammaAdjust(src_scan[-1], bgra.red, bgra.alpha, &dest_span[2]);
+          }
+          MergeGammaAdjust(src_scan[0], bgra.green, bgra.alpha, &dest_span[1]);
+          MergeGammaAdjust(src_scan[1], bgra.blue, bgra.alpha, &dest_span[0]);
+          SetAlpha(has_alpha, dest_span);
+        }
+        src_scan += 3;
+        dest_span = dest_span.subspan(bytes_per_pixel);
+        for (int col = start_col + 1; col < end_col; ++col) {
+          if (normalize) {
+            NormalizeDest(has_alpha, AverageRgb(&src_scan[-1]), bgra,
+                          dest_span);
+          } else {
+            MergeGammaAdjustRgb(&src_scan[-1], bgra, &dest_span[0]);
+            SetAlpha(has_alpha, dest_span);
+          }
+          src_scan += 3;
+          dest_span = dest_span.subspan(bytes_per_pixel);
+        }
+        continue;
+      }
+      if (normalize) {
+        int src_value =
+            start_col > left ? AverageRgb(&src_scan[-2]) : src_scan[0] / 3;
+        NormalizeSrc(has_alpha, src_value, bgra, dest_span);
+      } else {
+        if (start_col > left) {
+          MergeGammaAdjust(src_scan[-2], bgra.red, bgra.alpha, &dest_span[2]);
+          MergeGammaAdjust(src_scan[-1], bgra.green, bgra.alpha, &dest_span[1]);
+        }
+        MergeGammaAdjust(src_scan[0], bgra.blue, bgra.alpha, &dest_span[0]);
+        SetAlpha(has_alpha, dest_span);
+      }
+      src_scan += 3;
+      dest_span = dest_span.subspan(bytes_per_pixel);
+      for (int col = start_col + 1; col < end_col; ++col) {
+        if (normalize) {
+          NormalizeDest(has_alpha, AverageRgb(&src_scan[-2]), bgra, dest_span);
+        } else {
+          MergeGammaAdjustRgb(&src_scan[-2], bgra, &dest_span[0]);
+          SetAlpha(has_alpha, dest_span);
+        }
+        src_scan += 3;
+        dest_span = dest_span.subspan(bytes_per_pixel);
+      }
+    });
+  }
+}
+
+}  // namespace reference
+
+}  // namespace
+
+TEST(TextGlyphBlend, LcdOpaqueFullCoverage) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  ASSERT_TRUE(bitmap->Create(2, 1, FXDIB_Format::kBgra));
+  bitmap->Clear(0xff00ff00);
+  auto glyph = pdfium::MakeRetain<CFX_DIBitmap>();
+  ASSERT_TRUE(glyph->Create(6, 1, FXDIB_Format::k8bppMask));
+  glyph->Clear(0xffffffff);
+
+  const FX_BGRA_STRUCT<uint8_t> bgra = ArgbToBGRAStruct(0xff102030);
+  fxge::BlendLcdGlyph(bitmap, glyph, /*nrows=*/1, /*left=*/0, /*top=*/0,
+                      /*start_col=*/0, /*end_col=*/2, /*normalize=*/false,
+                      /*x_subpixel=*/0, bgra,
+                      fxge::BuildLcdTextAlphaTable(bgra.alpha));
+  pdfium::span<const uint32_t> pixels = bitmap->GetScanlineAs<uint32_t>(0);
+  EXPECT_EQ(0xff102030, pixels[0]);
+  EXPECT_EQ(0xff102030, pixels[1]);
+}
+
+TEST(TextGlyphBlend, LcdMatchesReference) {
+  Random random(1);
+  for (FXDIB_Format format : kLcdFormats) {
+    for (bool normalize : {false, true}) {
+      for (int x_subpixel : kSubpixelShifts) {
+        for (int i = 0; i < 50; ++i) {
+          SCOPED_TRACE(testing::Message()
+                       << "format " << static_cast<int>(format)
+                       << " normalize " << normalize << " x_subpixel "
+                       << x_subpixel << " iteration " << i);
+          const int width = 1 + random.Next() % 12;
+          const int height = 1 + random.Next() % 6;
+          const int ncols = 1 + random.Next() % 8;
+          const int nrows = 1 + random.Next() % 8;
+          // Glyphs may hang over any edge of the bitmap.
+          const int left = static_cast<int>(random.Next() % (width + 4)) - 4;
+          const int top = static_cast<int>(random.Next() % (height + 4)) - 4;
+          const int start_col = std::max(left, 0);
+          const int end_col = std::min(left + ncols, width);
+          if (start_col >= end_col) {
+            continue;
+          }
+
+          RetainPtr<CFX_DIBitmap> glyph = CreateRandomBitmap(
+              random, ncols * 3, nrows, FXDIB_Format::k8bppMask);
+          RetainPtr<CFX_DIBitmap> expected =
+              CreateRandomBitmap(random, width, height, format);
+          RetainPtr<CFX_DIBitmap> actual = CopyBitmap(expected);
+          const FX_BGRA_STRUCT<uint8_t> bgra = ArgbToBGRAStruct(
+              ArgbEncode(random.Value(255), random.Next() % 256,
+                         random.Next() % 256, random.Next() % 256));
+
+          reference::BlendLcdGlyph(expected, glyph, nrows, left, top,
+                                   start_col, end_col, normalize, x_subpixel,
+                                   bgra);
+          fxge::BlendLcdGlyph(actual, glyph, nrows, left, top, start_col,
+                              end_col, normalize, x_subpixel, bgra,
+                              fxge::BuildLcdTextAlphaTable(bgra.alpha));
+          ExpectSameBitmaps(expected, actual);
+        }
+      }
+    }
+  }
+}
+
+TEST(TextGlyphBlend, GrayMatchesCompositeMask) {
+  Random random(2);
+  for (FXDIB_Format format : kGrayFormats) {
+    for (int i = 0; i < 200; ++i) {
+      SCOPED_TRACE(testing::Message() << "format " << static_cast<int>(format)
+                                      << " iteration " << i);
+      const int width = 1 + random.Next() % 12;
+      const int height = 1 + random.Next() % 6;
+      const int ncols = 1 + random.Next() % 8;
+      const int nrows = 1 + random.Next() % 8;
+      const int left = static_cast<int>(random.Next() % (width + 8)) - 8;
+      const int top = static_cast<int>(random.Next() % (height + 8)) - 8;
+
+      RetainPtr<CFX_DIBitmap> glyph =
+          CreateRandomBitmap(random, ncols, nrows, FXDIB_Format::k8bppMask);
+      RetainPtr<CFX_DIBitmap> expected =
+          CreateRandomBitmap(random, width, height, format);
+      RetainPtr<CFX_DIBitmap> actual = CopyBitmap(expected);
+      const FX_ARGB color =
+          ArgbEncode(random.Value(255), random.Next() % 256,
+                     random.Next() % 256, random.Next() % 256);
+      const FX_BGRA_STRUCT<uint8_t> bgra = ArgbToBGRAStruct(color);
+
+      ASSERT_TRUE(expected->CompositeMask(left, top, ncols, nrows, glyph,
+                                          color, 0, 0, BlendMode::kNormal,
+                                          nullptr, false));
+      ASSERT_TRUE(fxge::BlendGrayGlyph(
+          actual, glyph, left, top, bgra,
+          fxge::BuildGrayTextAlphaTable(bgra.alpha)));
+      ExpectSameBitmaps(expected, actual);
+    }
+  }
+}
+
+TEST(TextGlyphBlend, GrayUnsupportedFormat) {
+  auto bitmap = pdfium::MakeRetain<CFX_DIBitmap>();
+  ASSERT_TRUE(bitmap->Create(4, 4, FXDIB_Format::k8bppRgb));
+  auto glyph = pdfium::MakeRetain<CFX_DIBitmap>();
+  ASSERT_TRUE(glyph->Create(2, 2, FXDIB_Format::k8bppMask));
+  EXPECT_FALSE(fxge::BlendGrayGlyph(bitmap, glyph, 0, 0,
+                                    ArgbToBGRAStruct(0xff000000),
+                                    fxge::BuildGrayTextAlphaTable(255)));
+}
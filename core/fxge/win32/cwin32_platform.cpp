@@ -487,6 +487,7 @@ CWin32Platform::CreateDefaultSystemFontInfo() {
         font_info->AddPath(*user_paths);
       }
     });
+    font_info->SetIndexCachePath(CFX_GEModule::Get()->GetFontIndexCachePath());
     return font_info;
   }
 
@@ -505,6 +506,8 @@ CWin32Platform::CreateDefaultSystemFontInfo() {
     fonts_path += "\\Fonts";
     fallback_info->AddPath(fonts_path);
   }
+  fallback_info->SetIndexCachePath(
+      CFX_GEModule::Get()->GetFontIndexCachePath());
   return fallback_info;
 }
 
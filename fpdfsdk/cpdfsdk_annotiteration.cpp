@@ -15,16 +15,28 @@
 CPDFSDK_AnnotIteration CPDFSDK_AnnotIteration::CreateForDrawing(
     CPDFSDK_PageView* page_view) {
   CPDFSDK_AnnotIteration result(page_view);
-  return CPDFSDK_AnnotIteration(page_view, /*put_focused_annot_at_end=*/true);
+  return CPDFSDK_AnnotIteration(page_view, page_view->GetAnnotList(),
+                                /*put_focused_annot_at_end=*/true);
 }
 
-CPDFSDK_AnnotIteration::CPDFSDK_AnnotIteration(CPDFSDK_PageView* page_view)
-    : CPDFSDK_AnnotIteration(page_view, /*put_focused_annot_at_end=*/false) {}
+// static
+CPDFSDK_AnnotIteration CPDFSDK_AnnotIteration::CreateForPoint(
+    CPDFSDK_PageView* page_view,
+    const CFX_PointF& point) {
+  return CPDFSDK_AnnotIteration(page_view, page_view->GetAnnotsAtPoint(point),
+                                /*put_focused_annot_at_end=*/false);
+}
 
-CPDFSDK_AnnotIteration::CPDFSDK_AnnotIteration(CPDFSDK_PageView* page_view,
-                                               bool put_focused_annot_at_end) {
+CPDFSDK_AnnotIteration::CPDFSDK_AnnotIteration(CPDFSDK_PageView* page_view)
+    : CPDFSDK_AnnotIteration(page_view,
+                             page_view->GetAnnotList(),
+                             /*put_focused_annot_at_end=*/false) {}
+
+CPDFSDK_AnnotIteration::CPDFSDK_AnnotIteration(
+    CPDFSDK_PageView* page_view,
+    std::vector<CPDFSDK_Annot*> copied_list,
+    bool put_focused_annot_at_end) {
   // Copying ObservedPtrs is expensive, so do it once at the end.
-  std::vector<CPDFSDK_Annot*> copied_list = page_view->GetAnnotList();
   std::stable_sort(copied_list.begin(), copied_list.end(),
                    [](const CPDFSDK_Annot* p1, const CPDFSDK_Annot* p2) {
                      return p1->GetLayoutOrder() < p2->GetLayoutOrder();
@@ -9,6 +9,7 @@
 
 #include <vector>
 
+#include "core/fxcrt/fx_coordinates.h"
 #include "fpdfsdk/cpdfsdk_annot.h"
 
 class CPDFSDK_PageView;
@@ -20,6 +21,10 @@ class CPDFSDK_AnnotIteration {
 
   static CPDFSDK_AnnotIteration CreateForDrawing(CPDFSDK_PageView* page_view);
 
+  // Only iterates over the annotations that may be hit at `point`.
+  static CPDFSDK_AnnotIteration CreateForPoint(CPDFSDK_PageView* page_view,
+                                               const CFX_PointF& point);
+
   explicit CPDFSDK_AnnotIteration(CPDFSDK_PageView* page_view);
   CPDFSDK_AnnotIteration(const CPDFSDK_AnnotIteration&) = delete;
   CPDFSDK_AnnotIteration& operator=(const CPDFSDK_AnnotIteration&) = delete;
@@ -30,6 +35,7 @@ class CPDFSDK_AnnotIteration {
 
  private:
   CPDFSDK_AnnotIteration(CPDFSDK_PageView* page_view,
+                         std::vector<CPDFSDK_Annot*> copied_list,
                          bool put_focused_annot_at_end);
 
   std::vector<ObservedPtr<CPDFSDK_Annot>> list_;
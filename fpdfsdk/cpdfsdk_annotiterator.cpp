@@ -73,6 +73,12 @@ CPDFSDK_Annot* CPDFSDK_AnnotIterator::GetPrevAnnot(CPDFSDK_Annot* pAnnot) {
   return *(--iter);
 }
 
+bool CPDFSDK_AnnotIterator::Matches(
+    const std::vector<CPDF_Annot::Subtype>& subtypes_to_iterate) const {
+  return subtypes_ == subtypes_to_iterate &&
+         tab_order_ == GetTabOrder(page_view_);
+}
+
 void CPDFSDK_AnnotIterator::CollectAnnots(
     std::vector<UnownedPtr<CPDFSDK_Annot>>* pArray) {
   for (auto* pAnnot : page_view_->GetAnnotList()) {
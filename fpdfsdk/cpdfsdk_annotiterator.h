@@ -29,6 +29,11 @@ class CPDFSDK_AnnotIterator {
   CPDFSDK_Annot* GetNextAnnot(CPDFSDK_Annot* pAnnot);
   CPDFSDK_Annot* GetPrevAnnot(CPDFSDK_Annot* pAnnot);
 
+  // Whether the iteration order is still the one for `subtypes_to_iterate`
+  // and the page's current tab order.
+  bool Matches(
+      const std::vector<CPDF_Annot::Subtype>& subtypes_to_iterate) const;
+
  private:
   enum class TabOrder : uint8_t { kStructure = 0, kRow, kColumn };
 
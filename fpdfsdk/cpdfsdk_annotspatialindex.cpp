@@ -0,0 +1,182 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "fpdfsdk/cpdfsdk_annotspatialindex.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+
+namespace {
+
+// Keeps the grid small for pages with few annotations, and bounds its size
+// for pages with very many.
+constexpr size_t kMaxGridSize = 128;
+
+// Bounds the grid's entries to this many per rectangle on average.
+constexpr size_t kMaxEntriesPerRect = 8;
+
+bool IsFinite(const CFX_FloatRect& rect) {
+  return isfinite(rect.left) && isfinite(rect.bottom) &&
+         isfinite(rect.right) && isfinite(rect.top);
+}
+
+// Maps `offset` into [0, `count`). Monotonic, so a rectangle's first and last
+// cells bracket the cells of every point it contains.
+size_t GetCell(float offset, float cell_size, size_t count) {
+  const float cell = offset / cell_size;
+  if (!(cell > 0.0f)) {
+    return 0;
+  }
+  if (cell >= static_cast<float>(count)) {
+    return count - 1;
+  }
+  return static_cast<size_t>(cell);
+}
+
+}  // namespace
+
+CPDFSDK_AnnotSpatialIndex::CPDFSDK_AnnotSpatialIndex(
+    pdfium::span<const CFX_FloatRect> rects)
+    : rects_(rects.begin(), rects.end()) {
+  bool has_bounds = false;
+  for (CFX_FloatRect& rect : rects_) {
+    rect.Normalize();
+    if (!IsFinite(rect)) {
+      continue;
+    }
+    if (has_bounds) {
+      bounds_.Union(rect);
+    } else {
+      bounds_ = rect;
+      has_bounds = true;
+    }
+  }
+  if (!has_bounds) {
+    return;
+  }
+
+  const size_t grid_size = std::clamp<size_t>(
+      static_cast<size_t>(ceil(sqrt(static_cast<double>(rects_.size())))), 1,
+      kMaxGridSize);
+  columns_ = grid_size;
+  rows_ = grid_size;
+  cell_width_ = bounds_.Width() / columns_;
+  cell_height_ = bounds_.Height() / rows_;
+
+  // Rectangles spanning many cells, e.g. ones covering most of the page, make
+  // the number of entries grow quadratically. Past kMaxEntriesPerRect entries
+  // per rectangle on average, move the largest rectangles out of the grid into
+  // a list that every query scans.
+  std::vector<size_t> cell_counts(rects_.size());
+  size_t total_entries = 0;
+  for (size_t i = 0; i < rects_.size(); ++i) {
+    const CFX_FloatRect& rect = rects_[i];
+    if (!IsFinite(rect)) {
+      continue;
+    }
+    cell_counts[i] = (GetRow(rect.top) - GetRow(rect.bottom) + 1) *
+                     (GetColumn(rect.right) - GetColumn(rect.left) + 1);
+    total_entries += cell_counts[i];
+  }
+  const size_t max_entries = kMaxEntriesPerRect * rects_.size();
+  if (total_entries > max_entries) {
+    std::vector<size_t> by_size(rects_.size());
+    std::iota(by_size.begin(), by_size.end(), 0);
+    std::ranges::stable_sort(
+        by_size, std::greater<>{},
+        [&cell_counts](size_t i) { return cell_counts[i]; });
+    for (size_t i : by_size) {
+      if (total_entries <= max_entries) {
+        break;
+      }
+      total_entries -= cell_counts[i];
+      cell_counts[i] = 0;
+      oversized_.push_back(pdfium::checked_cast<uint32_t>(i));
+    }
+    std::ranges::sort(oversized_);
+  }
+
+  // Count the entries per cell, then fill them in, so each cell's entries end
+  // up in ascending order.
+  cell_offsets_.resize(columns_ * rows_ + 1);
+  for (size_t i = 0; i < rects_.size(); ++i) {
+    if (!cell_counts[i]) {
+      continue;
+    }
+    const CFX_FloatRect& rect = rects_[i];
+    for (size_t row = GetRow(rect.bottom); row <= GetRow(rect.top); ++row) {
+      for (size_t col = GetColumn(rect.left); col <= GetColumn(rect.right);
+           ++col) {
+        ++cell_offsets_[row * columns_ + col + 1];
+      }
+    }
+  }
+  for (size_t i = 1; i < cell_offsets_.size(); ++i) {
+    cell_offsets_[i] += cell_offsets_[i - 1];
+  }
+
+  DataVector<uint32_t> next(cell_offsets_.begin(), cell_offsets_.end() - 1);
+  cell_entries_.resize(cell_offsets_.back());
+  for (size_t i = 0; i < rects_.size(); ++i) {
+    if (!cell_counts[i]) {
+      continue;
+    }
+    const CFX_FloatRect& rect = rects_[i];
+    for (size_t row = GetRow(rect.bottom); row <= GetRow(rect.top); ++row) {
+      for (size_t col = GetColumn(rect.left); col <= GetColumn(rect.right);
+           ++col) {
+        cell_entries_[next[row * columns_ + col]++] =
+            pdfium::checked_cast<uint32_t>(i);
+      }
+    }
+  }
+}
+
+CPDFSDK_AnnotSpatialIndex::~CPDFSDK_AnnotSpatialIndex() = default;
+
+std::vector<size_t> CPDFSDK_AnnotSpatialIndex::GetRectsAtPoint(
+    const CFX_PointF& point) const {
+  std::vector<size_t> results;
+  if (cell_offsets_.empty() || !bounds_.Contains(point)) {
+    return results;
+  }
+
+  // Merge the cell's entries with the oversized rectangles, so the results
+  // stay in ascending order.
+  const size_t cell = GetRow(point.y) * columns_ + GetColumn(point.x);
+  pdfium::span<const uint32_t> entries =
+      pdfium::span(cell_entries_)
+          .subspan(cell_offsets_[cell],
+                   cell_offsets_[cell + 1] - cell_offsets_[cell]);
+  pdfium::span<const uint32_t> oversized = oversized_;
+  while (!entries.empty() || !oversized.empty()) {
+    uint32_t index;
+    if (oversized.empty() ||
+        (!entries.empty() && entries.front() < oversized.front())) {
+      index = entries.front();
+      entries = entries.subspan<1u>();
+    } else {
+      index = oversized.front();
+      oversized = oversized.subspan<1u>();
+    }
+    if (rects_[index].Contains(point)) {
+      results.push_back(index);
+    }
+  }
+  return results;
+}
+
+size_t CPDFSDK_AnnotSpatialIndex::GetColumn(float x) const {
+  return GetCell(x - bounds_.left, cell_width_, columns_);
+}
+
+size_t CPDFSDK_AnnotSpatialIndex::GetRow(float y) const {
+  return GetCell(y - bounds_.bottom, cell_height_, rows_);
+}
@@ -0,0 +1,53 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FPDFSDK_CPDFSDK_ANNOTSPATIALINDEX_H_
+#define FPDFSDK_CPDFSDK_ANNOTSPATIALINDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "core/fxcrt/data_vector.h"
+#include "core/fxcrt/fx_coordinates.h"
+#include "core/fxcrt/span.h"
+
+// Uniform grid over a page's annotation rectangles, so point queries only
+// have to look at the annotations in one grid cell instead of all of them.
+// Each rectangle gets recorded in every cell it overlaps, except for the
+// largest ones when that would take too many entries. Those get scanned on
+// every query instead.
+class CPDFSDK_AnnotSpatialIndex {
+ public:
+  explicit CPDFSDK_AnnotSpatialIndex(pdfium::span<const CFX_FloatRect> rects);
+  ~CPDFSDK_AnnotSpatialIndex();
+
+  // Returns the indices of the rectangles that contain `point`, in ascending
+  // order.
+  std::vector<size_t> GetRectsAtPoint(const CFX_PointF& point) const;
+
+  size_t columns() const { return columns_; }
+  size_t rows() const { return rows_; }
+  size_t cell_entry_count() const { return cell_entries_.size(); }
+  size_t oversized_count() const { return oversized_.size(); }
+
+ private:
+  size_t GetColumn(float x) const;
+  size_t GetRow(float y) const;
+
+  std::vector<CFX_FloatRect> rects_;
+  CFX_FloatRect bounds_;
+  size_t columns_ = 0;
+  size_t rows_ = 0;
+  float cell_width_ = 0.0f;
+  float cell_height_ = 0.0f;
+  // Cell `i` holds `cell_entries_[cell_offsets_[i]:cell_offsets_[i + 1]]`.
+  DataVector<uint32_t> cell_offsets_;
+  DataVector<uint32_t> cell_entries_;
+  // Rectangles left out of the grid, in ascending order.
+  DataVector<uint32_t> oversized_;
+};
+
+#endif  // FPDFSDK_CPDFSDK_ANNOTSPATIALINDEX_H_
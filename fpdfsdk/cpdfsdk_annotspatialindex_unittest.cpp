@@ -0,0 +1,119 @@
+// Copyright 2026 The PDFium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "fpdfsdk/cpdfsdk_annotspatialindex.h"
+
+#include <limits>
+#include <vector>
+
+#include "core/fxcrt/fx_coordinates.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(CPDFSDKAnnotSpatialIndexTest, Empty) {
+  CPDFSDK_AnnotSpatialIndex index({});
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(0, 0)), IsEmpty());
+}
+
+TEST(CPDFSDKAnnotSpatialIndexTest, Overlapping) {
+  const CFX_FloatRect rects[] = {
+      CFX_FloatRect(0, 0, 612, 792),
+      CFX_FloatRect(100, 100, 200, 120),
+      // Not normalized.
+      CFX_FloatRect(250, 150, 150, 110),
+      CFX_FloatRect(300, 700, 400, 720),
+  };
+  CPDFSDK_AnnotSpatialIndex index(rects);
+  EXPECT_EQ(2u, index.columns());
+  EXPECT_EQ(2u, index.rows());
+
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(160, 115)),
+              ElementsAre(0, 1, 2));
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(120, 110)), ElementsAre(0, 1));
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(350, 710)), ElementsAre(0, 3));
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(500, 500)), ElementsAre(0));
+
+  // Edges are inclusive, as in CFX_FloatRect::Contains().
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(612, 792)), ElementsAre(0));
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(200, 120)),
+              ElementsAre(0, 1, 2));
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(-1, 0)), IsEmpty());
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(0, 793)), IsEmpty());
+}
+
+TEST(CPDFSDKAnnotSpatialIndexTest, MatchesLinearSearch) {
+  std::vector<CFX_FloatRect> rects;
+  for (int row = 0; row < 50; ++row) {
+    for (int col = 0; col < 40; ++col) {
+      const float left = col * 15.0f;
+      const float bottom = row * 15.0f;
+      rects.emplace_back(left, bottom, left + 20.0f, bottom + 12.0f);
+    }
+  }
+  rects.emplace_back(-1000, -1000, 1000, 1000);
+  CPDFSDK_AnnotSpatialIndex index(rects);
+  EXPECT_EQ(45u, index.columns());
+  EXPECT_EQ(0u, index.oversized_count());
+
+  for (float y = -5.0f; y < 770.0f; y += 7.3f) {
+    for (float x = -5.0f; x < 620.0f; x += 8.9f) {
+      const CFX_PointF point(x, y);
+      std::vector<size_t> expected;
+      for (size_t i = 0; i < rects.size(); ++i) {
+        if (rects[i].Contains(point)) {
+          expected.push_back(i);
+        }
+      }
+      ASSERT_EQ(expected, index.GetRectsAtPoint(point));
+    }
+  }
+}
+
+TEST(CPDFSDKAnnotSpatialIndexTest, BoundsEntries) {
+  // 390 of these cover all 20 * 20 cells of the grid.
+  std::vector<CFX_FloatRect> rects;
+  for (int i = 0; i < 400; ++i) {
+    if (i % 40 == 0) {
+      rects.emplace_back(i, i, i + 10.0f, i + 10.0f);
+    } else {
+      rects.emplace_back(0, 0, 1000, 1000);
+    }
+  }
+  CPDFSDK_AnnotSpatialIndex index(rects);
+  EXPECT_EQ(20u, index.columns());
+  EXPECT_LE(index.cell_entry_count(), 8u * rects.size());
+  // Only 7 of them fit into the grid next to the small rectangles.
+  EXPECT_EQ(383u, index.oversized_count());
+
+  for (float y = -5.0f; y < 1010.0f; y += 7.3f) {
+    for (float x = -5.0f; x < 1010.0f; x += 8.9f) {
+      const CFX_PointF point(x, y);
+      std::vector<size_t> expected;
+      for (size_t i = 0; i < rects.size(); ++i) {
+        if (rects[i].Contains(point)) {
+          expected.push_back(i);
+        }
+      }
+      ASSERT_EQ(expected, index.GetRectsAtPoint(point));
+    }
+  }
+}
+
+TEST(CPDFSDKAnnotSpatialIndexTest, Degenerate) {
+  const float kInfinity = std::numeric_limits<float>::infinity();
+  const float kNaN = std::numeric_limits<float>::quiet_NaN();
+  const CFX_FloatRect rects[] = {
+      CFX_FloatRect(kNaN, 0, 10, 10),
+      CFX_FloatRect(5, 5, 5, 5),
+      CFX_FloatRect(0, 0, kInfinity, 10),
+      CFX_FloatRect(-3e38f, -3e38f, 3e38f, 3e38f),
+  };
+  CPDFSDK_AnnotSpatialIndex index(rects);
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(5, 5)), ElementsAre(1, 3));
+  EXPECT_THAT(index.GetRectsAtPoint(CFX_PointF(1e30f, 1e30f)),
+              ElementsAre(3));
+}
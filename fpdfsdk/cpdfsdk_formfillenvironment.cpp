@@ -90,6 +90,19 @@ CPDFSDK_FormFillEnvironment::~CPDFSDK_FormFillEnvironment() {
   }
 }
 
+CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch::ScopedInvalidationBatch(
+    CPDFSDK_FormFillEnvironment* env)
+    : env_(env) {
+  ++env_->invalidation_batch_depth_;
+}
+
+CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch::
+    ~ScopedInvalidationBatch() {
+  if (--env_->invalidation_batch_depth_ == 0) {
+    env_->FlushDirtyRects();
+  }
+}
+
 void CPDFSDK_FormFillEnvironment::InvalidateRect(CPDFSDK_Widget* widget,
                                                  const CFX_FloatRect& rect) {
   IPDF_Page* pPage = widget->GetPage();
@@ -366,12 +379,35 @@ IJS_Runtime* CPDFSDK_FormFillEnvironment::GetIJSRuntime() {
 
 void CPDFSDK_FormFillEnvironment::Invalidate(IPDF_Page* page,
                                              const FX_RECT& rect) {
+  if (invalidation_batch_depth_ > 0) {
+    if (CPDFSDK_PageView* page_view = GetPageView(page)) {
+      page_view->AddDirtyRect(rect);
+      return;
+    }
+  }
   if (info_ && info_->FFI_Invalidate) {
     info_->FFI_Invalidate(info_, FPDFPageFromIPDFPage(page), rect.left,
                           rect.top, rect.right, rect.bottom);
   }
 }
 
+void CPDFSDK_FormFillEnvironment::FlushDirtyRects() {
+  // Collect everything first, as the embedder may call back into PDFium from
+  // FFI_Invalidate().
+  std::vector<std::pair<RetainPtr<IPDF_Page>, std::vector<FX_RECT>>> dirty;
+  for (auto& it : page_map_) {
+    std::vector<FX_RECT> rects = it.second->TakeDirtyRects();
+    if (!rects.empty()) {
+      dirty.emplace_back(pdfium::WrapRetain(it.first), std::move(rects));
+    }
+  }
+  for (const auto& [page, rects] : dirty) {
+    for (const FX_RECT& rect : rects) {
+      Invalidate(page.Get(), rect);
+    }
+  }
+}
+
 void CPDFSDK_FormFillEnvironment::SetCursor(
     IPWL_FillerNotify::CursorStyle nCursorType) {
   if (info_ && info_->FFI_SetCursor) {
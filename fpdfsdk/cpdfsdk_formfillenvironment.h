@@ -58,6 +58,18 @@ class CPDFSDK_FormFillEnvironment final
     : public CFX_Timer::HandlerIface,
       public CFFL_InteractiveFormFiller::CallbackIface {
  public:
+  // While one of these is alive, invalidations of pages with a page view get
+  // collected and merged by that page view, and are only reported to the
+  // embedder once the outermost batch ends.
+  class ScopedInvalidationBatch {
+   public:
+    explicit ScopedInvalidationBatch(CPDFSDK_FormFillEnvironment* env);
+    ~ScopedInvalidationBatch();
+
+   private:
+    UnownedPtr<CPDFSDK_FormFillEnvironment> const env_;
+  };
+
   CPDFSDK_FormFillEnvironment(CPDF_Document* doc, FPDF_FORMFILLINFO* pFFinfo);
 
   ~CPDFSDK_FormFillEnvironment() override;
@@ -249,6 +261,7 @@ class CPDFSDK_FormFillEnvironment final
   using RunScriptCallback = std::function<void(IJS_EventContext* context)>;
 
   IPDF_Page* GetPage(int nIndex) const;
+  void FlushDirtyRects();
   void OnSetFieldInputFocusInternal(const WideString& text, bool bFocus);
   void SendOnFocusChange(ObservedPtr<CPDFSDK_Annot>& pAnnot);
 
@@ -286,6 +299,7 @@ class CPDFSDK_FormFillEnvironment final
   std::unique_ptr<CFFL_InteractiveFormFiller> interactive_form_filler_;
   bool change_mask_ = false;
   bool being_destroyed_ = false;
+  int invalidation_batch_depth_ = 0;
 
   // Holds the list of focusable annot types.
   // Annotations of type WIDGET are by default focusable.
@@ -31,6 +31,7 @@ class CPDF_Annot;
 class CPDF_AnnotContext;
 class CPDF_ClipPath;
 class CPDF_ContentMarkItem;
+class CPDF_DocTextSearch;
 class CPDF_Object;
 class CPDF_Font;
 class CPDF_LinkExtract;
@@ -236,6 +237,15 @@ inline CPDF_TextPageFind* CPDFTextPageFindFromFPDFSchHandle(
   return reinterpret_cast<CPDF_TextPageFind*>(handle);
 }
 
+inline FPDF_DOCSEARCH FPDFDocSearchFromCPDFDocTextSearch(
+    CPDF_DocTextSearch* search) {
+  return reinterpret_cast<FPDF_DOCSEARCH>(search);
+}
+inline CPDF_DocTextSearch* CPDFDocTextSearchFromFPDFDocSearch(
+    FPDF_DOCSEARCH handle) {
+  return reinterpret_cast<CPDF_DocTextSearch*>(handle);
+}
+
 inline FPDF_FORMHANDLE FPDFFormHandleFromCPDFSDKFormFillEnvironment(
     CPDFSDK_FormFillEnvironment* handle) {
   return reinterpret_cast<FPDF_FORMHANDLE>(handle);
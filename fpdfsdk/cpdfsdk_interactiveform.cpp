@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "constants/annotation_flags.h"
+#include "constants/form_fields.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/parser/cfdf_document.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
@@ -108,6 +109,42 @@ ByteString FDFToURLEncodedData(ByteString buffer) {
   return ByteString(encoded_data);
 }
 
+// FDF fields may be nested, with each level contributing part of the name,
+// the same as in the AcroForm field tree.
+void CollectFDFFieldValues(
+    const CPDF_Array* fields,
+    const WideString& parent_name,
+    int depth,
+    std::vector<std::pair<WideString, WideString>>* out) {
+  static constexpr int kMaxFDFFieldDepth = 32;
+  if (depth > kMaxFDFFieldDepth) {
+    return;
+  }
+
+  for (size_t i = 0; i < fields->size(); ++i) {
+    RetainPtr<const CPDF_Dictionary> field = fields->GetDictAt(i);
+    if (!field) {
+      continue;
+    }
+
+    WideString name = field->GetUnicodeTextFor(pdfium::form_fields::kT);
+    if (!parent_name.IsEmpty()) {
+      name = parent_name + L"." + name;
+    }
+    RetainPtr<const CPDF_Array> kids = field->GetArrayFor("Kids");
+    if (kids) {
+      CollectFDFFieldValues(kids.Get(), name, depth + 1, out);
+    }
+
+    // Strings and names are the only values a single field value can take.
+    RetainPtr<const CPDF_Object> value =
+        field->GetDirectObjectFor(pdfium::form_fields::kV);
+    if (!name.IsEmpty() && value && (value->IsString() || value->IsName())) {
+      out->emplace_back(std::move(name), value->GetUnicodeText());
+    }
+  }
+}
+
 }  // namespace
 
 CPDFSDK_InteractiveForm::CPDFSDK_InteractiveForm(
@@ -374,6 +411,90 @@ void CPDFSDK_InteractiveForm::UpdateField(CPDF_FormField* pFormField) {
   }
 }
 
+size_t CPDFSDK_InteractiveForm::SetFieldValues(
+    pdfium::span<const std::pair<WideString, WideString>> values) {
+  size_t count = 0;
+  {
+    AutoRestorer<bool> restorer(&defer_updates_);
+    defer_updates_ = true;
+    for (const auto& [name, value] : values) {
+      // An empty name would match every field.
+      if (name.IsEmpty()) {
+        continue;
+      }
+
+      const size_t field_count = interactive_form_->CountFields(name);
+      for (size_t i = 0; i < field_count; ++i) {
+        CPDF_FormField* pField = interactive_form_->GetField(i, name);
+        if (!pField || pField->GetType() == CPDF_FormField::kPushButton ||
+            pField->GetType() == CPDF_FormField::kSign) {
+          continue;
+        }
+        if (pField->SetValue(value, NotificationOption::kNotify)) {
+          ++count;
+        }
+      }
+    }
+
+    // Fields changed by calculation scripts get deferred as well, so they
+    // also only have their appearances regenerated once.
+    if (!deferred_fields_.empty()) {
+      OnCalculate(nullptr);
+    }
+  }
+
+  // Leave the updates to the outermost call when nested.
+  if (!defer_updates_) {
+    FlushDeferredUpdates();
+  }
+  return count;
+}
+
+// static
+std::optional<std::vector<std::pair<WideString, WideString>>>
+CPDFSDK_InteractiveForm::ParseFDFFieldValues(pdfium::span<const uint8_t> fdf) {
+  std::unique_ptr<CFDF_Document> pFDF = CFDF_Document::ParseMemory(fdf);
+  if (!pFDF) {
+    return std::nullopt;
+  }
+
+  RetainPtr<const CPDF_Dictionary> pMainDict =
+      pFDF->GetRoot()->GetDictFor("FDF");
+  if (!pMainDict) {
+    return std::nullopt;
+  }
+
+  std::vector<std::pair<WideString, WideString>> values;
+  RetainPtr<const CPDF_Array> pFields = pMainDict->GetArrayFor("Fields");
+  if (pFields) {
+    CollectFDFFieldValues(pFields.Get(), WideString(), 0, &values);
+  }
+  return values;
+}
+
+void CPDFSDK_InteractiveForm::DeferUpdate(CPDF_FormField* pField) {
+  if (deferred_field_set_.emplace(pField).second) {
+    deferred_fields_.emplace_back(pField);
+  }
+}
+
+void CPDFSDK_InteractiveForm::FlushDeferredUpdates() {
+  std::vector<UnownedPtr<CPDF_FormField>> fields =
+      std::exchange(deferred_fields_, {});
+  deferred_field_set_.clear();
+  for (const auto& pField : fields) {
+    // Same as what the After*Change() notifications do when not deferred,
+    // minus the calculation, which already ran.
+    const FormFieldType fieldType = pField->GetFieldType();
+    if (IsFormFieldTypeComboOrText(fieldType)) {
+      ResetFieldAppearance(pField, OnFormat(pField));
+    } else if (fieldType == FormFieldType::kListBox) {
+      ResetFieldAppearance(pField, std::nullopt);
+    }
+    UpdateField(pField);
+  }
+}
+
 bool CPDFSDK_InteractiveForm::OnKeyStrokeCommit(CPDF_FormField* pFormField,
                                                 const WideString& csValue) {
   CPDF_AAction aAction = pFormField->GetAdditionalAction();
@@ -581,6 +702,11 @@ void CPDFSDK_InteractiveForm::AfterValueChange(CPDF_FormField* pField) {
     return;
   }
 
+  if (defer_updates_) {
+    DeferUpdate(pField);
+    return;
+  }
+
   OnCalculate(pField);
   ResetFieldAppearance(pField, OnFormat(pField));
   UpdateField(pField);
@@ -602,6 +728,11 @@ void CPDFSDK_InteractiveForm::AfterSelectionChange(CPDF_FormField* pField) {
     return;
   }
 
+  if (defer_updates_) {
+    DeferUpdate(pField);
+    return;
+  }
+
   OnCalculate(pField);
   ResetFieldAppearance(pField, std::nullopt);
   UpdateField(pField);
@@ -614,6 +745,11 @@ void CPDFSDK_InteractiveForm::AfterCheckedStatusChange(CPDF_FormField* pField) {
     return;
   }
 
+  if (defer_updates_) {
+    DeferUpdate(pField);
+    return;
+  }
+
   OnCalculate(pField);
   UpdateField(pField);
 }
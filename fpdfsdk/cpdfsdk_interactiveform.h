@@ -12,10 +12,13 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "core/fpdfdoc/cpdf_action.h"
 #include "core/fpdfdoc/cpdf_interactiveform.h"
+#include "core/fxcrt/span.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "core/fxge/dib/fx_dib.h"
 #include "fpdfsdk/cpdfsdk_widget.h"
@@ -65,6 +68,18 @@ class CPDFSDK_InteractiveForm final
                             std::optional<WideString> sValue);
   void UpdateField(CPDF_FormField* pFormField);
 
+  // Sets the values of the fields with the given full names. Calculation runs
+  // once after all the values are set, and each changed field gets its
+  // appearance regenerated once, rather than both happening after every
+  // field. Returns the number of fields whose values were set.
+  size_t SetFieldValues(
+      pdfium::span<const std::pair<WideString, WideString>> values);
+
+  // Returns the full names and values of the fields in the FDF data `fdf`, in
+  // a form SetFieldValues() takes, or std::nullopt if `fdf` is not valid FDF.
+  static std::optional<std::vector<std::pair<WideString, WideString>>>
+  ParseFDFFieldValues(pdfium::span<const uint8_t> fdf);
+
   bool DoAction_Hide(const CPDF_Action& action);
   bool DoAction_SubmitForm(const CPDF_Action& action);
   void DoAction_ResetForm(const CPDF_Action& action);
@@ -103,6 +118,9 @@ class CPDFSDK_InteractiveForm final
   int GetPageIndexByAnnotDict(CPDF_Document* document,
                               const CPDF_Dictionary* pAnnotDict) const;
 
+  void DeferUpdate(CPDF_FormField* pField);
+  void FlushDeferredUpdates();
+
   UnownedPtr<CPDFSDK_FormFillEnvironment> const form_fill_env_;
   std::unique_ptr<CPDF_InteractiveForm> const interactive_form_;
   std::map<UnownedPtr<const CPDF_FormControl>,
@@ -113,8 +131,13 @@ class CPDFSDK_InteractiveForm final
   bool xfa_calculate_ = true;
   bool xfa_validations_enabled_ = true;
 #endif  // PDF_ENABLE_XFA
+  // Fields changed while `defer_updates_` is set, in the order they first
+  // changed.
+  std::vector<UnownedPtr<CPDF_FormField>> deferred_fields_;
+  std::set<UnownedPtr<CPDF_FormField>, std::less<>> deferred_field_set_;
   bool calculate_ = true;
   bool busy_ = false;
+  bool defer_updates_ = false;
   uint8_t highlight_alpha_ = 0;
   std::array<FX_COLORREF, kFormFieldTypeCount> highlight_color_;
   std::array<bool, kFormFieldTypeCount> needs_highlight_;
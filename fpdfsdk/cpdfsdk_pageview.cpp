@@ -6,6 +6,7 @@
 
 #include "fpdfsdk/cpdfsdk_pageview.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -17,10 +18,12 @@
 #include "core/fpdfdoc/cpdf_interactiveform.h"
 #include "core/fxcrt/autorestorer.h"
 #include "core/fxcrt/check.h"
+#include "core/fxcrt/containers/contains.h"
 #include "core/fxcrt/containers/unique_ptr_adapters.h"
 #include "fpdfsdk/cpdfsdk_annot.h"
 #include "fpdfsdk/cpdfsdk_annotiteration.h"
 #include "fpdfsdk/cpdfsdk_annotiterator.h"
+#include "fpdfsdk/cpdfsdk_annotspatialindex.h"
 #include "fpdfsdk/cpdfsdk_formfillenvironment.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
 #include "fpdfsdk/cpdfsdk_interactiveform.h"
@@ -31,6 +34,41 @@
 #include "xfa/fxfa/cxfa_ffpageview.h"
 #endif  // PDF_ENABLE_XFA
 
+namespace {
+
+// View bounding boxes get inflated by a point and rounded outwards, so the
+// spatial index uses slightly larger rects than the annotations.
+constexpr float kAnnotIndexSlop = 2.0f;
+
+// Beyond this, the dirty rects get collapsed into their bounding box, which
+// is cheaper for embedders than many small repaints.
+constexpr size_t kMaxDirtyRects = 16;
+
+// Adjacent rects count as touching, so abutting widgets merge.
+bool RectsTouch(const FX_RECT& a, const FX_RECT& b) {
+  return a.left <= b.right && b.left <= a.right && a.top <= b.bottom &&
+         b.top <= a.bottom;
+}
+
+FX_RECT UnionRects(const FX_RECT& a, const FX_RECT& b) {
+  return FX_RECT(std::min(a.left, b.left), std::min(a.top, b.top),
+                 std::max(a.right, b.right), std::max(a.bottom, b.bottom));
+}
+
+bool IntersectsClip(const CFX_FloatRect& view_bbox,
+                    const CFX_Matrix& user_to_device,
+                    const FX_RECT& clip) {
+  // Leave a couple of pixels for focus rects and anti-aliasing along the
+  // edges.
+  CFX_FloatRect device_rect = user_to_device.TransformRect(view_bbox);
+  device_rect.Inflate(2.0f, 2.0f);
+  FX_RECT rect = device_rect.GetOuterRect();
+  rect.Intersect(clip);
+  return !rect.IsEmpty();
+}
+
+}  // namespace
+
 CPDFSDK_PageView::CPDFSDK_PageView(CPDFSDK_FormFillEnvironment* pFormFillEnv,
                                    IPDF_Page* page)
     : page_(page), form_fill_env_(pFormFillEnv) {
@@ -55,6 +93,8 @@ CPDFSDK_PageView::~CPDFSDK_PageView() {
     page_->AsPDFPage()->SetView(nullptr);
   }
 
+  OnAnnotRectsChanged();
+
   // Manually reset elements to ensure they are deleted in order.
   for (std::unique_ptr<CPDFSDK_Annot>& pAnnot : sdkannot_array_) {
     pAnnot.reset();
@@ -70,6 +110,11 @@ void CPDFSDK_PageView::ClearPage(CPDF_Page* pPage) {
   }
 }
 
+void CPDFSDK_PageView::OnAnnotRectsChanged() {
+  annot_index_.reset();
+  focusable_annot_iterator_.reset();
+}
+
 void CPDFSDK_PageView::PageView_OnDraw(CFX_RenderDevice* pDevice,
                                        const CFX_Matrix& mtUser2Device,
                                        CPDF_RenderOptions* pOptions,
@@ -88,8 +133,13 @@ void CPDFSDK_PageView::PageView_OnDraw(CFX_RenderDevice* pDevice,
 #endif  // PDF_ENABLE_XFA
 
   // for pdf/static xfa.
+  CPDFSDK_Annot* focus_annot = GetFocusAnnot();
   auto annot_iteration = CPDFSDK_AnnotIteration::CreateForDrawing(this);
   for (const auto& pSDKAnnot : annot_iteration) {
+    if (pSDKAnnot.Get() != focus_annot &&
+        !IntersectsClip(pSDKAnnot->GetViewBBox(), mtUser2Device, pClip)) {
+      continue;
+    }
     pSDKAnnot->OnDraw(pDevice, mtUser2Device, pOptions->GetDrawAnnots());
   }
 }
@@ -123,7 +173,7 @@ std::unique_ptr<CPDFSDK_Annot> CPDFSDK_PageView::NewAnnot(CPDF_Annot* annot) {
 }
 
 CPDFSDK_Annot* CPDFSDK_PageView::GetFXAnnotAtPoint(const CFX_PointF& point) {
-  CPDFSDK_AnnotIteration annot_iteration(this);
+  auto annot_iteration = CPDFSDK_AnnotIteration::CreateForPoint(this, point);
   for (const auto& pSDKAnnot : annot_iteration) {
     CFX_FloatRect rc = pSDKAnnot->GetViewBBox();
     if (pSDKAnnot->GetAnnotSubtype() == CPDF_Annot::Subtype::POPUP) {
@@ -137,7 +187,7 @@ CPDFSDK_Annot* CPDFSDK_PageView::GetFXAnnotAtPoint(const CFX_PointF& point) {
 }
 
 CPDFSDK_Annot* CPDFSDK_PageView::GetFXWidgetAtPoint(const CFX_PointF& point) {
-  CPDFSDK_AnnotIteration annot_iteration(this);
+  auto annot_iteration = CPDFSDK_AnnotIteration::CreateForPoint(this, point);
   for (const auto& pSDKAnnot : annot_iteration) {
     const CPDF_Annot::Subtype sub_type = pSDKAnnot->GetAnnotSubtype();
     bool do_hit_test = sub_type == CPDF_Annot::Subtype::WIDGET;
@@ -158,6 +208,7 @@ CPDFSDK_Annot* CPDFSDK_PageView::AddAnnotForFFWidget(CXFA_FFWidget* pWidget) {
     return pSDKAnnot;
   }
 
+  OnAnnotRectsChanged();
   sdkannot_array_.push_back(std::make_unique<CPDFXFA_Widget>(pWidget, this));
   return sdkannot_array_.back().get();
 }
@@ -183,6 +234,7 @@ void CPDFSDK_PageView::DeleteAnnotForFFWidget(CXFA_FFWidget* pWidget) {
     auto it = std::ranges::find_if(sdkannot_array_,
                                    pdfium::MatchesUniquePtr(pAnnot.Get()));
     if (it != sdkannot_array_.end()) {
+      OnAnnotRectsChanged();
       sdkannot_array_.erase(it);
     }
   }
@@ -218,6 +270,40 @@ std::vector<CPDFSDK_Annot*> CPDFSDK_PageView::GetAnnotList() const {
   return list;
 }
 
+std::vector<CPDFSDK_Annot*> CPDFSDK_PageView::GetAnnotsAtPoint(
+    const CFX_PointF& point) {
+  // XFA widgets move around without notifying the page view, so do not index
+  // them.
+  if (page_->AsXFAPage()) {
+    return GetAnnotList();
+  }
+
+  if (!annot_index_) {
+    std::vector<CFX_FloatRect> rects;
+    rects.reserve(sdkannot_array_.size());
+    for (const std::unique_ptr<CPDFSDK_Annot>& pAnnot : sdkannot_array_) {
+      CFX_FloatRect rect = pAnnot->GetRect();
+      rect.Normalize();
+      rect.Inflate(kAnnotIndexSlop, kAnnotIndexSlop);
+      rects.push_back(rect);
+    }
+    annot_index_ = std::make_unique<CPDFSDK_AnnotSpatialIndex>(rects);
+  }
+
+  std::vector<CPDFSDK_Annot*> annots;
+  for (size_t index : annot_index_->GetRectsAtPoint(point)) {
+    annots.push_back(sdkannot_array_[index].get());
+  }
+
+  // The focused annotation's view bounding box may extend beyond its rect,
+  // e.g. for an open combo box.
+  CPDFSDK_Annot* pFocusAnnot = GetFocusAnnot();
+  if (pFocusAnnot && !pdfium::Contains(annots, pFocusAnnot)) {
+    annots.push_back(pFocusAnnot);
+  }
+  return annots;
+}
+
 CPDFSDK_Annot* CPDFSDK_PageView::GetAnnotByDict(const CPDF_Dictionary* dict) {
   for (std::unique_ptr<CPDFSDK_Annot>& pAnnot : sdkannot_array_) {
     CPDF_Annot* pPDFAnnot = pAnnot->GetPDFAnnot();
@@ -260,8 +346,7 @@ CPDFSDK_Annot* CPDFSDK_PageView::GetNextAnnot(CPDFSDK_Annot* pAnnot) {
     return pXFAPage->GetNextXFAAnnot(pAnnot);
   }
 #endif  // PDF_ENABLE_XFA
-  CPDFSDK_AnnotIterator ai(this, GetFormFillEnv()->GetFocusableAnnotSubtypes());
-  return ai.GetNextAnnot(pAnnot);
+  return GetFocusableAnnotIterator()->GetNextAnnot(pAnnot);
 }
 
 CPDFSDK_Annot* CPDFSDK_PageView::GetPrevAnnot(CPDFSDK_Annot* pAnnot) {
@@ -271,8 +356,7 @@ CPDFSDK_Annot* CPDFSDK_PageView::GetPrevAnnot(CPDFSDK_Annot* pAnnot) {
     return pXFAPage->GetPrevXFAAnnot(pAnnot);
   }
 #endif  // PDF_ENABLE_XFA
-  CPDFSDK_AnnotIterator ai(this, GetFormFillEnv()->GetFocusableAnnotSubtypes());
-  return ai.GetPrevAnnot(pAnnot);
+  return GetFocusableAnnotIterator()->GetPrevAnnot(pAnnot);
 }
 
 CPDFSDK_Annot* CPDFSDK_PageView::GetFirstFocusableAnnot() {
@@ -282,8 +366,7 @@ CPDFSDK_Annot* CPDFSDK_PageView::GetFirstFocusableAnnot() {
     return pXFAPage->GetFirstXFAAnnot(this);
   }
 #endif  // PDF_ENABLE_XFA
-  CPDFSDK_AnnotIterator ai(this, GetFormFillEnv()->GetFocusableAnnotSubtypes());
-  return ai.GetFirstAnnot();
+  return GetFocusableAnnotIterator()->GetFirstAnnot();
 }
 
 CPDFSDK_Annot* CPDFSDK_PageView::GetLastFocusableAnnot() {
@@ -293,8 +376,20 @@ CPDFSDK_Annot* CPDFSDK_PageView::GetLastFocusableAnnot() {
     return pXFAPage->GetLastXFAAnnot(this);
   }
 #endif  // PDF_ENABLE_XFA
-  CPDFSDK_AnnotIterator ai(this, GetFormFillEnv()->GetFocusableAnnotSubtypes());
-  return ai.GetLastAnnot();
+  return GetFocusableAnnotIterator()->GetLastAnnot();
+}
+
+CPDFSDK_AnnotIterator* CPDFSDK_PageView::GetFocusableAnnotIterator() {
+  const std::vector<CPDF_Annot::Subtype>& subtypes =
+      GetFormFillEnv()->GetFocusableAnnotSubtypes();
+  // Computing the tab order is quadratic for row and column orders, so keep
+  // it around. XFA widgets move without notice, so those pages do not.
+  if (!focusable_annot_iterator_ || page_->AsXFAPage() ||
+      !focusable_annot_iterator_->Matches(subtypes)) {
+    focusable_annot_iterator_ =
+        std::make_unique<CPDFSDK_AnnotIterator>(this, subtypes);
+  }
+  return focusable_annot_iterator_.get();
 }
 
 WideString CPDFSDK_PageView::GetSelectedText() {
@@ -572,6 +667,7 @@ bool CPDFSDK_PageView::OnKeyDown(FWL_VKEYCODE key_code,
 void CPDFSDK_PageView::LoadFXAnnots() {
   AutoRestorer<bool> lock(&locked_);
   locked_ = true;
+  OnAnnotRectsChanged();
 
 #ifdef PDF_ENABLE_XFA
   RetainPtr<CPDFXFA_Page> protector(ToXFAPage(page_));
@@ -623,6 +719,36 @@ void CPDFSDK_PageView::UpdateView(CPDFSDK_Annot* pAnnot) {
   form_fill_env_->Invalidate(page_, rcWindow.GetOuterRect());
 }
 
+void CPDFSDK_PageView::AddDirtyRect(const FX_RECT& rect) {
+  FX_RECT merged = rect;
+  // Each merge can grow `merged` into rects it did not overlap before, so
+  // keep going until nothing overlaps.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = dirty_rects_.begin(); it != dirty_rects_.end(); ++it) {
+      if (RectsTouch(*it, merged)) {
+        merged = UnionRects(*it, merged);
+        dirty_rects_.erase(it);
+        changed = true;
+        break;
+      }
+    }
+  }
+  dirty_rects_.push_back(merged);
+  if (dirty_rects_.size() > kMaxDirtyRects) {
+    FX_RECT bounds = dirty_rects_.front();
+    for (const FX_RECT& dirty : dirty_rects_) {
+      bounds = UnionRects(bounds, dirty);
+    }
+    dirty_rects_ = {bounds};
+  }
+}
+
+std::vector<FX_RECT> CPDFSDK_PageView::TakeDirtyRects() {
+  return std::exchange(dirty_rects_, {});
+}
+
 int CPDFSDK_PageView::GetPageIndex() const {
 #ifdef PDF_ENABLE_XFA
   CPDF_Document::Extension* context = page_->GetDocument()->GetExtension();
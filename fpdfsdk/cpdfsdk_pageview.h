@@ -20,6 +20,8 @@
 class CFX_RenderDevice;
 class CPDF_AnnotList;
 class CPDF_RenderOptions;
+class CPDFSDK_AnnotIterator;
+class CPDFSDK_AnnotSpatialIndex;
 class CPDFSDK_FormFillEnvironment;
 class CPDFSDK_InteractiveForm;
 
@@ -35,6 +37,7 @@ class CPDFSDK_PageView final : public CPDF_Page::View {
 
   // CPDF_Page::View:
   void ClearPage(CPDF_Page* pPage) override;
+  void OnAnnotRectsChanged() override;
 
   void PageView_OnDraw(CFX_RenderDevice* pDevice,
                        const CFX_Matrix& mtUser2Device,
@@ -51,6 +54,10 @@ class CPDFSDK_PageView final : public CPDF_Page::View {
   bool IsValidSDKAnnot(const CPDFSDK_Annot* p) const;
 
   std::vector<CPDFSDK_Annot*> GetAnnotList() const;
+
+  // Returns the annotations whose view bounding boxes may contain `point`, in
+  // the same order as GetAnnotList(). Always includes the focused annotation.
+  std::vector<CPDFSDK_Annot*> GetAnnotsAtPoint(const CFX_PointF& point);
   CPDFSDK_Annot* GetAnnotByDict(const CPDF_Dictionary* dict);
 
 #ifdef PDF_ENABLE_XFA
@@ -95,6 +102,12 @@ class CPDFSDK_PageView final : public CPDF_Page::View {
   void UpdateRects(const std::vector<CFX_FloatRect>& rects);
   void UpdateView(CPDFSDK_Annot* pAnnot);
 
+  // Records `rect`, in page coordinates, as needing a redraw. Merges it with
+  // the dirty rects it overlaps, so a run of edits to one widget collapses
+  // into a single region.
+  void AddDirtyRect(const FX_RECT& rect);
+  std::vector<FX_RECT> TakeDirtyRects();
+
   int GetPageIndex() const;
 
   void SetValid(bool bValid) { valid_ = bValid; }
@@ -109,6 +122,7 @@ class CPDFSDK_PageView final : public CPDF_Page::View {
 #endif
 
   std::unique_ptr<CPDFSDK_Annot> NewAnnot(CPDF_Annot* annot);
+  CPDFSDK_AnnotIterator* GetFocusableAnnotIterator();
 
   CPDFSDK_InteractiveForm* GetInteractiveForm() const;
   CPDFSDK_Annot* GetFXAnnotAtPoint(const CFX_PointF& point);
@@ -124,6 +138,11 @@ class CPDFSDK_PageView final : public CPDF_Page::View {
   UnownedPtr<IPDF_Page> const page_;
   std::unique_ptr<CPDF_AnnotList> annot_list_;
   std::vector<std::unique_ptr<CPDFSDK_Annot>> sdkannot_array_;
+  // Both are built on demand from `sdkannot_array_`, and dropped whenever it
+  // changes or an annotation moves.
+  std::unique_ptr<CPDFSDK_AnnotSpatialIndex> annot_index_;
+  std::unique_ptr<CPDFSDK_AnnotIterator> focusable_annot_iterator_;
+  std::vector<FX_RECT> dirty_rects_;
   UnownedPtr<CPDFSDK_FormFillEnvironment> const form_fill_env_;
   ObservedPtr<CPDFSDK_Annot> capture_widget_;
   bool on_widget_ = false;
@@ -417,6 +417,7 @@ void CPDFSDK_Widget::SetRect(const CFX_FloatRect& rect) {
   DCHECK(rect.right - rect.left >= 1.0f);
   DCHECK(rect.top - rect.bottom >= 1.0f);
   GetMutableAnnotDict()->SetRectFor(pdfium::annotation::kRect, rect);
+  GetPageView()->OnAnnotRectsChanged();
 }
 
 bool CPDFSDK_Widget::IsAppearanceValid() {
@@ -255,6 +255,15 @@ RetainPtr<CPDF_Dictionary> GetMutableAnnotDictFromFPDFAnnotation(
   return context ? context->GetMutableAnnotDict() : nullptr;
 }
 
+// Lets the form fill page view, if any, know that `annot` may have moved.
+void NotifyAnnotRectsChanged(FPDF_ANNOTATION annot) {
+  CPDF_Page* page =
+      ToPDFPage(CPDFAnnotContextFromFPDFAnnotation(annot)->GetPage());
+  if (page) {
+    page->NotifyAnnotRectsChanged();
+  }
+}
+
 RetainPtr<CPDF_Dictionary> SetExtGStateInResourceDict(
     CPDF_Document* doc,
     const CPDF_Dictionary* pAnnotDict,
@@ -855,6 +864,7 @@ FPDFAnnot_SetAttachmentPoints(FPDF_ANNOTATION annot,
 
   SetQuadPointsAtIndex(pQuadPointsArray.Get(), quad_index, quad_points);
   UpdateBBox(pAnnotDict.Get());
+  NotifyAnnotRectsChanged(annot);
   return true;
 }
 
@@ -874,6 +884,7 @@ FPDFAnnot_AppendAttachmentPoints(FPDF_ANNOTATION annot,
   }
   AppendQuadPoints(pQuadPointsArray.Get(), quad_points);
   UpdateBBox(pAnnotDict.Get());
+  NotifyAnnotRectsChanged(annot);
   return true;
 }
 
@@ -921,6 +932,7 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FPDFAnnot_SetRect(FPDF_ANNOTATION annot,
 
   // Update the "Rect" entry in the annotation dictionary.
   pAnnotDict->SetRectFor(pdfium::annotation::kRect, newRect);
+  NotifyAnnotRectsChanged(annot);
 
   // If the annotation's appearance stream is defined, the annotation is of a
   // type that does not have quadpoints, and the new rectangle is bigger than
@@ -10,9 +10,12 @@
 #include <utility>
 
 #include "core/fpdfapi/page/cpdf_docpagedata.h"
+#include "core/fpdfapi/parser/cpdf_async_file_reader.h"
 #include "core/fpdfapi/parser/cpdf_data_avail.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
+#include "core/fpdfapi/parser/cpdf_read_validator.h"
 #include "core/fpdfapi/render/cpdf_docrenderdata.h"
+#include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/fx_safe_types.h"
 #include "core/fxcrt/fx_stream.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
@@ -121,6 +124,25 @@ class FPDF_DownloadHintsContext final : public CPDF_DataAvail::DownloadHints {
   UnownedPtr<FX_DOWNLOADHINTS> download_hints_;
 };
 
+class FPDF_AsyncFileAccessContext final
+    : public CPDF_AsyncFileReader::Delegate {
+ public:
+  explicit FPDF_AsyncFileAccessContext(FX_ASYNC_FILEACCESS* file)
+      : file_(file) {}
+  ~FPDF_AsyncFileAccessContext() override = default;
+
+  // CPDF_AsyncFileReader::Delegate:
+  void ReadAsync(FX_FILESIZE offset,
+                 size_t size,
+                 uint32_t request_id) override {
+    file_->ReadAsync(file_, pdfium::checked_cast<unsigned long>(offset),
+                     pdfium::checked_cast<unsigned long>(size), request_id);
+  }
+
+ private:
+  UnownedPtr<FX_ASYNC_FILEACCESS> const file_;
+};
+
 class FPDF_AvailContext {
  public:
   FPDF_AvailContext(FX_FILEAVAIL* file_avail, FPDF_FILEACCESS* file)
@@ -128,13 +150,29 @@ class FPDF_AvailContext {
         file_read_(pdfium::MakeRetain<FPDF_FileAccessContext>(file)),
         data_avail_(
             std::make_unique<CPDF_DataAvail>(file_avail_.get(), file_read_)) {}
+  explicit FPDF_AvailContext(FX_ASYNC_FILEACCESS* file)
+      : async_file_(std::make_unique<FPDF_AsyncFileAccessContext>(file)),
+        async_reader_(pdfium::MakeRetain<CPDF_AsyncFileReader>(
+            async_file_.get(),
+            file->file_len)),
+        data_avail_(std::make_unique<CPDF_DataAvail>(async_reader_.Get(),
+                                                     async_reader_)) {}
   ~FPDF_AvailContext() = default;
 
   CPDF_DataAvail* data_avail() { return data_avail_.get(); }
+  CPDF_AsyncFileReader* async_reader() { return async_reader_.Get(); }
+
+  // Asynchronous providers request data themselves and ignore `hints`.
+  CPDF_DataAvail::DownloadHints* GetDownloadHints(
+      CPDF_DataAvail::DownloadHints* hints) {
+    return async_reader_ ? async_reader_.Get() : hints;
+  }
 
  private:
   std::unique_ptr<FPDF_FileAvailContext> const file_avail_;
   RetainPtr<FPDF_FileAccessContext> const file_read_;
+  std::unique_ptr<FPDF_AsyncFileAccessContext> const async_file_;
+  RetainPtr<CPDF_AsyncFileReader> const async_reader_;
   std::unique_ptr<CPDF_DataAvail> const data_avail_;
 };
 
@@ -156,6 +194,18 @@ FPDF_EXPORT FPDF_AVAIL FPDF_CALLCONV FPDFAvail_Create(FX_FILEAVAIL* file_avail,
   return FPDFAvailFromFPDFAvailContext(pAvail.release());
 }
 
+FPDF_EXPORT FPDF_AVAIL FPDF_CALLCONV
+FPDFAvail_CreateAsync(FX_ASYNC_FILEACCESS* file_access) {
+  if (!file_access || !file_access->ReadAsync) {
+    return nullptr;
+  }
+
+  auto pAvail = std::make_unique<FPDF_AvailContext>(file_access);
+
+  // Caller takes ownership.
+  return FPDFAvailFromFPDFAvailContext(pAvail.release());
+}
+
 FPDF_EXPORT void FPDF_CALLCONV FPDFAvail_Destroy(FPDF_AVAIL avail) {
   // Take ownership back from caller and destroy.
   std::unique_ptr<FPDF_AvailContext>(FPDFAvailContextFromFPDFAvail(avail));
@@ -168,7 +218,8 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsDocAvail(FPDF_AVAIL avail,
     return PDF_DATA_ERROR;
   }
   FPDF_DownloadHintsContext hints_context(hints);
-  return avail_context->data_avail()->IsDocAvail(&hints_context);
+  return avail_context->data_avail()->IsDocAvail(
+      avail_context->GetDownloadHints(&hints_context));
 }
 
 FPDF_EXPORT FPDF_DOCUMENT FPDF_CALLCONV
@@ -206,7 +257,8 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsPageAvail(FPDF_AVAIL avail,
     return PDF_DATA_NOTAVAIL;
   }
   FPDF_DownloadHintsContext hints_context(hints);
-  return avail_context->data_avail()->IsPageAvail(page_index, &hints_context);
+  return avail_context->data_avail()->IsPageAvail(
+      page_index, avail_context->GetDownloadHints(&hints_context));
 }
 
 FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsFormAvail(FPDF_AVAIL avail,
@@ -216,7 +268,8 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsFormAvail(FPDF_AVAIL avail,
     return PDF_FORM_ERROR;
   }
   FPDF_DownloadHintsContext hints_context(hints);
-  return avail_context->data_avail()->IsFormAvail(&hints_context);
+  return avail_context->data_avail()->IsFormAvail(
+      avail_context->GetDownloadHints(&hints_context));
 }
 
 FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsLinearized(FPDF_AVAIL avail) {
@@ -226,3 +279,66 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsLinearized(FPDF_AVAIL avail) {
   }
   return avail_context->data_avail()->IsLinearizedPDF();
 }
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFAvail_SetRequestPolicy(FPDF_AVAIL avail,
+                           FPDF_BOOL coalesce,
+                           unsigned int merge_gap,
+                           unsigned int read_ahead) {
+  auto* avail_context = FPDFAvailContextFromFPDFAvail(avail);
+  if (!avail_context) {
+    return false;
+  }
+
+  CPDF_ReadValidator::RequestPolicy policy;
+  policy.coalesce = !!coalesce;
+  policy.merge_gap = merge_gap;
+  policy.read_ahead = read_ahead;
+  avail_context->data_avail()->GetValidator()->SetRequestPolicy(policy);
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFAvail_GetRequestStats(FPDF_AVAIL avail,
+                          size_t* request_count,
+                          size_t* requested_bytes) {
+  auto* avail_context = FPDFAvailContextFromFPDFAvail(avail);
+  if (!avail_context || !request_count || !requested_bytes) {
+    return false;
+  }
+
+  const CPDF_ReadValidator::RequestStats& stats =
+      avail_context->data_avail()->GetValidator()->request_stats();
+  *request_count = pdfium::saturated_cast<size_t>(stats.request_count);
+  *requested_bytes = pdfium::saturated_cast<size_t>(stats.requested_bytes);
+  return true;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFAvail_CompleteAsyncRead(FPDF_AVAIL avail,
+                            unsigned long request_id,
+                            const unsigned char* data,
+                            unsigned long size) {
+  auto* avail_context = FPDFAvailContextFromFPDFAvail(avail);
+  if (!avail_context || !avail_context->async_reader() || (size && !data) ||
+      !pdfium::IsValueInRangeForNumericType<uint32_t>(request_id)) {
+    return false;
+  }
+
+  // SAFETY: required from caller.
+  auto data_span =
+      data ? UNSAFE_BUFFERS(pdfium::span(data, static_cast<size_t>(size)))
+           : pdfium::span<const uint8_t>();
+  return avail_context->async_reader()->CompleteRead(
+      static_cast<uint32_t>(request_id), data_span);
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFAvail_GetPendingAsyncReadCount(FPDF_AVAIL avail) {
+  auto* avail_context = FPDFAvailContextFromFPDFAvail(avail);
+  if (!avail_context || !avail_context->async_reader()) {
+    return -1;
+  }
+  return pdfium::checked_cast<int>(
+      avail_context->async_reader()->pending_read_count());
+}
@@ -12,6 +12,7 @@
 #include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/numerics/safe_conversions.h"
 #include "core/fxcrt/stl_util.h"
+#include "public/cpp/fpdf_scopers.h"
 #include "public/fpdf_doc.h"
 #include "public/fpdfview.h"
 #include "testing/embedder_test.h"
@@ -72,6 +73,9 @@ class TestAsyncLoader final : public FX_DOWNLOADHINTS, FX_FILEAVAIL {
 
   size_t max_requested_bound() const { return max_requested_bound_; }
 
+  // Number of AddSegment() calls, not reset by ClearRequestedSegments().
+  size_t request_count() const { return request_count_; }
+
   void ClearRequestedSegments() {
     requested_segments_.clear();
     max_requested_bound_ = 0;
@@ -124,6 +128,7 @@ class TestAsyncLoader final : public FX_DOWNLOADHINTS, FX_FILEAVAIL {
   void AddSegmentImpl(size_t offset, size_t size) {
     requested_segments_.emplace_back(offset, size);
     max_requested_bound_ = std::max(max_requested_bound_, offset + size);
+    ++request_count_;
   }
 
   bool IsDataAvailImpl(size_t offset, size_t size) {
@@ -161,11 +166,128 @@ class TestAsyncLoader final : public FX_DOWNLOADHINTS, FX_FILEAVAIL {
   std::vector<uint8_t> file_contents_;
   std::vector<std::pair<size_t, size_t>> requested_segments_;
   size_t max_requested_bound_ = 0;
+  size_t request_count_ = 0;
   bool is_new_data_available_ = true;
 
   RangeSet available_ranges_;
 };
 
+// In-memory FX_ASYNC_FILEACCESS whose reads complete `latency` calls to
+// Tick() after they were started, or from within ReadAsync() if `latency` is
+// 0.
+class FakeAsyncFile final : public FX_ASYNC_FILEACCESS {
+ public:
+  FakeAsyncFile(const std::string& file_name, int latency)
+      : latency_(latency) {
+    std::string file_path = PathService::GetTestFilePath(file_name);
+    if (!file_path.empty()) {
+      file_contents_ = GetFileContents(file_path.c_str());
+    }
+    FX_ASYNC_FILEACCESS::version = 1;
+    FX_ASYNC_FILEACCESS::file_len =
+        pdfium::checked_cast<unsigned long>(file_contents_.size());
+    FX_ASYNC_FILEACCESS::ReadAsync = SReadAsync;
+  }
+
+  void set_avail(FPDF_AVAIL avail) { avail_ = avail; }
+  void set_fail_reads(bool fail_reads) { fail_reads_ = fail_reads; }
+  size_t read_count() const { return read_count_; }
+  bool has_pending_reads() const { return !pending_reads_.empty(); }
+
+  void Tick() {
+    std::vector<PendingRead> ready;
+    for (auto it = pending_reads_.begin(); it != pending_reads_.end();) {
+      if (--it->ticks_left <= 0) {
+        ready.push_back(*it);
+        it = pending_reads_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    for (const PendingRead& read : ready) {
+      Complete(read);
+    }
+  }
+
+ private:
+  struct PendingRead {
+    unsigned long position;
+    unsigned long size;
+    unsigned long request_id;
+    int ticks_left;
+  };
+
+  static void SReadAsync(FX_ASYNC_FILEACCESS* pThis,
+                         unsigned long position,
+                         unsigned long size,
+                         unsigned long request_id) {
+    static_cast<FakeAsyncFile*>(pThis)->ReadAsyncImpl(position, size,
+                                                      request_id);
+  }
+
+  void ReadAsyncImpl(unsigned long position,
+                     unsigned long size,
+                     unsigned long request_id) {
+    ++read_count_;
+    const PendingRead read = {position, size, request_id, latency_};
+    if (latency_ == 0) {
+      Complete(read);
+      return;
+    }
+    pending_reads_.push_back(read);
+  }
+
+  void Complete(const PendingRead& read) {
+    if (fail_reads_) {
+      EXPECT_TRUE(
+          FPDFAvail_CompleteAsyncRead(avail_, read.request_id, nullptr, 0));
+      return;
+    }
+    pdfium::span<const uint8_t> data =
+        pdfium::span(file_contents_).subspan(read.position, read.size);
+    EXPECT_TRUE(FPDFAvail_CompleteAsyncRead(avail_, read.request_id,
+                                            data.data(), read.size));
+  }
+
+  const int latency_;
+  FPDF_AVAIL avail_ = nullptr;
+  bool fail_reads_ = false;
+  size_t read_count_ = 0;
+  std::vector<uint8_t> file_contents_;
+  std::vector<PendingRead> pending_reads_;
+};
+
+// Loads `file_name` from an empty cache, making only the requested data
+// available after each call, and returns the number of requests made.
+size_t CountRequestsToLoadDocument(const std::string& file_name,
+                                   bool coalesce) {
+  TestAsyncLoader loader(file_name);
+  loader.set_is_new_data_available(false);
+  ScopedFPDFAvail avail(
+      FPDFAvail_Create(loader.file_avail(), loader.file_access()));
+  EXPECT_TRUE(avail);
+  if (coalesce) {
+    EXPECT_TRUE(FPDFAvail_SetRequestPolicy(avail.get(), /*coalesce=*/true,
+                                           /*merge_gap=*/4096,
+                                           /*read_ahead=*/16384));
+  }
+
+  int status = PDF_DATA_NOTAVAIL;
+  while (status == PDF_DATA_NOTAVAIL) {
+    loader.FlushRequestedData();
+    status = FPDFAvail_IsDocAvail(avail.get(), loader.hints());
+  }
+  EXPECT_EQ(PDF_DATA_AVAIL, status);
+
+  size_t request_count = 0;
+  size_t requested_bytes = 0;
+  EXPECT_TRUE(FPDFAvail_GetRequestStats(avail.get(), &request_count,
+                                        &requested_bytes));
+  EXPECT_EQ(loader.request_count(), request_count);
+  EXPECT_GT(requested_bytes, 0u);
+  return request_count;
+}
+
 }  // namespace
 
 class FPDFDataAvailEmbedderTest : public EmbedderTest {};
@@ -405,6 +527,138 @@ TEST_F(FPDFDataAvailEmbedderTest, BadInputsToAPIs) {
   EXPECT_EQ(PDF_DATA_ERROR, FPDFAvail_IsPageAvail(nullptr, 0, nullptr));
   EXPECT_EQ(PDF_FORM_ERROR, FPDFAvail_IsFormAvail(nullptr, nullptr));
   EXPECT_EQ(PDF_LINEARIZATION_UNKNOWN, FPDFAvail_IsLinearized(nullptr));
+  EXPECT_FALSE(FPDFAvail_SetRequestPolicy(nullptr, true, 0, 0));
+  size_t value = 0;
+  EXPECT_FALSE(FPDFAvail_GetRequestStats(nullptr, &value, &value));
+}
+
+TEST_F(FPDFDataAvailEmbedderTest, CoalescedRequests) {
+  static constexpr const char* kFileNames[] = {
+      "linearized.pdf", "feature_linearized_loading.pdf", "hello_world.pdf"};
+  for (const char* file_name : kFileNames) {
+    SCOPED_TRACE(file_name);
+    const size_t default_count = CountRequestsToLoadDocument(file_name, false);
+    const size_t coalesced_count = CountRequestsToLoadDocument(file_name, true);
+    EXPECT_GT(default_count, 0u);
+    EXPECT_GT(coalesced_count, 0u);
+    EXPECT_LE(coalesced_count, default_count);
+  }
+}
+
+TEST_F(FPDFDataAvailEmbedderTest, AsyncLoading) {
+  // Several documents in flight on one thread, with different latencies.
+  static constexpr const char* kFileNames[] = {
+      "linearized.pdf", "feature_linearized_loading.pdf", "hello_world.pdf"};
+  static constexpr int kLatencies[] = {0, 1, 3};
+  std::vector<std::unique_ptr<FakeAsyncFile>> files;
+  std::vector<ScopedFPDFAvail> avails;
+  for (size_t i = 0; i < std::size(kFileNames); ++i) {
+    files.push_back(
+        std::make_unique<FakeAsyncFile>(kFileNames[i], kLatencies[i]));
+    avails.emplace_back(FPDFAvail_CreateAsync(files.back().get()));
+    ASSERT_TRUE(avails.back());
+    files.back()->set_avail(avails.back().get());
+  }
+
+  std::vector<int> statuses(files.size(), PDF_DATA_NOTAVAIL);
+  for (int round = 0; round < 1000; ++round) {
+    bool all_available = true;
+    for (size_t i = 0; i < files.size(); ++i) {
+      if (statuses[i] == PDF_DATA_NOTAVAIL) {
+        // The hints are ignored.
+        statuses[i] = FPDFAvail_IsDocAvail(avails[i].get(), nullptr);
+      }
+      all_available &= statuses[i] != PDF_DATA_NOTAVAIL;
+      files[i]->Tick();
+    }
+    if (all_available) {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    SCOPED_TRACE(kFileNames[i]);
+    ASSERT_EQ(PDF_DATA_AVAIL, statuses[i]);
+    EXPECT_GT(files[i]->read_count(), 0u);
+
+    ScopedFPDFDocument doc(FPDFAvail_GetDocument(avails[i].get(), nullptr));
+    ASSERT_TRUE(doc);
+    const int page_count = FPDF_GetPageCount(doc.get());
+    ASSERT_GT(page_count, 0);
+    const int last_page = page_count - 1;
+    int page_status = PDF_DATA_NOTAVAIL;
+    for (int round = 0; round < 1000 && page_status == PDF_DATA_NOTAVAIL;
+         ++round) {
+      page_status = FPDFAvail_IsPageAvail(avails[i].get(), last_page, nullptr);
+      files[i]->Tick();
+    }
+    ASSERT_EQ(PDF_DATA_AVAIL, page_status);
+    ScopedFPDFPage page(FPDF_LoadPage(doc.get(), last_page));
+    EXPECT_TRUE(page);
+
+    // Reads that completed after the last check are not pending anymore.
+    while (files[i]->has_pending_reads()) {
+      files[i]->Tick();
+    }
+    EXPECT_EQ(0, FPDFAvail_GetPendingAsyncReadCount(avails[i].get()));
+  }
+}
+
+TEST_F(FPDFDataAvailEmbedderTest, AsyncLoadingFailedReads) {
+  FakeAsyncFile file("linearized.pdf", 1);
+  ScopedFPDFAvail avail(FPDFAvail_CreateAsync(&file));
+  ASSERT_TRUE(avail);
+  file.set_avail(avail.get());
+  file.set_fail_reads(true);
+
+  int status = PDF_DATA_NOTAVAIL;
+  for (int round = 0; round < 1000 && status == PDF_DATA_NOTAVAIL; ++round) {
+    status = FPDFAvail_IsDocAvail(avail.get(), nullptr);
+    file.Tick();
+  }
+  EXPECT_NE(PDF_DATA_NOTAVAIL, status);
+  EXPECT_FALSE(FPDFAvail_GetDocument(avail.get(), nullptr));
+}
+
+TEST_F(FPDFDataAvailEmbedderTest, AsyncBadParams) {
+  EXPECT_FALSE(FPDFAvail_CreateAsync(nullptr));
+  FX_ASYNC_FILEACCESS no_callback = {};
+  EXPECT_FALSE(FPDFAvail_CreateAsync(&no_callback));
+
+  static constexpr unsigned char kData[] = {1};
+  EXPECT_FALSE(FPDFAvail_CompleteAsyncRead(nullptr, 1, kData, 1));
+  EXPECT_EQ(-1, FPDFAvail_GetPendingAsyncReadCount(nullptr));
+
+  // Not an asynchronous provider.
+  TestAsyncLoader loader("linearized.pdf");
+  CreateAvail(loader.file_avail(), loader.file_access());
+  EXPECT_FALSE(FPDFAvail_CompleteAsyncRead(avail(), 1, kData, 1));
+  EXPECT_EQ(-1, FPDFAvail_GetPendingAsyncReadCount(avail()));
+
+  FakeAsyncFile file("linearized.pdf", 1);
+  ScopedFPDFAvail async_avail(FPDFAvail_CreateAsync(&file));
+  ASSERT_TRUE(async_avail);
+  file.set_avail(async_avail.get());
+  EXPECT_EQ(0, FPDFAvail_GetPendingAsyncReadCount(async_avail.get()));
+  EXPECT_EQ(PDF_DATA_NOTAVAIL,
+            FPDFAvail_IsDocAvail(async_avail.get(), nullptr));
+  EXPECT_GT(FPDFAvail_GetPendingAsyncReadCount(async_avail.get()), 0);
+  // Unknown request, and data without a size.
+  EXPECT_FALSE(
+      FPDFAvail_CompleteAsyncRead(async_avail.get(), 12345, kData, 1));
+  EXPECT_FALSE(FPDFAvail_CompleteAsyncRead(async_avail.get(), 1, nullptr, 1));
+}
+
+TEST_F(FPDFDataAvailEmbedderTest, RequestStatsBadParams) {
+  TestAsyncLoader loader("linearized.pdf");
+  CreateAvail(loader.file_avail(), loader.file_access());
+  size_t value = 0;
+  EXPECT_FALSE(FPDFAvail_GetRequestStats(avail(), nullptr, &value));
+  EXPECT_FALSE(FPDFAvail_GetRequestStats(avail(), &value, nullptr));
+  size_t request_count = 1;
+  EXPECT_TRUE(FPDFAvail_GetRequestStats(avail(), &request_count, &value));
+  EXPECT_EQ(0u, request_count);
+  EXPECT_EQ(0u, value);
 }
 
 TEST_F(FPDFDataAvailEmbedderTest, NegativePageIndex) {
@@ -8,7 +8,8 @@
 
 #include <limits.h>
 
-#include <algorithm>
+#include <chrono>
+#include <map>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -19,7 +20,6 @@
 #include "constants/page_object.h"
 #include "core/fpdfapi/edit/cpdf_contentstream_write_utils.h"
 #include "core/fpdfapi/page/cpdf_page.h"
-#include "core/fpdfapi/page/cpdf_pageobject.h"
 #include "core/fpdfapi/parser/cpdf_array.h"
 #include "core/fpdfapi/parser/cpdf_dictionary.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
@@ -30,81 +30,23 @@
 #include "core/fpdfapi/parser/cpdf_stream_acc.h"
 #include "core/fpdfapi/parser/fpdf_parser_utility.h"
 #include "core/fpdfdoc/cpdf_annot.h"
+#include "core/fxcrt/compiler_specific.h"
 #include "core/fxcrt/fx_string_wrappers.h"
 #include "core/fxcrt/notreached.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/span.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
 
-enum FPDF_TYPE { MAX, MIN };
-enum FPDF_VALUE { TOP, LEFT, RIGHT, BOTTOM };
-
 namespace {
 
-bool IsValidRect(const CFX_FloatRect& rect, const CFX_FloatRect& rcPage) {
-  static constexpr float kMinSize = 0.000001f;
-  if (rect.IsEmpty() || rect.Width() < kMinSize || rect.Height() < kMinSize) {
-    return false;
-  }
-
-  if (rcPage.IsEmpty()) {
-    return true;
-  }
-
-  static constexpr float kMinBorderSize = 10.000001f;
-  return rect.left - rcPage.left >= -kMinBorderSize &&
-         rect.right - rcPage.right <= kMinBorderSize &&
-         rect.top - rcPage.top <= kMinBorderSize &&
-         rect.bottom - rcPage.bottom >= -kMinBorderSize;
-}
-
-void GetContentsRect(CPDF_Document* doc,
-                     RetainPtr<CPDF_Dictionary> dict,
-                     std::vector<CFX_FloatRect>* pRectArray) {
-  auto pPDFPage = pdfium::MakeRetain<CPDF_Page>(doc, dict);
-  pPDFPage->ParseContent();
-
-  for (const auto& pPageObject : *pPDFPage) {
-    if (!pPageObject->IsActive()) {
-      continue;
-    }
-
-    const CFX_FloatRect& rc = pPageObject->GetRect();
-    if (IsValidRect(rc, dict->GetRectFor(pdfium::page_object::kMediaBox))) {
-      pRectArray->push_back(rc);
-    }
-  }
-}
-
-void ParserStream(const CPDF_Dictionary* pPageDic,
-                  CPDF_Dictionary* pStream,
-                  std::vector<CFX_FloatRect>* pRectArray,
-                  std::vector<CPDF_Dictionary*>* pObjectArray) {
-  if (!pStream) {
-    return;
-  }
-  CFX_FloatRect rect;
-  if (pStream->KeyExist("Rect")) {
-    rect = pStream->GetRectFor("Rect");
-  } else if (pStream->KeyExist("BBox")) {
-    rect = pStream->GetRectFor("BBox");
-  }
-
-  if (IsValidRect(rect, pPageDic->GetRectFor(pdfium::page_object::kMediaBox))) {
-    pRectArray->push_back(rect);
-  }
-
-  pObjectArray->push_back(pStream);
-}
+// Form XObjects made from annotation appearance streams, keyed by the
+// original appearance stream.
+using ConvertedAppearanceMap =
+    std::map<RetainPtr<const CPDF_Stream>, RetainPtr<CPDF_Stream>>;
 
-int ParserAnnots(CPDF_Document* pSourceDoc,
-                 RetainPtr<CPDF_Dictionary> pPageDic,
-                 std::vector<CFX_FloatRect>* pRectArray,
+int ParserAnnots(const CPDF_Dictionary* pPageDic,
                  std::vector<CPDF_Dictionary*>* pObjectArray,
                  int nUsage) {
-  if (!pSourceDoc) {
-    return FLATTEN_FAIL;
-  }
-
-  GetContentsRect(pSourceDoc, pPageDic, pRectArray);
   RetainPtr<const CPDF_Array> pAnnots = pPageDic->GetArrayFor("Annots");
   if (!pAnnots) {
     return FLATTEN_NOTHINGTODO;
@@ -136,68 +78,12 @@ int ParserAnnots(CPDF_Document* pSourceDoc,
       bParseStream = !!(nAnnotFlag & pdfium::annotation_flags::kPrint);
     }
     if (bParseStream) {
-      ParserStream(pPageDic.Get(), pAnnotDict.Get(), pRectArray, pObjectArray);
+      pObjectArray->push_back(pAnnotDict.Get());
     }
   }
   return FLATTEN_SUCCESS;
 }
 
-float GetMinMaxValue(const std::vector<CFX_FloatRect>& array,
-                     FPDF_TYPE type,
-                     FPDF_VALUE value) {
-  if (array.empty()) {
-    return 0.0f;
-  }
-
-  size_t nRects = array.size();
-  std::vector<float> pArray(nRects);
-  switch (value) {
-    case LEFT:
-      for (size_t i = 0; i < nRects; i++) {
-        pArray[i] = array[i].left;
-      }
-      break;
-    case TOP:
-      for (size_t i = 0; i < nRects; i++) {
-        pArray[i] = array[i].top;
-      }
-      break;
-    case RIGHT:
-      for (size_t i = 0; i < nRects; i++) {
-        pArray[i] = array[i].right;
-      }
-      break;
-    case BOTTOM:
-      for (size_t i = 0; i < nRects; i++) {
-        pArray[i] = array[i].bottom;
-      }
-      break;
-  }
-
-  float fRet = pArray[0];
-  if (type == MAX) {
-    for (size_t i = 1; i < nRects; i++) {
-      fRet = std::max(fRet, pArray[i]);
-    }
-  } else {
-    for (size_t i = 1; i < nRects; i++) {
-      fRet = std::min(fRet, pArray[i]);
-    }
-  }
-  return fRet;
-}
-
-CFX_FloatRect CalculateRect(std::vector<CFX_FloatRect>* pRectArray) {
-  CFX_FloatRect rcRet;
-
-  rcRet.left = GetMinMaxValue(*pRectArray, MIN, LEFT);
-  rcRet.top = GetMinMaxValue(*pRectArray, MAX, TOP);
-  rcRet.right = GetMinMaxValue(*pRectArray, MAX, RIGHT);
-  rcRet.bottom = GetMinMaxValue(*pRectArray, MIN, BOTTOM);
-
-  return rcRet;
-}
-
 ByteString GenerateFlattenedContent(const ByteString& key) {
   return "q 1 0 0 1 0 0 cm /" + key + " Do Q";
 }
@@ -315,28 +201,89 @@ void SanitizeResources(RetainPtr<CPDF_Dictionary> resources_dict) {
   SanitizeFontResources(resources_dict->GetMutableDictFor("Font"));
 }
 
-}  // namespace
+// Finds the normal appearance stream `pAnnotDict` would display, if any.
+RetainPtr<CPDF_Stream> GetNormalAppearanceStream(CPDF_Dictionary* pAnnotDict) {
+  RetainPtr<CPDF_Dictionary> pAnnotAP =
+      pAnnotDict->GetMutableDictFor(pdfium::annotation::kAP);
+  if (!pAnnotAP) {
+    return nullptr;
+  }
 
-FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
-  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
-  if (!page) {
-    return FLATTEN_FAIL;
+  RetainPtr<CPDF_Stream> original_ap_stream =
+      pAnnotAP->GetMutableStreamFor("N");
+  if (original_ap_stream) {
+    return original_ap_stream;
   }
 
-  CPDF_Document* document = pPage->GetDocument();
-  RetainPtr<CPDF_Dictionary> pPageDict = pPage->GetMutableDict();
-  if (!document) {
-    return FLATTEN_FAIL;
+  RetainPtr<CPDF_Dictionary> original_ap_dict =
+      pAnnotAP->GetMutableDictFor("N");
+  if (!original_ap_dict) {
+    return nullptr;
+  }
+
+  ByteString sAnnotState = pAnnotDict->GetByteStringFor("AS");
+  if (!sAnnotState.IsEmpty()) {
+    return original_ap_dict->GetMutableStreamFor(sAnnotState.AsStringView());
+  }
+  if (original_ap_dict->size() == 0) {
+    return nullptr;
   }
 
+  CPDF_DictionaryLocker locker(original_ap_dict);
+  RetainPtr<CPDF_Object> pFirstObj = locker.begin()->second;
+  if (!pFirstObj) {
+    return nullptr;
+  }
+  if (pFirstObj->IsReference()) {
+    pFirstObj = pFirstObj->GetMutableDirect();
+  }
+  return ToStream(std::move(pFirstObj));
+}
+
+// Turns `original_ap_stream` into a form XObject that can be referenced from
+// page resources. Annotations sharing an indirect appearance stream, e.g. the
+// same widget appearance on every page, reference the same XObject either way.
+// Remembering the result in `converted` only saves redoing the conversion.
+RetainPtr<CPDF_Stream> ConvertAppearanceStream(
+    CPDF_Document* document,
+    RetainPtr<CPDF_Stream> original_ap_stream,
+    ConvertedAppearanceMap* converted,
+    FPDF_FLATTEN_PAGE_STATS* stats) {
+  auto it = converted->find(original_ap_stream);
+  if (it != converted->end()) {
+    ++stats->already_converted_appearances;
+    return it->second;
+  }
+
+  RetainPtr<CPDF_Stream> ap_stream;
+  if (original_ap_stream->IsInline()) {
+    ap_stream = ToStream(original_ap_stream->Clone());
+    document->AddIndirectObject(ap_stream);
+  } else {
+    ap_stream = original_ap_stream;
+  }
+
+  RetainPtr<CPDF_Dictionary> ap_stream_dict = ap_stream->GetMutableDict();
+  ap_stream_dict->SetNewFor<CPDF_Name>("Type", "XObject");
+  ap_stream_dict->SetNewFor<CPDF_Name>("Subtype", "Form");
+  SanitizeResources(ap_stream_dict->GetMutableDictFor("Resources"));
+  converted->emplace(std::move(original_ap_stream), ap_stream);
+  return ap_stream;
+}
+
+// Flattens the annotations of the page in `pPageDict`. Fills in everything in
+// `stats` except `elapsed_us`, and returns `stats->result`.
+int FlattenPageDict(CPDF_Document* document,
+                    RetainPtr<CPDF_Dictionary> pPageDict,
+                    int nFlag,
+                    ConvertedAppearanceMap* converted,
+                    FPDF_FLATTEN_PAGE_STATS* stats) {
   std::vector<CPDF_Dictionary*> ObjectArray;
-  std::vector<CFX_FloatRect> RectArray;
-  int iRet = ParserAnnots(document, pPageDict, &RectArray, &ObjectArray, nFlag);
-  if (iRet == FLATTEN_NOTHINGTODO || iRet == FLATTEN_FAIL) {
-    return iRet;
+  stats->result = ParserAnnots(pPageDict.Get(), &ObjectArray, nFlag);
+  if (stats->result != FLATTEN_SUCCESS) {
+    return stats->result;
   }
 
-  CFX_FloatRect rcMerger = CalculateRect(&RectArray);
   CFX_FloatRect rcOriginalMB =
       pPageDict->GetRectFor(pdfium::page_object::kMediaBox);
   if (pPageDict->KeyExist(pdfium::page_object::kCropBox)) {
@@ -357,11 +304,6 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
     rcOriginalCB = rcOriginalMB;
   }
 
-  rcMerger.left = std::max(rcMerger.left, rcOriginalMB.left);
-  rcMerger.right = std::min(rcMerger.right, rcOriginalMB.right);
-  rcMerger.bottom = std::max(rcMerger.bottom, rcOriginalMB.bottom);
-  rcMerger.top = std::min(rcMerger.top, rcOriginalMB.top);
-
   pPageDict->SetRectFor(pdfium::page_object::kMediaBox, rcOriginalMB);
   pPageDict->SetRectFor(pdfium::page_object::kCropBox, rcOriginalCB);
 
@@ -399,6 +341,9 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
     pNewOXbjectDic->SetRectFor("BBox", rcOriginalCB);
   }
 
+  // Accumulate the content and write it out once, instead of re-reading and
+  // rewriting the stream for every annotation.
+  fxcrt::ostringstream sStream;
   for (size_t i = 0; i < ObjectArray.size(); ++i) {
     CPDF_Dictionary* pAnnotDict = ObjectArray[i];
     if (!pAnnotDict) {
@@ -408,41 +353,8 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
     CFX_FloatRect rcAnnot = pAnnotDict->GetRectFor(pdfium::annotation::kRect);
     rcAnnot.Normalize();
 
-    ByteString sAnnotState = pAnnotDict->GetByteStringFor("AS");
-    RetainPtr<CPDF_Dictionary> pAnnotAP =
-        pAnnotDict->GetMutableDictFor(pdfium::annotation::kAP);
-    if (!pAnnotAP) {
-      continue;
-    }
-
     RetainPtr<CPDF_Stream> original_ap_stream =
-        pAnnotAP->GetMutableStreamFor("N");
-    if (!original_ap_stream) {
-      RetainPtr<CPDF_Dictionary> original_ap_dict =
-          pAnnotAP->GetMutableDictFor("N");
-      if (!original_ap_dict) {
-        continue;
-      }
-
-      if (!sAnnotState.IsEmpty()) {
-        original_ap_stream =
-            original_ap_dict->GetMutableStreamFor(sAnnotState.AsStringView());
-      } else {
-        if (original_ap_dict->size() > 0) {
-          CPDF_DictionaryLocker locker(original_ap_dict);
-          RetainPtr<CPDF_Object> pFirstObj = locker.begin()->second;
-          if (pFirstObj) {
-            if (pFirstObj->IsReference()) {
-              pFirstObj = pFirstObj->GetMutableDirect();
-            }
-            if (!pFirstObj->IsStream()) {
-              continue;
-            }
-            original_ap_stream.Reset(pFirstObj->AsMutableStream());
-          }
-        }
-      }
-    }
+        GetNormalAppearanceStream(pAnnotDict);
     if (!original_ap_stream) {
       continue;
     }
@@ -461,18 +373,8 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
       continue;
     }
 
-    RetainPtr<CPDF_Stream> ap_stream;
-    if (original_ap_stream->IsInline()) {
-      ap_stream = ToStream(original_ap_stream->Clone());
-      document->AddIndirectObject(ap_stream);
-    } else {
-      ap_stream = original_ap_stream;
-    }
-
-    RetainPtr<CPDF_Dictionary> ap_stream_dict = ap_stream->GetMutableDict();
-    ap_stream_dict->SetNewFor<CPDF_Name>("Type", "XObject");
-    ap_stream_dict->SetNewFor<CPDF_Name>("Subtype", "Form");
-    SanitizeResources(ap_stream_dict->GetMutableDictFor("Resources"));
+    RetainPtr<CPDF_Stream> ap_stream = ConvertAppearanceStream(
+        document, original_ap_stream, converted, stats);
 
     RetainPtr<CPDF_Dictionary> pXObject =
         pNewXORes->GetOrCreateDictFor("XObject");
@@ -480,23 +382,83 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
     pXObject->SetNewFor<CPDF_Reference>(sFormName, document,
                                         ap_stream->GetObjNum());
 
-    ByteString sStream;
-    {
-      auto pAcc = pdfium::MakeRetain<CPDF_StreamAcc>(pNewXObject);
-      pAcc->LoadAllDataFiltered();
-      sStream = ByteString(ByteStringView(pAcc->GetSpan()));
-    }
     CFX_Matrix matrix = original_ap_stream_dict->GetMatrixFor("Matrix");
     CFX_Matrix m = GetMatrix(rcAnnot, rcStream, matrix);
     m.b = 0;
     m.c = 0;
-    fxcrt::ostringstream buf;
-    WriteMatrix(buf, m);
-    ByteString str(buf);
-    sStream += ByteString::Format("q %s cm /%s Do Q\n", str.c_str(),
-                                  sFormName.c_str());
-    pNewXObject->SetDataAndRemoveFilter(sStream.unsigned_span());
+    sStream << "q ";
+    WriteMatrix(sStream, m);
+    sStream << " cm /" << sFormName << " Do Q\n";
+    ++stats->flattened_annots;
+  }
+  if (stats->flattened_annots > 0) {
+    pNewXObject->SetDataAndRemoveFilter(ByteString(sStream).unsigned_span());
   }
   pPageDict->RemoveFor("Annots");
   return FLATTEN_SUCCESS;
 }
+
+}  // namespace
+
+FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag) {
+  CPDF_Page* pPage = CPDFPageFromFPDFPage(page);
+  if (!page) {
+    return FLATTEN_FAIL;
+  }
+
+  CPDF_Document* document = pPage->GetDocument();
+  if (!document) {
+    return FLATTEN_FAIL;
+  }
+
+  ConvertedAppearanceMap converted;
+  FPDF_FLATTEN_PAGE_STATS stats = {};
+  return FlattenPageDict(document, pPage->GetMutableDict(), nFlag, &converted,
+                         &stats);
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFDoc_Flatten(FPDF_DOCUMENT document,
+                int nFlag,
+                FPDF_FLATTEN_PAGE_STATS* page_stats,
+                int page_stats_count) {
+  CPDF_Document* pDoc = CPDFDocumentFromFPDFDocument(document);
+  if (!pDoc || page_stats_count < 0 || (page_stats_count && !page_stats)) {
+    return FLATTEN_FAIL;
+  }
+
+  // SAFETY: required from caller.
+  auto stats_span = UNSAFE_BUFFERS(pdfium::span(
+      page_stats, static_cast<size_t>(page_stats_count)));
+
+  // Pages share a document, which is not safe to modify from several threads,
+  // so they get flattened one after another. Appearance streams are shared
+  // across pages instead.
+  ConvertedAppearanceMap converted;
+  int result = FLATTEN_NOTHINGTODO;
+  const int page_count = pDoc->GetPageCount();
+  for (int i = 0; i < page_count; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    FPDF_FLATTEN_PAGE_STATS stats = {};
+    RetainPtr<CPDF_Dictionary> pPageDict = pDoc->GetMutablePageDictionary(i);
+    if (pPageDict) {
+      FlattenPageDict(pDoc, std::move(pPageDict), nFlag, &converted, &stats);
+    } else {
+      stats.result = FLATTEN_FAIL;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stats.elapsed_us = pdfium::saturated_cast<unsigned long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+            .count());
+    if (static_cast<size_t>(i) < stats_span.size()) {
+      stats_span[i] = stats;
+    }
+
+    if (stats.result == FLATTEN_FAIL) {
+      result = FLATTEN_FAIL;
+    } else if (stats.result == FLATTEN_SUCCESS && result != FLATTEN_FAIL) {
+      result = FLATTEN_SUCCESS;
+    }
+  }
+  return result;
+}
@@ -4,6 +4,8 @@
 
 #include "build/build_config.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
+#include "public/fpdf_annot.h"
+#include "public/fpdf_edit.h"
 #include "public/fpdf_flatten.h"
 #include "public/fpdfview.h"
 #include "testing/embedder_test.h"
@@ -41,6 +43,45 @@ TEST_F(FPDFFlattenEmbedderTest, FlatPrint) {
   EXPECT_EQ(FLATTEN_SUCCESS, FPDFPage_Flatten(page.get(), FLAT_PRINT));
 }
 
+TEST_F(FPDFFlattenEmbedderTest, FlatDocument) {
+  ASSERT_TRUE(OpenDocument("flatten_shared_appearance.pdf"));
+
+  FPDF_FLATTEN_PAGE_STATS stats[3] = {};
+  EXPECT_EQ(FLATTEN_SUCCESS, FPDFDoc_Flatten(document(), FLAT_PRINT, stats, 3));
+  EXPECT_EQ(FLATTEN_SUCCESS, stats[0].result);
+  EXPECT_EQ(1, stats[0].flattened_annots);
+  EXPECT_EQ(0, stats[0].already_converted_appearances);
+  // The second page uses the same appearance stream as the first one.
+  EXPECT_EQ(FLATTEN_SUCCESS, stats[1].result);
+  EXPECT_EQ(1, stats[1].flattened_annots);
+  EXPECT_EQ(1, stats[1].already_converted_appearances);
+  EXPECT_EQ(FLATTEN_NOTHINGTODO, stats[2].result);
+  EXPECT_EQ(0, stats[2].flattened_annots);
+
+  // Everything got flattened already.
+  EXPECT_EQ(FLATTEN_NOTHINGTODO,
+            FPDFDoc_Flatten(document(), FLAT_PRINT, nullptr, 0));
+
+  for (int i = 0; i < 2; ++i) {
+    ScopedPage page = LoadScopedPage(i);
+    ASSERT_TRUE(page);
+    EXPECT_EQ(0, FPDFPage_GetAnnotCount(page.get()));
+    EXPECT_EQ(1, FPDFPage_CountObjects(page.get()));
+  }
+}
+
+TEST_F(FPDFFlattenEmbedderTest, FlatDocumentBadParameters) {
+  EXPECT_EQ(FLATTEN_FAIL, FPDFDoc_Flatten(nullptr, FLAT_PRINT, nullptr, 0));
+
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  EXPECT_EQ(FLATTEN_FAIL, FPDFDoc_Flatten(document(), FLAT_PRINT, nullptr, 1));
+  FPDF_FLATTEN_PAGE_STATS stats = {};
+  EXPECT_EQ(FLATTEN_FAIL, FPDFDoc_Flatten(document(), FLAT_PRINT, &stats, -1));
+  EXPECT_EQ(FLATTEN_NOTHINGTODO,
+            FPDFDoc_Flatten(document(), FLAT_PRINT, &stats, 1));
+  EXPECT_EQ(FLATTEN_NOTHINGTODO, stats.result);
+}
+
 TEST_F(FPDFFlattenEmbedderTest, FlatWithBadFont) {
   ASSERT_TRUE(OpenDocument("344775293.pdf"));
   ScopedPage page = LoadScopedPage(0);
@@ -7,8 +7,10 @@
 #include "public/fpdf_formfill.h"
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "constants/form_fields.h"
 #include "core/fpdfapi/page/cpdf_annotcontext.h"
@@ -21,6 +23,8 @@
 #include "core/fpdfdoc/cpdf_formcontrol.h"
 #include "core/fpdfdoc/cpdf_formfield.h"
 #include "core/fpdfdoc/cpdf_interactiveform.h"
+#include "core/fxcrt/numerics/safe_conversions.h"
+#include "core/fxcrt/span.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
 #include "core/fxge/dib/cfx_dibitmap.h"
 #include "fpdfsdk/cpdfsdk_annot.h"
@@ -184,7 +188,7 @@ using BitmapOrCanvas = std::variant<CFX_DIBitmap*, SkCanvas*>;
 using BitmapOrCanvas = std::variant<CFX_DIBitmap*>;
 #endif
 
-// `dest` must be non-null.
+// `dest` must be non-null. `clipping` is optional, and in device coordinates.
 void FFLCommon(FPDF_FORMHANDLE hHandle,
                FPDF_PAGE fpdf_page,
                BitmapOrCanvas dest,
@@ -193,7 +197,8 @@ void FFLCommon(FPDF_FORMHANDLE hHandle,
                int size_x,
                int size_y,
                int rotate,
-               int flags) {
+               int flags,
+               const FS_RECTF* clipping) {
   if (!hHandle) {
     return;
   }
@@ -228,6 +233,13 @@ void FFLCommon(FPDF_FORMHANDLE hHandle,
 
   const FX_RECT rect(start_x, start_y, start_x + size_x, start_y + size_y);
   CFX_Matrix matrix = pPage->GetDisplayMatrixForRect(rect, rotate);
+  FX_RECT clip_rect = rect;
+  if (clipping) {
+    clip_rect.Intersect(CFXFloatRectFromFSRectF(*clipping).GetOuterRect());
+    if (clip_rect.IsEmpty()) {
+      return;
+    }
+  }
 
   auto pDevice = std::make_unique<CFX_DefaultRenderDevice>();
   if (dest_is_bitmap) {
@@ -245,7 +257,7 @@ void FFLCommon(FPDF_FORMHANDLE hHandle,
 
   {
     CFX_RenderDevice::StateRestorer restorer(pDevice.get());
-    pDevice->SetClip_Rect(rect);
+    pDevice->SetClip_Rect(clip_rect);
 
     CPDF_RenderOptions options;
     options.GetOptions().bClearType = !!(flags & FPDF_LCD_TEXT);
@@ -260,11 +272,28 @@ void FFLCommon(FPDF_FORMHANDLE hHandle,
         pdfium::MakeRetain<CPDF_OCContext>(pPDFDoc, CPDF_OCContext::kView));
 
     if (pPageView) {
-      pPageView->PageView_OnDraw(pDevice.get(), matrix, &options, rect);
+      pPageView->PageView_OnDraw(pDevice.get(), matrix, &options, clip_rect);
     }
   }
 }
 
+// Kills focus first, so a focused field's edit gets committed rather than
+// overwriting the new values later. Fails if the focused field keeps focus.
+int SetFieldValuesCommon(
+    CPDFSDK_FormFillEnvironment* pFormFillEnv,
+    pdfium::span<const std::pair<WideString, WideString>> values) {
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(pFormFillEnv);
+  if (pFormFillEnv->GetFocusAnnot() && !pFormFillEnv->KillFocusAnnot({})) {
+    return -1;
+  }
+  const size_t count =
+      pFormFillEnv->GetInteractiveForm()->SetFieldValues(values);
+  if (count) {
+    pFormFillEnv->SetChangeMark();
+  }
+  return pdfium::saturated_cast<int>(count);
+}
+
 // Returns true if formfill version is correctly set. See |version| in
 // FPDF_FORMFILLINFO for details regarding correct version.
 bool CheckFormfillVersion(FPDF_FORMFILLINFO* formInfo) {
@@ -417,10 +446,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnMouseMove(FPDF_FORMHANDLE hHandle,
                                                      double page_x,
                                                      double page_y) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnMouseMove(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnMouseMove(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
@@ -435,10 +468,14 @@ FORM_OnMouseWheel(FPDF_FORMHANDLE hHandle,
   }
 
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnMouseWheel(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFXPointFFromFSPointF(*page_coord), CFX_Vector(delta_x, delta_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnMouseWheel(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFXPointFFromFSPointF(*page_coord), CFX_Vector(delta_x, delta_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnFocus(FPDF_FORMHANDLE hHandle,
@@ -447,10 +484,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnFocus(FPDF_FORMHANDLE hHandle,
                                                  double page_x,
                                                  double page_y) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnFocus(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnFocus(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnLButtonDown(FPDF_FORMHANDLE hHandle,
@@ -463,10 +504,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnLButtonDown(FPDF_FORMHANDLE hHandle,
           static_cast<int>(round(page_y)));
 #endif  // PDF_ENABLE_CLICK_LOGGING
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnLButtonDown(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnLButtonDown(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnLButtonUp(FPDF_FORMHANDLE hHandle,
@@ -479,10 +524,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnLButtonUp(FPDF_FORMHANDLE hHandle,
           static_cast<int>(round(page_y)));
 #endif  // PDF_ENABLE_CLICK_LOGGING
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnLButtonUp(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnLButtonUp(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
@@ -496,10 +545,14 @@ FORM_OnLButtonDoubleClick(FPDF_FORMHANDLE hHandle,
           static_cast<int>(round(page_x)), static_cast<int>(round(page_y)));
 #endif  // PDF_ENABLE_CLICK_LOGGING
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnLButtonDblClk(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnLButtonDblClk(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnRButtonDown(FPDF_FORMHANDLE hHandle,
@@ -512,10 +565,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnRButtonDown(FPDF_FORMHANDLE hHandle,
           static_cast<int>(round(page_y)));
 #endif  // PDF_ENABLE_CLICK_LOGGING
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnRButtonDown(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnRButtonDown(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnRButtonUp(FPDF_FORMHANDLE hHandle,
@@ -528,10 +585,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnRButtonUp(FPDF_FORMHANDLE hHandle,
           static_cast<int>(round(page_y)));
 #endif  // PDF_ENABLE_CLICK_LOGGING
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnRButtonUp(
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
-             CFX_PointF(page_x, page_y));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnRButtonUp(
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier),
+      CFX_PointF(page_x, page_y));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnKeyDown(FPDF_FORMHANDLE hHandle,
@@ -539,10 +600,14 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnKeyDown(FPDF_FORMHANDLE hHandle,
                                                    int nKeyCode,
                                                    int modifier) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnKeyDown(
-             static_cast<FWL_VKEYCODE>(nKeyCode),
-             Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnKeyDown(
+      static_cast<FWL_VKEYCODE>(nKeyCode),
+      Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier));
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnKeyUp(FPDF_FORMHANDLE hHandle,
@@ -557,9 +622,13 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_OnChar(FPDF_FORMHANDLE hHandle,
                                                 int nChar,
                                                 int modifier) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView &&
-         pPageView->OnChar(
-             nChar, Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier));
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->OnChar(
+      nChar, Mask<FWL_EVENTFLAG>::FromUnderlyingUnchecked(modifier));
 }
 
 FPDF_EXPORT unsigned long FPDF_CALLCONV
@@ -600,6 +669,8 @@ FORM_ReplaceAndKeepSelection(FPDF_FORMHANDLE hHandle,
   if (!pPageView) {
     return;
   }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
   // SAFETY: required from caller.
   pPageView->ReplaceAndKeepSelection(
       UNSAFE_BUFFERS(WideStringFromFPDFWideString(wsText)));
@@ -612,6 +683,8 @@ FPDF_EXPORT void FPDF_CALLCONV FORM_ReplaceSelection(FPDF_FORMHANDLE hHandle,
   if (!pPageView) {
     return;
   }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
   // SAFETY: required from caller.
   pPageView->ReplaceSelection(
       UNSAFE_BUFFERS(WideStringFromFPDFWideString(wsText)));
@@ -620,7 +693,12 @@ FPDF_EXPORT void FPDF_CALLCONV FORM_ReplaceSelection(FPDF_FORMHANDLE hHandle,
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_SelectAllText(FPDF_FORMHANDLE hHandle,
                                                        FPDF_PAGE page) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView && pPageView->SelectAllText();
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->SelectAllText();
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_CanUndo(FPDF_FORMHANDLE hHandle,
@@ -647,6 +725,8 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_Undo(FPDF_FORMHANDLE hHandle,
   if (!pPageView) {
     return false;
   }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
   return pPageView->Undo();
 }
 
@@ -656,6 +736,8 @@ FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV FORM_Redo(FPDF_FORMHANDLE hHandle,
   if (!pPageView) {
     return false;
   }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
   return pPageView->Redo();
 }
 
@@ -666,6 +748,7 @@ FORM_ForceToKillFocus(FPDF_FORMHANDLE hHandle) {
   if (!pFormFillEnv) {
     return false;
   }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(pFormFillEnv);
   return pFormFillEnv->KillFocusAnnot({});
 }
 
@@ -745,6 +828,7 @@ FORM_SetFocusedAnnot(FPDF_FORMHANDLE handle, FPDF_ANNOTATION annot) {
     return false;
   }
 
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(form_fill_env);
   return form_fill_env->SetFocusAnnot(cpdfsdk_annot);
 }
 
@@ -767,7 +851,30 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_FFLDraw(FPDF_FORMHANDLE hHandle,
       pdfium::WrapRetain(cbitmap));
 #endif
   FFLCommon(hHandle, page, cbitmap, start_x, start_y, size_x, size_y, rotate,
-            flags);
+            flags, /*clipping=*/nullptr);
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDF_FFLDrawWithClip(FPDF_FORMHANDLE hHandle,
+                                                    FPDF_BITMAP bitmap,
+                                                    FPDF_PAGE page,
+                                                    int start_x,
+                                                    int start_y,
+                                                    int size_x,
+                                                    int size_y,
+                                                    int rotate,
+                                                    int flags,
+                                                    const FS_RECTF* clipping) {
+  CFX_DIBitmap* cbitmap = CFXDIBitmapFromFPDFBitmap(bitmap);
+  if (!cbitmap) {
+    return;
+  }
+
+#if defined(PDF_USE_SKIA)
+  CFX_DIBitmap::ScopedPremultiplier scoped_premultiplier(
+      pdfium::WrapRetain(cbitmap));
+#endif
+  FFLCommon(hHandle, page, cbitmap, start_x, start_y, size_x, size_y, rotate,
+            flags, clipping);
 }
 
 #if defined(PDF_USE_SKIA)
@@ -786,7 +893,7 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_FFLDrawSkia(FPDF_FORMHANDLE hHandle,
   }
 
   FFLCommon(hHandle, page, sk_canvas, start_x, start_y, size_x, size_y, rotate,
-            flags);
+            flags, /*clipping=*/nullptr);
 }
 #endif  // defined(PDF_USE_SKIA)
 
@@ -928,7 +1035,12 @@ FORM_SetIndexSelected(FPDF_FORMHANDLE hHandle,
                       int index,
                       FPDF_BOOL selected) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
-  return pPageView && pPageView->SetIndexSelected(index, selected);
+  if (!pPageView) {
+    return false;
+  }
+  CPDFSDK_FormFillEnvironment::ScopedInvalidationBatch batch(
+      pPageView->GetFormFillEnv());
+  return pPageView->SetIndexSelected(index, selected);
 }
 
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
@@ -936,3 +1048,69 @@ FORM_IsIndexSelected(FPDF_FORMHANDLE hHandle, FPDF_PAGE page, int index) {
   CPDFSDK_PageView* pPageView = FormHandleToPageView(hHandle, page);
   return pPageView && pPageView->IsIndexSelected(index);
 }
+
+FPDF_EXPORT int FPDF_CALLCONV FORM_SetFieldValues(FPDF_FORMHANDLE hHandle,
+                                                  const FPDF_WIDESTRING* names,
+                                                  const FPDF_WIDESTRING* values,
+                                                  unsigned long count) {
+  CPDFSDK_FormFillEnvironment* pFormFillEnv =
+      CPDFSDKFormFillEnvironmentFromFPDFFormHandle(hHandle);
+  if (!pFormFillEnv || (count && (!names || !values))) {
+    return -1;
+  }
+
+  // SAFETY: required from caller.
+  auto names_span = UNSAFE_BUFFERS(pdfium::span(names, count));
+  auto values_span = UNSAFE_BUFFERS(pdfium::span(values, count));
+  std::vector<std::pair<WideString, WideString>> field_values;
+  field_values.reserve(count);
+  for (size_t i = 0; i < names_span.size(); ++i) {
+    if (!names_span[i] || !values_span[i]) {
+      return -1;
+    }
+    // SAFETY: required from caller.
+    field_values.emplace_back(
+        UNSAFE_BUFFERS(WideStringFromFPDFWideString(names_span[i])),
+        UNSAFE_BUFFERS(WideStringFromFPDFWideString(values_span[i])));
+  }
+  return SetFieldValuesCommon(pFormFillEnv, field_values);
+}
+
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FORM_ExportFieldValuesToFDF(FPDF_FORMHANDLE hHandle,
+                            void* buffer,
+                            unsigned long buflen) {
+  CPDFSDK_InteractiveForm* pForm = FormHandleToInteractiveForm(hHandle);
+  if (!pForm) {
+    return 0;
+  }
+
+  ByteString fdf = pForm->ExportFormToFDFTextBuf();
+  if (fdf.IsEmpty()) {
+    return 0;
+  }
+
+  // SAFETY: required from caller.
+  return NulTerminateMaybeCopyAndReturnLength(
+      fdf, UNSAFE_BUFFERS(SpanFromFPDFApiArgs(buffer, buflen)));
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FORM_ImportFieldValuesFromFDF(FPDF_FORMHANDLE hHandle,
+                              const void* data,
+                              unsigned long size) {
+  CPDFSDK_FormFillEnvironment* pFormFillEnv =
+      CPDFSDKFormFillEnvironmentFromFPDFFormHandle(hHandle);
+  if (!pFormFillEnv || !data) {
+    return -1;
+  }
+
+  // SAFETY: required from caller.
+  std::optional<std::vector<std::pair<WideString, WideString>>> values =
+      CPDFSDK_InteractiveForm::ParseFDFFieldValues(UNSAFE_BUFFERS(
+          pdfium::span(static_cast<const uint8_t*>(data), size)));
+  if (!values.has_value()) {
+    return -1;
+  }
+  return SetFieldValuesCommon(pFormFillEnv, values.value());
+}
@@ -2,7 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <iterator>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "build/build_config.h"
@@ -39,6 +42,70 @@ static constexpr int kModifier = FWL_EVENTFLAG_MetaKey;
 static constexpr int kModifier = FWL_EVENTFLAG_ControlKey;
 #endif
 
+std::wstring GetFieldValue(FPDF_FORMHANDLE form_handle,
+                           FPDF_PAGE page,
+                           int annot_index) {
+  ScopedFPDFAnnotation annot(FPDFPage_GetAnnot(page, annot_index));
+  CHECK(annot);
+  unsigned long length_bytes =
+      FPDFAnnot_GetFormFieldValue(form_handle, annot.get(), nullptr, 0);
+  std::vector<FPDF_WCHAR> buf = GetFPDFWideStringBuffer(length_bytes);
+  FPDFAnnot_GetFormFieldValue(form_handle, annot.get(), buf.data(),
+                              length_bytes);
+  return GetPlatformWString(buf.data());
+}
+
+// Records FFI_Invalidate() calls, along with the focused text at the time,
+// and lets tests fire timers on demand.
+class InvalidationRecordingDelegate final : public EmbedderTest::Delegate {
+ public:
+  struct Invalidation {
+    FPDF_PAGE page;
+    CFX_FloatRect rect;
+    unsigned long focused_text_bytes;
+  };
+
+  void set_form_handle(FPDF_FORMHANDLE form_handle) {
+    form_handle_ = form_handle;
+  }
+
+  void Invalidate(FPDF_PAGE page,
+                  double left,
+                  double top,
+                  double right,
+                  double bottom) override {
+    CFX_FloatRect rect(left, bottom, right, top);
+    rect.Normalize();
+    invalidations_.push_back(
+        {page, rect, FORM_GetFocusedText(form_handle_, page, nullptr, 0)});
+  }
+
+  int SetTimer(int msecs, TimerCallback fn) override {
+    timers_[++next_timer_id_] = fn;
+    return next_timer_id_;
+  }
+
+  void KillTimer(int id) override { timers_.erase(id); }
+
+  void FireTimers() {
+    // Copy, as timers may get killed or set while firing.
+    const std::map<int, TimerCallback> timers = timers_;
+    for (const auto& [id, fn] : timers) {
+      fn(id);
+    }
+  }
+
+  std::vector<Invalidation> TakeInvalidations() {
+    return std::exchange(invalidations_, {});
+  }
+
+ private:
+  FPDF_FORMHANDLE form_handle_ = nullptr;
+  std::map<int, TimerCallback> timers_;
+  int next_timer_id_ = 0;
+  std::vector<Invalidation> invalidations_;
+};
+
 }  // namespace
 
 using FPDFFormFillEmbedderTest = EmbedderTest;
@@ -1372,6 +1439,45 @@ TEST_F(FPDFFormFillEmbedderTest, Bug1477093) {
   delegate.AdvanceTime(1000);
 }
 
+TEST_F(FPDFFormFillEmbedderTest, SetFieldValuesCalculatesOnce) {
+  ASSERT_TRUE(OpenDocument("bulk_calculate.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+  EXPECT_EQ(L"3", GetFieldValue(form_handle(), page.get(), 2));
+  EXPECT_EQ(L"0", GetFieldValue(form_handle(), page.get(), 3));
+
+  ScopedFPDFWideString name_a = GetFPDFWideString(L"A");
+  ScopedFPDFWideString name_b = GetFPDFWideString(L"B");
+  ScopedFPDFWideString name_missing = GetFPDFWideString(L"Missing");
+  ScopedFPDFWideString value_a = GetFPDFWideString(L"30");
+  ScopedFPDFWideString value_b = GetFPDFWideString(L"12");
+  const FPDF_WIDESTRING names[] = {name_a.get(), name_missing.get(),
+                                   name_b.get()};
+  const FPDF_WIDESTRING values[] = {value_a.get(), value_a.get(),
+                                    value_b.get()};
+  EXPECT_EQ(2, FORM_SetFieldValues(form_handle(), names, values, 3));
+
+  // The calculation saw both new values, and only ran once.
+  EXPECT_EQ(L"30", GetFieldValue(form_handle(), page.get(), 0));
+  EXPECT_EQ(L"12", GetFieldValue(form_handle(), page.get(), 1));
+  EXPECT_EQ(L"42", GetFieldValue(form_handle(), page.get(), 2));
+  EXPECT_EQ(L"1", GetFieldValue(form_handle(), page.get(), 3));
+
+  // Importing FDF goes through the same path.
+  static constexpr char kFDF[] =
+      "%FDF-1.2\n"
+      "1 0 obj\n"
+      "<< /FDF << /Fields [<< /T (A) /V (5) >> << /T (B) /V (6) >>] >> >>\n"
+      "endobj\n"
+      "trailer\n"
+      "<< /Root 1 0 R >>\n"
+      "%%EOF\n";
+  EXPECT_EQ(2, FORM_ImportFieldValuesFromFDF(form_handle(), kFDF,
+                                             sizeof(kFDF) - 1));
+  EXPECT_EQ(L"11", GetFieldValue(form_handle(), page.get(), 2));
+  EXPECT_EQ(L"2", GetFieldValue(form_handle(), page.get(), 3));
+}
+
 #endif  // PDF_ENABLE_V8
 
 TEST_F(FPDFFormFillEmbedderTest, FormText) {
@@ -1659,6 +1765,118 @@ TEST_F(FPDFFormFillEmbedderTest, RemoveFormFieldHighlight) {
   CompareBitmap(bitmap3.get(), 300, 300, TextFormChecksum());
 }
 
+TEST_F(FPDFFormFillEmbedderTest, FFLDrawWithClip) {
+  ASSERT_TRUE(OpenDocument("text_form.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  auto render_with_clip = [&](const FS_RECTF* clipping) {
+    ScopedFPDFBitmap bitmap(FPDFBitmap_Create(300, 300, 0));
+    FPDFBitmap_FillRect(bitmap.get(), 0, 0, 300, 300, 0xFFFFFFFF);
+    FPDF_RenderPageBitmap(bitmap.get(), page.get(), 0, 0, 300, 300, 0, 0);
+    FPDF_FFLDrawWithClip(form_handle(), bitmap.get(), page.get(), 0, 0, 300,
+                         300, 0, 0, clipping);
+    return HashBitmap(bitmap.get());
+  };
+
+  ScopedFPDFBitmap page_only = RenderPage(page.get());
+  const std::string page_only_checksum = HashBitmap(page_only.get());
+  ASSERT_NE(TextFormChecksum(), page_only_checksum);
+
+  // No clip, or a clip around the text field, draws the field as usual.
+  EXPECT_EQ(TextFormChecksum(), render_with_clip(nullptr));
+  const FS_RECTF field_clip = {90.0f, 160.0f, 210.0f, 210.0f};
+  EXPECT_EQ(TextFormChecksum(), render_with_clip(&field_clip));
+
+  // A clip away from the text field, or an empty one, draws nothing.
+  const FS_RECTF corner_clip = {0.0f, 0.0f, 50.0f, 50.0f};
+  EXPECT_EQ(page_only_checksum, render_with_clip(&corner_clip));
+  const FS_RECTF empty_clip = {120.0f, 180.0f, 120.0f, 180.0f};
+  EXPECT_EQ(page_only_checksum, render_with_clip(&empty_clip));
+
+  // Same after an edit, which only dirties the text field.
+  FORM_OnMouseMove(form_handle(), page.get(), 0, 120.0, 120.0);
+  FORM_OnLButtonDown(form_handle(), page.get(), 0, 120.0, 120.0);
+  FORM_OnLButtonUp(form_handle(), page.get(), 0, 120.0, 120.0);
+  FORM_OnChar(form_handle(), page.get(), 'A', 0);
+  ScopedFPDFBitmap edited = RenderLoadedPage(page.get());
+  EXPECT_EQ(HashBitmap(edited.get()), render_with_clip(&field_clip));
+}
+
+TEST_F(FPDFFormFillEmbedderTest, CoalescedInvalidations) {
+  InvalidationRecordingDelegate delegate;
+  SetDelegate(&delegate);
+  ASSERT_TRUE(OpenDocument("text_form.pdf"));
+  delegate.set_form_handle(form_handle());
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  FORM_OnMouseMove(form_handle(), page.get(), 0, 120.0, 120.0);
+  FORM_OnLButtonDown(form_handle(), page.get(), 0, 120.0, 120.0);
+  FORM_OnLButtonUp(form_handle(), page.get(), 0, 120.0, 120.0);
+  delegate.TakeInvalidations();
+
+  // Each keystroke invalidates the field several times. The embedder gets
+  // one merged rect for the page, once the edit is complete.
+  const FPDF_WCHAR kText[] = {'A', 'B', 'C', 'D'};
+  for (size_t i = 0; i < std::size(kText); ++i) {
+    FORM_OnChar(form_handle(), page.get(), kText[i], 0);
+    std::vector<InvalidationRecordingDelegate::Invalidation> invalidations =
+        delegate.TakeInvalidations();
+    ASSERT_EQ(1u, invalidations.size());
+    EXPECT_EQ(page.get(), invalidations[0].page);
+    EXPECT_TRUE(invalidations[0].rect.Contains(CFX_PointF(120.0f, 120.0f)));
+    // The typed characters and the terminating NUL, in UTF-16LE.
+    EXPECT_EQ((i + 2) * sizeof(FPDF_WCHAR),
+              invalidations[0].focused_text_bytes);
+  }
+
+  // Invalidations from outside of FORM_* calls, like those from the caret
+  // flashing, reach the embedder right away.
+  delegate.FireTimers();
+  std::vector<InvalidationRecordingDelegate::Invalidation> invalidations =
+      delegate.TakeInvalidations();
+  ASSERT_FALSE(invalidations.empty());
+  EXPECT_EQ(page.get(), invalidations[0].page);
+}
+
+TEST_F(FPDFFormFillEmbedderTest, FieldValuesFDFRoundTrip) {
+  ASSERT_TRUE(OpenDocument("text_form_multiple.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  EXPECT_EQ(0u, FORM_ExportFieldValuesToFDF(nullptr, nullptr, 0));
+  EXPECT_EQ(-1, FORM_ImportFieldValuesFromFDF(nullptr, "", 0));
+  EXPECT_EQ(-1, FORM_ImportFieldValuesFromFDF(form_handle(), "Not FDF", 7));
+  EXPECT_EQ(-1, FORM_SetFieldValues(nullptr, nullptr, nullptr, 0));
+  EXPECT_EQ(-1, FORM_SetFieldValues(form_handle(), nullptr, nullptr, 1));
+  EXPECT_EQ(0, FORM_SetFieldValues(form_handle(), nullptr, nullptr, 0));
+
+  ScopedFPDFWideString name = GetFPDFWideString(L"Text Box");
+  ScopedFPDFWideString exported = GetFPDFWideString(L"Exported");
+  ScopedFPDFWideString changed = GetFPDFWideString(L"Changed");
+  const FPDF_WIDESTRING names[] = {name.get()};
+  const FPDF_WIDESTRING exported_values[] = {exported.get()};
+  const FPDF_WIDESTRING changed_values[] = {changed.get()};
+  ASSERT_EQ(1, FORM_SetFieldValues(form_handle(), names, exported_values, 1));
+
+  unsigned long length =
+      FORM_ExportFieldValuesToFDF(form_handle(), nullptr, 0);
+  ASSERT_GT(length, 0u);
+  std::vector<char> fdf(length);
+  ASSERT_EQ(length,
+            FORM_ExportFieldValuesToFDF(form_handle(), fdf.data(), length));
+  EXPECT_EQ('\0', fdf.back());
+
+  ASSERT_EQ(1, FORM_SetFieldValues(form_handle(), names, changed_values, 1));
+  EXPECT_EQ(L"Changed", GetFieldValue(form_handle(), page.get(), 0));
+
+  // Every exported field gets set again, including the unchanged ones.
+  EXPECT_GT(
+      FORM_ImportFieldValuesFromFDF(form_handle(), fdf.data(), length - 1), 0);
+  EXPECT_EQ(L"Exported", GetFieldValue(form_handle(), page.get(), 0));
+}
+
 TEST_F(FPDFFormFillEmbedderTest, HasFormInfoNone) {
   ASSERT_TRUE(OpenDocument("hello_world.pdf"));
   EXPECT_EQ(FORMTYPE_NONE, FPDF_GetFormType(document()));
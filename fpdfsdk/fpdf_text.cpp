@@ -9,13 +9,17 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "build/build_config.h"
 #include "core/fpdfapi/font/cpdf_font.h"
 #include "core/fpdfapi/page/cpdf_page.h"
 #include "core/fpdfapi/page/cpdf_textobject.h"
+#include "core/fpdfapi/parser/cpdf_dictionary.h"
+#include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fpdfdoc/cpdf_viewerpreferences.h"
+#include "core/fpdftext/cpdf_doctextsearch.h"
 #include "core/fpdftext/cpdf_linkextract.h"
 #include "core/fpdftext/cpdf_textpage.h"
 #include "core/fpdftext/cpdf_textpagefind.h"
@@ -55,6 +59,30 @@ FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV FPDFText_LoadPage(FPDF_PAGE page) {
   return FPDFTextPageFromCPDFTextPage(textpage.release());
 }
 
+FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV
+FPDFText_LoadTextOnlyPage(FPDF_DOCUMENT document, int page_index) {
+  CPDF_Document* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc || page_index < 0 || page_index >= doc->GetPageCount()) {
+    return nullptr;
+  }
+
+  RetainPtr<CPDF_Dictionary> dict = doc->GetMutablePageDictionary(page_index);
+  if (!dict) {
+    return nullptr;
+  }
+
+  auto page = pdfium::MakeRetain<CPDF_Page>(doc, std::move(dict));
+  page->SetParseMode(CPDF_PageObjectHolder::ParseMode::kTextOnly);
+  page->ParseContent();
+
+  CPDF_ViewerPreferences viewRef(doc);
+  auto textpage =
+      std::make_unique<CPDF_TextPage>(std::move(page), viewRef.IsDirectionR2L());
+
+  // Caller takes ownership.
+  return FPDFTextPageFromCPDFTextPage(textpage.release());
+}
+
 FPDF_EXPORT void FPDF_CALLCONV FPDFText_ClosePage(FPDF_TEXTPAGE text_page) {
   // PDFium takes ownership.
   std::unique_ptr<CPDF_TextPage> textpage_deleter(
@@ -504,6 +532,108 @@ FPDF_EXPORT void FPDF_CALLCONV FPDFText_FindClose(FPDF_SCHHANDLE handle) {
       CPDFTextPageFindFromFPDFSchHandle(handle));
 }
 
+FPDF_EXPORT FPDF_DOCSEARCH FPDF_CALLCONV
+FPDFText_LoadDocSearch(FPDF_DOCUMENT document) {
+  CPDF_Document* doc = CPDFDocumentFromFPDFDocument(document);
+  if (!doc) {
+    return nullptr;
+  }
+
+  CPDF_ViewerPreferences viewRef(doc);
+  auto search =
+      std::make_unique<CPDF_DocTextSearch>(doc, viewRef.IsDirectionR2L());
+
+  // Caller takes ownership.
+  return FPDFDocSearchFromCPDFDocTextSearch(search.release());
+}
+
+FPDF_EXPORT void FPDF_CALLCONV FPDFText_CloseDocSearch(FPDF_DOCSEARCH handle) {
+  // Take ownership back from caller and destroy.
+  std::unique_ptr<CPDF_DocTextSearch> search(
+      CPDFDocTextSearchFromFPDFDocSearch(handle));
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_DocSearchFind(FPDF_DOCSEARCH handle,
+                       const FPDF_WIDESTRING* terms,
+                       int term_count,
+                       unsigned long flags) {
+  CPDF_DocTextSearch* search = CPDFDocTextSearchFromFPDFDocSearch(handle);
+  if (!search || !terms || term_count <= 0) {
+    return -1;
+  }
+
+  // SAFETY: required from caller.
+  auto terms_span = UNSAFE_BUFFERS(
+      pdfium::span(terms, static_cast<size_t>(term_count)));
+  std::vector<WideString> find_what;
+  find_what.reserve(terms_span.size());
+  for (FPDF_WIDESTRING term : terms_span) {
+    if (!term) {
+      return -1;
+    }
+    // SAFETY: required from caller.
+    find_what.push_back(UNSAFE_BUFFERS(WideStringFromFPDFWideString(term)));
+  }
+
+  CPDF_DocTextSearch::Options options;
+  options.bMatchCase = !!(flags & FPDF_MATCHCASE);
+  options.bMatchWholeWord = !!(flags & FPDF_MATCHWHOLEWORD);
+  search->Find(find_what, options);
+  return fxcrt::CollectionSize<int>(search->results());
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_DocSearchGetMatch(FPDF_DOCSEARCH handle,
+                           int match_index,
+                           int* page_index,
+                           int* term_index,
+                           int* char_index,
+                           int* char_count) {
+  CPDF_DocTextSearch* search = CPDFDocTextSearchFromFPDFDocSearch(handle);
+  if (!search || !page_index || !term_index || !char_index || !char_count ||
+      !fxcrt::IndexInBounds(search->results(), match_index)) {
+    return false;
+  }
+
+  const CPDF_DocTextSearch::Result& result = search->results()[match_index];
+  *page_index = result.page_index;
+  *term_index = result.term_index;
+  *char_index = result.char_index;
+  *char_count = result.char_count;
+  return true;
+}
+
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_DocSearchCountRects(FPDF_DOCSEARCH handle, int match_index) {
+  CPDF_DocTextSearch* search = CPDFDocTextSearchFromFPDFDocSearch(handle);
+  return search ? search->CountRects(match_index) : -1;
+}
+
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_DocSearchGetRect(FPDF_DOCSEARCH handle,
+                          int rect_index,
+                          double* left,
+                          double* top,
+                          double* right,
+                          double* bottom) {
+  CPDF_DocTextSearch* search = CPDFDocTextSearchFromFPDFDocSearch(handle);
+  if (!search || !left || !top || !right || !bottom) {
+    return false;
+  }
+
+  CFX_FloatRect rect;
+  if (!search->GetRect(rect_index, &rect)) {
+    return false;
+  }
+
+  *left = rect.left;
+  *top = rect.top;
+  *right = rect.right;
+  *bottom = rect.bottom;
+  return true;
+}
+
 // web link
 FPDF_EXPORT FPDF_PAGELINK FPDF_CALLCONV
 FPDFLink_LoadWebLinks(FPDF_TEXTPAGE text_page) {
@@ -278,6 +278,199 @@ TEST_F(FPDFTextEmbedderTest, Text) {
   EXPECT_EQ(0xbdbd, buffer[10]);
 }
 
+TEST_F(FPDFTextEmbedderTest, CharIndexAtPosForEveryChar) {
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  ScopedFPDFTextPage textpage(FPDFText_LoadPage(page.get()));
+  ASSERT_TRUE(textpage);
+
+  const int char_count = FPDFText_CountChars(textpage.get());
+  ASSERT_EQ(kHelloGoodbyeTextSize - 1, char_count);
+  for (int i = 0; i < char_count; ++i) {
+    double left;
+    double right;
+    double bottom;
+    double top;
+    ASSERT_TRUE(
+        FPDFText_GetCharBox(textpage.get(), i, &left, &right, &bottom, &top));
+    if (right <= left || top <= bottom) {
+      continue;
+    }
+
+    // The first char whose box contains the point wins, so the result is never
+    // past `i`, and its box must contain the point.
+    const double x = (left + right) / 2;
+    const double y = (bottom + top) / 2;
+    const int index =
+        FPDFText_GetCharIndexAtPos(textpage.get(), x, y, 0.0, 0.0);
+    ASSERT_GE(index, 0);
+    EXPECT_LE(index, i);
+    ASSERT_TRUE(FPDFText_GetCharBox(textpage.get(), index, &left, &right,
+                                    &bottom, &top));
+    EXPECT_GE(x, left);
+    EXPECT_LE(x, right);
+    EXPECT_GE(y, bottom);
+    EXPECT_LE(y, top);
+  }
+}
+
+TEST_F(FPDFTextEmbedderTest, LoadTextOnlyPage) {
+  ASSERT_TRUE(OpenDocument("text_with_graphics.pdf"));
+  ScopedPage page = LoadScopedPage(0);
+  ASSERT_TRUE(page);
+
+  ScopedFPDFTextPage textpage(FPDFText_LoadPage(page.get()));
+  ASSERT_TRUE(textpage);
+  ScopedFPDFTextPage text_only_page(FPDFText_LoadTextOnlyPage(document(), 0));
+  ASSERT_TRUE(text_only_page);
+
+  const int char_count = FPDFText_CountChars(textpage.get());
+  ASSERT_GT(char_count, 0);
+  ASSERT_EQ(char_count, FPDFText_CountChars(text_only_page.get()));
+  for (int i = 0; i < char_count; ++i) {
+    EXPECT_EQ(FPDFText_GetUnicode(textpage.get(), i),
+              FPDFText_GetUnicode(text_only_page.get(), i));
+
+    double left;
+    double right;
+    double bottom;
+    double top;
+    ASSERT_TRUE(
+        FPDFText_GetCharBox(textpage.get(), i, &left, &right, &bottom, &top));
+    double text_only_left;
+    double text_only_right;
+    double text_only_bottom;
+    double text_only_top;
+    ASSERT_TRUE(FPDFText_GetCharBox(text_only_page.get(), i, &text_only_left,
+                                    &text_only_right, &text_only_bottom,
+                                    &text_only_top));
+    EXPECT_DOUBLE_EQ(left, text_only_left);
+    EXPECT_DOUBLE_EQ(right, text_only_right);
+    EXPECT_DOUBLE_EQ(bottom, text_only_bottom);
+    EXPECT_DOUBLE_EQ(top, text_only_top);
+  }
+
+  std::vector<unsigned short> buffer(char_count + 1);
+  std::vector<unsigned short> text_only_buffer(char_count + 1);
+  ASSERT_EQ(char_count + 1, FPDFText_GetText(textpage.get(), 0, char_count,
+                                             buffer.data()));
+  ASSERT_EQ(char_count + 1,
+            FPDFText_GetText(text_only_page.get(), 0, char_count,
+                             text_only_buffer.data()));
+  EXPECT_EQ(buffer, text_only_buffer);
+}
+
+TEST_F(FPDFTextEmbedderTest, LoadTextOnlyPageBadParams) {
+  EXPECT_FALSE(FPDFText_LoadTextOnlyPage(nullptr, 0));
+
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  EXPECT_FALSE(FPDFText_LoadTextOnlyPage(document(), -1));
+  EXPECT_FALSE(FPDFText_LoadTextOnlyPage(document(), 1));
+}
+
+TEST_F(FPDFTextEmbedderTest, DocSearch) {
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  ScopedFPDFDocSearch search(FPDFText_LoadDocSearch(document()));
+  ASSERT_TRUE(search);
+
+  ScopedFPDFWideString world = GetFPDFWideString(L"world");
+  ScopedFPDFWideString goodbye_caps = GetFPDFWideString(L"GOODBYE");
+  ScopedFPDFWideString nope = GetFPDFWideString(L"nope");
+  ScopedFPDFWideString across_lines = GetFPDFWideString(L"world! Goodbye");
+  ScopedFPDFWideString world_substr = GetFPDFWideString(L"orld");
+
+  int page_index = -1;
+  int term_index = -1;
+  int char_index = -1;
+  int char_count = -1;
+  {
+    // Matches of all terms, ordered by position.
+    const FPDF_WIDESTRING terms[] = {world.get(), goodbye_caps.get(),
+                                     nope.get(), across_lines.get()};
+    ASSERT_EQ(4, FPDFText_DocSearchFind(search.get(), terms, 4, 0));
+
+    static constexpr int kExpected[][3] = {
+        {0, 7, 5}, {3, 7, 15}, {1, 15, 7}, {0, 24, 5}};
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(FPDFText_DocSearchGetMatch(search.get(), i, &page_index,
+                                             &term_index, &char_index,
+                                             &char_count));
+      EXPECT_EQ(0, page_index);
+      EXPECT_EQ(kExpected[i][0], term_index);
+      EXPECT_EQ(kExpected[i][1], char_index);
+      EXPECT_EQ(kExpected[i][2], char_count);
+    }
+    EXPECT_FALSE(FPDFText_DocSearchGetMatch(search.get(), 4, &page_index,
+                                            &term_index, &char_index,
+                                            &char_count));
+  }
+  {
+    // Rects match the ones for the same range on a regular text page.
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+    ScopedFPDFTextPage textpage(FPDFText_LoadPage(page.get()));
+    ASSERT_TRUE(textpage);
+
+    const int rect_count = FPDFText_CountRects(textpage.get(), 7, 15);
+    ASSERT_GT(rect_count, 0);
+    ASSERT_EQ(rect_count, FPDFText_DocSearchCountRects(search.get(), 1));
+    for (int i = 0; i < rect_count; ++i) {
+      double expected[4];
+      double actual[4];
+      ASSERT_TRUE(FPDFText_GetRect(textpage.get(), i, &expected[0],
+                                   &expected[1], &expected[2], &expected[3]));
+      ASSERT_TRUE(FPDFText_DocSearchGetRect(search.get(), i, &actual[0],
+                                            &actual[1], &actual[2],
+                                            &actual[3]));
+      for (int j = 0; j < 4; ++j) {
+        EXPECT_DOUBLE_EQ(expected[j], actual[j]);
+      }
+    }
+    double left = 0;
+    EXPECT_FALSE(FPDFText_DocSearchGetRect(search.get(), rect_count, &left,
+                                           &left, &left, &left));
+  }
+  {
+    // Flags behave like FPDFText_FindStart().
+    const FPDF_WIDESTRING terms[] = {goodbye_caps.get(), world_substr.get()};
+    EXPECT_EQ(0,
+              FPDFText_DocSearchFind(search.get(), terms, 2,
+                                     FPDF_MATCHCASE | FPDF_MATCHWHOLEWORD));
+    EXPECT_EQ(1, FPDFText_DocSearchFind(search.get(), terms, 2,
+                                        FPDF_MATCHWHOLEWORD));
+    EXPECT_EQ(2, FPDFText_DocSearchFind(search.get(), terms, 2,
+                                        FPDF_MATCHCASE));
+  }
+}
+
+TEST_F(FPDFTextEmbedderTest, DocSearchBadParams) {
+  EXPECT_FALSE(FPDFText_LoadDocSearch(nullptr));
+  FPDFText_CloseDocSearch(nullptr);
+
+  ScopedFPDFWideString world = GetFPDFWideString(L"world");
+  const FPDF_WIDESTRING terms[] = {world.get(), nullptr};
+  EXPECT_EQ(-1, FPDFText_DocSearchFind(nullptr, terms, 1, 0));
+  EXPECT_EQ(-1, FPDFText_DocSearchCountRects(nullptr, 0));
+
+  ASSERT_TRUE(OpenDocument("hello_world.pdf"));
+  ScopedFPDFDocSearch search(FPDFText_LoadDocSearch(document()));
+  ASSERT_TRUE(search);
+  EXPECT_EQ(-1, FPDFText_DocSearchFind(search.get(), nullptr, 1, 0));
+  EXPECT_EQ(-1, FPDFText_DocSearchFind(search.get(), terms, 0, 0));
+  EXPECT_EQ(-1, FPDFText_DocSearchFind(search.get(), terms, 2, 0));
+  EXPECT_EQ(-1, FPDFText_DocSearchCountRects(search.get(), 0));
+
+  ASSERT_EQ(2, FPDFText_DocSearchFind(search.get(), terms, 1, 0));
+  int value = 0;
+  EXPECT_FALSE(FPDFText_DocSearchGetMatch(search.get(), -1, &value, &value,
+                                          &value, &value));
+  EXPECT_FALSE(FPDFText_DocSearchGetMatch(search.get(), 0, nullptr, &value,
+                                          &value, &value));
+  EXPECT_EQ(-1, FPDFText_DocSearchCountRects(search.get(), 2));
+}
+
 TEST_F(FPDFTextEmbedderTest, TextVertical) {
   ASSERT_TRUE(OpenDocument("vertical_text.pdf"));
   ScopedPage page = LoadScopedPage(0);
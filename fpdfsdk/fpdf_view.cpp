@@ -29,6 +29,7 @@
 #include "core/fpdfapi/render/cpdf_pagerendercontext.h"
 #include "core/fpdfapi/render/cpdf_rendercontext.h"
 #include "core/fpdfapi/render/cpdf_renderoptions.h"
+#include "core/fpdfapi/render/cpdf_type3glyphcache.h"
 #include "core/fpdfdoc/cpdf_nametree.h"
 #include "core/fpdfdoc/cpdf_viewerpreferences.h"
 #include "core/fxcrt/cfx_read_only_span_stream.h"
@@ -242,8 +243,11 @@ FPDF_InitLibraryWithConfig(const FPDF_LIBRARY_CONFIG* config) {
 
   FX_InitializeMemoryAllocators();
   CFX_Timer::InitializeGlobals();
-  CFX_GEModule::Create(config ? config->m_pUserFontPaths : nullptr);
+  CFX_GEModule::Create(
+      config ? config->m_pUserFontPaths : nullptr,
+      config && config->version >= 5 ? config->m_pFontIndexCachePath : nullptr);
   pdfium::InitializePageModule();
+  CPDF_Type3GlyphCache::Create();
 
 #if defined(PDF_USE_SKIA)
   CFX_GlyphCache::InitializeGlobals();
@@ -283,6 +287,7 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_DestroyLibrary() {
   CFX_GlyphCache::DestroyGlobals();
 #endif
 
+  CPDF_Type3GlyphCache::Destroy();
   pdfium::DestroyPageModule();
   CFX_GEModule::Destroy();
   CFX_Timer::DestroyGlobals();
@@ -126,14 +126,19 @@ int CheckPDFiumCApi() {
     CHK(FPDFCatalog_SetLanguage);
 
     // fpdf_dataavail.h
+    CHK(FPDFAvail_CompleteAsyncRead);
     CHK(FPDFAvail_Create);
+    CHK(FPDFAvail_CreateAsync);
     CHK(FPDFAvail_Destroy);
     CHK(FPDFAvail_GetDocument);
     CHK(FPDFAvail_GetFirstPageNum);
+    CHK(FPDFAvail_GetPendingAsyncReadCount);
+    CHK(FPDFAvail_GetRequestStats);
     CHK(FPDFAvail_IsDocAvail);
     CHK(FPDFAvail_IsFormAvail);
     CHK(FPDFAvail_IsLinearized);
     CHK(FPDFAvail_IsPageAvail);
+    CHK(FPDFAvail_SetRequestPolicy);
 
     // fpdf_doc.h
     CHK(FPDFAction_GetDest);
@@ -289,6 +294,7 @@ int CheckPDFiumCApi() {
     CHK(FSDK_SetUnSpObjProcessHandler);
 
     // fpdf_flatten.h
+    CHK(FPDFDoc_Flatten);
     CHK(FPDFPage_Flatten);
 
     // fpdf_fwlevent.h - no exports.
@@ -300,10 +306,12 @@ int CheckPDFiumCApi() {
     CHK(FORM_DoDocumentJSAction);
     CHK(FORM_DoDocumentOpenAction);
     CHK(FORM_DoPageAAction);
+    CHK(FORM_ExportFieldValuesToFDF);
     CHK(FORM_ForceToKillFocus);
     CHK(FORM_GetFocusedAnnot);
     CHK(FORM_GetFocusedText);
     CHK(FORM_GetSelectedText);
+    CHK(FORM_ImportFieldValuesFromFDF);
     CHK(FORM_IsIndexSelected);
     CHK(FORM_OnAfterLoadPage);
     CHK(FORM_OnBeforeClosePage);
@@ -322,6 +330,7 @@ int CheckPDFiumCApi() {
     CHK(FORM_ReplaceAndKeepSelection);
     CHK(FORM_ReplaceSelection);
     CHK(FORM_SelectAllText);
+    CHK(FORM_SetFieldValues);
     CHK(FORM_SetFocusedAnnot);
     CHK(FORM_SetIndexSelected);
     CHK(FORM_Undo);
@@ -333,6 +342,7 @@ int CheckPDFiumCApi() {
 #if defined(PDF_USE_SKIA)
     CHK(FPDF_FFLDrawSkia);
 #endif
+    CHK(FPDF_FFLDrawWithClip);
     CHK(FPDF_GetFormType);
     CHK(FPDF_LoadXFA);
     CHK(FPDF_RemoveFormFieldHighlight);
@@ -429,9 +439,14 @@ int CheckPDFiumCApi() {
     CHK(FPDFLink_GetTextRange);
     CHK(FPDFLink_GetURL);
     CHK(FPDFLink_LoadWebLinks);
+    CHK(FPDFText_CloseDocSearch);
     CHK(FPDFText_ClosePage);
     CHK(FPDFText_CountChars);
     CHK(FPDFText_CountRects);
+    CHK(FPDFText_DocSearchCountRects);
+    CHK(FPDFText_DocSearchFind);
+    CHK(FPDFText_DocSearchGetMatch);
+    CHK(FPDFText_DocSearchGetRect);
     CHK(FPDFText_FindClose);
     CHK(FPDFText_FindNext);
     CHK(FPDFText_FindPrev);
@@ -457,7 +472,9 @@ int CheckPDFiumCApi() {
     CHK(FPDFText_HasUnicodeMapError);
     CHK(FPDFText_IsGenerated);
     CHK(FPDFText_IsHyphen);
+    CHK(FPDFText_LoadDocSearch);
     CHK(FPDFText_LoadPage);
+    CHK(FPDFText_LoadTextOnlyPage);
 
     // fpdf_thumbnail.h
     CHK(FPDFPage_GetDecodedThumbnailData);
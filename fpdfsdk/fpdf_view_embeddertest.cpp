@@ -14,6 +14,8 @@
 #include "build/build_config.h"
 #include "core/fpdfapi/parser/cpdf_document.h"
 #include "core/fxge/cfx_defaultrenderdevice.h"
+#include "core/fxge/cfx_fontcache.h"
+#include "core/fxge/cfx_gemodule.h"
 #include "fpdfsdk/cpdfsdk_helpers.h"
 #include "fpdfsdk/fpdf_view_c_api_test.h"
 #include "public/cpp/fpdf_scopers.h"
@@ -654,6 +656,32 @@ TEST_F(FPDFViewEmbedderTest, Page) {
   EXPECT_FALSE(LoadScopedPage(1));
 }
 
+TEST_F(FPDFViewEmbedderTest, EmbeddedFontFacesSharedAcrossDocuments) {
+  CFX_FontCache* font_cache = CFX_GEModule::Get()->GetFontCache();
+  font_cache->ClearEmbeddedFaces();
+
+  ASSERT_TRUE(OpenDocument("hebrew_mirrored.pdf"));
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+  }
+  CloseDocument();
+  const size_t hits = font_cache->embedded_face_stats().hits;
+  const size_t misses = font_cache->embedded_face_stats().misses;
+  EXPECT_GT(misses, 0u);
+
+  // The second document embeds the same font program, so its face comes from
+  // the pool.
+  ASSERT_TRUE(OpenDocument("hebrew_mirrored.pdf"));
+  {
+    ScopedPage page = LoadScopedPage(0);
+    ASSERT_TRUE(page);
+  }
+  CloseDocument();
+  EXPECT_GT(font_cache->embedded_face_stats().hits, hits);
+  EXPECT_EQ(misses, font_cache->embedded_face_stats().misses);
+}
+
 TEST_F(FPDFViewEmbedderTest, ViewerRefDummy) {
   ASSERT_TRUE(OpenDocument("about_blank.pdf"));
   EXPECT_TRUE(FPDF_VIEWERREF_GetPrintScaling(document()));
@@ -2277,3 +2305,43 @@ TEST_F(FPDFViewEmbedderTest, DocumentVersionInCatalog) {
   EXPECT_TRUE(FPDF_GetFileVersion(document(), &version));
   EXPECT_EQ(16, version);
 }
+
+TEST_F(FPDFViewEmbedderTest, Type3GlyphsIndependentOfRenderOrder) {
+  // The glyph in this document is drawn from the same image as the "A" glyphs
+  // in type3_blue_zones.pdf, but not snapped to the blue zone of a "B" glyph.
+  std::string file_path =
+      PathService::GetTestFilePath("type3_single_glyph.pdf");
+  ASSERT_FALSE(file_path.empty());
+  std::vector<uint8_t> file_contents = GetFileContents(file_path.c_str());
+  ASSERT_FALSE(file_contents.empty());
+  ScopedFPDFDocument other_doc(FPDF_LoadMemDocument64(
+      file_contents.data(), file_contents.size(), nullptr));
+  ASSERT_TRUE(other_doc);
+  std::string other_checksum;
+  {
+    ScopedFPDFPage other_page(FPDF_LoadPage(other_doc.get(), 0));
+    ASSERT_TRUE(other_page);
+    ScopedFPDFBitmap bitmap = RenderPage(other_page.get());
+    other_checksum = HashBitmap(bitmap.get());
+  }
+
+  // Both pages snap the top of "A" to the blue zone of "B". The pages only
+  // differ in the size of the image "A" draws, which does not change the
+  // rendering, but keeps the second page from sharing glyphs with the other
+  // document.
+  ASSERT_TRUE(OpenDocument("type3_blue_zones.pdf"));
+  std::string checksums[2];
+  for (int i = 0; i < 2; ++i) {
+    ScopedPage page = LoadScopedPage(i);
+    ASSERT_TRUE(page);
+    ScopedFPDFBitmap bitmap = RenderLoadedPage(page.get());
+    checksums[i] = HashBitmap(bitmap.get());
+  }
+  EXPECT_EQ(checksums[0], checksums[1]);
+
+  // Rendering the other document again is not affected by the snapped glyphs.
+  ScopedFPDFPage other_page(FPDF_LoadPage(other_doc.get(), 0));
+  ASSERT_TRUE(other_page);
+  ScopedFPDFBitmap bitmap = RenderPage(other_page.get());
+  EXPECT_EQ(other_checksum, HashBitmap(bitmap.get()));
+}
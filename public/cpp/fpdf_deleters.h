@@ -35,6 +35,12 @@ struct FPDFClipPathDeleter {
   }
 };
 
+struct FPDFDocSearchDeleter {
+  inline void operator()(FPDF_DOCSEARCH search) {
+    FPDFText_CloseDocSearch(search);
+  }
+};
+
 struct FPDFDocumentDeleter {
   inline void operator()(FPDF_DOCUMENT doc) { FPDF_CloseDocument(doc); }
 };
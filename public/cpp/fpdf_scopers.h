@@ -26,6 +26,10 @@ using ScopedFPDFClipPath =
     std::unique_ptr<std::remove_pointer<FPDF_CLIPPATH>::type,
                     FPDFClipPathDeleter>;
 
+using ScopedFPDFDocSearch =
+    std::unique_ptr<std::remove_pointer<FPDF_DOCSEARCH>::type,
+                    FPDFDocSearchDeleter>;
+
 using ScopedFPDFDocument =
     std::unique_ptr<std::remove_pointer<FPDF_DOCUMENT>::type,
                     FPDFDocumentDeleter>;
@@ -197,6 +197,120 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsFormAvail(FPDF_AVAIL avail,
 // if the PDF is linearlized.
 FPDF_EXPORT int FPDF_CALLCONV FPDFAvail_IsLinearized(FPDF_AVAIL avail);
 
+// Experimental API.
+// Control how missing data is reported through FX_DOWNLOADHINTS.
+//
+//   avail      - handle to document availability provider.
+//   coalesce   - if TRUE, the segments found to be missing during one call to
+//                FPDFAvail_IsDocAvail(), FPDFAvail_IsPageAvail() or
+//                FPDFAvail_IsFormAvail() are sorted, merged and reported just
+//                before that call returns, instead of one at a time.
+//   merge_gap  - when |coalesce| is TRUE, also merge segments separated by at
+//                most this many bytes.
+//   read_ahead - number of extra bytes to request past the end of each
+//                missing segment. For linearized files with hint tables,
+//                read-ahead stops at the end of the page or shared object
+//                group that contains the segment end.
+//
+// Returns TRUE on success. By default, |coalesce| is FALSE and the other
+// values are 0, so every missing segment is reported as soon as it is found.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFAvail_SetRequestPolicy(FPDF_AVAIL avail,
+                           FPDF_BOOL coalesce,
+                           unsigned int merge_gap,
+                           unsigned int read_ahead);
+
+// Experimental API.
+// Get the number of segments and bytes reported through FX_DOWNLOADHINTS so
+// far by |avail|.
+//
+//   avail           - handle to document availability provider.
+//   request_count   - receives the number of AddSegment() calls.
+//   requested_bytes - receives the total size of those segments.
+//
+// Returns TRUE on success.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFAvail_GetRequestStats(FPDF_AVAIL avail,
+                          size_t* request_count,
+                          size_t* requested_bytes);
+
+// Experimental API.
+// Interface for reading a file asynchronously, e.g. from network storage.
+typedef struct _FX_ASYNC_FILEACCESS {
+  // Version number of the interface. Must be 1.
+  int version;
+
+  // File length, in bytes.
+  unsigned long file_len;
+
+  // Starts reading a section of the file. Must not block.
+  //
+  // Interface Version: 1
+  // Implementation Required: Yes
+  //
+  //   pThis      - pointer to the interface structure.
+  //   position   - the offset of the section in the file.
+  //   size       - the size of the section.
+  //   request_id - identifies the read in FPDFAvail_CompleteAsyncRead().
+  //
+  // Once the data has arrived, or the read has failed, the embedder calls
+  // FPDFAvail_CompleteAsyncRead() with |request_id|. That call may happen
+  // from within ReadAsync(), or later, but must happen on the thread that uses
+  // the availability provider. The same section is never requested twice
+  // while a read for it is outstanding.
+  void (*ReadAsync)(struct _FX_ASYNC_FILEACCESS* pThis,
+                    unsigned long position,
+                    unsigned long size,
+                    unsigned long request_id);
+} FX_ASYNC_FILEACCESS;
+
+// Experimental API.
+// Create a document availability provider backed by an asynchronous file.
+//
+//   file_access - pointer to an asynchronous file access interface, which
+//                 must outlive the returned provider.
+//
+// Returns a handle to the document availability provider, or NULL on error.
+//
+// Use the returned handle like one from FPDFAvail_Create(), except that the
+// |hints| parameter of FPDFAvail_IsDocAvail(), FPDFAvail_IsPageAvail() and
+// FPDFAvail_IsFormAvail() is ignored: missing data is requested with
+// ReadAsync() instead. When those functions return |PDF_DATA_NOTAVAIL| or
+// |PDF_FORM_NOTAVAIL|, call them again after FPDFAvail_CompleteAsyncRead().
+// Nothing blocks on I/O, so one thread can drive many documents.
+//
+// FPDFAvail_Destroy() must be called when done with the availability provider.
+// Reads still outstanding at that point must not be completed.
+FPDF_EXPORT FPDF_AVAIL FPDF_CALLCONV
+FPDFAvail_CreateAsync(FX_ASYNC_FILEACCESS* file_access);
+
+// Experimental API.
+// Deliver the result of a read started with FX_ASYNC_FILEACCESS::ReadAsync().
+//
+//   avail      - handle from FPDFAvail_CreateAsync().
+//   request_id - the |request_id| passed to ReadAsync().
+//   data       - the requested data, or NULL if the read failed.
+//   size       - the size of |data|. Must equal the requested size, or 0 if
+//                the read failed.
+//
+// Returns TRUE if the result was accepted. A failed read makes the affected
+// availability checks return an error instead of waiting for the data.
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFAvail_CompleteAsyncRead(FPDF_AVAIL avail,
+                            unsigned long request_id,
+                            const unsigned char* data,
+                            unsigned long size);
+
+// Experimental API.
+// Get the number of reads started with ReadAsync() that have not completed.
+//
+//   avail - handle from FPDFAvail_CreateAsync().
+//
+// Returns the number of outstanding reads, or -1 if |avail| was not created
+// with FPDFAvail_CreateAsync().
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFAvail_GetPendingAsyncReadCount(FPDF_AVAIL avail);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
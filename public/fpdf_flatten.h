@@ -22,6 +22,19 @@
 // Flatten for print.
 #define FLAT_PRINT 1
 
+// Per-page results of FPDFDoc_Flatten().
+typedef struct _FPDF_FLATTEN_PAGE_STATS {
+  // One of the |FLATTEN_*| values.
+  int result;
+  // Number of annotations drawn into the page contents.
+  int flattened_annots;
+  // Number of those whose appearance stream had already been converted to a
+  // form XObject earlier in the same FPDFDoc_Flatten() call.
+  int already_converted_appearances;
+  // Time spent flattening the page, in microseconds.
+  unsigned long elapsed_us;
+} FPDF_FLATTEN_PAGE_STATS;
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -37,6 +50,29 @@ extern "C" {
 // cause.
 FPDF_EXPORT int FPDF_CALLCONV FPDFPage_Flatten(FPDF_PAGE page, int nFlag);
 
+// Experimental API.
+// Flatten annotations and form fields into the page contents of every page
+// in a document. Appearance streams used by several annotations, e.g. the same
+// widget appearance on many pages, only get converted to form XObjects once.
+//
+//   document         - handle to the document.
+//   nFlag            - One of the |FLAT_*| values denoting the page usage.
+//   page_stats       - optional array that receives the results for each page,
+//                      indexed by page number.
+//   page_stats_count - number of entries in |page_stats|. Pages past the end
+//                      are still flattened.
+//
+// Returns |FLATTEN_FAIL| if flattening any page failed, |FLATTEN_NOTHINGTODO|
+// if no page had anything to flatten, and |FLATTEN_SUCCESS| otherwise.
+//
+// Pages that are loaded while calling this function do not reflect the
+// flattened contents until they are reloaded.
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFDoc_Flatten(FPDF_DOCUMENT document,
+                int nFlag,
+                FPDF_FLATTEN_PAGE_STATS* page_stats,
+                int page_stats_count);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
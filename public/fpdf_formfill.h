@@ -1755,6 +1755,48 @@ FPDF_EXPORT void FPDF_CALLCONV FPDF_FFLDrawSkia(FPDF_FORMHANDLE hHandle,
                                                 int flags);
 #endif
 
+// Experimental API
+// Function: FPDF_FFLDrawWithClip
+//       Same as FPDF_FFLDraw(), but only renders the parts of the form fields
+//       and popup windows that fall inside |clipping|.
+// Parameters:
+//       hHandle      -   Handle to the form fill module, as returned by
+//                        FPDFDOC_InitFormFillEnvironment().
+//       bitmap       -   Handle to the device independent bitmap (as the
+//                        output buffer). Bitmap handles can be created by
+//                        FPDFBitmap_Create().
+//       page         -   Handle to the page, as returned by FPDF_LoadPage().
+//       start_x      -   Left pixel position of the display area in the
+//                        device coordinates.
+//       start_y      -   Top pixel position of the display area in the device
+//                        coordinates.
+//       size_x       -   Horizontal size (in pixels) for displaying the page.
+//       size_y       -   Vertical size (in pixels) for displaying the page.
+//       rotate       -   Page orientation: 0 (normal), 1 (rotated 90 degrees
+//                        clockwise), 2 (rotated 180 degrees), 3 (rotated 90
+//                        degrees counter-clockwise).
+//       flags        -   0 for normal display, or combination of flags
+//                        defined above.
+//       clipping     -   The rect to clip to in device coords. If NULL, this
+//                        behaves the same as FPDF_FFLDraw().
+// Return Value:
+//       None.
+// Comments:
+//       Form fields that do not intersect |clipping| are skipped entirely, so
+//       embedders can redraw just the regions reported through
+//       FPDF_FORMFILLINFO::FFI_Invalidate() after converting them to device
+//       coordinates with FPDF_PageToDevice().
+FPDF_EXPORT void FPDF_CALLCONV FPDF_FFLDrawWithClip(FPDF_FORMHANDLE hHandle,
+                                                    FPDF_BITMAP bitmap,
+                                                    FPDF_PAGE page,
+                                                    int start_x,
+                                                    int start_y,
+                                                    int size_x,
+                                                    int size_y,
+                                                    int rotate,
+                                                    int flags,
+                                                    const FS_RECTF* clipping);
+
 // Experimental API
 // Function: FPDF_GetFormType
 //           Returns the type of form contained in the PDF document.
@@ -1813,6 +1855,76 @@ FORM_SetIndexSelected(FPDF_FORMHANDLE hHandle,
 FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
 FORM_IsIndexSelected(FPDF_FORMHANDLE hHandle, FPDF_PAGE page, int index);
 
+// Experimental API
+// Function: FORM_SetFieldValues
+//           Sets the values of many form fields at once.
+// Parameters:
+//           hHandle     -   Handle to the form fill module. Returned by
+//                           FPDFDOC_InitFormFillEnvironment.
+//           names       -   Array of |count| fully qualified field names,
+//                           each encoded in UTF-16LE and NUL-terminated.
+//           values      -   Array of |count| values, each encoded in
+//                           UTF-16LE and NUL-terminated. For check boxes and
+//                           radio buttons, the value is the export value of
+//                           the widget to check. For list boxes, it is the
+//                           option to select.
+//           count       -   Number of entries in |names| and |values|.
+// Return Value:
+//           The number of fields whose values were set, or -1 on error,
+//           including when the focused field fails to lose focus.
+// Comments:
+//           Keystroke and validation actions still run for every field, but
+//           calculation actions only run once after all the values are set,
+//           and each changed field only gets its appearance regenerated once.
+//           Prefer this to setting the values one at a time when filling in
+//           many fields. Unknown field names are skipped. The focused field,
+//           if any, loses focus first. Not currently supported for XFA
+//           forms.
+FPDF_EXPORT int FPDF_CALLCONV FORM_SetFieldValues(FPDF_FORMHANDLE hHandle,
+                                                  const FPDF_WIDESTRING* names,
+                                                  const FPDF_WIDESTRING* values,
+                                                  unsigned long count);
+
+// Experimental API
+// Function: FORM_ExportFieldValuesToFDF
+//           Exports the values of the form fields as FDF data.
+// Parameters:
+//           hHandle     -   Handle to the form fill module. Returned by
+//                           FPDFDOC_InitFormFillEnvironment.
+//           buffer      -   Buffer for holding the FDF data, which gets NUL
+//                           terminated. May be NULL.
+//           buflen      -   Length of |buffer| in bytes. If |buflen| is less
+//                           than the returned length, or |buffer| is NULL,
+//                           |buffer| will not be modified.
+// Return Value:
+//           Length in bytes of the FDF data, including the trailing NUL, or 0
+//           on error.
+// Comments:
+//           The data can be passed to FORM_ImportFieldValuesFromFDF().
+FPDF_EXPORT unsigned long FPDF_CALLCONV
+FORM_ExportFieldValuesToFDF(FPDF_FORMHANDLE hHandle,
+                            void* buffer,
+                            unsigned long buflen);
+
+// Experimental API
+// Function: FORM_ImportFieldValuesFromFDF
+//           Sets the values of form fields from FDF data.
+// Parameters:
+//           hHandle     -   Handle to the form fill module. Returned by
+//                           FPDFDOC_InitFormFillEnvironment.
+//           data        -   Pointer to the FDF data.
+//           size        -   Length of |data| in bytes.
+// Return Value:
+//           The number of fields whose values were set, or -1 if |data| is
+//           not valid FDF or the focused field fails to lose focus.
+// Comments:
+//           Only the field names and values in the FDF data are used. The
+//           values get set the same way as with FORM_SetFieldValues().
+FPDF_EXPORT int FPDF_CALLCONV
+FORM_ImportFieldValuesFromFDF(FPDF_FORMHANDLE hHandle,
+                              const void* data,
+                              unsigned long size);
+
 // Function: FPDF_LoadXFA
 //          If the document consists of XFA fields, call this method to
 //          attempt to load XFA fields.
@@ -30,6 +30,29 @@ extern "C" {
 //
 FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV FPDFText_LoadPage(FPDF_PAGE page);
 
+// Experimental API.
+// Function: FPDFText_LoadTextOnlyPage
+//          Prepare information about all characters in a page, without
+//          loading the page for rendering.
+// Parameters:
+//          document    -   Handle to a document. Returned by FPDF_LoadDocument.
+//          page_index  -   Index number of the page. 0 for the first page.
+// Return value:
+//          A handle to the text page information structure.
+//          NULL if something goes wrong.
+// Comments:
+//          The page content is parsed in a text-only mode that skips path,
+//          image and shading objects, so this is much cheaper than calling
+//          FPDF_LoadPage() followed by FPDFText_LoadPage(). The extracted text
+//          is the same. Text objects returned by FPDFText_GetTextObject() stay
+//          valid until the text page is released.
+//          XFA pages are not supported.
+//          Application must call FPDFText_ClosePage to release the text page
+//          information.
+//
+FPDF_EXPORT FPDF_TEXTPAGE FPDF_CALLCONV
+FPDFText_LoadTextOnlyPage(FPDF_DOCUMENT document, int page_index);
+
 // Function: FPDFText_ClosePage
 //          Release all resources allocated for a text page information
 //          structure.
@@ -554,6 +577,125 @@ FPDF_EXPORT int FPDF_CALLCONV FPDFText_GetSchCount(FPDF_SCHHANDLE handle);
 //
 FPDF_EXPORT void FPDF_CALLCONV FPDFText_FindClose(FPDF_SCHHANDLE handle);
 
+// Experimental API.
+// Function: FPDFText_LoadDocSearch
+//          Create a search context that covers every page of a document.
+// Parameters:
+//          document    -   Handle to a document. Returned by FPDF_LoadDocument.
+// Return Value:
+//          A handle for the document search context, or NULL on failure.
+//          FPDFText_CloseDocSearch must be called to release this handle.
+// Comments:
+//          The normalized text of each page is extracted the first time it is
+//          searched and kept for the lifetime of the handle, so repeated
+//          searches do not reload pages. The document must outlive the handle
+//          and must not be modified while the handle is open.
+//          XFA pages are not supported.
+//
+FPDF_EXPORT FPDF_DOCSEARCH FPDF_CALLCONV
+FPDFText_LoadDocSearch(FPDF_DOCUMENT document);
+
+// Experimental API.
+// Function: FPDFText_CloseDocSearch
+//          Release a document search context.
+// Parameters:
+//          handle      -   A handle returned by FPDFText_LoadDocSearch.
+// Return Value:
+//          None.
+//
+FPDF_EXPORT void FPDF_CALLCONV FPDFText_CloseDocSearch(FPDF_DOCSEARCH handle);
+
+// Experimental API.
+// Function: FPDFText_DocSearchFind
+//          Search every page of the document for several terms at once.
+// Parameters:
+//          handle      -   A handle returned by FPDFText_LoadDocSearch.
+//          terms       -   An array of unicode search terms.
+//          term_count  -   Number of entries in |terms|.
+//          flags       -   FPDF_MATCHCASE and/or FPDF_MATCHWHOLEWORD.
+//                          FPDF_CONSECUTIVE is ignored; overlapping matches
+//                          are always reported.
+// Return Value:
+//          Number of matches, or -1 on bad parameters.
+// Comments:
+//          Replaces the matches of any previous search on |handle|. Matches
+//          are ordered by page, then by position on the page, then by index
+//          in |terms|. Both the terms and the page text are compared after
+//          Unicode compatibility normalization, e.g. ligatures are expanded,
+//          and runs of whitespace compare equal to a single space.
+//
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_DocSearchFind(FPDF_DOCSEARCH handle,
+                       const FPDF_WIDESTRING* terms,
+                       int term_count,
+                       unsigned long flags);
+
+// Experimental API.
+// Function: FPDFText_DocSearchGetMatch
+//          Get one match from the last FPDFText_DocSearchFind call.
+// Parameters:
+//          handle      -   A handle returned by FPDFText_LoadDocSearch.
+//          match_index -   Zero-based index of the match.
+//          page_index  -   Receives the page index of the match.
+//          term_index  -   Receives the index of the matched term.
+//          char_index  -   Receives the index of the first matched character,
+//                          as used by FPDFText_LoadPage on that page.
+//          char_count  -   Receives the number of matched characters.
+// Return Value:
+//          TRUE on success. FALSE on bad parameters, in which case the out
+//          parameters are not modified.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_DocSearchGetMatch(FPDF_DOCSEARCH handle,
+                           int match_index,
+                           int* page_index,
+                           int* term_index,
+                           int* char_index,
+                           int* char_count);
+
+// Experimental API.
+// Function: FPDFText_DocSearchCountRects
+//          Count the rectangular areas occupied by a match, and cache them for
+//          subsequent FPDFText_DocSearchGetRect() calls.
+// Parameters:
+//          handle      -   A handle returned by FPDFText_LoadDocSearch.
+//          match_index -   Zero-based index of the match.
+// Return Value:
+//          Number of rectangles, or -1 on bad parameters.
+// Comments:
+//          The rectangles are in page coordinates, as with FPDFText_GetRect.
+//          Consecutive calls for matches on the same page reuse the loaded
+//          text page.
+//
+FPDF_EXPORT int FPDF_CALLCONV
+FPDFText_DocSearchCountRects(FPDF_DOCSEARCH handle, int match_index);
+
+// Experimental API.
+// Function: FPDFText_DocSearchGetRect
+//          Get a rectangle from the result of FPDFText_DocSearchCountRects.
+// Parameters:
+//          handle      -   A handle returned by FPDFText_LoadDocSearch.
+//          rect_index  -   Zero-based index for the rectangle.
+//          left        -   Pointer to a double value receiving the rectangle
+//                          left boundary.
+//          top         -   Pointer to a double value receiving the rectangle
+//                          top boundary.
+//          right       -   Pointer to a double value receiving the rectangle
+//                          right boundary.
+//          bottom      -   Pointer to a double value receiving the rectangle
+//                          bottom boundary.
+// Return Value:
+//          TRUE on success. FALSE on bad parameters, in which case the out
+//          parameters are not modified.
+//
+FPDF_EXPORT FPDF_BOOL FPDF_CALLCONV
+FPDFText_DocSearchGetRect(FPDF_DOCSEARCH handle,
+                          int rect_index,
+                          double* left,
+                          double* top,
+                          double* right,
+                          double* bottom);
+
 // Function: FPDFLink_LoadWebLinks
 //          Prepare information about weblinks in a page.
 // Parameters:
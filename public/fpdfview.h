@@ -67,6 +67,7 @@ typedef struct fpdf_bitmap_t__* FPDF_BITMAP;
 typedef struct fpdf_bookmark_t__* FPDF_BOOKMARK;
 typedef struct fpdf_clippath_t__* FPDF_CLIPPATH;
 typedef struct fpdf_dest_t__* FPDF_DEST;
+typedef struct fpdf_docsearch_t__* FPDF_DOCSEARCH;
 typedef struct fpdf_document_t__* FPDF_DOCUMENT;
 typedef struct fpdf_font_t__* FPDF_FONT;
 typedef struct fpdf_form_handle_t__* FPDF_FORMHANDLE;
@@ -280,6 +281,15 @@ typedef struct FPDF_LIBRARY_CONFIG_ {
   // corresponding render library is not included in the build will similarly
   // fail with an immediate crash.
   FPDF_RENDERER_TYPE m_RendererType;
+
+  // Version 5 - Experimental.
+
+  // Path of a file where the built-in FXGE font loading code may keep an index
+  // of the fonts it finds in the font paths, or NULL to not keep one. Later
+  // initializations with the same path only parse font files that were added
+  // or changed since. The file gets created or updated as needed. May be
+  // ignored entirely depending upon the platform.
+  const char* m_pFontIndexCachePath;
 } FPDF_LIBRARY_CONFIG;
 
 // Function: FPDF_InitLibraryWithConfig
@@ -64,6 +64,16 @@ int AlertTrampoline(IPDF_JSPLATFORM* platform,
   return delegate->Alert(message, title, type, icon);
 }
 
+void InvalidateTrampoline(FPDF_FORMFILLINFO* info,
+                          FPDF_PAGE page,
+                          double left,
+                          double top,
+                          double right,
+                          double bottom) {
+  auto* delegate = static_cast<EmbedderTest*>(info)->GetDelegate();
+  return delegate->Invalidate(page, left, top, right, bottom);
+}
+
 int SetTimerTrampoline(FPDF_FORMFILLINFO* info, int msecs, TimerCallback fn) {
   auto* delegate = static_cast<EmbedderTest*>(info)->GetDelegate();
   return delegate->SetTimer(msecs, fn);
@@ -111,13 +121,6 @@ void DoURIActionWithKeyboardModifierTrampoline(FPDF_FORMFILLINFO* info,
 }
 
 // These do nothing (but must return a reasonable default value).
-void InvalidateStub(FPDF_FORMFILLINFO* pThis,
-                    FPDF_PAGE page,
-                    double left,
-                    double top,
-                    double right,
-                    double bottom) {}
-
 void OutputSelectedRectStub(FPDF_FORMFILLINFO* pThis,
                             FPDF_PAGE page,
                             double left,
@@ -453,7 +456,7 @@ FPDF_FORMHANDLE EmbedderTest::SetupFormFillEnvironment(
   FPDF_FORMFILLINFO* formfillinfo = static_cast<FPDF_FORMFILLINFO*>(this);
   *formfillinfo = {};
   formfillinfo->version = form_fill_info_version_;
-  formfillinfo->FFI_Invalidate = InvalidateStub;
+  formfillinfo->FFI_Invalidate = InvalidateTrampoline;
   formfillinfo->FFI_OutputSelectedRect = OutputSelectedRectStub;
   formfillinfo->FFI_SetCursor = SetCursorStub;
   formfillinfo->FFI_SetTimer = SetTimerTrampoline;
@@ -57,6 +57,13 @@ class EmbedderTest : public ::testing::Test,
       return 0;
     }
 
+    // Equivalent to FPDF_FORMFILLINFO::FFI_Invalidate().
+    virtual void Invalidate(FPDF_PAGE page,
+                            double left,
+                            double top,
+                            double right,
+                            double bottom) {}
+
     // Equivalent to FPDF_FORMFILLINFO::FFI_SetTimer().
     virtual int SetTimer(int msecs, TimerCallback fn) { return 0; }
 
@@ -5,11 +5,13 @@
 #include <cstdint>
 
 #include "core/fxcodec/icc/icc_transform.h"
+#include "core/fxcrt/retain_ptr.h"
 #include "core/fxcrt/span.h"
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
-  std::unique_ptr<fxcodec::IccTransform> transform =
-      fxcodec::IccTransform::CreateTransformSRGB(pdfium::span(data, size));
+  RetainPtr<fxcodec::IccTransform> transform =
+      fxcodec::IccTransform::CreateTransformSRGB(pdfium::span(data, size),
+                                                  INTENT_PERCEPTUAL);
   if (!transform) {
     return 0;
   }
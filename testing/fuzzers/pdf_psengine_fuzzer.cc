@@ -2,15 +2,71 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <math.h>
 #include <stdint.h>
+#include <string.h>
+
+#include <memory>
 
 #include "core/fpdfapi/page/cpdf_psengine.h"
+#include "core/fpdfapi/page/cpdf_psprogram.h"
+#include "core/fxcrt/check.h"
+#include "core/fxcrt/check_op.h"
 #include "core/fxcrt/span.h"
 
+namespace {
+
+constexpr uint32_t kMaxInputs = 4;
+constexpr uint32_t kMaxOutputs = 4;
+
+bool SameFloat(float a, float b) {
+  return (isnan(a) && isnan(b)) || memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Checks that the compiled form of the program matches the interpreter.
+void CheckCompiledProgram(CPDF_PSEngine* engine,
+                          uint32_t input_count,
+                          uint32_t output_count) {
+  std::unique_ptr<CPDF_PSProgram> program =
+      CPDF_PSProgram::Compile(engine->main_proc(), input_count, output_count);
+  if (!program) {
+    return;
+  }
+
+  static constexpr float kInputs[][kMaxInputs] = {
+      {0, 0, 0, 0},
+      {1, 1, 1, 1},
+      {0.5f, 0.25f, 0.75f, 0.125f},
+      {-2.5f, 3, 100, -0.001f},
+  };
+  for (const auto& input_set : kInputs) {
+    auto inputs = pdfium::span(input_set).first(input_count);
+    engine->Reset();
+    for (float input : inputs) {
+      engine->Push(input);
+    }
+    engine->Execute();
+    CHECK_GE(engine->GetStackSize(), output_count);
+
+    float results[kMaxOutputs];
+    program->Run(1, inputs, results);
+    for (uint32_t i = 0; i < output_count; ++i) {
+      CHECK(SameFloat(engine->Pop(), results[output_count - i - 1]));
+    }
+  }
+}
+
+}  // namespace
+
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
   CPDF_PSEngine engine;
   if (engine.Parse(pdfium::span(data, size))) {
     engine.Execute();
+    // Derive the function shape from the input, so existing corpora still
+    // work as plain programs.
+    const uint32_t input_count = 1 + size % kMaxInputs;
+    const uint32_t output_count = 1 + (size / kMaxInputs) % kMaxOutputs;
+    CheckCompiledProgram(&engine, input_count, output_count);
   }
   return 0;
 }
@@ -47,6 +47,20 @@ CXFA_ContentLayoutItem* CXFA_ContentLayoutItem::GetLast() {
   return pCurNode;
 }
 
+std::optional<CFX_SizeF> CXFA_ContentLayoutItem::GetMeasuredSize(
+    uint32_t generation) const {
+  if (generation != measured_generation_) {
+    return std::nullopt;
+  }
+  return measured_size_;
+}
+
+void CXFA_ContentLayoutItem::SetMeasuredSize(const CFX_SizeF& size,
+                                             uint32_t generation) {
+  measured_size_ = size;
+  measured_generation_ = generation;
+}
+
 void CXFA_ContentLayoutItem::InsertAfter(CXFA_ContentLayoutItem* pItem) {
   CHECK_NE(this, pItem);
   pItem->RemoveSelf();
@@ -7,6 +7,10 @@
 #ifndef XFA_FXFA_LAYOUT_CXFA_CONTENTLAYOUTITEM_H_
 #define XFA_FXFA_LAYOUT_CXFA_CONTENTLAYOUTITEM_H_
 
+#include <stdint.h>
+
+#include <optional>
+
 #include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/mask.h"
 #include "v8/include/cppgc/persistent.h"
@@ -42,6 +46,12 @@ class CXFA_ContentLayoutItem final : public CXFA_LayoutItem {
     return status_.TestAll(val);
   }
 
+  // Size of the field or draw measured during measure generation
+  // `generation`, if any. Lets relayouts skip measuring unchanged widgets.
+  std::optional<CFX_SizeF> GetMeasuredSize(uint32_t generation) const;
+  void SetMeasuredSize(const CFX_SizeF& size, uint32_t generation);
+  void ClearMeasuredSize() { measured_size_.reset(); }
+
   CFX_PointF s_pos_;
   CFX_SizeF s_size_;
 
@@ -50,6 +60,8 @@ class CXFA_ContentLayoutItem final : public CXFA_LayoutItem {
   void RemoveSelf();
 
   mutable Mask<XFA_WidgetStatus> status_;
+  uint32_t measured_generation_ = 0;
+  std::optional<CFX_SizeF> measured_size_;
   cppgc::Member<CXFA_ContentLayoutItem> prev_;
   cppgc::Member<CXFA_ContentLayoutItem> next_;
   cppgc::Member<CXFA_FFWidget> const ffwidget_;
@@ -2196,10 +2196,9 @@ void CXFA_ContentLayoutProcessor::DoLayoutField() {
     return;
   }
 
-  CXFA_Document* document = GetFormNode()->GetDocument();
-  CXFA_FFNotify* pNotify = document->GetNotify();
-  CFX_SizeF size(-1, -1);
-  pNotify->StartFieldDrawLayout(GetFormNode(), &size.width, &size.height);
+  CFX_SizeF size =
+      CXFA_LayoutProcessor::FromDocument(GetFormNode()->GetDocument())
+          ->MeasureWidget(layout_item_);
 
   int32_t nRotate = XFA_MapRotation(
       GetFormNode()->JSObject()->GetInteger(XFA_Attribute::Rotate));
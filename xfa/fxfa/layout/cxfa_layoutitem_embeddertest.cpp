@@ -4,6 +4,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/xfa_js_embedder_test.h"
+#include "xfa/fxfa/layout/cxfa_layoutprocessor.h"
 
 class CXFALayoutItemEmbedderTest : public XFAJSEmbedderTest {};
 
@@ -43,3 +44,34 @@ TEST_F(CXFALayoutItemEmbedderTest, BreakBeforeAfter) {
     EXPECT_TRUE(page);
   }
 }
+
+TEST_F(CXFALayoutItemEmbedderTest, AddRowsToLargeRepeatingSubform) {
+  static constexpr size_t kInitialRows = 500;
+  static constexpr size_t kAddedRows = 50;
+  static constexpr size_t kFieldsPerRow = 2;
+  ASSERT_TRUE(OpenDocument("xfa/xfa_repeating_rows.pdf"));
+  CXFA_LayoutProcessor* layout =
+      CXFA_LayoutProcessor::FromDocument(GetXFADocument());
+  const int32_t initial_page_count = layout->CountPages();
+  EXPECT_GT(initial_page_count, 1);
+  const CXFA_LayoutProcessor::Stats initial_stats = layout->stats();
+  EXPECT_GE(initial_stats.measured_widgets, kInitialRows * kFieldsPerRow);
+
+  ASSERT_TRUE(Execute(
+      "var mgr = xfa.resolveNode(\"xfa.form..Row\").instanceManager;"
+      "for (var i = 0; i < 50; ++i) {"
+      "  mgr.addInstance(true);"
+      "}"));
+  ASSERT_EQ(0, layout->StartLayout());
+  EXPECT_EQ(100, layout->DoLayout());
+  EXPECT_GT(layout->CountPages(), initial_page_count);
+
+  // Only the new rows need measuring. The existing rows reuse their sizes.
+  const CXFA_LayoutProcessor::Stats& stats = layout->stats();
+  const size_t measured =
+      stats.measured_widgets - initial_stats.measured_widgets;
+  EXPECT_GE(measured, kAddedRows * kFieldsPerRow);
+  EXPECT_LT(measured, kInitialRows * kFieldsPerRow);
+  EXPECT_GE(stats.reused_measurements - initial_stats.reused_measurements,
+            kInitialRows * kFieldsPerRow);
+}
@@ -6,9 +6,12 @@
 
 #include "xfa/fxfa/layout/cxfa_layoutprocessor.h"
 
+#include <optional>
+
 #include "fxjs/gc/container_trace.h"
 #include "fxjs/xfa/cjx_object.h"
 #include "v8/include/cppgc/heap.h"
+#include "xfa/fxfa/cxfa_ffnotify.h"
 #include "xfa/fxfa/layout/cxfa_contentlayoutitem.h"
 #include "xfa/fxfa/layout/cxfa_contentlayoutprocessor.h"
 #include "xfa/fxfa/layout/cxfa_viewlayoutprocessor.h"
@@ -38,6 +41,7 @@ void CXFA_LayoutProcessor::Trace(cppgc::Visitor* visitor) const {
 
 void CXFA_LayoutProcessor::SetForceRelayout() {
   need_layout_ = true;
+  ++measure_generation_;
 }
 
 int32_t CXFA_LayoutProcessor::StartLayout() {
@@ -146,6 +150,47 @@ void CXFA_LayoutProcessor::SetHasChangedContainer() {
   has_changed_containers_ = true;
 }
 
+void CXFA_LayoutProcessor::AddChangedContainer(CXFA_Node* pContainer) {
+  XFA_Element eType = pContainer->GetElementType();
+  if (eType != XFA_Element::Field && eType != XFA_Element::Draw) {
+    // Subforms pass properties like locales on to their widgets.
+    ++measure_generation_;
+    return;
+  }
+
+  CXFA_ContentLayoutItem* pItem =
+      ToContentLayoutItem(pContainer->JSObject()->GetLayoutItem());
+  if (pItem) {
+    pItem->ClearMeasuredSize();
+  }
+}
+
+CFX_SizeF CXFA_LayoutProcessor::MeasureWidget(CXFA_ContentLayoutItem* pItem) {
+  CXFA_Node* pFormNode = pItem->GetFormNode();
+
+  // Only the first item of a widget remembers its size. Text draws are always
+  // measured, since that also resets the text layout used to split them.
+  const bool bCacheable =
+      pFormNode->JSObject()->GetLayoutItem() == pItem &&
+      pFormNode->GetFFWidgetType() != XFA_FFWidgetType::kText;
+  if (bCacheable) {
+    std::optional<CFX_SizeF> size = pItem->GetMeasuredSize(measure_generation_);
+    if (size.has_value()) {
+      ++stats_.reused_measurements;
+      return size.value();
+    }
+  }
+
+  CFX_SizeF size(-1, -1);
+  GetDocument()->GetNotify()->StartFieldDrawLayout(pFormNode, &size.width,
+                                                   &size.height);
+  ++stats_.measured_widgets;
+  if (bCacheable) {
+    pItem->SetMeasuredSize(size, measure_generation_);
+  }
+  return size;
+}
+
 bool CXFA_LayoutProcessor::NeedLayout() const {
   return need_layout_ || has_changed_containers_;
 }
@@ -7,8 +7,10 @@
 #ifndef XFA_FXFA_LAYOUT_CXFA_LAYOUTPROCESSOR_H_
 #define XFA_FXFA_LAYOUT_CXFA_LAYOUTPROCESSOR_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "core/fxcrt/fx_coordinates.h"
 #include "core/fxcrt/unowned_ptr.h"
 #include "fxjs/gc/heap.h"
 #include "v8/include/cppgc/garbage-collected.h"
@@ -16,6 +18,7 @@
 #include "v8/include/cppgc/visitor.h"
 #include "xfa/fxfa/parser/cxfa_document.h"
 
+class CXFA_ContentLayoutItem;
 class CXFA_ContentLayoutProcessor;
 class CXFA_LayoutItem;
 class CXFA_Node;
@@ -28,6 +31,11 @@ class Heap;
 
 class CXFA_LayoutProcessor final : public CXFA_Document::LayoutProcessorIface {
  public:
+  struct Stats {
+    size_t measured_widgets = 0;
+    size_t reused_measurements = 0;
+  };
+
   static CXFA_LayoutProcessor* FromDocument(const CXFA_Document* pXFADoc);
 
   CONSTRUCT_VIA_MAKE_GARBAGE_COLLECTED;
@@ -38,6 +46,7 @@ class CXFA_LayoutProcessor final : public CXFA_Document::LayoutProcessorIface {
   // CXFA_Document::LayoutProcessorIface:
   void SetForceRelayout() override;
   void SetHasChangedContainer() override;
+  void AddChangedContainer(CXFA_Node* pContainer) override;
 
   int32_t StartLayout();
   int32_t DoLayout();
@@ -52,6 +61,12 @@ class CXFA_LayoutProcessor final : public CXFA_Document::LayoutProcessorIface {
     return view_layout_processor_;
   }
 
+  // Returns the size of the field or draw `pItem` lays out. Unless its form
+  // node changed since, reuses the size measured by an earlier layout pass,
+  // so relayouts only measure new and changed widgets.
+  CFX_SizeF MeasureWidget(CXFA_ContentLayoutItem* pItem);
+  const Stats& stats() const { return stats_; }
+
  private:
   explicit CXFA_LayoutProcessor(cppgc::Heap* pHeap);
 
@@ -63,6 +78,10 @@ class CXFA_LayoutProcessor final : public CXFA_Document::LayoutProcessorIface {
   cppgc::Member<CXFA_ViewLayoutProcessor> view_layout_processor_;
   cppgc::Member<CXFA_ContentLayoutProcessor> content_layout_processor_;
   uint32_t progress_counter_ = 0;
+  // Incremented when a change may affect how any widget measures, which
+  // invalidates all sizes remembered by MeasureWidget().
+  uint32_t measure_generation_ = 0;
+  Stats stats_;
   bool has_changed_containers_ = false;
   bool need_layout_ = true;
 };
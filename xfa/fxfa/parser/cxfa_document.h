@@ -73,6 +73,9 @@ class CXFA_Document final : public cppgc::GarbageCollected<CXFA_Document> {
     virtual void Trace(cppgc::Visitor* visitor) const;
     virtual void SetForceRelayout() = 0;
     virtual void SetHasChangedContainer() = 0;
+    // Called when `pContainer`, or a non-container node inside it, changed,
+    // so layout results cached for it must not be reused.
+    virtual void AddChangedContainer(CXFA_Node* pContainer) = 0;
 
     void SetDocument(CXFA_Document* document) { document_ = document; }
     CXFA_Document* GetDocument() const { return document_; }
@@ -1713,6 +1713,7 @@ void CXFA_Node::InsertChildAndNotify(CXFA_Node* pNode, CXFA_Node* pBeforeNode) {
   if (pNotify) {
     pNotify->OnChildAdded(this);
   }
+  SendLayoutChangeMessage(true);
 
   if (!IsNeedSavingXMLNode() || !pNode->xml_node_) {
     return;
@@ -1732,6 +1733,9 @@ void CXFA_Node::RemoveChildAndNotify(CXFA_Node* pNode, bool bNotify) {
   pNode->SetFlag(XFA_NodeFlag::kHasRemovedChildren);
   GCedTreeNodeMixin<CXFA_Node>::RemoveChild(pNode);
   OnRemoved(bNotify);
+  if (bNotify) {
+    SendLayoutChangeMessage(true);
+  }
 
   if (!IsNeedSavingXMLNode() || !pNode->xml_node_) {
     return;
@@ -1954,6 +1958,34 @@ void CXFA_Node::OnRemoved(bool bNotify) const {
   }
 }
 
+void CXFA_Node::SendLayoutChangeMessage(bool bChildrenChanged) {
+  if (GetPacketType() != XFA_PacketType::Form) {
+    return;
+  }
+
+  CXFA_Document::LayoutProcessorIface* pLayout =
+      document_->GetLayoutProcessor();
+  if (!pLayout) {
+    return;
+  }
+
+  CXFA_Node* pContainer = this;
+  while (pContainer && !pContainer->IsContainerNode()) {
+    pContainer = pContainer->GetParent();
+  }
+  if (!pContainer) {
+    return;
+  }
+
+  if (bChildrenChanged) {
+    XFA_Element eType = pContainer->GetElementType();
+    if (eType != XFA_Element::Field && eType != XFA_Element::Draw) {
+      return;
+    }
+  }
+  pLayout->AddChangedContainer(pContainer);
+}
+
 void CXFA_Node::UpdateNameHash() {
   WideString wsName = JSObject()->GetCData(XFA_Attribute::Name);
   name_hash_ = FX_HashCode_GetW(wsName.AsStringView());
@@ -2243,6 +2275,7 @@ void CXFA_Node::SendAttributeChangeMessage(XFA_Attribute eAttribute,
     return;
   }
 
+  SendLayoutChangeMessage(false);
   bool bNeedFindContainer = false;
   switch (GetElementType()) {
     case XFA_Element::Caption:
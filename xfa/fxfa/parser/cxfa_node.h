@@ -456,6 +456,10 @@ class CXFA_Node : public CXFA_Object, public GCedTreeNodeMixin<CXFA_Node> {
   std::optional<XFA_Element> GetFirstPropertyWithFlag(
       XFA_PropertyFlag flag) const;
   void OnRemoved(bool bNotify) const;
+  // Tells the layout processor that the container of this node changed.
+  // Adding or removing children only matters inside fields and draws, since
+  // it does not change how the other children of a subform measure.
+  void SendLayoutChangeMessage(bool bChildrenChanged);
   std::optional<void*> GetDefaultValue(XFA_Attribute attr,
                                        XFA_AttributeType eType) const;
   CXFA_Node* GetChildInternal(size_t index,